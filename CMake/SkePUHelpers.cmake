@@ -19,6 +19,12 @@ macro(skepu_filter_args)
 			set(_skepu_opencl ON)
 		elseif(${arg} STREQUAL "OpenMP")
 			set(_skepu_openmp ON)
+		elseif(${arg} STREQUAL "TaskPool")
+			set(_skepu_taskpool ON)
+		elseif(${arg} STREQUAL "Fuse")
+			set(_skepu_fuse ON)
+		elseif(${arg} STREQUAL "Specialize")
+			set(_skepu_specialize ON)
 		elseif(${arg} STREQUAL "FNAMES")
 			set(_fnames_arg ON)
 			set(_src_arg OFF)
@@ -104,6 +110,22 @@ macro(skepu_configure)
 			list(APPEND _target_libs OpenMP::OpenMP_CXX)
 		endif()
 	endif()
+
+	if(_skepu_taskpool)
+		if(NOT Threads_FOUND)
+			find_package(Threads REQUIRED)
+		endif()
+		list(APPEND _skepu_backends "-taskpool")
+		list(APPEND _target_libs Threads::Threads)
+	endif()
+
+	if(_skepu_fuse)
+		list(APPEND _skepu_backends "-fuse")
+	endif()
+
+	if(_skepu_specialize)
+		list(APPEND _skepu_backends "-specialize")
+	endif()
 endmacro(skepu_configure)
 
 # We need to make sure that target_link_libraries and target_include_directories
@@ -135,7 +157,7 @@ macro(skepu_generate_include_generators)
 endmacro(skepu_generate_include_generators)
 
 #	skepu_add_library(<name> [STATIC | SHARED | MODULE] [EXCLUDE_FROM_ALL]
-#		[[CUDA] [OpenCL] [OpenMP] | [MPI]]
+#		[[CUDA] [OpenCL] [OpenMP] [TaskPool] | [MPI]] [Fuse] [Specialize]
 #		SKEPUSRC ssrc1 [ssrc2 ...]
 #		[SRC	src1 [src2 ...]])
 #
@@ -150,7 +172,7 @@ function(skepu_add_library name)
 endfunction(skepu_add_library)
 
 #	skepu_add_executable(<name> [EXCLUDE_FROM_ALL]
-#		[[CUDA] [OpenCL] [OpenMP] | [MPI]]
+#		[[CUDA] [OpenCL] [OpenMP] [TaskPool] | [MPI]] [Fuse] [Specialize]
 #		SKEPUSRC ssrc1 [ssrc2 ...]
 #		[SRC src1 [src2 ...]])
 #
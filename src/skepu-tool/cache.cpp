@@ -0,0 +1,125 @@
+#include "clang/Basic/Version.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "globals.h"
+
+using namespace clang;
+
+// ------------------------------
+// Incremental precompilation
+// ------------------------------
+
+// The cache of an output lists the content hashes of every file the translation unit was parsed from, together with
+// a hash of the options it was generated with. When all of them match, the translation unit is not parsed again.
+// Output files are only written when their contents change, so that unchanged outputs keep their time stamps and
+// do not trigger downstream rebuilds.
+
+// Files written for the current translation unit
+static std::set<std::string> GeneratedFiles;
+
+// Version and commit the tool was built from, set by the build. Outputs of another version are generated again
+#ifndef SKEPU_TOOL_VERSION
+#define SKEPU_TOOL_VERSION "unknown"
+#endif
+static const char *ToolVersion = SKEPU_TOOL_VERSION;
+
+
+static std::string contentHash(llvm::StringRef data)
+{
+	llvm::MD5 hasher;
+	hasher.update(data);
+	llvm::MD5::MD5Result result;
+	hasher.final(result);
+	return result.digest().str().str();
+}
+
+static std::string fileHash(const std::string &path)
+{
+	auto buffer = llvm::MemoryBuffer::getFile(path);
+	if (!buffer)
+		return "";
+	return contentHash((*buffer)->getBuffer());
+}
+
+bool writeFileIfChanged(const std::string &path, const std::string &contents)
+{
+	GeneratedFiles.insert(path);
+
+	auto existing = llvm::MemoryBuffer::getFile(path);
+	if (existing && (*existing)->getBuffer() == contents)
+	{
+		SkePULog() << "Unchanged output: " << path << "\n";
+		return false;
+	}
+
+	std::ofstream FSOutFile {path};
+	FSOutFile << contents;
+	if (!FSOutFile)
+		SkePUAbort("Could not write output file: " + path);
+	return true;
+}
+
+std::string optionsHash(const std::vector<std::string> &commandLine)
+{
+	std::stringstream SSOptions;
+	SSOptions << ToolVersion << "\n" << getClangFullVersion() << "\n"
+		<< GenCUDA << GenOMP << GenCL << GenTaskPool << GenFusion << GenSpecialization << "\n"
+		<< AllowedFuncNames << "\n" << ResultDir << "\n" << ResultName << "\n";
+	for (const std::string &arg : commandLine)
+		SSOptions << arg << "\n";
+	return contentHash(SSOptions.str());
+}
+
+// Format: one "options <hash>" line, then "input <hash> <path>" and "output <path>" lines
+bool isUpToDate(const std::string &cacheFile, const std::string &options)
+{
+	std::ifstream FSCache {cacheFile};
+	std::string kind, hash, path;
+	if (!(FSCache >> kind >> hash) || kind != "options" || hash != options)
+		return false;
+
+	bool anyInput = false;
+	while (FSCache >> kind)
+	{
+		FSCache >> std::ws;
+		if (kind == "input")
+		{
+			FSCache >> hash >> std::ws;
+			std::getline(FSCache, path);
+			if (fileHash(path) != hash)
+			{
+				SkePULog() << "Changed input: " << path << "\n";
+				return false;
+			}
+			anyInput = true;
+		}
+		else if (kind == "output")
+		{
+			std::getline(FSCache, path);
+			if (!llvm::sys::fs::exists(path))
+				return false;
+		}
+		else
+			return false;
+	}
+	return anyInput;
+}
+
+void saveCache(const std::string &cacheFile, const std::string &options, SourceManager &SM)
+{
+	std::stringstream SSCache;
+	SSCache << "options " << options << "\n";
+	for (auto it = SM.fileinfo_begin(); it != SM.fileinfo_end(); ++it)
+	{
+		std::string path = it->first->getName().str();
+		SSCache << "input " << fileHash(path) << " " << path << "\n";
+	}
+	for (const std::string &path : GeneratedFiles)
+		SSCache << "output " << path << "\n";
+
+	std::ofstream FSCache {cacheFile};
+	FSCache << SSCache.str();
+	GeneratedFiles.clear();
+}
@@ -182,8 +182,7 @@ std::string createCallKernelProgram_CL(UserFunction &callFunc, std::string dir)
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIES", SSProxyInitializer.str());
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIE_INNER", SSProxyInitializerInner.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
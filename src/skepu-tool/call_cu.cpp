@@ -43,7 +43,6 @@ std::string createCallKernelProgram_CU(UserFunction &callFunc, std::string dir)
 	replaceTextInString(kernelSource, PH_KernelParams, SSKernelParamList.str());
 	replaceTextInString(kernelSource, PH_CallArgs, SSCallFuncParams.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
@@ -381,7 +381,53 @@ bool testAndSet(bool &arg, bool newVal = true)
 	return oldVal;
 }
 
-void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clang::SourceLocation loc)
+// Hash of the user function source and the user functions it calls, keys the function in the tuning database
+uint64_t userFunctionSourceHash(UserFunction &UF)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	auto update = [&hash] (const std::string &text)
+	{
+		for (unsigned char c : text)
+			hash = (hash ^ c) * 0x100000001b3ull;
+	};
+	
+	update(getSourceAsString(UF.astDeclNode->getSourceRange()));
+	for (const UserFunction::TemplateArgument &arg : UF.templateArguments)
+		update(arg.resolvedTypeName);
+	for (auto *referenced : UF.ReferencedUFs)
+		hash ^= userFunctionSourceHash(*referenced) * 0x100000001b3ull;
+	return hash;
+}
+
+// Vector variants of the OpenMP function can be declared when it only takes and returns arithmetic scalars
+bool isSimdCompatible(UserFunction &UF)
+{
+	static const std::set<std::string> scalarTypes {
+		"bool", "char", "signed char", "unsigned char", "short", "unsigned short", "int", "unsigned int", "unsigned",
+		"long", "unsigned long", "long long", "unsigned long long", "float", "double", "size_t",
+		"int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t"
+	};
+	auto isScalar = [] (std::string typeName)
+	{
+		if (typeName.compare(0, 6, "const ") == 0)
+			typeName.erase(0, 6);
+		return scalarTypes.count(typeName) > 0;
+	};
+	
+	if (UF.indexed1D || UF.indexed2D || UF.indexed3D || UF.indexed4D || !UF.anyContainerParams.empty() || !UF.multipleReturnTypes.empty())
+		return false;
+	
+	for (UserFunction::Param& param : UF.elwiseParams)
+		if (!isScalar(param.resolvedTypeName))
+			return false;
+	for (UserFunction::Param& param : UF.anyScalarParams)
+		if (!isScalar(param.resolvedTypeName))
+			return false;
+	return isScalar(UF.resolvedReturnTypeName);
+}
+
+void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clang::SourceLocation loc, std::string KernelSource_OMP,
+	std::vector<std::pair<size_t, std::string>> ConstantUniforms)
 {
 	static std::set<std::string> generatedStructs;
 	static std::set<std::string> usingDecls;
@@ -400,6 +446,21 @@ void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clan
 	generatedStructs.insert(FunctorName);
 	UF.instanceName = InstanceName;
 
+	// Uniform arguments known at the call site are declared as constants with the parameter's name in the body,
+	// the parameter itself is renamed and left unused
+	std::string ConstantDecls;
+	std::vector<std::string> UniformNames;
+	for (UserFunction::Param& param : UF.anyScalarParams)
+		UniformNames.push_back(param.name);
+	for (auto &constant : ConstantUniforms)
+	{
+		UserFunction::Param &param = UF.anyScalarParams[constant.first];
+		if (param.astDeclNode->getOriginalType().isConstQualified())
+			ConstantDecls += "constexpr ";
+		ConstantDecls += param.resolvedTypeName + " " + param.name + " = " + constant.second + ";\n";
+		param.name = "skepu_folded_" + param.name;
+	}
+
 	std::stringstream SSSkepuFunctorStruct;
 	SSSkepuFunctorStruct << "\nstruct " << FunctorName;
 	SSSkepuFunctorStruct << "\n{\n";
@@ -490,6 +551,7 @@ void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clan
 	if (UF.multipleReturnTypes.size() == 0 && UF.rawReturnTypeName != UF.resolvedReturnTypeName && (std::find(usingDecls.begin(), usingDecls.end(), UF.rawReturnTypeName) == usingDecls.end()))
 		SSSkepuFunctorStruct << "using " << UF.rawReturnTypeName << " = " << UF.resolvedReturnTypeName << ";\n\n";
 	SSSkepuFunctorStruct << "constexpr static bool prefersMatrix = " << (UF.indexed2D) << ";\n\n";
+	SSSkepuFunctorStruct << "constexpr static uint64_t sourceHash = " << userFunctionSourceHash(UF) << "ull;\n\n";
 
 	// CUDA code
 	if (GenCUDA)
@@ -503,7 +565,7 @@ void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clan
 		SSSkepuFunctorStruct << "#define VARIANT_CUDA(block) block\n";
 		SSSkepuFunctorStruct << "static inline SKEPU_ATTRIBUTE_FORCE_INLINE " << "__device__ " << UF.resolvedReturnTypeName << " CU(";
 		printParamList(SSSkepuFunctorStruct, UF);
-		SSSkepuFunctorStruct << ")\n{" << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::CU"; }) << "\n}\n";
+		SSSkepuFunctorStruct << ")\n{" << ConstantDecls << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::CU"; }) << "\n}\n";
 		SSSkepuFunctorStruct << "#undef SKEPU_USING_BACKEND_CUDA\n\n";
 	}
 
@@ -516,9 +578,12 @@ void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clan
 		SSSkepuFunctorStruct << "#define VARIANT_CPU(block)\n";
 		SSSkepuFunctorStruct << "#define VARIANT_OPENMP(block) block\n";
 		SSSkepuFunctorStruct << "#define VARIANT_CUDA(block)\n";
+		if (isSimdCompatible(UF))
+			SSSkepuFunctorStruct << "#pragma omp declare simd\n";
 		SSSkepuFunctorStruct << "static inline SKEPU_ATTRIBUTE_FORCE_INLINE " << UF.resolvedReturnTypeName << " OMP(";
 		printParamList(SSSkepuFunctorStruct, UF);
-		SSSkepuFunctorStruct << ")\n{" << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::OMP"; }) << "\n}\n";
+		SSSkepuFunctorStruct << ")\n{" << ConstantDecls << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::OMP"; }) << "\n}\n";
+		SSSkepuFunctorStruct << KernelSource_OMP;
 		SSSkepuFunctorStruct << "#undef SKEPU_USING_BACKEND_OMP\n\n";
 	}
 
@@ -532,9 +597,12 @@ void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clan
 	SSSkepuFunctorStruct << "#define VARIANT_CUDA(block) block\n";
 	SSSkepuFunctorStruct << "static inline SKEPU_ATTRIBUTE_FORCE_INLINE " << UF.resolvedReturnTypeName << " CPU(";
 	printParamList(SSSkepuFunctorStruct, UF);
-	SSSkepuFunctorStruct << ")\n{" << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::CPU"; }) << "\n}\n";
+	SSSkepuFunctorStruct << ")\n{" << ConstantDecls << replaceReferencesToOtherUFs(UF, [InstanceName] (UserFunction &UF) { return SkePU_UF_Prefix + InstanceName + "_" + UF.uniqueName + "::CPU"; }) << "\n}\n";
 	SSSkepuFunctorStruct << "#undef SKEPU_USING_BACKEND_CPU\n};\n\n";
 	
+	for (size_t i = 0; i < UniformNames.size(); ++i)
+		UF.anyScalarParams[i].name = UniformNames[i];
+	
 	if (GlobalRewriter.InsertTextAfter(loc, SSSkepuFunctorStruct.str()))
 		SkePUAbort("Code gen target source loc not rewritable: UF " + UF.uniqueName + " for instance" + InstanceName);
 }
@@ -630,7 +698,12 @@ bool transformSkeletonInvocation(const Skeleton &skeleton, std::string InstanceN
 			loc = dyn_cast<FunctionDecl>(DeclCtx)->getSourceRange().getBegin();
 		}
 		
-		generateUserFunctionStruct(*UF, InstanceName, loc);
+		// The user function of a Map carries the instance's flat OpenMP loop
+		std::string KernelSource_OMP;
+		if (GenOMP && skeleton.type == Skeleton::Type::Map && UF == FuncArgs[0])
+			KernelSource_OMP = createMapKernelProgram_OMP(*UF, arity[0]);
+		
+		generateUserFunctionStruct(*UF, InstanceName, loc, KernelSource_OMP);
 	}
 
 
@@ -725,6 +798,15 @@ bool transformSkeletonInvocation(const Skeleton &skeleton, std::string InstanceN
 			SSTemplateArgs << ", decltype(&" << KernelName_CU << ")";
 			SSCallArgs << KernelName_CU;
 			break;
+			
+		case Skeleton::Type::SpMV:
+		case Skeleton::Type::ReduceByKey:
+		case Skeleton::Type::Histogram:
+		case Skeleton::Type::Sort:
+			// No device kernel yet, the skeleton falls back to the host backends
+			SSTemplateArgs << ", bool";
+			SSCallArgs << "false";
+			break;
 		}
 
 		// Insert the code at the proper place
@@ -734,7 +816,7 @@ bool transformSkeletonInvocation(const Skeleton &skeleton, std::string InstanceN
 		{
 			loc = dyn_cast<FunctionDecl>(DeclCtx)->getSourceRange().getBegin();
 		}
-		if (GlobalRewriter.InsertText(loc, "#include \"" + KernelName_CU + ".cu\"\n"))
+		if (!KernelName_CU.empty() && GlobalRewriter.InsertText(loc, "#include \"" + KernelName_CU + ".cu\"\n"))
 			SkePUAbort("Code gen target source loc not rewritable: instance" + InstanceName);
 	}
 	else
@@ -806,17 +888,29 @@ bool transformSkeletonInvocation(const Skeleton &skeleton, std::string InstanceN
 		case Skeleton::Type::Call:
 			KernelName_CL = createCallKernelProgram_CL(*FuncArgs[0], ResultDir);
 			break;
+			
+		case Skeleton::Type::SpMV:
+		case Skeleton::Type::ReduceByKey:
+		case Skeleton::Type::Histogram:
+		case Skeleton::Type::Sort:
+			// No device kernel yet, the skeleton falls back to the host backends
+			break;
 		}
 
-		// Insert the code at the proper place
-		SourceLocation loc = d->getSourceRange().getBegin();
-		if (const FunctionDecl *DeclCtx = dyn_cast<FunctionDecl>(d->getDeclContext()))
-			loc = DeclCtx->getSourceRange().getBegin();
+		if (KernelName_CL.empty())
+			SSTemplateArgs << ", void";
+		else
+		{
+			// Insert the code at the proper place
+			SourceLocation loc = d->getSourceRange().getBegin();
+			if (const FunctionDecl *DeclCtx = dyn_cast<FunctionDecl>(d->getDeclContext()))
+				loc = DeclCtx->getSourceRange().getBegin();
 
-		if (GlobalRewriter.InsertText(loc, "#include \"" + KernelName_CL + "_cl_source.inl\"\n"))
-			SkePUAbort("Code gen target source loc not rewritable: instance" + InstanceName);
+			if (GlobalRewriter.InsertText(loc, "#include \"" + KernelName_CL + "_cl_source.inl\"\n"))
+				SkePUAbort("Code gen target source loc not rewritable: instance" + InstanceName);
 
-		SSTemplateArgs << ", CLWrapperClass_" << KernelName_CL;
+			SSTemplateArgs << ", CLWrapperClass_" << KernelName_CL;
+		}
 	}
 	else
 	{
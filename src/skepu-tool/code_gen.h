@@ -81,7 +81,10 @@ typedef long     int64_t;
 
 )~~~";
 
-void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clang::SourceLocation loc);
+std::string getSourceAsString(clang::SourceRange range);
+uint64_t userFunctionSourceHash(UserFunction &UF);
+void generateUserFunctionStruct(UserFunction &UF, std::string InstanceName, clang::SourceLocation loc, std::string KernelSource_OMP = "",
+	std::vector<std::pair<size_t, std::string>> ConstantUniforms = {});
 
 std::string generateOpenCLVectorProxy(std::string typeName);
 std::string generateOpenCLMatrixProxy(std::string typeName);
@@ -110,6 +113,9 @@ std::string createMapOverlap3DKernelProgram_CU(UserFunction &mapOverlapFunc, std
 std::string createMapOverlap4DKernelProgram_CU(UserFunction &mapOverlapFunc, std::string dir);
 std::string createCallKernelProgram_CU(UserFunction &callFunc, std::string dir);
 
+// OpenMP generators
+std::string createMapKernelProgram_OMP(UserFunction &mapFunc, size_t arity);
+
 // OpenCL helpers
 std::string generateUserFunctionCode_CL(UserFunction &Func);
 std::string generateUserTypeCode_CL(UserType &Type);
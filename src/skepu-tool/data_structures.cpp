@@ -116,6 +116,9 @@ UserConstant::UserConstant(const VarDecl *v)
 UserType::UserType(const CXXRecordDecl *t)
 : astDeclNode(t), name(t->getNameAsString()), requiresDoublePrecision(false)
 {
+	// Types of only arithmetic members get a structure-of-arrays layout for VectorSoA and MatrixSoA
+	std::stringstream SSLayoutFields;
+	bool soaLayout = t->getDeclContext()->isTranslationUnit() && GlobalRewriter.getSourceMgr().isInMainFile(t->getBeginLoc());
 
 	if (const RecordDecl *r = dyn_cast<RecordDecl>(t))
 	{
@@ -127,9 +130,19 @@ UserType::UserType(const CXXRecordDecl *t)
 
 			if (typeName == "double")
 				this->requiresDoublePrecision = true;
+
+			if (f->isBitField() || fieldName.empty() || !f->getType()->isArithmeticType())
+				soaLayout = false;
+			SSLayoutFields << (SSLayoutFields.tellp() > 0 ? ", " : "") << "SKEPU_SOA_FIELD(" << this->name << ", " << fieldName << ")";
 		}
 	}
 
+	if (soaLayout && SSLayoutFields.tellp() > 0)
+	{
+		std::string layout = "\nnamespace skepu { template<> struct soa_generated_layout<" + this->name + ">: soa_fields<" + SSLayoutFields.str() + "> {}; }\n";
+		GlobalRewriter.InsertText(t->getEndLoc().getLocWithOffset(2), layout);
+	}
+
 	static const std::string RunTimeTypeNameFunc = R"~~~(
 	namespace skepu { template<> std::string getDataTypeCL<TYPE_NAME>() { return "struct TYPE_NAME"; } }
 	)~~~";
@@ -45,7 +45,11 @@ struct Skeleton
 		MapOverlap2D,
 		MapOverlap3D,
 		MapOverlap4D,
-		Call
+		Call,
+		SpMV,
+		ReduceByKey,
+		Histogram,
+		Sort
 	};
 
 	std::string name;
@@ -0,0 +1,455 @@
+#include "globals.h"
+#include "code_gen.h"
+#include "visitor.h"
+
+using namespace clang;
+
+// ------------------------------
+// Skeleton fusion
+// ------------------------------
+
+// A Map whose result is only consumed by the next statement, by a Map, Reduce or MapReduce, is fused with it into a
+// single skeleton with a user function calling both. The rewrite is only made when it cannot change the result:
+// - both instances and the intermediate container are local to the function, and the instances are only called,
+//   so their backend selection and start values are the defaults;
+// - the intermediate container is referenced by nothing but the two calls;
+// - the user functions are not indexed and return a single value, the producer takes no random access container,
+//   which could alias the output the consumer only writes once the producer is done, and the consumer writes to none,
+//   which could alias the producer's element-wise inputs;
+// - element-wise arguments are container variables and no other argument of either call has side effects, as the
+//   fused call evaluates them all in one unspecified order.
+// Only host code is composed, device kernels are generated from a single user function.
+
+struct FusedParam
+{
+	std::string typeName;
+	std::string name;
+};
+
+// Element type of a SkePU container variable, empty for anything else
+static std::string containerElementType(const VarDecl *d)
+{
+	if (!d || d->getType()->isReferenceType())
+		return "";
+
+	auto *record = dyn_cast_or_null<ClassTemplateSpecializationDecl>(d->getType()->getAsCXXRecordDecl());
+	if (!record)
+		return "";
+
+	std::string name = record->getQualifiedNameAsString();
+	if (name != "skepu::Vector" && name != "skepu::Matrix" && name != "skepu::Tensor3" && name != "skepu::Tensor4")
+		return "";
+
+	std::string typeName = record->getTemplateArgs().get(0).getAsType().getAsString();
+	if (typeName.find("struct ") == 0)
+		typeName = typeName.substr(7);
+	return typeName;
+}
+
+static std::string removeConst(std::string typeName)
+{
+	if (typeName.compare(0, 6, "const ") == 0)
+		typeName.erase(0, 6);
+	return typeName;
+}
+
+static std::string joined(const std::vector<std::string> &list)
+{
+	std::string result;
+	for (const std::string &item : list)
+		result += (result.empty() ? "" : ", ") + item;
+	return result;
+}
+
+// The consumer is either the whole statement or the value it assigns, initializes or returns, so that nothing else
+// in the statement is evaluated between the producer and the consumer
+static bool matchConsumerStatement(const Stmt *s, SkeletonCall &call, std::string &declaredName)
+{
+	const Expr *value = nullptr;
+
+	if (auto *expr = dyn_cast<Expr>(s))
+	{
+		value = expr->IgnoreImplicit();
+		if (auto *assign = dyn_cast<BinaryOperator>(value))
+			if (assign->isAssignmentOp() && referencedVar(assign->getLHS()))
+				value = assign->getRHS();
+	}
+	else if (auto *declStmt = dyn_cast<DeclStmt>(s))
+	{
+		auto *var = declStmt->isSingleDecl() ? dyn_cast<VarDecl>(declStmt->getSingleDecl()) : nullptr;
+		if (!var || !var->getInit())
+			return false;
+
+		declaredName = var->getNameAsString();
+		value = var->getInit()->IgnoreImplicit();
+		if (auto *construct = dyn_cast<CXXConstructExpr>(value))
+			if (construct->getNumArgs() == 1)
+				value = construct->getArg(0);
+	}
+	else if (auto *ret = dyn_cast<ReturnStmt>(s))
+		value = ret->getRetValue();
+
+	return matchSkeletonCall(value, call);
+}
+
+
+// Fused instances are declared where the producer was called, which is not possible between the cases of a switch
+class CompoundCollector : public RecursiveASTVisitor<CompoundCollector>
+{
+public:
+
+	bool VisitCompoundStmt(CompoundStmt *c)
+	{
+		this->compounds.push_back(c);
+		return true;
+	}
+
+	bool VisitSwitchStmt(SwitchStmt *s)
+	{
+		this->switchBodies.insert(s->getBody());
+		return true;
+	}
+
+	std::vector<CompoundStmt*> compounds;
+	std::set<const Stmt*> switchBodies;
+};
+
+
+class SkePUFusionVisitor : public RecursiveASTVisitor<SkePUFusionVisitor>
+{
+public:
+
+	SkePUFusionVisitor(ASTContext &ctx): Context(ctx) {}
+
+	bool VisitFunctionDecl(FunctionDecl *f)
+	{
+		if (!f->doesThisDeclarationHaveABody() || f->isDependentContext()
+			|| !this->Context.getSourceManager().isInMainFile(f->getBeginLoc()))
+			return true;
+
+		this->Function = f;
+		this->References = ReferenceCounter();
+		this->References.TraverseStmt(f->getBody());
+
+		CompoundCollector collector;
+		collector.TraverseStmt(f->getBody());
+
+		for (CompoundStmt *compound : collector.compounds)
+		{
+			if (collector.switchBodies.count(compound))
+				continue;
+
+			std::vector<Stmt*> body(compound->body_begin(), compound->body_end());
+			for (size_t i = 0; i + 1 < body.size(); ++i)
+				if (this->tryFuse(body[i], body[i + 1]))
+					++i;
+		}
+		return true;
+	}
+
+private:
+
+	ASTContext &Context;
+	FunctionDecl *Function = nullptr;
+	ReferenceCounter References;
+	size_t FusedCount = 0;
+
+	bool isLocal(const VarDecl *var) const
+	{
+		return var->isLocalVarDecl() && !isa<ParmVarDecl>(var) && var->getParentFunctionOrMethod() == this->Function;
+	}
+
+	bool onlyCalled(const VarDecl *instance) const
+	{
+		return this->isLocal(instance) && this->References.referencesTo(instance) == this->References.callsTo(instance);
+	}
+
+	bool reject(const std::string &producer, const std::string &consumer, const std::string &reason) const
+	{
+		SkePULog() << "Not fusing " << producer << " and " << consumer << ": " << reason << "\n";
+		return false;
+	}
+
+	bool tryFuse(Stmt *first, Stmt *second)
+	{
+		SkeletonCall producer, consumer;
+		std::string declaredName;
+		if (!matchSkeletonCall(dyn_cast<Expr>(first), producer) || producer.parsed->skeleton->type != Skeleton::Type::Map)
+			return false;
+		if (!matchConsumerStatement(second, consumer, declaredName))
+			return false;
+
+		const Skeleton::Type consumerType = consumer.parsed->skeleton->type;
+		if (consumerType != Skeleton::Type::Map && consumerType != Skeleton::Type::Reduce1D && consumerType != Skeleton::Type::MapReduce)
+			return false;
+
+		// A consumer Map is the whole statement, its result is the output container
+		if (consumerType == Skeleton::Type::Map && (!isa<Expr>(second) || dyn_cast<Expr>(second)->IgnoreImplicit() != consumer.expr))
+			return false;
+
+		std::string producerName = producer.instance->getNameAsString(), consumerName = consumer.instance->getNameAsString();
+		if (producer.instance == consumer.instance || !this->onlyCalled(producer.instance) || !this->onlyCalled(consumer.instance))
+			return this->reject(producerName, consumerName, "the instances are not local or are used other than called");
+
+		UserFunction &producerUF = *producer.parsed->userFunctions[0];
+		size_t producerArity = producer.parsed->arity[0];
+		if (producerUF.indexed1D || producerUF.indexed2D || producerUF.indexed3D || producerUF.indexed4D
+			|| !producerUF.multipleReturnTypes.empty() || !producerUF.anyContainerParams.empty() || producerArity == 0
+			|| producer.args.size() != 1 + producerArity + producerUF.anyScalarParams.size())
+			return this->reject(producerName, consumerName, "unsupported producer user function or arguments");
+
+		const VarDecl *intermediate = referencedVar(producer.args[0]);
+		std::string intermediateType = containerElementType(intermediate);
+		if (intermediateType.empty() || !this->isLocal(intermediate) || this->References.referencesTo(intermediate) != 2)
+			return this->reject(producerName, consumerName, "the intermediate container is used elsewhere");
+
+		// Producer arguments are evaluated at the consumer, where a declared variable must not hide them
+		ReferenceCounter producerReferences;
+		for (const Expr *arg : producer.args)
+			producerReferences.TraverseStmt(const_cast<Expr*>(arg));
+		if (producerReferences.names.count(declaredName))
+			return this->reject(producerName, consumerName, "the consumer declares a name used by the producer");
+
+		std::vector<const VarDecl*> producerElwise;
+		std::vector<std::string> producerUniform;
+		for (size_t i = 1; i <= producerArity; ++i)
+		{
+			producerElwise.push_back(referencedVar(producer.args[i]));
+			if (containerElementType(producerElwise.back()).empty())
+				return this->reject(producerName, consumerName, "an element-wise argument is not a container variable");
+		}
+		for (size_t i = 1 + producerArity; i < producer.args.size(); ++i)
+		{
+			producerUniform.push_back(getSourceAsString(producer.args[i]->getSourceRange()));
+			if (producer.args[i]->HasSideEffects(this->Context) || producerUniform.back().empty())
+				return this->reject(producerName, consumerName, "a uniform argument has side effects");
+		}
+
+		// The consumer's mapping user function, MapReduce arguments have no output container in front
+		UserFunction *consumerUF = nullptr;
+		size_t consumerArity = 0, firstElwise = 0, position = 0;
+		if (consumerType == Skeleton::Type::Reduce1D)
+		{
+			if (consumer.args.size() != 1 || referencedVar(consumer.args[0]) != intermediate)
+				return this->reject(producerName, consumerName, "the consumer does not reduce the intermediate container");
+		}
+		else
+		{
+			consumerUF = consumer.parsed->userFunctions[0];
+			consumerArity = consumer.parsed->arity[0];
+			firstElwise = (consumerType == Skeleton::Type::Map) ? 1 : 0;
+			if (consumerUF->indexed1D || consumerUF->indexed2D || consumerUF->indexed3D || consumerUF->indexed4D
+				|| !consumerUF->multipleReturnTypes.empty()
+				|| consumer.args.size() != firstElwise + consumerArity + consumerUF->anyContainerParams.size() + consumerUF->anyScalarParams.size())
+				return this->reject(producerName, consumerName, "unsupported consumer user function or arguments");
+
+			for (UserFunction::RandomAccessParam &param : consumerUF->anyContainerParams)
+				if (param.accessMode == AccessMode::Write || param.accessMode == AccessMode::ReadWrite)
+					return this->reject(producerName, consumerName, "the consumer writes to a random access argument");
+
+			for (size_t i = firstElwise + consumerArity; i < consumer.args.size(); ++i)
+				if (consumer.args[i]->HasSideEffects(this->Context))
+					return this->reject(producerName, consumerName, "a consumer argument has side effects");
+
+			while (position < consumerArity && referencedVar(consumer.args[firstElwise + position]) != intermediate)
+				++position;
+			if (position == consumerArity)
+				return this->reject(producerName, consumerName, "the intermediate container is not an element-wise argument");
+		}
+
+		// Fused parameters and arguments, the producer's take the place of the intermediate container
+		std::vector<FusedParam> elwiseParams, containerParams, scalarParams;
+		std::vector<const VarDecl*> elwiseArgs;
+		std::vector<std::string> containerArgs, uniformArgs, producerCall, consumerCall;
+
+		auto addProducerElwise = [&]
+		{
+			for (size_t i = 0; i < producerArity; ++i)
+			{
+				std::string name = "skepu_elwise_" + std::to_string(elwiseParams.size());
+				elwiseParams.push_back({producerUF.elwiseParams[i].resolvedTypeName, name});
+				elwiseArgs.push_back(producerElwise[i]);
+				producerCall.push_back(name);
+			}
+		};
+
+		if (!consumerUF)
+			addProducerElwise();
+		else
+		{
+			for (size_t i = 0; i < consumerArity; ++i)
+			{
+				if (i == position)
+				{
+					addProducerElwise();
+					consumerCall.push_back("static_cast<" + intermediateType + ">(SKEPU_FUSED_PRODUCER)");
+					continue;
+				}
+
+				std::string name = "skepu_elwise_" + std::to_string(elwiseParams.size());
+				elwiseParams.push_back({consumerUF->elwiseParams[i].resolvedTypeName, name});
+				elwiseArgs.push_back(referencedVar(consumer.args[firstElwise + i]));
+				consumerCall.push_back(name);
+				if (containerElementType(elwiseArgs.back()).empty())
+					return this->reject(producerName, consumerName, "an element-wise argument is not a container variable");
+			}
+
+			for (size_t i = 0; i < consumerUF->anyContainerParams.size(); ++i)
+			{
+				std::string name = "skepu_container_" + std::to_string(i);
+				containerParams.push_back({consumerUF->anyContainerParams[i].fullTypeName, name});
+				containerArgs.push_back(getSourceAsString(consumer.args[firstElwise + consumerArity + i]->getSourceRange()));
+				consumerCall.push_back(name);
+			}
+		}
+
+		for (size_t i = 0; i < producerUF.anyScalarParams.size(); ++i)
+		{
+			std::string name = "skepu_uniform_" + std::to_string(scalarParams.size());
+			scalarParams.push_back({producerUF.anyScalarParams[i].resolvedTypeName, name});
+			uniformArgs.push_back(producerUniform[i]);
+			producerCall.push_back(name);
+		}
+
+		if (consumerUF)
+			for (size_t i = 0; i < consumerUF->anyScalarParams.size(); ++i)
+			{
+				const Expr *arg = consumer.args[firstElwise + consumerArity + consumerUF->anyContainerParams.size() + i];
+				std::string name = "skepu_uniform_" + std::to_string(scalarParams.size());
+				scalarParams.push_back({consumerUF->anyScalarParams[i].resolvedTypeName, name});
+				uniformArgs.push_back(getSourceAsString(arg->getSourceRange()));
+				consumerCall.push_back(name);
+			}
+
+		for (auto *list : {&containerArgs, &uniformArgs})
+			for (const std::string &arg : *list)
+				if (arg.empty())
+					return this->reject(producerName, consumerName, "argument source text is not available");
+
+		// MapReduce takes its first element-wise argument as a container of the first parameter type
+		if (consumerType != Skeleton::Type::Map && containerElementType(elwiseArgs[0]) != removeConst(elwiseParams[0].typeName))
+			return this->reject(producerName, consumerName, "the first element-wise argument does not match its parameter type");
+
+		// Generate the fused user function
+		std::string fusedName = "skepu_fused_" + std::to_string(this->FusedCount++);
+		std::string functorName = SkePU_UF_Prefix + fusedName;
+		std::string producerFunctor = SkePU_UF_Prefix + producerName + "_" + producerUF.uniqueName;
+		std::string returnType = consumerUF ? consumerUF->resolvedReturnTypeName : intermediateType;
+
+		auto body = [&] (const std::string &backend) -> std::string
+		{
+			std::string producerExpr = producerFunctor + "::" + backend + "(" + joined(producerCall) + ")";
+			if (!consumerUF)
+				return "return static_cast<" + intermediateType + ">(" + producerExpr + ");";
+
+			std::string consumerArgs = joined(consumerCall);
+			replaceTextInString(consumerArgs, "SKEPU_FUSED_PRODUCER", producerExpr);
+			return "return " + SkePU_UF_Prefix + consumerName + "_" + consumerUF->uniqueName + "::" + backend + "(" + consumerArgs + ");";
+		};
+
+		std::vector<std::string> paramList, elwiseTypes, containerTypes, uniformTypes, proxyTags;
+		for (FusedParam &param : elwiseParams)
+		{
+			paramList.push_back(param.typeName + " " + param.name);
+			elwiseTypes.push_back(param.typeName);
+		}
+		for (FusedParam &param : containerParams)
+		{
+			paramList.push_back(param.typeName + " " + param.name);
+			containerTypes.push_back(param.typeName);
+			proxyTags.push_back((param.typeName.find("MatRow") != std::string::npos) ? "skepu::ProxyTag::MatRow" : "skepu::ProxyTag::Default");
+		}
+		for (FusedParam &param : scalarParams)
+		{
+			paramList.push_back(param.typeName + " " + param.name);
+			uniformTypes.push_back(param.typeName);
+		}
+
+		std::stringstream SSAccessModes;
+		if (consumerUF)
+			for (UserFunction::RandomAccessParam &param : consumerUF->anyContainerParams)
+			{
+				SSAccessModes << "skepu::AccessMode::";
+				if (param.accessMode == AccessMode::Read)
+					SSAccessModes << "Read, ";
+				else if (param.accessMode == AccessMode::Write)
+					SSAccessModes << "Write, ";
+				else if (param.accessMode == AccessMode::ReadWrite)
+					SSAccessModes << "ReadWrite, ";
+			}
+
+		uint64_t sourceHash = userFunctionSourceHash(producerUF);
+		if (consumerUF)
+			sourceHash = (sourceHash * 0x100000001b3ull) ^ userFunctionSourceHash(*consumerUF);
+
+		std::stringstream SSFunctor;
+		SSFunctor << "\nstruct " << functorName << "\n{\n";
+		SSFunctor << "constexpr static size_t totalArity = " << paramList.size() << ";\n";
+		SSFunctor << "constexpr static size_t outArity = 1;\n";
+		SSFunctor << "constexpr static bool indexed = 0;\n";
+		SSFunctor << "using IndexType = void;\n";
+		SSFunctor << "using ElwiseArgs = std::tuple<" << joined(elwiseTypes) << ">;\n";
+		SSFunctor << "using ContainerArgs = std::tuple<" << joined(containerTypes) << ">;\n";
+		SSFunctor << "using UniformArgs = std::tuple<" << joined(uniformTypes) << ">;\n";
+		SSFunctor << "typedef std::tuple<" << joined(proxyTags) << "> ProxyTags;\n";
+		SSFunctor << "constexpr static skepu::AccessMode anyAccessMode[] = {\n" << SSAccessModes.str() << "};\n\n";
+		SSFunctor << "using Ret = " << returnType << ";\n\n";
+		SSFunctor << "constexpr static bool prefersMatrix = 0;\n\n";
+		SSFunctor << "constexpr static uint64_t sourceHash = " << sourceHash << "ull;\n\n";
+		if (GenOMP)
+			SSFunctor << "static inline SKEPU_ATTRIBUTE_FORCE_INLINE " << returnType << " OMP(" << joined(paramList) << ")\n{\n" << body("OMP") << "\n}\n";
+		SSFunctor << "static inline SKEPU_ATTRIBUTE_FORCE_INLINE " << returnType << " CPU(" << joined(paramList) << ")\n{\n" << body("CPU") << "\n}\n";
+		SSFunctor << "};\n\n";
+
+		// The fused instance is declared in place of the producer call and the consumer call is redirected to it
+		std::vector<std::string> callArgs;
+		std::stringstream SSDecl;
+		if (consumerType == Skeleton::Type::Map)
+		{
+			SSDecl << "skepu::backend::Map<" << elwiseParams.size() << ", " << functorName << ", bool, void> " << fusedName << "(false)";
+			callArgs.push_back(getSourceAsString(consumer.args[0]->getSourceRange()));
+			for (const VarDecl *arg : elwiseArgs)
+				callArgs.push_back(arg->getNameAsString());
+		}
+		else
+		{
+			std::string reduceFunctor = SkePU_UF_Prefix + consumerName + "_" + consumer.parsed->userFunctions.back()->uniqueName;
+			SSDecl << "skepu::backend::MapReduce<" << elwiseParams.size() << ", " << functorName << ", " << reduceFunctor
+				<< ", bool, bool, void> " << fusedName << "(false, false)";
+
+			// Reduce as many elements as the consumer's first element-wise argument held, which is the intermediate
+			// container only when that is where it was passed
+			std::string firstArg = elwiseArgs[0]->getNameAsString();
+			callArgs.push_back(firstArg + ".begin()");
+			callArgs.push_back(firstArg + ".begin() + " + referencedVar(consumer.args[0])->getNameAsString() + ".size()");
+			for (size_t i = 1; i < elwiseArgs.size(); ++i)
+				callArgs.push_back(elwiseArgs[i]->getNameAsString());
+		}
+		callArgs.insert(callArgs.end(), containerArgs.begin(), containerArgs.end());
+		callArgs.insert(callArgs.end(), uniformArgs.begin(), uniformArgs.end());
+
+		SourceLocation loc = this->Function->getSourceRange().getBegin();
+		RewrittenSkeletonCalls.insert(producer.expr);
+		RewrittenSkeletonCalls.insert(consumer.expr);
+		if (GlobalRewriter.InsertTextAfter(loc, SSFunctor.str())
+			|| GlobalRewriter.ReplaceText(producer.expr->getSourceRange(), SSDecl.str())
+			|| GlobalRewriter.ReplaceText(consumer.expr->getSourceRange(), fusedName + "(" + joined(callArgs) + ")"))
+			SkePUAbort("Code gen target source loc not rewritable: fusion of " + producerName + " and " + consumerName);
+
+		SkePULog() << "Fused instances " << producerName << " and " << consumerName << " into " << fusedName << "\n";
+		return true;
+	}
+};
+
+
+void FuseSkeletonInvocations(ASTContext &ctx)
+{
+	if (GenCUDA || GenCL)
+	{
+		SkePULog() << "Skeleton fusion is only done for host backends, skipping\n";
+		return;
+	}
+
+	SkePUFusionVisitor visitor(ctx);
+	visitor.TraverseDecl(ctx.getTranslationUnitDecl());
+}
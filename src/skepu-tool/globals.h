@@ -29,9 +29,13 @@
 extern llvm::cl::opt<bool> GenCUDA;
 extern llvm::cl::opt<bool> GenOMP;
 extern llvm::cl::opt<bool> GenCL;
+extern llvm::cl::opt<bool> GenTaskPool;
+extern llvm::cl::opt<bool> GenFusion;
+extern llvm::cl::opt<bool> GenSpecialization;
 
 extern llvm::cl::opt<std::string> ResultName;
 extern llvm::cl::opt<std::string> ResultDir;
+extern llvm::cl::opt<std::string> AllowedFuncNames;
 
 extern llvm::cl::opt<bool> Verbose;
 
@@ -57,5 +61,11 @@ const std::string SkePU_UF_Prefix {"skepu_userfunction_"};
 [[noreturn]] void SkePUAbort(std::string msg);
 llvm::raw_ostream& SkePULog();
 
+// Incremental precompilation
+bool writeFileIfChanged(const std::string &path, const std::string &contents);
+std::string optionsHash(const std::vector<std::string> &commandLine);
+bool isUpToDate(const std::string &cacheFile, const std::string &options);
+void saveCache(const std::string &cacheFile, const std::string &options, clang::SourceManager &SM);
+
 void replaceTextInString(std::string& text, const std::string &find, const std::string &replace);
 std::string transformToCXXIdentifier(std::string &in);
@@ -280,8 +280,7 @@ std::string createMapKernelProgram_CL(UserFunction &mapFunc, size_t arity, std::
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIES", SSProxyInitializer.str());
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIE_INNER", SSProxyInitializerInner.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
@@ -112,7 +112,6 @@ std::string createMapKernelProgram_CU(UserFunction &mapFunc, size_t arity, std::
 	replaceTextInString(kernelSource, PH_IndexInitializer, indexInitializer);
 	replaceTextInString(kernelSource, "SKEPU_OUTPUT_BINDINGS", SSOutputBindings.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
@@ -0,0 +1,211 @@
+#include "code_gen.h"
+
+using namespace clang;
+
+// ------------------------------
+// Kernel templates
+// ------------------------------
+
+// Element-wise and 1D-indexed maps are a single parallel loop. The loop is only vectorized when the user function
+// writes to no proxy parameter, as iterations are otherwise not independent
+const char *MapKernelTemplate_OMP = R"~~~(
+static void SKEPU_KERNEL_NAME(SKEPU_KERNEL_PARAMS size_t skepu_w2, size_t skepu_w3, size_t skepu_w4, size_t skepu_n, size_t skepu_base)
+{
+#pragma omp parallel for SKEPU_SIMD schedule(runtime)
+	for (size_t skepu_i = 0; skepu_i < skepu_n; ++skepu_i)
+	{
+		SKEPU_INDEX_INITIALIZER
+		auto skepu_res = SKEPU_FUNCTION_NAME_MAP(SKEPU_MAP_PARAMS);
+		SKEPU_OUTPUT_BINDINGS
+	}
+}
+)~~~";
+
+// Maps indexed in 2-4 dimensions run in parallel over rows of the innermost dimension, so that the index is
+// computed once per row and only the innermost coordinate varies in the inner loop, which is the vectorized one
+const char *MapKernelTemplate_OMP_Rows = R"~~~(
+static void SKEPU_KERNEL_NAME(SKEPU_KERNEL_PARAMS size_t skepu_w2, size_t skepu_w3, size_t skepu_w4, size_t skepu_n, size_t skepu_base)
+{
+	const size_t skepu_width = SKEPU_ROW_WIDTH;
+	const size_t skepu_end = skepu_base + skepu_n;
+	const size_t skepu_first_row = skepu_base / skepu_width;
+	const size_t skepu_last_row = (skepu_end + skepu_width - 1) / skepu_width;
+
+#pragma omp parallel for schedule(runtime)
+	for (size_t skepu_row = skepu_first_row; skepu_row < skepu_last_row; ++skepu_row)
+	{
+		const size_t skepu_row_start = skepu_row * skepu_width;
+		const size_t skepu_col_begin = (skepu_row_start < skepu_base) ? skepu_base - skepu_row_start : 0;
+		const size_t skepu_col_end = (skepu_row_start + skepu_width > skepu_end) ? skepu_end - skepu_row_start : skepu_width;
+		SKEPU_ROW_INDEX
+
+SKEPU_INNER_SIMD
+		for (size_t skepu_col = skepu_col_begin; skepu_col < skepu_col_end; ++skepu_col)
+		{
+			const size_t skepu_i = skepu_row_start + skepu_col - skepu_base;
+			SKEPU_INDEX_INITIALIZER
+			auto skepu_res = SKEPU_FUNCTION_NAME_MAP(SKEPU_MAP_PARAMS);
+			SKEPU_OUTPUT_BINDINGS
+		}
+	}
+}
+)~~~";
+
+// An in-place map passes the same container as output and input, so the restrict-qualified loop is only entered
+// when no output overlaps an element-wise input. Otherwise the unqualified loop runs
+const char *MapKernelDispatchTemplate_OMP = R"~~~(
+static void OMPMapKernel(SKEPU_KERNEL_PARAMS size_t skepu_w2, size_t skepu_w3, size_t skepu_w4, size_t skepu_n, size_t skepu_base)
+{
+	if (SKEPU_DISJOINT_CHECK)
+		OMPMapKernelRestrict(SKEPU_KERNEL_ARGS skepu_w2, skepu_w3, skepu_w4, skepu_n, skepu_base);
+	else
+		OMPMapKernelAliased(SKEPU_KERNEL_ARGS skepu_w2, skepu_w3, skepu_w4, skepu_n, skepu_base);
+}
+)~~~";
+
+
+static std::string removeConst(std::string typeName)
+{
+	if (typeName.compare(0, 6, "const ") == 0)
+		typeName.erase(0, 6);
+	return typeName;
+}
+
+/*!
+ *  Generates a static member of the user function struct which runs a whole OpenMP Map over raw pointers. Returns an
+ *  empty string when the instance has to use the generic loop, which is when a container argument is a matrix row
+ *  proxy depending on the index of each element.
+ */
+std::string createMapKernelProgram_OMP(UserFunction &mapFunc, size_t arity)
+{
+	std::stringstream SSKernelParamList, SSKernelArgs, SSMapFuncParams, SSOutputBindings, SSDisjointCheck;
+	std::string kernelSource = MapKernelTemplate_OMP, rowWidth, rowIndex, indexInitializer;
+	std::vector<std::string> outputNames;
+	bool first = true;
+	bool writesProxy = false;
+
+	for (UserFunction::RandomAccessParam& param : mapFunc.anyContainerParams)
+	{
+		if (param.fullTypeName.find("MatRow") != std::string::npos)
+			return "";
+		if (param.accessMode == AccessMode::Write || param.accessMode == AccessMode::ReadWrite)
+			writesProxy = true;
+	}
+
+	// A proxy may refer to the output container, which restrict would not allow
+	const bool restrictPointers = mapFunc.anyContainerParams.empty();
+
+	if (mapFunc.indexed1D || mapFunc.indexed2D || mapFunc.indexed3D || mapFunc.indexed4D)
+	{
+		SSMapFuncParams << "skepu_index";
+		first = false;
+	}
+
+	if (mapFunc.indexed1D)
+		indexInitializer = "skepu::Index1D skepu_index;\nskepu_index.i = skepu_base + skepu_i;";
+	else if (mapFunc.indexed2D)
+	{
+		kernelSource = MapKernelTemplate_OMP_Rows;
+		rowWidth = "skepu_w2";
+		indexInitializer = "skepu::Index2D skepu_index;\nskepu_index.row = skepu_row;\nskepu_index.col = skepu_col;";
+	}
+	else if (mapFunc.indexed3D)
+	{
+		kernelSource = MapKernelTemplate_OMP_Rows;
+		rowWidth = "skepu_w3";
+		rowIndex = "const size_t skepu_index_i = skepu_row / skepu_w2, skepu_index_j = skepu_row % skepu_w2;";
+		indexInitializer = "skepu::Index3D skepu_index;\nskepu_index.i = skepu_index_i;\nskepu_index.j = skepu_index_j;\nskepu_index.k = skepu_col;";
+	}
+	else if (mapFunc.indexed4D)
+	{
+		kernelSource = MapKernelTemplate_OMP_Rows;
+		rowWidth = "skepu_w4";
+		rowIndex = "const size_t skepu_index_i = skepu_row / (skepu_w2 * skepu_w3), skepu_index_j = skepu_row / skepu_w3 % skepu_w2, skepu_index_k = skepu_row % skepu_w3;";
+		indexInitializer = "skepu::Index4D skepu_index;\nskepu_index.i = skepu_index_i;\nskepu_index.j = skepu_index_j;\nskepu_index.k = skepu_index_k;\nskepu_index.l = skepu_col;";
+	}
+
+	// Output data
+	if (mapFunc.multipleReturnTypes.size() == 0)
+	{
+		SSKernelParamList << mapFunc.resolvedReturnTypeName << " *SKEPU_RESTRICT skepu_output, ";
+		outputNames.push_back("skepu_output");
+		SSOutputBindings << "skepu_output[skepu_i] = skepu_res;";
+	}
+	else
+	{
+		size_t outCtr = 0;
+		for (std::string& outputType : mapFunc.multipleReturnTypes)
+		{
+			SSKernelParamList << outputType << " *SKEPU_RESTRICT skepu_output_" << outCtr << ", ";
+			outputNames.push_back("skepu_output_" + std::to_string(outCtr));
+			SSOutputBindings << "skepu_output_" << outCtr << "[skepu_i] = std::get<" << outCtr << ">(skepu_res);\n";
+			outCtr++;
+		}
+	}
+
+	for (UserFunction::Param& param : mapFunc.elwiseParams)
+	{
+		if (!first) { SSMapFuncParams << ", "; }
+		SSKernelParamList << "const " << removeConst(param.resolvedTypeName) << " *SKEPU_RESTRICT " << param.name << ", ";
+		for (std::string &output : outputNames)
+			SSDisjointCheck << (SSDisjointCheck.tellp() > 0 ? " && " : "")
+				<< "skepu::backend::disjoint_ranges(" << output << ", " << param.name << ", skepu_n)";
+		SSMapFuncParams << param.name << "[skepu_i]";
+		first = false;
+	}
+
+	for (UserFunction::RandomAccessParam& param : mapFunc.anyContainerParams)
+	{
+		if (!first) { SSMapFuncParams << ", "; }
+		SSKernelParamList << param.fullTypeName << " " << param.name << ", ";
+		SSMapFuncParams << param.name;
+		first = false;
+	}
+
+	for (UserFunction::Param& param : mapFunc.anyScalarParams)
+	{
+		if (!first) { SSMapFuncParams << ", "; }
+		SSKernelParamList << param.resolvedTypeName << " " << param.name << ", ";
+		SSMapFuncParams << param.name;
+		first = false;
+	}
+
+	replaceTextInString(kernelSource, PH_MapFuncName, "OMP");
+	replaceTextInString(kernelSource, PH_MapParams, SSMapFuncParams.str());
+	replaceTextInString(kernelSource, PH_IndexInitializer, indexInitializer);
+	replaceTextInString(kernelSource, "SKEPU_ROW_WIDTH", rowWidth);
+	replaceTextInString(kernelSource, "SKEPU_ROW_INDEX", rowIndex);
+	replaceTextInString(kernelSource, "SKEPU_OUTPUT_BINDINGS", SSOutputBindings.str());
+	replaceTextInString(kernelSource, "SKEPU_INNER_SIMD", writesProxy ? "" : "#pragma omp simd");
+	replaceTextInString(kernelSource, "SKEPU_SIMD", writesProxy ? "" : "simd");
+
+	const std::string kernelParams = SSKernelParamList.str();
+	if (!restrictPointers)
+	{
+		std::string kernel = kernelSource;
+		replaceTextInString(kernel, PH_KernelName, "OMPMapKernel");
+		replaceTextInString(kernel, PH_KernelParams, kernelParams);
+		replaceTextInString(kernel, "SKEPU_RESTRICT ", "");
+		return kernel;
+	}
+
+	for (std::string &output : outputNames)
+		SSKernelArgs << output << ", ";
+	for (UserFunction::Param& param : mapFunc.elwiseParams)
+		SSKernelArgs << param.name << ", ";
+	for (UserFunction::Param& param : mapFunc.anyScalarParams)
+		SSKernelArgs << param.name << ", ";
+
+	std::string restrictKernel = kernelSource, aliasedKernel = kernelSource, dispatch = MapKernelDispatchTemplate_OMP;
+	replaceTextInString(restrictKernel, PH_KernelName, "OMPMapKernelRestrict");
+	replaceTextInString(restrictKernel, PH_KernelParams, kernelParams);
+	replaceTextInString(restrictKernel, "SKEPU_RESTRICT ", "__restrict ");
+	replaceTextInString(aliasedKernel, PH_KernelName, "OMPMapKernelAliased");
+	replaceTextInString(aliasedKernel, PH_KernelParams, kernelParams);
+	replaceTextInString(aliasedKernel, "SKEPU_RESTRICT ", "");
+	replaceTextInString(dispatch, PH_KernelParams, kernelParams);
+	replaceTextInString(dispatch, "SKEPU_RESTRICT ", "");
+	replaceTextInString(dispatch, "SKEPU_KERNEL_ARGS ", SSKernelArgs.str());
+	replaceTextInString(dispatch, "SKEPU_DISJOINT_CHECK", SSDisjointCheck.tellp() > 0 ? SSDisjointCheck.str() : "true");
+	return restrictKernel + aliasedKernel + dispatch;
+}
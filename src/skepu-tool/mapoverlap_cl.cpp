@@ -633,8 +633,7 @@ std::string createMapOverlap1DKernelProgram_CL(UserFunction &mapOverlapFunc, std
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIES", SSProxyInitializer.str());
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIE_INNER", SSProxyInitializerInner.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
@@ -868,8 +867,7 @@ std::string createMapOverlap2DKernelProgram_CL(UserFunction &mapOverlapFunc, std
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIES", SSProxyInitializer.str());
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIE_INNER", SSProxyInitializerInner.str());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
@@ -570,8 +570,7 @@ std::string createMapOverlapKernelProgramHelper_CU(UserFunction &mapOverlapFunc,
 	replaceTextInString(kernelSource, PH_KernelParams, SSKernelParamList.str());
 	replaceTextInString(kernelSource, PH_MapOverlapArgs, SSMapOverlapFuncArgs.str());
 	
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
 
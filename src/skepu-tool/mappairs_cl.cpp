@@ -260,8 +260,7 @@ std::string createMapPairsKernelProgram_CL(UserFunction &mapPairsFunc, std::stri
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIES", SSProxyInitializer.str());
 	replaceTextInString(finalSource, "SKEPU_CONTAINER_PROXIE_INNER", SSProxyInitializerInner.str());
 	
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 	
 	return kernelName;
 }
\ No newline at end of file
@@ -91,7 +91,6 @@ std::string createMapPairsKernelProgram_CU(UserFunction &mapPairsFunc, std::stri
 	replaceTextInString(kernelSource, PH_MapPairsParams, SSMapPairsFuncParams.str());
 	replaceTextInString(kernelSource, PH_IndexInitializer, indexInitializer);
 	
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
\ No newline at end of file
@@ -427,8 +427,7 @@ std::string createMapReduceKernelProgram_CL(UserFunction &mapFunc, UserFunction
 	replaceTextInString(finalSource, "SKEPU_SIZES_TUPLE_PARAM", indexInfo.sizesTupleParam);
 	replaceTextInString(finalSource, "TEMPLATE_HEADER", indexInfo.templateHeader);
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
@@ -203,7 +203,6 @@ std::string createMapReduceKernelProgram_CU(UserFunction &mapFunc, UserFunction
 
 	std::string totalSource = kernelSource + reduceKernelSource;
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << totalSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", totalSource);
 	return kernelName;
 }
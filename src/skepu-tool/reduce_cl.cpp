@@ -126,8 +126,7 @@ std::string createReduce1DKernelProgram_CL(UserFunction &reduceFunc, std::string
 	replaceTextInString(finalSource, PH_ReduceFuncName, reduceFunc.uniqueName);
 	replaceTextInString(finalSource, "SKEPU_KERNEL_CLASS", className);
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
@@ -262,7 +261,6 @@ std::string createReduce2DKernelProgram_CL(UserFunction &rowWiseFunc, UserFuncti
 	replaceTextInString(finalSource, PH_KernelName, kernelName);
 	replaceTextInString(finalSource, "SKEPU_KERNEL_CLASS", className);
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 	return kernelName;
 }
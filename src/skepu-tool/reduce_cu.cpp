@@ -86,8 +86,7 @@ std::string createReduce1DKernelProgram_CU(UserFunction &reduceFunc, std::string
 	replaceTextInString(kernelSource, PH_KernelName, kernelName);
 	replaceTextInString(kernelSource, PH_ReduceFuncName, reduceFunc.funcNameCUDA());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
 
@@ -106,7 +105,6 @@ std::string createReduce2DKernelProgram_CU(UserFunction &rowWiseFunc, UserFuncti
 	replaceTextInString(colKernelSource, PH_KernelName, kernelName + "_ColWise");
 	replaceTextInString(colKernelSource, PH_ReduceFuncName, colWiseFunc.funcNameCUDA());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << rowKernelSource << colKernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", rowKernelSource + colKernelSource);
 	return kernelName;
 }
@@ -260,8 +260,7 @@ std::string createScanKernelProgram_CL(UserFunction &scanFunc, std::string dir)
 	replaceTextInString(finalSource, PH_KernelName, kernelName);
 	replaceTextInString(finalSource, "SKEPU_KERNEL_CLASS", className);
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + "_cl_source.inl"};
-	FSOutFile << finalSource;
+	writeFileIfChanged(dir + "/" + kernelName + "_cl_source.inl", finalSource);
 
 	return kernelName;
 }
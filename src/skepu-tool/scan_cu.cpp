@@ -147,7 +147,6 @@ std::string createScanKernelProgram_CU(UserFunction &scanFunc, std::string dir)
 	replaceTextInString(kernelSource, PH_KernelName, kernelName);
 	replaceTextInString(kernelSource, PH_ScanFuncName, scanFunc.funcNameCUDA());
 
-	std::ofstream FSOutFile {dir + "/" + kernelName + ".cu"};
-	FSOutFile << kernelSource;
+	writeFileIfChanged(dir + "/" + kernelName + ".cu", kernelSource);
 	return kernelName;
 }
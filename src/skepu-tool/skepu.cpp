@@ -1,3 +1,8 @@
+#include <deque>
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Program.h"
+
 #include "globals.h"
 #include "visitor.h"
 
@@ -12,10 +17,15 @@ llvm::cl::OptionCategory SkepuPrecompilerCategory("SkePU source-to-source compil
 llvm::cl::opt<bool> GenCUDA("cuda",  llvm::cl::desc("Generate CUDA backend"),   llvm::cl::cat(SkepuPrecompilerCategory));
 llvm::cl::opt<bool> GenOMP("openmp", llvm::cl::desc("Generate OpenMP backend"), llvm::cl::cat(SkepuPrecompilerCategory));
 llvm::cl::opt<bool> GenCL("opencl",  llvm::cl::desc("Generate OpenCL backend"), llvm::cl::cat(SkepuPrecompilerCategory));
+llvm::cl::opt<bool> GenTaskPool("taskpool",  llvm::cl::desc("Enable work-stealing TaskPool backend"), llvm::cl::cat(SkepuPrecompilerCategory));
+llvm::cl::opt<bool> GenSpecialization("specialize",  llvm::cl::desc("Generate instance variants for calls with uniform arguments known at compile time (host backends only)"), llvm::cl::cat(SkepuPrecompilerCategory));
+llvm::cl::opt<bool> GenFusion("fuse",  llvm::cl::desc("Fuse a Map with a consuming Map, Reduce or MapReduce in the next statement (host backends only)"), llvm::cl::cat(SkepuPrecompilerCategory));
 
 llvm::cl::opt<bool> Verbose("verbose",  llvm::cl::desc("Verbose logging printout"), llvm::cl::cat(SkepuPrecompilerCategory));
 llvm::cl::opt<bool> Silent("silent",  llvm::cl::desc("Disable normal printouts"), llvm::cl::cat(SkepuPrecompilerCategory));
 llvm::cl::opt<bool> NoAddExtension("override-extension",  llvm::cl::desc("Do not automatically add file extension to output file (good for headers)"), llvm::cl::cat(SkepuPrecompilerCategory));
+llvm::cl::opt<bool> NoCache("no-cache",  llvm::cl::desc("Always parse the input, even if it and the options are unchanged since the last run"), llvm::cl::cat(SkepuPrecompilerCategory));
+llvm::cl::opt<unsigned> Jobs("j",  llvm::cl::desc("Number of input files to precompile concurrently"), llvm::cl::init(1), llvm::cl::cat(SkepuPrecompilerCategory));
 
 llvm::cl::opt<std::string> AllowedFuncNames("fnames", llvm::cl::desc("Function names which are allowed to be called from user functions (separated by space, e.g. -fnames \"conj csqrt\")"), llvm::cl::cat(SkepuPrecompilerCategory));
 
@@ -25,6 +35,8 @@ llvm::cl::opt<std::string> ResultName("name", llvm::cl::desc("File name of main
 
 // Derived
 static std::string mainFileName;
+static std::string cacheFileName;
+static std::string optionsKey;
 
 
 // ------------------------------
@@ -72,6 +84,10 @@ const std::unordered_map<std::string, Skeleton> Skeletons =
 	{"MapPairsImpl",         {"MapPairs",           Skeleton::Type::MapPairs,           1, 1}},
 	{"MapPairsReduceImpl",   {"MapPairsReduce",     Skeleton::Type::MapPairsReduce,     2, 2}},
 	{"CallImpl",             {"Call",               Skeleton::Type::Call,               1, 1}},
+	{"SpMVImpl",             {"SpMV",               Skeleton::Type::SpMV,               2, 1}},
+	{"ReduceByKeyImpl",      {"ReduceByKey",        Skeleton::Type::ReduceByKey,        2, 1}},
+	{"HistogramImpl",        {"Histogram",          Skeleton::Type::Histogram,          1, 1}},
+	{"SortImpl",             {"Sort",               Skeleton::Type::Sort,               1, 1}},
 };
 
 Rewriter GlobalRewriter;
@@ -109,10 +125,17 @@ public:
 		if (GenOMP)  GlobalRewriter.InsertText(SLStart, "#define SKEPU_OPENMP\n");
 		if (GenCL)   GlobalRewriter.InsertText(SLStart, "#define SKEPU_OPENCL\n");
 		if (GenCUDA) GlobalRewriter.InsertText(SLStart, "#define SKEPU_CUDA\n");
+		if (GenTaskPool) GlobalRewriter.InsertText(SLStart, "#define SKEPU_TASKPOOL\n");
 
 		for (VarDecl *d : this->SkeletonInstances)
 			HandleSkeletonInstance(d);
 
+		if (GenFusion)
+			FuseSkeletonInvocations(getCompilerInstance().getASTContext());
+
+		if (GenSpecialization)
+			SpecializeConstantUniforms(getCompilerInstance().getASTContext());
+
 
 
 
@@ -120,11 +143,13 @@ public:
 		if (Verbose) llvm::errs() << "** EndSourceFileAction for: " << SM.getFileEntryForID(SM.getMainFileID())->getName() << "\n";
 
 		// Now emit the rewritten buffer.
-		std::error_code EC;
-		llvm::raw_fd_ostream OutFile(
-			mainFileName, EC, llvm::sys::fs::FileAccess::FA_Write);
-		GlobalRewriter.getEditBuffer(SM.getMainFileID()).write(OutFile);
-		OutFile.close();
+		std::string Output;
+		llvm::raw_string_ostream OutStream(Output);
+		GlobalRewriter.getEditBuffer(SM.getMainFileID()).write(OutStream);
+		writeFileIfChanged(mainFileName, OutStream.str());
+
+		if (!NoCache && !getCompilerInstance().getDiagnostics().hasErrorOccurred())
+			saveCache(cacheFileName, optionsKey, SM);
 	}
 
 	std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI, StringRef file) override
@@ -139,14 +164,87 @@ private:
 };
 
 
+// Used to find the path of the executable
+static int StaticSymbol;
+
+// The code generation state is global, so several input files are precompiled by one process each
+static int precompileConcurrently(int argc, const char **argv, const std::vector<std::string> &sources)
+{
+	if (ResultName != "")
+		SkePUAbort("Option -name can not be used with several input files");
+
+	std::string program = llvm::sys::fs::getMainExecutable(argv[0], &StaticSymbol);
+	std::vector<llvm::StringRef> options, compilerArgs;
+	for (int i = 1; i < argc; ++i)
+	{
+		llvm::StringRef arg = argv[i];
+		if (!compilerArgs.empty() || arg == "--")
+			compilerArgs.push_back(arg);
+		else if (std::find(sources.begin(), sources.end(), arg) == sources.end())
+			options.push_back(arg);
+	}
+
+	if (!Silent)
+		llvm::errs() << "[SKEPU] Precompiling " << sources.size() << " files, " << std::max(1u, (unsigned)Jobs) << " at a time\n";
+
+	std::deque<llvm::sys::ProcessInfo> running;
+	size_t next = 0;
+	int failures = 0;
+	while (next < sources.size() || !running.empty())
+	{
+		if (next < sources.size() && running.size() < std::max(1u, (unsigned)Jobs))
+		{
+			std::vector<llvm::StringRef> args {program};
+			args.insert(args.end(), options.begin(), options.end());
+			if (!Silent)
+				args.push_back("-silent");
+			args.push_back(sources[next]);
+			args.insert(args.end(), compilerArgs.begin(), compilerArgs.end());
+
+			std::string ErrMsg;
+			bool failed = false;
+			llvm::sys::ProcessInfo child = llvm::sys::ExecuteNoWait(program, args, llvm::None, {}, 0, &ErrMsg, &failed);
+			if (failed)
+			{
+				llvm::errs() << "[SKEPU] Could not precompile " << sources[next] << ": " << ErrMsg << "\n";
+				failures++;
+			}
+			else
+				running.push_back(child);
+			next++;
+			continue;
+		}
+
+		std::string ErrMsg;
+		llvm::sys::ProcessInfo result = llvm::sys::Wait(running.front(), 0, true, &ErrMsg);
+		if (result.ReturnCode != 0)
+			failures++;
+		running.pop_front();
+	}
+
+	return failures == 0 ? 0 : 1;
+}
+
+
 int main(int argc, const char **argv)
 {
 	tooling::CommonOptionsParser op(argc, argv, SkepuPrecompilerCategory);
-	tooling::ClangTool Tool(op.getCompilations(), op.getSourcePathList());
+	const std::vector<std::string> &sources = op.getSourcePathList();
+
+	if (sources.size() > 1)
+		return precompileConcurrently(argc, argv, sources);
+
+	tooling::ClangTool Tool(op.getCompilations(), sources);
 
 	if (ResultName == "")
-		ResultName = op.getSourcePathList()[0];
+		ResultName = sources[0];
 	mainFileName = ResultDir + "/" + ResultName + (NoAddExtension ? "" : (GenCUDA ? ".cu" : ".cpp"));
+	cacheFileName = mainFileName + ".skepu-cache";
+
+	std::vector<std::string> commandLine;
+	for (const tooling::CompileCommand &command : op.getCompilations().getCompileCommands(sources[0]))
+		commandLine.insert(commandLine.end(), command.CommandLine.begin(), command.CommandLine.end());
+	optionsKey = optionsHash(commandLine);
 
 	if (!Silent)
 	{
@@ -156,10 +254,20 @@ int main(int argc, const char **argv)
 		llvm::errs() << "   CUDA gen:\t" << (GenCUDA ? "ON" : "OFF") << "\n";
 		llvm::errs() << "   OpenCL gen:\t" << (GenCL ? "ON" : "OFF") << "\n";
 		llvm::errs() << "   OpenMP gen:\t" << (GenOMP ? "ON" : "OFF") << "\n";
+		llvm::errs() << "   TaskPool:\t" << (GenTaskPool ? "ON" : "OFF") << "\n";
+		llvm::errs() << "   Fusion:\t" << (GenFusion ? "ON" : "OFF") << "\n";
+		llvm::errs() << "   Specialize:\t" << (GenSpecialization ? "ON" : "OFF") << "\n";
 		llvm::errs() << "   Main output file: " << mainFileName << "\n";
 		llvm::errs() << "# ======================================= #\n";
 	}
 
+	if (!NoCache && isUpToDate(cacheFileName, optionsKey))
+	{
+		if (!Silent)
+			llvm::errs() << "   Up to date, nothing to do\n";
+		return 0;
+	}
+
 	std::istringstream SSNames(AllowedFuncNames);
 	std::vector<std::string> Names{std::istream_iterator<std::string>{SSNames}, std::istream_iterator<std::string>{}};
 	for (std::string &name : Names)
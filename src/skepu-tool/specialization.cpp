@@ -0,0 +1,225 @@
+#include "globals.h"
+#include "code_gen.h"
+#include "visitor.h"
+
+using namespace clang;
+
+// ------------------------------
+// Uniform argument specialization
+// ------------------------------
+
+// Calls passing uniform arguments which are constant at compile time are redirected to a variant of the instance
+// whose user function declares them as constants, so that loops bounded by them can be unrolled and vectorized.
+// Variants are shared by calls passing the same constants. As the variant is a separate skeleton object, the instance
+// must be used for nothing but calls, so that it keeps the default backend selection.
+
+// Literal of the value of a constant arithmetic expression, in the type of the expression, empty if not constant
+static std::string constantLiteral(const Expr *arg, const ASTContext &ctx)
+{
+	QualType type = arg->getType().getCanonicalType().getUnqualifiedType();
+	if (arg->isValueDependent() || arg->isTypeDependent() || type->isEnumeralType()
+		|| !(type->isIntegerType() || type->isRealFloatingType()) || arg->HasSideEffects(ctx))
+		return "";
+
+	Expr::EvalResult result;
+	if (!arg->EvaluateAsRValue(result, ctx) || result.HasSideEffects)
+		return "";
+
+	if (type->isBooleanType() && result.Val.isInt())
+		return result.Val.getInt().getBoolValue() ? "true" : "false";
+
+	if (result.Val.isInt())
+	{
+		const llvm::APSInt &value = result.Val.getInt();
+		return "static_cast<" + type.getAsString() + ">(" + value.toString(10) + (value.isUnsigned() ? "ull" : "ll") + ")";
+	}
+
+	if (result.Val.isFloat())
+	{
+		const llvm::APFloat &value = result.Val.getFloat();
+		if (!value.isFinite())
+			return "";
+
+		// Enough significant digits to read back the same value
+		llvm::SmallString<32> digits;
+		value.toString(digits, llvm::APFloat::semanticsPrecision(value.getSemantics()) * 59 / 196 + 2, 0, false);
+
+		std::string literal = digits.str().str();
+		if (literal.find_first_of(".eE") == std::string::npos)
+			literal += ".0";
+		if (type->isSpecificBuiltinType(BuiltinType::Float))
+			literal += "f";
+		else if (type->isSpecificBuiltinType(BuiltinType::LongDouble))
+			literal += "L";
+		return literal;
+	}
+
+	return "";
+}
+
+// The variant is declared right after the instance, which needs its own statement or to be at namespace scope
+static bool declaredAsStatement(const VarDecl *d, ASTContext &ctx)
+{
+	if (d->isFileVarDecl())
+		return true;
+
+	for (const auto &parent : ctx.getParents(*d))
+		if (const DeclStmt *declStmt = parent.get<DeclStmt>())
+			for (const auto &grandparent : ctx.getParents(*declStmt))
+				if (grandparent.get<CompoundStmt>())
+					return true;
+	return false;
+}
+
+
+class SkePUSpecializationVisitor : public RecursiveASTVisitor<SkePUSpecializationVisitor>
+{
+public:
+
+	SkePUSpecializationVisitor(ASTContext &ctx, ReferenceCounter &references): Context(ctx), References(references) {}
+
+	bool VisitCXXOperatorCallExpr(CXXOperatorCallExpr *c)
+	{
+		SkeletonCall call;
+		if (!this->Context.getSourceManager().isInMainFile(c->getBeginLoc()) || c->isInstantiationDependent()
+			|| !matchSkeletonCall(c, call) || RewrittenSkeletonCalls.count(call.expr))
+			return true;
+
+		UserFunction &UF = *call.parsed->userFunctions[0];
+		size_t numUniforms = UF.anyScalarParams.size();
+		if (numUniforms == 0 || call.args.size() < numUniforms)
+			return true;
+
+		std::string instanceName = call.instance->getNameAsString();
+
+		// Uniform arguments are the last ones for all skeletons
+		std::vector<std::pair<size_t, std::string>> constants;
+		std::string key = instanceName;
+		for (size_t i = 0; i < numUniforms; ++i)
+		{
+			const Expr *arg = call.args[call.args.size() - numUniforms + i];
+			const ParmVarDecl *param = UF.anyScalarParams[i].astDeclNode;
+			if (!param->getType()->isArithmeticType() || param->getType()->isReferenceType())
+				continue;
+
+			std::string literal = constantLiteral(arg, this->Context);
+			if (literal.empty())
+				continue;
+
+			constants.emplace_back(i, literal);
+			key += "|" + std::to_string(i) + "=" + literal;
+		}
+
+		if (constants.empty())
+			return true;
+
+		if (this->References.referencesTo(call.instance) != this->References.callsTo(call.instance))
+		{
+			SkePULog() << "Not specializing " << instanceName << ": the instance is used other than called\n";
+			return true;
+		}
+
+		if (!declaredAsStatement(call.instance, this->Context))
+		{
+			SkePULog() << "Not specializing " << instanceName << ": the instance is not declared by a statement of its own\n";
+			return true;
+		}
+
+		auto variant = this->Variants.find(key);
+		if (variant == this->Variants.end())
+		{
+			std::string variantName = instanceName + "_specialized_" + std::to_string(this->Variants.size());
+			if (!this->declareVariant(call, variantName, constants))
+				return true;
+			variant = this->Variants.emplace(key, variantName).first;
+		}
+
+		RewrittenSkeletonCalls.insert(call.expr);
+		if (GlobalRewriter.ReplaceText(call.expr->getArg(0)->getSourceRange(), variant->second))
+			SkePUAbort("Code gen target source loc not rewritable: call of " + instanceName);
+
+		SkePULog() << "Specialized call of " << instanceName << " as " << variant->second << "\n";
+		return true;
+	}
+
+private:
+
+	ASTContext &Context;
+	ReferenceCounter &References;
+	std::unordered_map<std::string, std::string> Variants;
+
+	// Generates the user function structs and declaration of a variant, in the same places as for the instance
+	bool declareVariant(const SkeletonCall &call, const std::string &variantName, const std::vector<std::pair<size_t, std::string>> &constants)
+	{
+		const VarDecl *d = call.instance;
+		const Skeleton &skeleton = *call.parsed->skeleton;
+		const std::vector<UserFunction*> &FuncArgs = call.parsed->userFunctions;
+		const std::vector<size_t> &arity = call.parsed->arity;
+
+		SourceLocation declEnd = Lexer::findLocationAfterToken(d->getEndLoc(), tok::semi, this->Context.getSourceManager(), this->Context.getLangOpts(), false);
+		if (declEnd.isInvalid())
+		{
+			SkePULog() << "Not specializing " << d->getNameAsString() << ": no end of declaration statement\n";
+			return false;
+		}
+
+		SourceLocation loc = d->getSourceRange().getBegin();
+		if (const FunctionDecl *DeclCtx = dyn_cast<FunctionDecl>(d->getDeclContext()))
+			loc = DeclCtx->getSourceRange().getBegin();
+
+		std::stringstream SSTemplateArgs, SSCallArgs, SSNewDecl;
+		if (skeleton.type == Skeleton::Type::Map || skeleton.type == Skeleton::Type::MapReduce)
+			SSTemplateArgs << arity[0] << ", ";
+		else if (skeleton.type == Skeleton::Type::MapPairs || skeleton.type == Skeleton::Type::MapPairsReduce)
+			SSTemplateArgs << arity[0] << ", " << arity[1] << ", ";
+
+		for (UserFunction *UF : FuncArgs)
+		{
+			std::string instanceName = UF->instanceName;
+			std::string KernelSource_OMP;
+			if (GenOMP && skeleton.type == Skeleton::Type::Map && UF == FuncArgs[0])
+				KernelSource_OMP = createMapKernelProgram_OMP(*UF, arity[0]);
+
+			generateUserFunctionStruct(*UF, variantName, loc, KernelSource_OMP,
+				(UF == FuncArgs[0]) ? constants : std::vector<std::pair<size_t, std::string>>{});
+			UF->instanceName = instanceName;
+
+			SSTemplateArgs << SkePU_UF_Prefix << variantName << "_" << UF->uniqueName << ", ";
+		}
+
+		SSTemplateArgs << "bool";
+		SSCallArgs << "false";
+		for (size_t i = 1; i < skeleton.deviceKernelAmount; ++i)
+		{
+			SSTemplateArgs << ", bool";
+			SSCallArgs << ", false";
+		}
+		SSTemplateArgs << ", void";
+
+		SSNewDecl << "\n";
+		if (d->isStaticLocal())
+			SSNewDecl << "static ";
+		SSNewDecl << "skepu::backend::" << skeleton.name << "<" << SSTemplateArgs.str() << "> " << variantName << "(" << SSCallArgs.str() << ");";
+
+		if (GlobalRewriter.InsertTextAfter(declEnd, SSNewDecl.str()))
+			SkePUAbort("Code gen target source loc not rewritable: instance" + variantName);
+
+		return true;
+	}
+};
+
+
+void SpecializeConstantUniforms(ASTContext &ctx)
+{
+	if (GenCUDA || GenCL)
+	{
+		SkePULog() << "Uniform specialization is only done for host backends, skipping\n";
+		return;
+	}
+
+	ReferenceCounter references;
+	references.TraverseDecl(ctx.getTranslationUnitDecl());
+
+	SkePUSpecializationVisitor visitor(ctx, references);
+	visitor.TraverseDecl(ctx.getTranslationUnitDecl());
+}
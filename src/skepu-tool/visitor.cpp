@@ -5,6 +5,8 @@
 using namespace clang;
 
 std::unordered_set<std::string> SkeletonInstances;
+std::unordered_map<const VarDecl*, ParsedInstance> ParsedInstances;
+std::unordered_set<const Expr*> RewrittenSkeletonCalls;
 
 [[noreturn]] void SkePUAbort(std::string msg)
 {
@@ -193,6 +195,14 @@ bool HandleSkeletonInstance(VarDecl *d)
 		arity[0] = 1; break;
 	case Skeleton::Type::MapOverlap4D:
 		arity[0] = 1; break;
+	case Skeleton::Type::SpMV:
+		arity[0] = 2; break;
+	case Skeleton::Type::ReduceByKey:
+	case Skeleton::Type::Histogram:
+		arity[0] = 1; break;
+	case Skeleton::Type::Sort:
+		// A comparator, or a key function of a single element
+		arity[0] = 2; break;
 	default:
 		break;
 	}
@@ -223,9 +233,39 @@ bool HandleSkeletonInstance(VarDecl *d)
 			UF->updateArgLists(arity[i++]);
 	}
 	
+	ParsedInstances[d] = {&Skeletons.at(TypeName), FuncArgs, arity};
 	return transformSkeletonInvocation(Skeletons.at(TypeName), InstanceName, FuncArgs, arity, d);
 }
 
+const VarDecl *referencedVar(const Expr *expr)
+{
+	if (auto *ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts()))
+		return dyn_cast<VarDecl>(ref->getDecl());
+	return nullptr;
+}
+
+bool matchSkeletonCall(const Expr *expr, SkeletonCall &call)
+{
+	if (!expr)
+		return false;
+
+	auto *opCall = dyn_cast<CXXOperatorCallExpr>(expr->IgnoreImplicit());
+	if (!opCall || opCall->getOperator() != OO_Call)
+		return false;
+
+	const VarDecl *instance = referencedVar(opCall->getArg(0));
+	if (!instance || ParsedInstances.find(instance) == ParsedInstances.end())
+		return false;
+
+	call.expr = opCall;
+	call.instance = instance;
+	call.parsed = &ParsedInstances.at(instance);
+	call.args.clear();
+	for (unsigned i = 1; i < opCall->getNumArgs(); ++i)
+		call.args.push_back(opCall->getArg(i));
+	return true;
+}
+
 // Returns nullptr if the user type can be ignored
 UserType *HandleUserType(const CXXRecordDecl *t)
 {
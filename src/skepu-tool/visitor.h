@@ -8,6 +8,74 @@
 UserFunction *HandleUserFunction(clang::FunctionDecl *f);
 UserType *HandleUserType(const clang::CXXRecordDecl *t);
 bool HandleSkeletonInstance(clang::VarDecl *d);
+void FuseSkeletonInvocations(clang::ASTContext &ctx);
+void SpecializeConstantUniforms(clang::ASTContext &ctx);
+
+// Skeleton instances handled so far, with the user functions and arities they were generated for
+struct ParsedInstance
+{
+	const Skeleton *skeleton;
+	std::vector<UserFunction*> userFunctions;
+	std::vector<size_t> arity;
+};
+
+extern std::unordered_map<const clang::VarDecl*, ParsedInstance> ParsedInstances;
+
+// Invocations already replaced by a pass over the instance calls
+extern std::unordered_set<const clang::Expr*> RewrittenSkeletonCalls;
+
+// A call of a skeleton instance, instance(args...)
+struct SkeletonCall
+{
+	const clang::CXXOperatorCallExpr *expr = nullptr;
+	const clang::VarDecl *instance = nullptr;
+	const ParsedInstance *parsed = nullptr;
+	std::vector<const clang::Expr*> args{};
+};
+
+const clang::VarDecl *referencedVar(const clang::Expr *expr);
+bool matchSkeletonCall(const clang::Expr *expr, SkeletonCall &call);
+
+// Counts the references to each variable, and how many of them call the variable
+class ReferenceCounter : public clang::RecursiveASTVisitor<ReferenceCounter>
+{
+public:
+
+	bool VisitDeclRefExpr(clang::DeclRefExpr *ref)
+	{
+		if (auto *var = clang::dyn_cast<clang::VarDecl>(ref->getDecl()))
+		{
+			this->references[var]++;
+			this->names.insert(var->getNameAsString());
+		}
+		return true;
+	}
+
+	bool VisitCXXOperatorCallExpr(clang::CXXOperatorCallExpr *c)
+	{
+		if (c->getOperator() == clang::OO_Call)
+			if (const clang::VarDecl *var = referencedVar(c->getArg(0)))
+				this->calls[var]++;
+		return true;
+	}
+
+	size_t referencesTo(const clang::VarDecl *var) const
+	{
+		auto it = this->references.find(var);
+		return (it != this->references.end()) ? it->second : 0;
+	}
+
+	size_t callsTo(const clang::VarDecl *var) const
+	{
+		auto it = this->calls.find(var);
+		return (it != this->calls.end()) ? it->second : 0;
+	}
+
+	std::set<std::string> names;
+
+private:
+	std::unordered_map<const clang::VarDecl*, size_t> references, calls;
+};
 
 
 
@@ -0,0 +1,343 @@
+/*! \file binary_io.h
+ *  \brief Contains the binary file format of the containers, with parallel and memory-mapped file access.
+ */
+
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SKEPU_POSIX_IO
+#endif
+
+#ifdef SKEPU_OPENMP
+#include <omp.h>
+#endif
+
+#include "debug.h"
+
+// Size of the file chunks read or written by one thread
+#ifndef SKEPU_IO_CHUNK_BYTES
+#define SKEPU_IO_CHUNK_BYTES (8 * 1024 * 1024)
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Header of a binary container file. The elements follow the header in the byte order of the machine that
+		 *  wrote them, \p endian tells which one it was. The header is 64 bytes, so the elements of a mapped file
+		 *  are aligned to a cache line. Unused dimensions are 1.
+		 */
+		struct BinaryHeader
+		{
+			char magic[8];
+			uint32_t endian;
+			uint32_t typeSize;
+			uint64_t rank;
+			uint64_t dims[4];
+			uint64_t checksum;
+		};
+
+		static_assert(sizeof(BinaryHeader) == 64, "Binary container header must be 64 bytes");
+
+		static constexpr char BINARY_MAGIC[8] = {'S', 'K', 'E', 'P', 'U', 'B', 'I', 'N'};
+		static constexpr uint32_t BINARY_ENDIAN = 0x01020304;
+
+		inline size_t ioThreads(size_t bytes)
+		{
+#ifdef SKEPU_OPENMP
+			if (bytes > SKEPU_IO_CHUNK_BYTES && !omp_in_parallel())
+				return std::min<size_t>(omp_get_max_threads(), (bytes + SKEPU_IO_CHUNK_BYTES - 1) / SKEPU_IO_CHUNK_BYTES);
+#else
+			(void)bytes;
+#endif
+			return 1;
+		}
+
+		// Little-endian value of up to 8 bytes, so the checksum does not depend on the byte order of the reader
+		inline uint64_t littleEndianWord(const unsigned char *p, size_t bytes)
+		{
+			uint64_t w = 0;
+			for (size_t b = 0; b < bytes; ++b)
+				w |= (uint64_t)p[b] << (8 * b);
+			return w;
+		}
+
+		/*!
+		 *  Position-dependent sum over the 64-bit words of \p data, so that reordered or corrupted data is detected
+		 *  while the sum can still be computed in parallel.
+		 */
+		inline uint64_t binaryChecksum(const void *data, size_t bytes)
+		{
+			const unsigned char *p = static_cast<const unsigned char*>(data);
+			const size_t words = bytes / sizeof(uint64_t);
+			uint64_t sum = 0;
+
+#ifdef SKEPU_OPENMP
+			const size_t threads = ioThreads(bytes);
+#pragma omp parallel for schedule(static) reduction(+:sum) num_threads(threads) if(threads > 1)
+#endif
+			for (size_t i = 0; i < words; ++i)
+				sum += (littleEndianWord(p + i * sizeof(uint64_t), sizeof(uint64_t)) ^ (i + 1)) * 0x9E3779B97F4A7C15ull;
+
+			const uint64_t tail = littleEndianWord(p + words * sizeof(uint64_t), bytes - words * sizeof(uint64_t));
+			return sum + (tail ^ (words + 1)) * 0x9E3779B97F4A7C15ull;
+		}
+
+		inline void byteSwap(void *data, size_t count, size_t typeSize)
+		{
+			unsigned char *p = static_cast<unsigned char*>(data);
+
+#ifdef SKEPU_OPENMP
+			const size_t threads = ioThreads(count * typeSize);
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+#endif
+			for (size_t i = 0; i < count; ++i)
+				std::reverse(p + i * typeSize, p + (i + 1) * typeSize);
+		}
+
+
+		/*!
+		 *  Writes \p count elements of \p typeSize bytes with the given dimensions to \p filename. Large files are
+		 *  written in chunks by several threads.
+		 */
+		inline void writeBinaryFile(const std::string &filename, const void *data, size_t count, size_t typeSize, size_t rank, const size_t *dims)
+		{
+			BinaryHeader header;
+			std::memset(&header, 0, sizeof(header));
+			std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+			header.endian = BINARY_ENDIAN;
+			header.typeSize = typeSize;
+			header.rank = rank;
+			for (size_t d = 0; d < 4; ++d)
+				header.dims[d] = (d < rank) ? dims[d] : 1;
+
+			const size_t bytes = count * typeSize;
+			header.checksum = binaryChecksum(data, bytes);
+
+#ifdef SKEPU_POSIX_IO
+			int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (fd < 0)
+				SKEPU_ERROR("Unable to open file " << filename << " for writing");
+
+			bool ok = ::pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+			const char *bytesp = static_cast<const char*>(data);
+			const size_t chunks = (bytes + SKEPU_IO_CHUNK_BYTES - 1) / SKEPU_IO_CHUNK_BYTES;
+
+#ifdef SKEPU_OPENMP
+			const size_t threads = ioThreads(bytes);
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1) reduction(&&:ok)
+#endif
+			for (size_t c = 0; c < chunks; ++c)
+			{
+				const size_t first = c * SKEPU_IO_CHUNK_BYTES;
+				size_t left = std::min<size_t>(SKEPU_IO_CHUNK_BYTES, bytes - first);
+				size_t done = 0;
+				while (left > 0)
+				{
+					ssize_t n = ::pwrite(fd, bytesp + first + done, left, sizeof(header) + first + done);
+					if (n <= 0) { ok = false; break; }
+					done += n;
+					left -= n;
+				}
+			}
+
+			if (::close(fd) != 0 || !ok)
+				SKEPU_ERROR("Writing " << filename << " failed");
+#else
+			std::ofstream file(filename.c_str(), std::ios::binary);
+			if (!file.is_open())
+				SKEPU_ERROR("Unable to open file " << filename << " for writing");
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(static_cast<const char*>(data), bytes);
+			if (!file)
+				SKEPU_ERROR("Writing " << filename << " failed");
+#endif
+		}
+
+
+		/*!
+		 *  \class BinaryFile
+		 *
+		 *  \brief A binary container file opened for reading, with its header validated.
+		 *
+		 *  The elements are either read into storage provided by the container, in chunks by several threads, or
+		 *  mapped into memory. A mapping is private, writes to the container never reach the file.
+		 */
+		class BinaryFile
+		{
+		public:
+
+			BinaryFile(const std::string &filename, size_t typeSize): m_filename(filename)
+			{
+#ifdef SKEPU_POSIX_IO
+				this->m_fd = ::open(filename.c_str(), O_RDONLY);
+				if (this->m_fd < 0 || ::pread(this->m_fd, &this->m_header, sizeof(BinaryHeader), 0) != (ssize_t)sizeof(BinaryHeader))
+					SKEPU_ERROR("Unable to read binary file " << filename);
+#else
+				this->m_file.open(filename.c_str(), std::ios::binary);
+				if (!this->m_file.read(reinterpret_cast<char*>(&this->m_header), sizeof(BinaryHeader)))
+					SKEPU_ERROR("Unable to read binary file " << filename);
+#endif
+
+				if (std::memcmp(this->m_header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+					SKEPU_ERROR(filename << " is not a SkePU binary file");
+
+				this->m_swapped = (this->m_header.endian != BINARY_ENDIAN);
+				if (this->m_swapped)
+				{
+					byteSwap(&this->m_header.endian, 1, sizeof(uint32_t));
+					byteSwap(&this->m_header.typeSize, 1, sizeof(uint32_t));
+					byteSwap(&this->m_header.rank, 1, sizeof(uint64_t));
+					byteSwap(this->m_header.dims, 4, sizeof(uint64_t));
+					if (this->m_header.endian != BINARY_ENDIAN)
+						SKEPU_ERROR(filename << " has an unknown byte order");
+				}
+
+				if (this->m_header.typeSize != typeSize)
+					SKEPU_ERROR(filename << " holds elements of " << this->m_header.typeSize << " bytes, expected " << typeSize);
+			}
+
+			~BinaryFile()
+			{
+#ifdef SKEPU_POSIX_IO
+				if (this->m_fd >= 0)
+					::close(this->m_fd);
+#endif
+			}
+
+			BinaryFile(const BinaryFile&) = delete;
+			BinaryFile &operator=(const BinaryFile&) = delete;
+
+			size_t rank() const
+			{
+				return this->m_header.rank;
+			}
+
+			size_t dim(size_t d) const
+			{
+				return this->m_header.dims[d];
+			}
+
+			size_t count() const
+			{
+				return this->m_header.dims[0] * this->m_header.dims[1] * this->m_header.dims[2] * this->m_header.dims[3];
+			}
+
+			void requireRank(size_t rank) const
+			{
+				if (this->m_header.rank != rank)
+					SKEPU_ERROR(this->m_filename << " holds a container of rank " << this->m_header.rank << ", expected " << rank);
+			}
+
+			/*!
+			 *  Reads all elements to \p data, converting the byte order if needed.
+			 */
+			void read(void *data)
+			{
+				const size_t bytes = this->count() * this->m_header.typeSize;
+				char *bytesp = static_cast<char*>(data);
+
+#ifdef SKEPU_POSIX_IO
+				const size_t chunks = (bytes + SKEPU_IO_CHUNK_BYTES - 1) / SKEPU_IO_CHUNK_BYTES;
+				const int fd = this->m_fd;
+				bool ok = true;
+
+#ifdef SKEPU_OPENMP
+				const size_t threads = ioThreads(bytes);
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1) reduction(&&:ok)
+#endif
+				for (size_t c = 0; c < chunks; ++c)
+				{
+					const size_t first = c * SKEPU_IO_CHUNK_BYTES;
+					size_t left = std::min<size_t>(SKEPU_IO_CHUNK_BYTES, bytes - first);
+					size_t done = 0;
+					while (left > 0)
+					{
+						ssize_t n = ::pread(fd, bytesp + first + done, left, sizeof(BinaryHeader) + first + done);
+						if (n <= 0) { ok = false; break; }
+						done += n;
+						left -= n;
+					}
+				}
+#else
+				bool ok = (bool)this->m_file.read(bytesp, bytes);
+#endif
+
+				if (!ok)
+					SKEPU_ERROR("Reading " << this->m_filename << " failed, the file is truncated");
+				this->verify(data, bytes);
+
+				if (this->m_swapped)
+					byteSwap(data, this->count(), this->m_header.typeSize);
+			}
+
+			/*!
+			 *  Maps the elements into memory without reading them, pages are loaded on first access. Returns the
+			 *  address of the first element and sets \p deleter to a function unmapping the file. The checksum
+			 *  is not verified, since that would read the whole file.
+			 */
+			template<typename T>
+			T *map(std::function<void(T*)> &deleter)
+			{
+				if (this->m_swapped)
+					SKEPU_ERROR(this->m_filename << " was written with a different byte order and can not be mapped");
+
+#ifdef SKEPU_POSIX_IO
+				const size_t length = sizeof(BinaryHeader) + this->count() * sizeof(T);
+				struct stat st;
+				if (::fstat(this->m_fd, &st) != 0 || (size_t)st.st_size < length)
+					SKEPU_ERROR("Mapping " << this->m_filename << " failed, the file is truncated");
+
+				void *base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->m_fd, 0);
+				if (base == MAP_FAILED)
+					SKEPU_ERROR("Mapping " << this->m_filename << " failed");
+
+				deleter = [base, length](T*) { ::munmap(base, length); };
+				return reinterpret_cast<T*>(static_cast<char*>(base) + sizeof(BinaryHeader));
+#else
+				// No memory mapping available, read into owned storage instead
+				T *data = new T[this->count()];
+				this->read(data);
+				deleter = [](T *p) { delete[] p; };
+				return data;
+#endif
+			}
+
+		private:
+			std::string m_filename;
+			BinaryHeader m_header;
+			bool m_swapped = false;
+
+#ifdef SKEPU_POSIX_IO
+			int m_fd = -1;
+#else
+			std::ifstream m_file;
+#endif
+
+			void verify(const void *data, size_t bytes) const
+			{
+				uint64_t checksum = this->m_header.checksum;
+				if (this->m_swapped)
+					byteSwap(&checksum, 1, sizeof(uint64_t));
+				if (binaryChecksum(data, bytes) != checksum)
+					SKEPU_ERROR("Checksum mismatch in " << this->m_filename);
+			}
+		};
+
+	} // namespace backend
+} // namespace skepu
+
+#endif // BINARY_IO_H
@@ -55,6 +55,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<Call>(tuner::userFunctionHash<CallFunc>());
+			}
+			
 			template<typename... CallArgs>
 			void operator()(CallArgs&&... args)
 			{
@@ -113,6 +118,7 @@ namespace skepu
 			//	assert(this->m_execPlan != NULL && this->m_execPlan->isCalibrated());
 				
 				this->selectBackend(0);
+				auto trace = this->traceCall(this, 0);
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -126,6 +132,8 @@ namespace skepu
 					this->CL(ai, ci, get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("Call");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->OMP(ai, ci, get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
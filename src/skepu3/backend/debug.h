@@ -93,6 +93,13 @@
 #define SKEPU_ATTRIBUTE_FORCE_INLINE
 #endif
 
+// Vectorization hint for inner loops, only emitted when compiling with OpenMP
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define SKEPU_PRAGMA_SIMD _Pragma("omp simd")
+#else
+#define SKEPU_PRAGMA_SIMD
+#endif
+
 #ifdef SKEPU_OPENCL
 #include <iostream>
 #ifdef __APPLE__
@@ -9,6 +9,7 @@
 
 #include "environment.h"
 #include "device_cl.h"
+#include "trace.h"
 
 namespace skepu
 {
@@ -222,6 +223,7 @@ template <typename T>
 				sizeVec = (copyLast ? m_numElements : m_effectiveNumElements) * sizeof(T);
 			else
 				sizeVec = numElements*sizeof(T);
+			TraceScope sync(TracePhase::HostToDevice, this, Backend::Type::OpenCL, sizeVec / sizeof(T), sizeVec);
 			
 #ifdef SKEPU_MEASURE_TIME_DISTRIBUTION
 #ifdef SKEPU_MEASURE_ONLY_COPY
@@ -267,6 +269,7 @@ template <typename T>
 					sizeVec = (copyLast ? m_numElements : m_effectiveNumElements) * sizeof(T);
 				else
 					sizeVec = numElements*sizeof(T);
+				TraceScope sync(TracePhase::DeviceToHost, this, Backend::Type::OpenCL, sizeVec / sizeof(T), sizeVec);
 				
 #ifdef SKEPU_MEASURE_TIME_DISTRIBUTION
 #ifdef SKEPU_MEASURE_ONLY_COPY
@@ -13,6 +13,7 @@
 
 #include "device_cu.h"
 #include "mem_pointer_base.h"
+#include "trace.h"
 
 namespace skepu
 {
@@ -651,6 +652,7 @@ namespace skepu
 				}
 
 				sizeVec = numElements*sizeof(T);
+				TraceScope sync(TracePhase::HostToDevice, this, Backend::Type::CUDA, numElements, sizeVec);
 
 				CHECK_CUDA_ERROR(cudaSetDevice(m_deviceID));
 
@@ -710,6 +712,7 @@ namespace skepu
 				}
 
 				sizeVec = numElements*sizeof(T);
+				TraceScope sync(TracePhase::DeviceToHost, this, Backend::Type::CUDA, numElements, sizeVec);
 
 				CHECK_CUDA_ERROR(cudaSetDevice(m_deviceID));
 
@@ -0,0 +1,702 @@
+/*! \file host_memory.h
+ *  \brief Contains the host allocators used by the containers and the NUMA placement policy.
+ */
+
+#ifndef HOST_MEMORY_H
+#define HOST_MEMORY_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef SKEPU_OPENMP
+#include <omp.h>
+#endif
+
+#include "debug.h"
+
+// Allocations smaller than this are placed and initialized by the calling thread only
+#ifndef SKEPU_PLACEMENT_MIN_BYTES
+#define SKEPU_PLACEMENT_MIN_BYTES (256 * 1024)
+#endif
+
+// Default alignment of container storage, one cache line
+#ifndef SKEPU_HOST_ALIGNMENT
+#define SKEPU_HOST_ALIGNMENT 64
+#endif
+
+#ifndef SKEPU_HUGE_PAGE_SIZE
+#define SKEPU_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+// Default upper limit of the memory kept by a PoolAllocator
+#ifndef SKEPU_POOL_MAX_BYTES
+#define SKEPU_POOL_MAX_BYTES ((size_t)1 << 30)
+#endif
+
+namespace skepu
+{
+	/*!
+	 *  \brief Placement of container host memory on NUMA systems.
+	 *
+	 *  FirstTouch initializes new storage in parallel with the same static partitioning as the OpenMP skeletons
+	 *  (schedule(static) over the element range, which is the default BackendSpec scheduling), so each thread
+	 *  finds its part of the container on its own node. Interleave spreads the pages round-robin over all
+	 *  nodes, Node binds them to a single node. The policy is process-wide and applies to containers allocated
+	 *  while it is set, use PlacementScope to change it temporarily.
+	 */
+	struct Placement
+	{
+		enum class Policy
+		{
+			FirstTouch, Interleave, Node
+		};
+
+		Policy policy = Policy::FirstTouch;
+		int node = 0;
+
+		// Threads doing the first touch, 0 uses the OpenMP default like a default BackendSpec does
+		size_t threads = 0;
+
+		static Placement firstTouch(size_t threads = 0)
+		{
+			Placement placement;
+			placement.threads = threads;
+			return placement;
+		}
+
+		static Placement interleave()
+		{
+			Placement placement;
+			placement.policy = Policy::Interleave;
+			return placement;
+		}
+
+		static Placement onNode(int node)
+		{
+			Placement placement;
+			placement.policy = Policy::Node;
+			placement.node = node;
+			return placement;
+		}
+	};
+
+	inline std::ostream &operator<<(std::ostream &o, Placement placement)
+	{
+		switch (placement.policy)
+		{
+		case Placement::Policy::FirstTouch: o << "first-touch"; break;
+		case Placement::Policy::Interleave: o << "interleave"; break;
+		case Placement::Policy::Node:       o << "node " << placement.node; break;
+		}
+		return o;
+	}
+
+	namespace backend
+	{
+		inline Placement &currentPlacement()
+		{
+			static Placement placement;
+			return placement;
+		}
+	}
+
+	inline void setPlacement(Placement placement)
+	{
+		backend::currentPlacement() = placement;
+	}
+
+	inline Placement getPlacement()
+	{
+		return backend::currentPlacement();
+	}
+
+	/*!
+	 *  Sets the placement policy for the lifetime of the object.
+	 */
+	class PlacementScope
+	{
+	public:
+		PlacementScope(Placement placement): m_previous{getPlacement()} { setPlacement(placement); }
+		~PlacementScope() { setPlacement(this->m_previous); }
+
+		PlacementScope(const PlacementScope&) = delete;
+		PlacementScope &operator=(const PlacementScope&) = delete;
+
+	private:
+		Placement m_previous;
+	};
+
+
+	namespace backend
+	{
+		inline size_t pageSize()
+		{
+#if defined(__unix__) || defined(__APPLE__)
+			static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+			return size;
+#else
+			return 4096;
+#endif
+		}
+
+		/*!
+		 *  Returns the ids of the online NUMA nodes, a single node 0 where the topology is not available.
+		 */
+		inline const std::vector<int> &numaNodes()
+		{
+			static const std::vector<int> nodes = []
+			{
+				std::vector<int> result;
+				std::ifstream file("/sys/devices/system/node/online");
+				std::string ranges;
+				if (file >> ranges)
+				{
+					// Format is a list of ranges, e.g. "0-1,4"
+					std::stringstream ss(ranges);
+					std::string range;
+					while (std::getline(ss, range, ','))
+					{
+						size_t dash = range.find('-');
+						int first = std::atoi(range.substr(0, dash).c_str());
+						int last = (dash == std::string::npos) ? first : std::atoi(range.substr(dash + 1).c_str());
+						for (int node = first; node <= last; ++node)
+							result.push_back(node);
+					}
+				}
+				if (result.empty())
+					result.push_back(0);
+				return result;
+			}();
+			return nodes;
+		}
+
+		/*!
+		 *  Applies an interleave or node policy to the pages in [\p data, \p data + \p bytes). With \p move set,
+		 *  pages that are already resident are migrated as well. Returns false if the policy could not be applied.
+		 */
+		inline bool bindHostMemory(void *data, size_t bytes, Placement placement, bool move = false)
+		{
+			if (placement.policy == Placement::Policy::FirstTouch || bytes == 0)
+				return true;
+
+#if defined(__linux__) && defined(SYS_mbind)
+			constexpr int MODE_BIND = 2, MODE_INTERLEAVE = 3;
+			constexpr unsigned FLAG_MOVE = 1 << 1;
+			constexpr size_t bits = 8 * sizeof(unsigned long);
+
+			const std::vector<int> &nodes = numaNodes();
+			if (placement.policy == Placement::Policy::Interleave && nodes.size() < 2)
+				return true;
+
+			if (placement.policy == Placement::Policy::Node && std::find(nodes.begin(), nodes.end(), placement.node) == nodes.end())
+			{
+				SKEPU_WARNING("Placement on NUMA node " << placement.node << " requested, node is not online");
+				return false;
+			}
+
+			std::vector<unsigned long> mask(*std::max_element(nodes.begin(), nodes.end()) / bits + 1, 0);
+			if (placement.policy == Placement::Policy::Interleave)
+				for (int node : nodes)
+					mask[node / bits] |= 1ul << (node % bits);
+			else
+				mask[placement.node / bits] |= 1ul << (placement.node % bits);
+
+			// mbind works on whole pages, only the pages fully inside the range are affected
+			const size_t page = pageSize();
+			const size_t first = ((size_t)data + page - 1) / page * page;
+			const size_t last = ((size_t)data + bytes) / page * page;
+			if (first >= last)
+				return true;
+
+			const int mode = (placement.policy == Placement::Policy::Interleave) ? MODE_INTERLEAVE : MODE_BIND;
+			if (syscall(SYS_mbind, first, last - first, mode, mask.data(), mask.size() * bits + 1, move ? FLAG_MOVE : 0) != 0)
+			{
+				DEBUG_TEXT_LEVEL1("mbind failed, keeping the default placement");
+				return false;
+			}
+			return true;
+#else
+			(void)data; (void)move;
+			return false;
+#endif
+		}
+
+
+		/*!
+		 *  Number of threads initializing \p bytes of storage under \p placement, 1 if it is done serially.
+		 */
+		inline size_t placementThreads(size_t bytes, Placement placement)
+		{
+#ifdef SKEPU_OPENMP
+			if (bytes >= SKEPU_PLACEMENT_MIN_BYTES && !omp_in_parallel())
+				return placement.threads ? placement.threads : (size_t)omp_get_max_threads();
+#else
+			(void)bytes; (void)placement;
+#endif
+			return 1;
+		}
+
+		/*!
+		 *  Writes one byte per page of fresh storage so that the pages are faulted in by the threads that will
+		 *  work on them. The pages are partitioned statically, like the element ranges of the skeletons.
+		 */
+		inline void touchHostMemory(void *data, size_t bytes, Placement placement)
+		{
+			const size_t threads = placementThreads(bytes, placement);
+			if (threads < 2)
+				return;
+
+			char *bytePtr = static_cast<char*>(data);
+			const size_t page = pageSize();
+			const size_t pages = (bytes + page - 1) / page;
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+			for (size_t i = 0; i < pages; ++i)
+				bytePtr[i * page] = 0;
+		}
+
+		/*!
+		 *  Fills \p data with \p val, in parallel with static partitioning if the storage is large.
+		 */
+		template<typename T>
+		void fillHostMemory(T *data, size_t size, const T &val)
+		{
+			const size_t threads = placementThreads(size * sizeof(T), getPlacement());
+			if (threads < 2)
+			{
+				std::fill(data, data + size, val);
+				return;
+			}
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+			for (size_t i = 0; i < size; ++i)
+				data[i] = val;
+		}
+
+		/*!
+		 *  Copies \p size elements from \p src to \p dst, in parallel with static partitioning if the storage is large.
+		 */
+		template<typename T>
+		void copyHostMemory(const T *src, size_t size, T *dst)
+		{
+			const size_t threads = placementThreads(size * sizeof(T), getPlacement());
+			if (threads < 2)
+			{
+				std::copy(src, src + size, dst);
+				return;
+			}
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+			for (size_t i = 0; i < size; ++i)
+				dst[i] = src[i];
+		}
+
+
+	} // namespace backend
+
+
+	/*!
+	 *  \class HostAllocator
+	 *
+	 *  \brief Interface of the allocators providing host storage for containers.
+	 *
+	 *  deallocate() is called with the same size that was passed to allocate(). Containers remember the
+	 *  allocator their storage came from, so an allocator has to outlive all containers allocated with it.
+	 */
+	class HostAllocator
+	{
+	public:
+		virtual ~HostAllocator() = default;
+
+		virtual void *allocate(size_t bytes) = 0;
+		virtual void deallocate(void *data, size_t bytes) = 0;
+	};
+
+
+	/*!
+	 *  \class SystemAllocator
+	 *
+	 *  \brief Allocates host storage directly from the system.
+	 *
+	 *  Storage is aligned to \p alignment bytes, 64 by default so that full-width vector loads never split a
+	 *  cache line. Large allocations are mapped fresh and placed according to the current placement policy,
+	 *  optionally backed by 2 MB huge pages: Transparent asks the kernel to use transparent huge pages for the
+	 *  mapping, Explicit maps from the reserved huge page pool (hugetlbfs) and falls back to transparent huge
+	 *  pages if none are available.
+	 */
+	class SystemAllocator: public HostAllocator
+	{
+	public:
+		enum class HugePages
+		{
+			None, Transparent, Explicit
+		};
+
+		SystemAllocator(size_t alignment = SKEPU_HOST_ALIGNMENT, HugePages hugePages = HugePages::None)
+		: m_alignment(std::max(alignment, sizeof(void*))), m_hugePages(hugePages) {}
+
+		void *allocate(size_t bytes) override
+		{
+			void *data = nullptr;
+			bytes = std::max<size_t>(bytes, 1);
+
+#if defined(SKEPU_CUDA) && defined(USE_PINNED_MEMORY)
+			if (cudaMallocHost(&data, bytes) != cudaSuccess)
+				SKEPU_ERROR("Error allocating pinned host memory\n");
+			return data;
+#else
+#ifdef __linux__
+			if (bytes >= SKEPU_PLACEMENT_MIN_BYTES)
+			{
+				data = this->map(this->mappedSize(bytes));
+				const Placement placement = getPlacement();
+				backend::bindHostMemory(data, bytes, placement);
+				backend::touchHostMemory(data, bytes, placement);
+				return data;
+			}
+#endif
+			if (posix_memalign(&data, this->m_alignment, bytes) != 0)
+				SKEPU_ERROR("Memory allocation failed\n");
+			return data;
+#endif
+		}
+
+		void deallocate(void *data, size_t bytes) override
+		{
+			if (!data)
+				return;
+
+			bytes = std::max<size_t>(bytes, 1);
+#if defined(SKEPU_CUDA) && defined(USE_PINNED_MEMORY)
+			if (cudaFreeHost(data) != cudaSuccess)
+				SKEPU_ERROR("Error de-allocating pinned host memory.\n");
+#else
+#ifdef __linux__
+			if (bytes >= SKEPU_PLACEMENT_MIN_BYTES)
+			{
+				munmap(data, this->mappedSize(bytes));
+				return;
+			}
+#endif
+			std::free(data);
+#endif
+		}
+
+	private:
+		size_t m_alignment;
+		HugePages m_hugePages;
+
+		size_t mappedSize(size_t bytes) const
+		{
+			const size_t unit = (this->m_hugePages == HugePages::None) ? std::max(backend::pageSize(), this->m_alignment) : SKEPU_HUGE_PAGE_SIZE;
+			return (bytes + unit - 1) / unit * unit;
+		}
+
+#ifdef __linux__
+		void *map(size_t size)
+		{
+			const int prot = PROT_READ | PROT_WRITE;
+			const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+			void *data;
+
+			if (this->m_hugePages == HugePages::None)
+			{
+				data = mmap(nullptr, size, prot, flags, -1, 0);
+				if (data == MAP_FAILED)
+					SKEPU_ERROR("Memory allocation failed\n");
+				return data;
+			}
+
+#ifdef MAP_HUGETLB
+			if (this->m_hugePages == HugePages::Explicit)
+			{
+				data = mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+				if (data != MAP_FAILED)
+					return data;
+
+				static bool warned = false;
+				if (!warned)
+					SKEPU_WARNING("No huge pages reserved, using transparent huge pages");
+				warned = true;
+			}
+#endif
+
+			// Over-allocate and trim, so that the mapping starts on a huge page boundary
+			char *raw = static_cast<char*>(mmap(nullptr, size + SKEPU_HUGE_PAGE_SIZE, prot, flags, -1, 0));
+			if (raw == MAP_FAILED)
+				SKEPU_ERROR("Memory allocation failed\n");
+
+			char *aligned = reinterpret_cast<char*>(((size_t)raw + SKEPU_HUGE_PAGE_SIZE - 1) / SKEPU_HUGE_PAGE_SIZE * SKEPU_HUGE_PAGE_SIZE);
+			if (aligned != raw)
+				munmap(raw, aligned - raw);
+			if (aligned + size != raw + size + SKEPU_HUGE_PAGE_SIZE)
+				munmap(aligned + size, raw + size + SKEPU_HUGE_PAGE_SIZE - (aligned + size));
+
+#ifdef MADV_HUGEPAGE
+			madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+			return aligned;
+		}
+#endif
+	};
+
+
+	/*!
+	 *  \class PoolAllocator
+	 *
+	 *  \brief Caches released buffers by size class and hands them out again instead of allocating.
+	 *
+	 *  Requests are rounded up to size classes with four classes per power of two, so a buffer is at most 25%
+	 *  larger than requested. At most \p maxCached bytes are kept, beyond that released buffers go back to the
+	 *  upstream allocator. A recycled buffer keeps the placement it was first touched with.
+	 */
+	class PoolAllocator: public HostAllocator
+	{
+	public:
+		PoolAllocator(HostAllocator &upstream, size_t maxCached = SKEPU_POOL_MAX_BYTES)
+		: m_upstream(upstream), m_maxCached(maxCached) {}
+
+		~PoolAllocator()
+		{
+			this->release();
+		}
+
+		void *allocate(size_t bytes) override
+		{
+			const size_t size = sizeClass(bytes);
+			{
+				std::lock_guard<std::mutex> lock(this->m_lock);
+				auto it = this->m_free.find(size);
+				if (it != this->m_free.end() && !it->second.empty())
+				{
+					void *data = it->second.back();
+					it->second.pop_back();
+					this->m_cached -= size;
+					return data;
+				}
+			}
+			return this->m_upstream.allocate(size);
+		}
+
+		void deallocate(void *data, size_t bytes) override
+		{
+			if (!data)
+				return;
+
+			const size_t size = sizeClass(bytes);
+			{
+				std::lock_guard<std::mutex> lock(this->m_lock);
+				if (this->m_cached + size <= this->m_maxCached)
+				{
+					this->m_free[size].push_back(data);
+					this->m_cached += size;
+					return;
+				}
+			}
+			this->m_upstream.deallocate(data, size);
+		}
+
+		/*!
+		 *  Returns all cached buffers to the upstream allocator.
+		 */
+		void release()
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			for (auto &entry : this->m_free)
+				for (void *data : entry.second)
+					this->m_upstream.deallocate(data, entry.first);
+			this->m_free.clear();
+			this->m_cached = 0;
+		}
+
+		size_t cachedBytes() const
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			return this->m_cached;
+		}
+
+		static size_t sizeClass(size_t bytes)
+		{
+			if (bytes <= 64)
+				return 64;
+
+			size_t power = 64;
+			while (power * 2 < bytes)
+				power *= 2;
+			const size_t step = power / 4;
+			return (bytes + step - 1) / step * step;
+		}
+
+	private:
+		HostAllocator &m_upstream;
+		size_t m_maxCached;
+		size_t m_cached = 0;
+		mutable std::mutex m_lock;
+		std::map<size_t, std::vector<void*>> m_free;
+	};
+
+
+	namespace backend
+	{
+		inline HostAllocator &defaultHostAllocator()
+		{
+			static SystemAllocator allocator;
+			return allocator;
+		}
+
+		inline HostAllocator *&currentHostAllocator()
+		{
+			static HostAllocator *allocator = &defaultHostAllocator();
+			return allocator;
+		}
+	}
+
+	/*!
+	 *  Sets the allocator used for the host storage of containers created from now on.
+	 */
+	inline void setHostAllocator(HostAllocator &allocator)
+	{
+		backend::currentHostAllocator() = &allocator;
+	}
+
+	inline HostAllocator &getHostAllocator()
+	{
+		return *backend::currentHostAllocator();
+	}
+
+	/*!
+	 *  Sets the host allocator for the lifetime of the object.
+	 */
+	class HostAllocatorScope
+	{
+	public:
+		HostAllocatorScope(HostAllocator &allocator): m_previous{getHostAllocator()} { setHostAllocator(allocator); }
+		~HostAllocatorScope() { setHostAllocator(this->m_previous); }
+
+		HostAllocatorScope(const HostAllocatorScope&) = delete;
+		HostAllocatorScope &operator=(const HostAllocatorScope&) = delete;
+
+	private:
+		HostAllocator &m_previous;
+	};
+
+
+	namespace backend
+	{
+		/*!
+		 *  Allocates and default-initializes an array of \p size elements with \p allocator.
+		 */
+		template<typename T>
+		T *allocateHostArray(HostAllocator &allocator, size_t size)
+		{
+			T *data = static_cast<T*>(allocator.allocate(size * sizeof(T)));
+			if (!std::is_trivially_default_constructible<T>::value)
+				for (size_t i = 0; i < size; ++i)
+					::new(static_cast<void*>(data + i)) T;
+			return data;
+		}
+
+		template<typename T>
+		void deallocateHostArray(HostAllocator &allocator, T *data, size_t size)
+		{
+			if (!data)
+				return;
+			if (!std::is_trivially_destructible<T>::value)
+				for (size_t i = 0; i < size; ++i)
+					data[i].~T();
+			allocator.deallocate(data, size * sizeof(T));
+		}
+
+
+		/*!
+		 *  \class host_allocator
+		 *
+		 *  \brief Allocator for \p std::vector based container storage, forwarding to a HostAllocator.
+		 *
+		 *  It binds to the host allocator that is current when it is created. Elements constructed without
+		 *  arguments are default-initialized rather than value-initialized, so that a vector of trivial elements
+		 *  is not written serially on creation. Containers initialize the elements themselves with fillHostMemory.
+		 */
+		template<typename T>
+		class host_allocator
+		{
+		public:
+			typedef T value_type;
+			typedef std::true_type propagate_on_container_copy_assignment;
+			typedef std::true_type propagate_on_container_move_assignment;
+			typedef std::true_type propagate_on_container_swap;
+
+			template<typename U>
+			struct rebind
+			{
+				typedef host_allocator<U> other;
+			};
+
+			host_allocator(): m_allocator(&getHostAllocator()) {}
+
+			template<typename U>
+			host_allocator(const host_allocator<U> &other): m_allocator(other.m_allocator) {}
+
+			T *allocate(size_t n)
+			{
+				return static_cast<T*>(this->m_allocator->allocate(n * sizeof(T)));
+			}
+
+			void deallocate(T *p, size_t n)
+			{
+				this->m_allocator->deallocate(p, n * sizeof(T));
+			}
+
+			template<typename U>
+			void construct(U *p)
+			{
+				::new(static_cast<void*>(p)) U;
+			}
+
+			template<typename U, typename... Args>
+			void construct(U *p, Args&&... args)
+			{
+				::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+			}
+
+			HostAllocator *m_allocator;
+		};
+
+		template<typename T, typename U>
+		inline bool operator==(const host_allocator<T> &a, const host_allocator<U> &b)
+		{
+			return a.m_allocator == b.m_allocator;
+		}
+
+		template<typename T, typename U>
+		inline bool operator!=(const host_allocator<T> &a, const host_allocator<U> &b)
+		{
+			return a.m_allocator != b.m_allocator;
+		}
+
+	} // namespace backend
+} // namespace skepu
+
+#endif // HOST_MEMORY_H
@@ -40,10 +40,6 @@ namespace skepu
 				// Tuple with uniform arguments (can be empty)
 				typename Skeleton::UniformArgs uniformArgs;
 				
-				// Reserve memory for the maximum input size in advance
-				reserve_all_in_tuple(resultArg,  max);
-				reserve_all_in_tuple(elwiseArgs, max);
-				
 				ExecutionTimeModel* cpuModel = new ExecutionTimeModel();
 				ExecutionTimeModel* gpuModel = new ExecutionTimeModel();
 				
@@ -117,8 +113,8 @@ namespace skepu
 				cpuModel->fitModel();
 				gpuModel->fitModel();
 				
-				std::cout << "CPU model: " << cpuModel->getA() << "x + " << cpuModel->getB() << std::endl; 
-				std::cout << "GPU model: " << gpuModel->getA() << "x + " << gpuModel->getB() << std::endl; 
+				std::cout << "CPU model: " << cpuModel->getBreakpoints().size() + 1 << " segment(s), last log(y) = " << cpuModel->getA() << " log(x) + " << cpuModel->getB() << std::endl; 
+				std::cout << "GPU model: " << gpuModel->getBreakpoints().size() + 1 << " segment(s), last log(y) = " << gpuModel->getA() << " log(x) + " << gpuModel->getB() << std::endl; 
 				std::cout << "CPU R2 error: " << cpuModel->getR2Error() << std::endl;
 				std::cout << "GPU R2 error: " << gpuModel->getR2Error() << std::endl;
 				
@@ -28,7 +28,7 @@ namespace skepu
 					get<AI, CallArgs...>(args...).hostProxy(std::get<AI-arity-outArity>(proxy_tags), index)...,
 					get<CI, CallArgs...>(args...)...
 				);
-				std::tie(get<OI, CallArgs...>(args...)(i)...) = res;
+				bind_result(res, get<OI, CallArgs...>(args...)(i)...);
 			}
 		}
 	}
@@ -61,6 +61,10 @@ namespace skepu
 			omp_set_num_threads(nthr);
 			const size_t numCPUThreads = nthr - 1; // One thread is used for GPU
 			
+			// Times of the two parts in microseconds, fed back into the execution time models
+			const double start = omp_get_wtime();
+			double cpuTime = 0.0, gpuTime = 0.0;
+			
 #pragma omp parallel
 			{
 				size_t myId = omp_get_thread_num();
@@ -72,6 +76,7 @@ namespace skepu
 #else
 					this->CL(cpuSize, gpuSize, oi, ei, ai, ci, args...);
 #endif
+					gpuTime = (omp_get_wtime() - start) * 1e6;
 				}
 				else {
 					myId--; // Reindex CPU threads 0...numCPUThreads
@@ -95,8 +100,15 @@ namespace skepu
 						);
 						std::tie(get<OI, CallArgs...>(args...)(i)...) = res;
 					}
+					
+					const double elapsed = (omp_get_wtime() - start) * 1e6;
+#pragma omp critical
+					cpuTime = std::max(cpuTime, elapsed);
 				}
 			}
+			
+			if (this->m_execPlan)
+				this->m_execPlan->observeHybrid(cpuSize, cpuTime, gpuSize, gpuTime);
 		}
 		
 	} // namespace backend
@@ -0,0 +1,53 @@
+/*! \file map_lazy.inl
+ *  \brief Contains the definitions of the deferred (lazy) member functions for the Map skeleton.
+ */
+
+#ifdef SKEPU_LAZY
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Records the Map call in the lazy queue instead of executing it. The iterators and uniform arguments are
+		 *  stored by value, the call is executed fused with the other pending calls on the next flush.
+		 */
+		template<size_t arity, typename MapFunc, typename CUDAKernel, typename CLKernel>
+		template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs> 
+		void Map<arity, MapFunc, CUDAKernel, CLKernel>
+		::Lazy(size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args)
+		{
+			DEBUG_TEXT_LEVEL1("Lazy Map: size = " << size);
+			
+			LazyQueue &queue = LazyQueue::instance();
+			std::vector<LazyQueue::Access> accesses {
+				{&get<OI, CallArgs...>(args...).getParent(), get<OI, CallArgs...>(args...).getAddress(), true}...,
+				{&get<EI, CallArgs...>(args...).getParent(), get<EI, CallArgs...>(args...).getAddress(), false}...
+			};
+			
+			if (!queue.compatible(size, accesses))
+				queue.flush();
+			
+			// Sync with device data, without triggering a flush of the calls this one depends on
+			{
+				LazyQueue::Pause pause;
+				pack_expand((get<EI, CallArgs...>(args...).getParent().updateHost(), 0)...);
+				pack_expand((get<OI, CallArgs...>(args...).getParent().invalidateDeviceData(), 0)...);
+			}
+			
+			const size_t threads = (this->m_selected_spec->backend() == Backend::Type::OpenMP) ? this->m_selected_spec->CPUThreads() : 1;
+			
+			queue.record(size, threads, accesses, [=](size_t first, size_t last) mutable
+			{
+				for (size_t i = first; i < last; ++i)
+				{
+					auto index = (std::get<0>(std::make_tuple(get<OI>(args...)...)) + i).getIndex();
+					auto res = F::forward(MapFunc::CPU, index, get<EI>(args...)(i)..., get<CI>(args...)...);
+					std::tie(get<OI>(args...)(i)...) = res;
+				}
+			});
+		}
+	}
+}
+
+#endif // SKEPU_LAZY
@@ -5,18 +5,75 @@
 #ifdef SKEPU_OPENMP
 
 #include <omp.h>
+#include <cstdint>
 
 namespace skepu
 {
 	namespace backend
 	{
+		// True if skepu-tool generated a flat OpenMP loop for the user function of the instance
+		template<typename MapFunc, typename = void>
+		struct has_omp_map_kernel: std::false_type {};
+		
+		template<typename MapFunc>
+		struct has_omp_map_kernel<MapFunc, decltype((void)&MapFunc::OMPMapKernel)>: std::true_type {};
+		
+		// True if n elements from a and n elements from b do not overlap in memory, used by generated kernels to
+		// select the restrict-qualified loop
+		template<typename A, typename B>
+		inline bool disjoint_ranges(const A *a, const B *b, size_t n)
+		{
+			const uintptr_t begin_a = reinterpret_cast<uintptr_t>(a), begin_b = reinterpret_cast<uintptr_t>(b);
+			return begin_a + n * sizeof(A) <= begin_b || begin_b + n * sizeof(B) <= begin_a;
+		}
+		
+		// Element type of a dense container iterator, void for others
+		template<typename Iterator>
+		struct contiguous_element { using type = void; };
+		
+		template<typename T>
+		struct contiguous_element<VectorIterator<T>> { using type = T; };
+		
+		template<typename T>
+		struct contiguous_element<MatrixIterator<T>> { using type = T; };
+		
+		template<typename T>
+		struct contiguous_element<Tensor3Iterator<T>> { using type = T; };
+		
+		template<typename T>
+		struct contiguous_element<Tensor4Iterator<T>> { using type = T; };
+		
+		// The types returned by a user function, one per output container
+		template<typename Ret>
+		struct map_output_types { using type = std::tuple<Ret>; };
+		
+		template<typename... Rets>
+		struct map_output_types<std::tuple<Rets...>> { using type = std::tuple<Rets...>; };
+		
+		// True if every container holds exactly the type the generated loop takes pointers to, no conversions are done there
+		template<typename Params, typename Elements>
+		struct matching_element_types: std::false_type {};
+		
+		template<>
+		struct matching_element_types<std::tuple<>, std::tuple<>>: std::true_type {};
+		
+		template<typename P, typename... Ps, typename E, typename... Es>
+		struct matching_element_types<std::tuple<P, Ps...>, std::tuple<E, Es...>>: std::integral_constant<bool,
+			std::is_same<typename std::decay<P>::type, typename std::decay<E>::type>::value
+			&& matching_element_types<std::tuple<Ps...>, std::tuple<Es...>>::value> {};
+		
+		template<typename MapFunc, typename Iterator>
+		constexpr bool matchingIndex()
+		{
+			return !MapFunc::indexed || index_dimension<typename MapFunc::IndexType>::value == index_dimension<decltype(std::declval<Iterator>().getIndex())>::value;
+		}
+		
 		template<size_t arity, typename MapFunc, typename CUDAKernel, typename CLKernel>
 		template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs> 
 		void Map<arity, MapFunc, CUDAKernel, CLKernel>
-		::OMP(size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args)
+		::OMP(size_t size, pack_indices<OI...> oi, pack_indices<EI...> ei, pack_indices<AI...> ai, pack_indices<CI...> ci, CallArgs&&... args)
 		{
 			DEBUG_TEXT_LEVEL1("OpenMP Map: size = " << size);
-			static constexpr auto proxy_tags = typename MapFunc::ProxyTags{};
 			
 			// Sync with device data
 			pack_expand((get<EI, CallArgs...>(args...).getParent().updateHost(), 0)...);
@@ -24,6 +81,46 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapFunc::anyAccessMode[AI-arity-outArity])), 0)...);
 			pack_expand((get<OI, CallArgs...>(args...).getParent().invalidateDeviceData(), 0)...);
 			
+			// The generated loop takes raw pointers, so every element-wise argument must be dense and of the parameter type
+			constexpr bool flat = has_omp_map_kernel<MapFunc>::value
+				&& trait_count_all<is_contiguous_iterator, typename std::decay<CallArgs>::type...>::value == outArity + arity
+				&& matchingIndex<MapFunc, typename std::decay<decltype(get<0, CallArgs...>(args...))>::type>()
+				&& matching_element_types<
+					decltype(std::tuple_cat(std::declval<typename map_output_types<typename MapFunc::Ret>::type>(), std::declval<typename MapFunc::ElwiseArgs>())),
+					std::tuple<typename contiguous_element<typename std::decay<typename std::tuple_element<OI, std::tuple<CallArgs...>>::type>::type>::type...,
+						typename contiguous_element<typename std::decay<typename std::tuple_element<EI, std::tuple<CallArgs...>>::type>::type>::type...>>::value;
+			this->OMP_loop(std::integral_constant<bool, flat>{}, size, oi, ei, ai, ci, std::forward<CallArgs>(args)...);
+		}
+		
+		template<size_t arity, typename MapFunc, typename CUDAKernel, typename CLKernel>
+		template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs> 
+		void Map<arity, MapFunc, CUDAKernel, CLKernel>
+		::OMP_loop(std::true_type, size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args)
+		{
+			static constexpr auto proxy_tags = typename MapFunc::ProxyTags{};
+			auto &first = get<0, CallArgs...>(args...);
+			auto &parent = first.getParent();
+			
+			MapFunc::OMPMapKernel(
+				get<OI, CallArgs...>(args...).getAddress()...,
+				get<EI, CallArgs...>(args...).getAddress()...,
+				get<AI, CallArgs...>(args...).hostProxy(std::get<AI-arity-outArity>(proxy_tags), 0)...,
+				get<CI, CallArgs...>(args...)...,
+				parent.size_j(),
+				parent.size_k(),
+				parent.size_l(),
+				size,
+				first.getAddress() - parent.getAddress()
+			);
+		}
+		
+		template<size_t arity, typename MapFunc, typename CUDAKernel, typename CLKernel>
+		template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs> 
+		void Map<arity, MapFunc, CUDAKernel, CLKernel>
+		::OMP_loop(std::false_type, size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args)
+		{
+			static constexpr auto proxy_tags = typename MapFunc::ProxyTags{};
+			
 #pragma omp parallel for schedule(runtime)
 			for (size_t i = 0; i < size; ++i)
 			{
@@ -33,7 +130,7 @@ namespace skepu
 					get<AI, CallArgs...>(args...).hostProxy(std::get<AI-arity-outArity>(proxy_tags), index)...,
 					get<CI, CallArgs...>(args...)...
 				);
-				std::tie(get<OI, CallArgs...>(args...)(i)...) = res;
+				bind_result(res, get<OI, CallArgs...>(args...)(i)...);
 			}
 		}
 	}
@@ -197,9 +197,9 @@ namespace skepu
 		
 		
 		template<typename MapOverlapFunc, typename CUDAKernel, typename CLKernel>
-		template<size_t... AI, size_t... CI, typename... CallArgs>
+		template<typename Input, size_t... AI, size_t... CI, typename... CallArgs>
 		void MapOverlap2D<MapOverlapFunc, CUDAKernel, CLKernel>
-		::helper_CPU(skepu::Matrix<Ret>& res, skepu::Matrix<T>& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+		::helper_CPU(skepu::Matrix<Ret>& res, Input& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
 		{
 			// Sync with device data
 			arg.updateHost();
@@ -209,11 +209,36 @@ namespace skepu
 			
 			const int overlap_x = (int)this->m_overlap_x;
 			const int overlap_y = (int)this->m_overlap_y;
-			const size_t in_cols = arg.total_cols();
+			const size_t rows = res.total_rows();
+			const size_t cols = res.total_cols();
+			const size_t in_cols = rowStride(arg);
+			const T *in = arg.getAddress();
+			Ret *out = res.getAddress();
+			
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
 			
-			for (size_t i = 0; i < res.total_rows(); i++)
-				for (size_t j = 0; j < res.total_cols(); j++)
-					res(i, j) = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, &arg(i + overlap_y, j + overlap_x)}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+			// Cache-sized tiles
+			for (size_t ti = 0; ti < rows; ti += SKEPU_MAPOVERLAP_TILE_ROWS)
+				for (size_t tj = 0; tj < cols; tj += SKEPU_MAPOVERLAP_TILE_COLS)
+				{
+					const size_t i_end = std::min<size_t>(ti + SKEPU_MAPOVERLAP_TILE_ROWS, rows);
+					const size_t j_end = std::min<size_t>(tj + SKEPU_MAPOVERLAP_TILE_COLS, cols);
+					for (size_t i = ti; i < i_end; ++i)
+					{
+						const T *in_row = in + (i + overlap_y) * in_cols + overlap_x;
+						Ret *out_row = out + i * cols;
+						if (vectorize)
+						{
+							SKEPU_PRAGMA_SIMD
+							for (size_t j = tj; j < j_end; ++j)
+								out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						}
+						else
+							for (size_t j = tj; j < j_end; ++j)
+								out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+					}
+				}
 		}
 		
 		
@@ -230,12 +255,39 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
 			res.invalidateDeviceData();
 			
-			for (size_t i = 0; i < res.size_i(); i++)
-				for (size_t j = 0; j < res.size_j(); j++)
-					for (size_t k = 0; k < res.size_k(); k++)
-						res(i, j, k) = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
-							arg.size_i(), arg.size_j(), &arg(i+this->m_overlap_i, + j+this->m_overlap_j, + k+this->m_overlap_k)},
-							get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+			const size_t size_i = res.size_i();
+			const size_t size_j = res.size_j();
+			const size_t size_k = res.size_k();
+			
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
+			
+			// Tiles over the two inner dimensions, swept along the outer one so that neighbouring planes stay in cache
+			for (size_t tj = 0; tj < size_j; tj += SKEPU_MAPOVERLAP_TILE_ROWS)
+				for (size_t tk = 0; tk < size_k; tk += SKEPU_MAPOVERLAP_TILE_COLS)
+				{
+					const size_t j_end = std::min<size_t>(tj + SKEPU_MAPOVERLAP_TILE_ROWS, size_j);
+					const size_t k_end = std::min<size_t>(tk + SKEPU_MAPOVERLAP_TILE_COLS, size_k);
+					for (size_t i = 0; i < size_i; ++i)
+						for (size_t j = tj; j < j_end; ++j)
+						{
+							const T *in_row = &arg(i + this->m_overlap_i, j + this->m_overlap_j, this->m_overlap_k);
+							Ret *out_row = &res(i, j, 0);
+							if (vectorize)
+							{
+								SKEPU_PRAGMA_SIMD
+								for (size_t k = tk; k < k_end; ++k)
+									out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
+										arg.size_j(), arg.size_k(), in_row + k},
+										get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+							}
+							else
+								for (size_t k = tk; k < k_end; ++k)
+									out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
+										arg.size_j(), arg.size_k(), in_row + k},
+										get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						}
+				}
 		}
 		
 		
@@ -258,7 +310,7 @@ namespace skepu
 						for (size_t l = 0; l < res.size_l(); l++)
 						{
 							res(i, j, k, l) = MapOverlapFunc::CPU(Region4D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k, this->m_overlap_l,
-								arg.size_i(), arg.size_j(), arg.size_k(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
+								arg.size_j(), arg.size_k(), arg.size_l(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
 								get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 						}
 		}
@@ -0,0 +1,268 @@
+/*! \file mapoverlap_iterate.inl
+ *  \brief Contains the definitions of the temporally blocked host implementation of iterated MapOverlap.
+ */
+
+#ifdef SKEPU_OPENMP
+#include <omp.h>
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Number of time steps computed per tile. Each step widens the halo a tile has to load by one overlap,
+		 *  by default the halo is kept to about half the tile extent.
+		 */
+		inline size_t mapOverlapTimeBlock(size_t requested, size_t steps, size_t overlap, size_t tile)
+		{
+			size_t block = requested ? requested : std::max<size_t>(tile / (4 * std::max<size_t>(overlap, 1)), 1);
+			return std::min(block, steps);
+		}
+
+
+		/*!
+		 *  Performs \p steps applications of the 2D stencil on the host. The grid is divided into tiles, each tile
+		 *  is loaded with a halo wide enough for a block of time steps, the steps are computed in thread-private
+		 *  buffers on a shrinking region and only the tile itself is written back (overlapped tiling).
+		 */
+		template<typename MapOverlapFunc, typename CUDAKernel, typename CLKernel>
+		template<size_t... AI, size_t... CI, typename... CallArgs>
+		void MapOverlap2D<MapOverlapFunc, CUDAKernel, CLKernel>
+		::iterate_Host(size_t steps, size_t threads, skepu::Matrix<Ret>& res, skepu::Matrix<T>& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+		{
+			DEBUG_TEXT_LEVEL1("MapOverlap 2D iterate: steps = " << steps << ", threads = " << threads);
+
+			// Sync with device data
+			arg.updateHost();
+			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
+			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
+			res.invalidateDeviceData();
+
+			const int overlap_x = (int)this->m_overlap_x;
+			const int overlap_y = (int)this->m_overlap_y;
+			const size_t rows = arg.total_rows();
+			const size_t cols = arg.total_cols();
+
+			Ret *out = res.getAddress();
+			std::copy(arg.getAddress(), arg.getAddress() + rows * cols, out);
+
+			if (steps == 0 || rows <= 2 * (size_t)overlap_y || cols <= 2 * (size_t)overlap_x)
+				return;
+
+			const size_t tile_rows = SKEPU_MAPOVERLAP_TILE_ROWS;
+			const size_t tile_cols = SKEPU_MAPOVERLAP_TILE_COLS;
+			const size_t block = mapOverlapTimeBlock(this->m_time_block, steps, std::max(overlap_x, overlap_y), std::min(tile_rows, tile_cols));
+
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
+
+			std::vector<T> scratch(rows * cols);
+			T *src = out;
+			T *dst = scratch.data();
+
+			for (size_t done = 0; done < steps; )
+			{
+				const size_t s = std::min(block, steps - done);
+				const size_t halo_y = s * overlap_y;
+				const size_t halo_x = s * overlap_x;
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+				{
+					std::vector<T> bufA((tile_rows + 2 * halo_y) * (tile_cols + 2 * halo_x));
+					std::vector<T> bufB(bufA.size());
+
+#ifdef SKEPU_OPENMP
+#pragma omp for collapse(2) schedule(static)
+#endif
+					for (size_t r0 = 0; r0 < rows; r0 += tile_rows)
+						for (size_t c0 = 0; c0 < cols; c0 += tile_cols)
+						{
+							const size_t r1 = std::min(r0 + tile_rows, rows);
+							const size_t c1 = std::min(c0 + tile_cols, cols);
+
+							// Tile extended by the halo of the whole time block, clamped to the grid
+							const size_t hr0 = (r0 > halo_y) ? r0 - halo_y : 0;
+							const size_t hr1 = std::min(r1 + halo_y, rows);
+							const size_t hc0 = (c0 > halo_x) ? c0 - halo_x : 0;
+							const size_t hc1 = std::min(c1 + halo_x, cols);
+							const size_t hcols = hc1 - hc0;
+
+							T *a = bufA.data();
+							T *b = bufB.data();
+							for (size_t i = hr0; i < hr1; ++i)
+							{
+								std::copy(src + i * cols + hc0, src + i * cols + hc1, a + (i - hr0) * hcols);
+								std::copy(src + i * cols + hc0, src + i * cols + hc1, b + (i - hr0) * hcols);
+							}
+
+							for (size_t t = 1; t <= s; ++t)
+							{
+								// The valid region shrinks by one overlap per step, border cells of the grid stay fixed
+								const size_t ext_y = (s - t) * overlap_y;
+								const size_t ext_x = (s - t) * overlap_x;
+								const size_t i0 = std::max((r0 > ext_y) ? r0 - ext_y : 0, (size_t)overlap_y);
+								const size_t i1 = std::min(r1 + ext_y, rows - overlap_y);
+								const size_t j0 = std::max((c0 > ext_x) ? c0 - ext_x : 0, (size_t)overlap_x) - hc0;
+								const size_t j1 = std::min(c1 + ext_x, cols - overlap_x) - hc0;
+
+								for (size_t i = i0; i < i1; ++i)
+								{
+									const T *in_row = a + (i - hr0) * hcols;
+									T *out_row = b + (i - hr0) * hcols;
+									if (vectorize)
+									{
+										SKEPU_PRAGMA_SIMD
+										for (size_t j = j0; j < j1; ++j)
+											out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, hcols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+									}
+									else
+										for (size_t j = j0; j < j1; ++j)
+											out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, hcols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+								}
+								std::swap(a, b);
+							}
+
+							for (size_t i = r0; i < r1; ++i)
+								std::copy(a + (i - hr0) * hcols + (c0 - hc0), a + (i - hr0) * hcols + (c1 - hc0), dst + i * cols + c0);
+						}
+				}
+
+				std::swap(src, dst);
+				done += s;
+			}
+
+			if (src != out)
+				std::copy(src, src + rows * cols, out);
+		}
+
+
+		/*!
+		 *  Performs \p steps applications of the 3D stencil on the host, using the same overlapped tiling as the
+		 *  2D version with tiles over all three dimensions.
+		 */
+		template<typename MapOverlapFunc, typename CUDAKernel, typename CLKernel>
+		template<size_t... AI, size_t... CI, typename... CallArgs>
+		void MapOverlap3D<MapOverlapFunc, CUDAKernel, CLKernel>
+		::iterate_Host(size_t steps, size_t threads, skepu::Tensor3<Ret>& res, skepu::Tensor3<T>& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+		{
+			DEBUG_TEXT_LEVEL1("MapOverlap 3D iterate: steps = " << steps << ", threads = " << threads);
+
+			// Sync with device data
+			arg.updateHost();
+			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
+			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
+			res.invalidateDeviceData();
+
+			const size_t o[3] = {(size_t)this->m_overlap_i, (size_t)this->m_overlap_j, (size_t)this->m_overlap_k};
+			const size_t size[3] = {arg.size_i(), arg.size_j(), arg.size_k()};
+			const size_t total = size[0] * size[1] * size[2];
+
+			Ret *out = res.getAddress();
+			std::copy(arg.getAddress(), arg.getAddress() + total, out);
+
+			if (steps == 0 || size[0] <= 2 * o[0] || size[1] <= 2 * o[1] || size[2] <= 2 * o[2])
+				return;
+
+			const size_t tile[3] = {SKEPU_MAPOVERLAP_TILE_PLANES, SKEPU_MAPOVERLAP_TILE_ROWS, SKEPU_MAPOVERLAP_TILE_COLS};
+			const size_t block = mapOverlapTimeBlock(this->m_time_block, steps, std::max({o[0], o[1], o[2]}), tile[0]);
+
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
+
+			std::vector<T> scratch(total);
+			T *src = out;
+			T *dst = scratch.data();
+
+			for (size_t done = 0; done < steps; )
+			{
+				const size_t s = std::min(block, steps - done);
+				const size_t halo[3] = {s * o[0], s * o[1], s * o[2]};
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+				{
+					std::vector<T> bufA((tile[0] + 2 * halo[0]) * (tile[1] + 2 * halo[1]) * (tile[2] + 2 * halo[2]));
+					std::vector<T> bufB(bufA.size());
+
+#ifdef SKEPU_OPENMP
+#pragma omp for collapse(3) schedule(static)
+#endif
+					for (size_t p0 = 0; p0 < size[0]; p0 += tile[0])
+						for (size_t r0 = 0; r0 < size[1]; r0 += tile[1])
+							for (size_t c0 = 0; c0 < size[2]; c0 += tile[2])
+							{
+								const size_t first[3] = {p0, r0, c0};
+								size_t last[3], hfirst[3], hlast[3], hsize[3];
+								for (size_t d = 0; d < 3; ++d)
+								{
+									last[d] = std::min(first[d] + tile[d], size[d]);
+									hfirst[d] = (first[d] > halo[d]) ? first[d] - halo[d] : 0;
+									hlast[d] = std::min(last[d] + halo[d], size[d]);
+									hsize[d] = hlast[d] - hfirst[d];
+								}
+
+								T *a = bufA.data();
+								T *b = bufB.data();
+								for (size_t i = hfirst[0]; i < hlast[0]; ++i)
+									for (size_t j = hfirst[1]; j < hlast[1]; ++j)
+									{
+										const T *row = src + (i * size[1] + j) * size[2];
+										const size_t local = ((i - hfirst[0]) * hsize[1] + (j - hfirst[1])) * hsize[2];
+										std::copy(row + hfirst[2], row + hlast[2], a + local);
+										std::copy(row + hfirst[2], row + hlast[2], b + local);
+									}
+
+								for (size_t t = 1; t <= s; ++t)
+								{
+									// The valid region shrinks by one overlap per step, border cells of the grid stay fixed
+									size_t lo[3], hi[3];
+									for (size_t d = 0; d < 3; ++d)
+									{
+										const size_t ext = (s - t) * o[d];
+										lo[d] = std::max((first[d] > ext) ? first[d] - ext : 0, o[d]) - hfirst[d];
+										hi[d] = std::min(last[d] + ext, size[d] - o[d]) - hfirst[d];
+									}
+
+									for (size_t i = lo[0]; i < hi[0]; ++i)
+										for (size_t j = lo[1]; j < hi[1]; ++j)
+										{
+											const T *in_row = a + (i * hsize[1] + j) * hsize[2];
+											T *out_row = b + (i * hsize[1] + j) * hsize[2];
+											if (vectorize)
+											{
+												SKEPU_PRAGMA_SIMD
+												for (size_t k = lo[2]; k < hi[2]; ++k)
+													out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k, hsize[1], hsize[2], in_row + k},
+														get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+											}
+											else
+												for (size_t k = lo[2]; k < hi[2]; ++k)
+													out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k, hsize[1], hsize[2], in_row + k},
+														get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+										}
+									std::swap(a, b);
+								}
+
+								for (size_t i = first[0]; i < last[0]; ++i)
+									for (size_t j = first[1]; j < last[1]; ++j)
+									{
+										const T *local = a + ((i - hfirst[0]) * hsize[1] + (j - hfirst[1])) * hsize[2];
+										std::copy(local + (first[2] - hfirst[2]), local + (last[2] - hfirst[2]), dst + (i * size[1] + j) * size[2] + first[2]);
+									}
+							}
+				}
+
+				std::swap(src, dst);
+				done += s;
+			}
+
+			if (src != out)
+				std::copy(src, src + total, out);
+		}
+
+	} // namespace backend
+} // namespace skepu
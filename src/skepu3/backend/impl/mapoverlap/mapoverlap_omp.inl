@@ -30,9 +30,7 @@ namespace skepu
 			
 			T start[3*overlap], end[3*overlap];
 			
-			omp_set_num_threads(this->m_selected_spec->CPUThreads());
-			
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 			for (size_t i = 0; i < overlap; ++i)
 			{
 				switch (this->m_edge)
@@ -61,7 +59,7 @@ namespace skepu
 				res(i) = MapOverlapFunc::OMP({overlap, stride, &start[i + overlap]},
 						get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 				
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 			for (size_t i = overlap; i < size - overlap; ++i)
 				res(i) = MapOverlapFunc::OMP({overlap, stride, &arg(i)},
 					get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
@@ -98,13 +96,11 @@ namespace skepu
 			const Ret *inputEnd = inputBegin + size;
 			Ret *out = res.getAddress();
 			
-			omp_set_num_threads(this->m_selected_spec->CPUThreads());
-			
 			for (size_t row = 0; row < arg.total_rows(); ++row)
 			{
 				inputEnd = inputBegin + rowWidth;
 				
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 				for (size_t i = 0; i < overlap; ++i)
 				{
 					switch (this->m_edge)
@@ -133,7 +129,7 @@ namespace skepu
 				for (size_t i = 0; i < overlap; ++i)
 					out[i] = MapOverlapFunc::OMP({overlap, stride, &start[i + overlap]}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 					
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 				for (size_t i = overlap; i < rowWidth - overlap; ++i)
 					out[i] = MapOverlapFunc::OMP({overlap, stride, &inputBegin[i]}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 					
@@ -172,13 +168,11 @@ namespace skepu
 			const Ret *inputBegin = arg.getAddress();
 			const Ret *inputEnd = inputBegin + size;
 			
-			omp_set_num_threads(this->m_selected_spec->CPUThreads());
-			
 			for (size_t col = 0; col < arg.total_cols(); ++col)
 			{
 				inputEnd = inputBegin + (rowWidth * (colWidth-1));
 				
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 				for (size_t i = 0; i < overlap; ++i)
 				{
 					switch (this->m_edge)
@@ -208,7 +202,7 @@ namespace skepu
 					res(i * stride + col) = MapOverlapFunc::OMP({overlap, 1, &start[i + overlap]},
 						get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 					
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 				for (size_t i = overlap; i < colWidth - overlap; ++i)
 					res(i * stride + col) = MapOverlapFunc::OMP({overlap, stride, &inputBegin[i*stride]},
 						get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
@@ -223,9 +217,9 @@ namespace skepu
 		
 		
 		template<typename MapOverlapFunc, typename CUDAKernel, typename CLKernel>
-		template<size_t... AI, size_t... CI, typename... CallArgs>
+		template<typename Input, size_t... AI, size_t... CI, typename... CallArgs>
 		void MapOverlap2D<MapOverlapFunc, CUDAKernel, CLKernel>
-		::helper_OpenMP(skepu::Matrix<Ret>& res, skepu::Matrix<T>& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+		::helper_OpenMP(skepu::Matrix<Ret>& res, Input& arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
 		{
 			// Sync with device data
 			arg.updateHost();
@@ -233,18 +227,39 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
 			res.invalidateDeviceData();
 			
-			omp_set_num_threads(this->m_selected_spec->CPUThreads());
-			
 			const int overlap_x = (int)this->m_overlap_x;
 			const int overlap_y = (int)this->m_overlap_y;
 			const size_t rows = res.total_rows();
 			const size_t cols = res.total_cols();
-			const size_t in_cols = arg.total_cols();
+			const size_t in_cols = rowStride(arg);
+			const T *in = arg.getAddress();
+			Ret *out = res.getAddress();
 			
-#pragma omp parallel for schedule(runtime)
-			for (size_t i = 0; i < rows; i++)
-				for (size_t j = 0; j < cols; j++)
-					res(i, j) = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, &arg((i + overlap_y) * in_cols + (j + overlap_x))}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
+			
+			// Cache-sized tiles distributed among the threads
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads()) collapse(2)
+			for (size_t ti = 0; ti < rows; ti += SKEPU_MAPOVERLAP_TILE_ROWS)
+				for (size_t tj = 0; tj < cols; tj += SKEPU_MAPOVERLAP_TILE_COLS)
+				{
+					const size_t i_end = std::min<size_t>(ti + SKEPU_MAPOVERLAP_TILE_ROWS, rows);
+					const size_t j_end = std::min<size_t>(tj + SKEPU_MAPOVERLAP_TILE_COLS, cols);
+					for (size_t i = ti; i < i_end; ++i)
+					{
+						const T *in_row = in + (i + overlap_y) * in_cols + overlap_x;
+						Ret *out_row = out + i * cols;
+						if (vectorize)
+						{
+							SKEPU_PRAGMA_SIMD
+							for (size_t j = tj; j < j_end; ++j)
+								out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						}
+						else
+							for (size_t j = tj; j < j_end; ++j)
+								out_row[j] = MapOverlapFunc::CPU({overlap_x, overlap_y, in_cols, in_row + j}, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+					}
+				}
 		}
 		
 		template<typename MapOverlapFunc, typename CUDAKernel, typename CLKernel>
@@ -258,13 +273,40 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
 			res.invalidateDeviceData();
 			
-#pragma omp parallel for schedule(runtime)
-			for (size_t i = 0; i < res.size_i(); i++)
-				for (size_t j = 0; j < res.size_j(); j++)
-					for (size_t k = 0; k < res.size_k(); k++)
-						res(i, j, k) = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
-							arg.size_i(), arg.size_j(), &arg(i+this->m_overlap_i, + j+this->m_overlap_j, + k+this->m_overlap_k)},
-							get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+			const size_t size_i = res.size_i();
+			const size_t size_j = res.size_j();
+			const size_t size_k = res.size_k();
+			
+			// Rows are vectorized unless the user function writes to a random access argument
+			constexpr bool vectorize = !anyWriteAccess(MapOverlapFunc::anyAccessMode[AI]...);
+			
+			// Tiles over the two inner dimensions, swept along the outer one so that neighbouring planes stay in cache
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads()) collapse(2)
+			for (size_t tj = 0; tj < size_j; tj += SKEPU_MAPOVERLAP_TILE_ROWS)
+				for (size_t tk = 0; tk < size_k; tk += SKEPU_MAPOVERLAP_TILE_COLS)
+				{
+					const size_t j_end = std::min<size_t>(tj + SKEPU_MAPOVERLAP_TILE_ROWS, size_j);
+					const size_t k_end = std::min<size_t>(tk + SKEPU_MAPOVERLAP_TILE_COLS, size_k);
+					for (size_t i = 0; i < size_i; ++i)
+						for (size_t j = tj; j < j_end; ++j)
+						{
+							const T *in_row = &arg(i + this->m_overlap_i, j + this->m_overlap_j, this->m_overlap_k);
+							Ret *out_row = &res(i, j, 0);
+							if (vectorize)
+							{
+								SKEPU_PRAGMA_SIMD
+								for (size_t k = tk; k < k_end; ++k)
+									out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
+										arg.size_j(), arg.size_k(), in_row + k},
+										get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+							}
+							else
+								for (size_t k = tk; k < k_end; ++k)
+									out_row[k] = MapOverlapFunc::CPU(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
+										arg.size_j(), arg.size_k(), in_row + k},
+										get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						}
+				}
 		}
 		
 		
@@ -281,14 +323,14 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapOverlapFunc::anyAccessMode[AI])), 0)...);
 			res.invalidateDeviceData();
 			
-#pragma omp parallel for schedule(runtime)
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
 			for (size_t i = 0; i < res.size_i(); i++)
 				for (size_t j = 0; j < res.size_j(); j++)
 					for (size_t k = 0; k < res.size_k(); k++)
 						for (size_t l = 0; l < res.size_l(); l++)
 						{
 							res(i, j, k, l) = MapOverlapFunc::CPU(Region4D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k, this->m_overlap_l,
-								arg.size_i(), arg.size_j(), arg.size_k(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
+								arg.size_j(), arg.size_k(), arg.size_l(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
 								get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 						}
 		}
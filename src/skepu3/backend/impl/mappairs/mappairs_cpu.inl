@@ -20,6 +20,24 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			
+			if (this->m_symmetry != Symmetry::None)
+			{
+				// Evaluate the upper triangle only, the pairs below the diagonal are mirrored
+				for (size_t i = 0; i < Vsize; ++i)
+				{
+					for (size_t j = i; j < Hsize; ++j)
+					{
+						auto res = F::forward(MapPairsFunc::CPU, Index2D { i, j },
+							get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)...,
+							get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						std::tie(get<OI, CallArgs...>(args...)(i, j)...) = res;
+						if (i != j)
+							pack_expand((get<OI, CallArgs...>(args...)(j, i) = mirror_pair(get<OI, CallArgs...>(args...)(i, j), this->m_symmetry), 0)...);
+					}
+				}
+				return;
+			}
+			
 			for (size_t i = 0; i < Vsize; ++i)
 			{
 				for (size_t j = 0; j < Hsize; ++j)
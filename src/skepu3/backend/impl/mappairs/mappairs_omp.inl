@@ -24,13 +24,48 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			
-#pragma omp parallel for schedule(runtime)
-			for (size_t i = 0; i < Vsize; ++i)
+			if (this->m_symmetry != Symmetry::None)
 			{
-				for (size_t j = 0; j < Hsize; ++j)
+				// Tiles on and above the diagonal, each mirrored into its transposed tile. Tiles differ in
+				// cost along the diagonal, so they are scheduled dynamically.
+				const size_t tile = SKEPU_MAPPAIRS_TILE;
+				const std::vector<std::pair<size_t, size_t>> tiles = upperTriangleTiles(Vsize, tile);
+				
+#pragma omp parallel for schedule(dynamic) num_threads(this->m_selected_spec->CPUThreads())
+				for (size_t t = 0; t < tiles.size(); ++t)
 				{
-					auto res = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
-					std::tie(get<OI, CallArgs...>(args...)(i, j)...) = res;
+					const size_t i0 = tiles[t].first, j0 = tiles[t].second;
+					const size_t iEnd = std::min(i0 + tile, Vsize), jEnd = std::min(j0 + tile, Hsize);
+					for (size_t i = i0; i < iEnd; ++i)
+					{
+						for (size_t j = std::max(j0, i); j < jEnd; ++j)
+						{
+							auto res = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+							std::tie(get<OI, CallArgs...>(args...)(i, j)...) = res;
+							if (i != j)
+								pack_expand((get<OI, CallArgs...>(args...)(j, i) = mirror_pair(get<OI, CallArgs...>(args...)(i, j), this->m_symmetry), 0)...);
+						}
+					}
+				}
+				return;
+			}
+			
+			const size_t rowTile = SKEPU_MAPPAIRS_TILE_ROWS, colTile = SKEPU_MAPPAIRS_TILE_COLS;
+			const size_t colBlocks = (Hsize + colTile - 1) / colTile;
+			const size_t numTiles = (Vsize + rowTile - 1) / rowTile * colBlocks;
+			
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
+			for (size_t t = 0; t < numTiles; ++t)
+			{
+				const size_t i0 = t / colBlocks * rowTile, j0 = t % colBlocks * colTile;
+				const size_t iEnd = std::min(i0 + rowTile, Vsize), jEnd = std::min(j0 + colTile, Hsize);
+				for (size_t i = i0; i < iEnd; ++i)
+				{
+					for (size_t j = j0; j < jEnd; ++j)
+					{
+						auto res = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						std::tie(get<OI, CallArgs...>(args...)(i, j)...) = res;
+					}
 				}
 			}
 		}
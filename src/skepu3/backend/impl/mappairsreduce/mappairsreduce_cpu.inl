@@ -19,7 +19,26 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			
-			if (this->m_mode == ReduceMode::RowWise)
+			if (this->m_symmetry != Symmetry::None)
+			{
+				// Each unordered pair is evaluated once and reduced into both of its rows (or columns)
+				for (size_t k = 0; k < Vsize; ++k)
+					res(k) = this->m_start;
+				
+				for (size_t i = 0; i < Vsize; ++i)
+				{
+					for (size_t j = i; j < Hsize; ++j)
+					{
+						Ret temp = F::forward(MapPairsFunc::CPU, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+						const size_t own = (this->m_mode == ReduceMode::RowWise) ? i : j;
+						const size_t other = (this->m_mode == ReduceMode::RowWise) ? j : i;
+						res(own) = ReduceFunc::CPU(res(own), temp);
+						if (i != j)
+							res(other) = ReduceFunc::CPU(res(other), mirror_pair(temp, this->m_symmetry));
+					}
+				}
+			}
+			else if (this->m_mode == ReduceMode::RowWise)
 				for (size_t i = 0; i < Vsize; ++i)
 				{
 					res(i) = this->m_start;
@@ -31,16 +50,18 @@ namespace skepu
 					}
 				}
 			else if (this->m_mode == ReduceMode::ColWise)
+			{
+				// Rows in the outer loop so that the horizontal elements are streamed, the order of each column is kept
 				for (size_t j = 0; j < Hsize; ++j)
-				{
 					res(j) = this->m_start;
-					for (size_t i = 0; i < Vsize; ++i)
+				
+				for (size_t i = 0; i < Vsize; ++i)
+					for (size_t j = 0; j < Hsize; ++j)
 					{
-						auto index = Index2D { i, j };
 						Ret temp = F::forward(MapPairsFunc::CPU, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
 						res(j) = ReduceFunc::CPU(res(j), temp);
 					}
-				}
+			}
 		}
 		
 	}
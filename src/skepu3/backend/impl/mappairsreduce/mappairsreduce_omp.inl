@@ -25,30 +25,135 @@ namespace skepu
 			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapPairsFunc::anyAccessMode[AI-Varity-Harity])), 0)...);
 			
-			if (this->m_mode == ReduceMode::RowWise)
-#pragma omp parallel for schedule(runtime)
-				for (size_t i = 0; i < Vsize; ++i)
+			if (this->m_symmetry != Symmetry::None)
+			{
+				// Each unordered pair is evaluated once, in tiles on and above the diagonal, and reduced into
+				// both of its rows (or columns). Every thread reduces into a private copy of the result, which
+				// are combined after the tiles are done.
+				const size_t tile = SKEPU_MAPPAIRS_TILE;
+				const std::vector<std::pair<size_t, size_t>> tiles = upperTriangleTiles(Vsize, tile);
+				const size_t numThreads = this->m_selected_spec->CPUThreads();
+				std::vector<std::vector<Ret>> partials(numThreads);
+				std::vector<std::vector<char>> touched(numThreads);
+				
+#pragma omp parallel num_threads(numThreads)
 				{
-					res(i) = this->m_start;
-					for (size_t j = 0; j < Hsize; ++j)
+					std::vector<Ret> &partial = partials[omp_get_thread_num()];
+					std::vector<char> &used = touched[omp_get_thread_num()];
+					partial.resize(Vsize);
+					used.assign(Vsize, 0);
+					
+					auto accumulate = [&](size_t k, const Ret &value)
+					{
+						partial[k] = used[k] ? ReduceFunc::OMP(partial[k], value) : value;
+						used[k] = 1;
+					};
+					
+#pragma omp for schedule(dynamic)
+					for (size_t t = 0; t < tiles.size(); ++t)
+					{
+						const size_t i0 = tiles[t].first, j0 = tiles[t].second;
+						const size_t iEnd = std::min(i0 + tile, Vsize), jEnd = std::min(j0 + tile, Hsize);
+						for (size_t i = i0; i < iEnd; ++i)
+						{
+							for (size_t j = std::max(j0, i); j < jEnd; ++j)
+							{
+								Ret temp = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+								accumulate((this->m_mode == ReduceMode::RowWise) ? i : j, temp);
+								if (i != j)
+									accumulate((this->m_mode == ReduceMode::RowWise) ? j : i, mirror_pair(temp, this->m_symmetry));
+							}
+						}
+					}
+					
+#pragma omp for schedule(static)
+					for (size_t k = 0; k < Vsize; ++k)
 					{
-						auto index = Index2D { i, j };
-						Ret temp = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
-						res(i) = ReduceFunc::OMP(res(i), temp);
+						Ret sum = this->m_start;
+						for (size_t t = 0; t < numThreads; ++t)
+							if (!touched[t].empty() && touched[t][k])
+								sum = ReduceFunc::OMP(sum, partials[t][k]);
+						res(k) = sum;
 					}
 				}
+			}
+			else if (this->m_mode == ReduceMode::RowWise)
+			{
+				// Every thread reduces whole rows, a block of rows at a time, so that each block of horizontal
+				// elements is reused for all rows of the block while in cache
+				const size_t rowTile = SKEPU_MAPPAIRS_TILE_ROWS, colTile = SKEPU_MAPPAIRS_TILE_COLS;
+				const size_t rowBlocks = (Vsize + rowTile - 1) / rowTile;
+				
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
+				for (size_t b = 0; b < rowBlocks; ++b)
+				{
+					const size_t i0 = b * rowTile, iEnd = std::min(i0 + rowTile, Vsize);
+					for (size_t i = i0; i < iEnd; ++i)
+						res(i) = this->m_start;
+					
+					for (size_t j0 = 0; j0 < Hsize; j0 += colTile)
+					{
+						const size_t jEnd = std::min(j0 + colTile, Hsize);
+						for (size_t i = i0; i < iEnd; ++i)
+						{
+							Ret sum = res(i);
+							for (size_t j = j0; j < jEnd; ++j)
+							{
+								Ret temp = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+								sum = ReduceFunc::OMP(sum, temp);
+							}
+							res(i) = sum;
+						}
+					}
+				}
+			}
 			else if (this->m_mode == ReduceMode::ColWise)
-#pragma omp parallel for schedule(runtime)
-				for (size_t j = 0; j < Hsize; ++j) // TODO: optimize?
+			{
+				// Every thread reduces a contiguous range of rows into partial column results, tile by tile as
+				// for rows. The partial results are combined in row order, so only associativity is required.
+				const size_t rowTile = SKEPU_MAPPAIRS_TILE_ROWS, colTile = SKEPU_MAPPAIRS_TILE_COLS;
+				std::vector<std::vector<Ret>> partials(this->m_selected_spec->CPUThreads());
+				size_t numThreads = 0;
+				
+#pragma omp parallel num_threads(partials.size())
 				{
-					res(j) = this->m_start;
-					for (size_t i = 0; i < Vsize; ++i)
+					const size_t nt = omp_get_num_threads(), tid = omp_get_thread_num();
+					const size_t rowBegin = Vsize * tid / nt, rowEnd = Vsize * (tid + 1) / nt;
+					std::vector<Ret> &partial = partials[tid];
+					
+					if (tid == 0)
+						numThreads = nt;
+					if (rowBegin < rowEnd)
+						partial.resize(Hsize);
+					
+					for (size_t i0 = rowBegin; i0 < rowEnd; i0 += rowTile)
+					{
+						const size_t iEnd = std::min(i0 + rowTile, rowEnd);
+						for (size_t j0 = 0; j0 < Hsize; j0 += colTile)
+						{
+							const size_t jEnd = std::min(j0 + colTile, Hsize);
+							for (size_t i = i0; i < iEnd; ++i)
+								for (size_t j = j0; j < jEnd; ++j)
+								{
+									Ret temp = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+									partial[j] = (i == rowBegin) ? temp : ReduceFunc::OMP(partial[j], temp);
+								}
+						}
+					}
+					
+#pragma omp barrier
+					
+#pragma omp for schedule(static)
+					for (size_t j = 0; j < Hsize; ++j)
 					{
-						auto index = Index2D { i, j };
-						Ret temp = F::forward(MapPairsFunc::OMP, Index2D { i, j }, get<VEI, CallArgs...>(args...)(i)..., get<HEI, CallArgs...>(args...)(j)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
-						res(j) = ReduceFunc::OMP(res(j), temp);
+						Ret sum = this->m_start;
+						for (size_t t = 0; t < numThreads; ++t)
+							if (!partials[t].empty())
+								sum = ReduceFunc::OMP(sum, partials[t][j]);
+						res(j) = sum;
 					}
 				}
+			}
 		}
 		
 	} // namespace backend
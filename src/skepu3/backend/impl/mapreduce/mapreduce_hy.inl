@@ -54,6 +54,10 @@ namespace skepu
 			
 			std::vector<Ret> parsums(numCPUThreads);
 			
+			// Times of the two parts in microseconds, fed back into the execution time models
+			const double start = omp_get_wtime();
+			double cpuTime = 0.0, gpuTime = 0.0;
+			
 			// Perform Map and partial Reduce with OpenMP
 #pragma omp parallel
 			{
@@ -66,6 +70,7 @@ namespace skepu
 #else
 					res = this->CL(cpuSize, gpuSize, ei, ai, ci, res, args...);
 #endif
+					gpuTime = (omp_get_wtime() - start) * 1e6;
 				}
 				else {
 					// CPU threads
@@ -82,9 +87,16 @@ namespace skepu
 						psum = ReduceFunc::OMP(psum, tempMap);
 					}
 					parsums[myId] = psum;
+					
+					const double elapsed = (omp_get_wtime() - start) * 1e6;
+#pragma omp critical
+					cpuTime = std::max(cpuTime, elapsed);
 				}
 			}
 			
+			if (this->m_execPlan)
+				this->m_execPlan->observeHybrid(cpuSize, cpuTime, gpuSize, gpuTime);
+			
 			// Final Reduce sequentially
 			for (Ret &parsum : parsums)
 				res = ReduceFunc::OMP(res, parsum);
@@ -0,0 +1,65 @@
+/*! \file mapreduce_lazy.inl
+*  \brief Contains the definitions of the fused (lazy) member functions for the MapReduce skeleton.
+*/
+
+#ifdef SKEPU_LAZY
+
+#include <vector>
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Performs MapReduce on element-wise arguments produced by pending lazy calls. Each block is mapped and
+		 *  reduced right after the pending calls have produced it.
+		 */
+		template<size_t arity, typename MapFunc, typename ReduceFunc, typename CUDAKernel, typename CUDAReduceKernel, typename CLKernel>
+		template<size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+		typename ReduceFunc::Ret MapReduce<arity, MapFunc, ReduceFunc, CUDAKernel, CUDAReduceKernel, CLKernel>
+		::Lazy(size_t size, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args)
+		{
+			LazyQueue &queue = LazyQueue::instance();
+			std::vector<Ret> parsums(queue.workers());
+			std::vector<char> used(queue.workers(), false);
+			
+			// Perform Map and partial Reduce on each block as it is produced
+			queue.flush([&](size_t first, size_t last, size_t worker)
+			{
+				auto index = (get<0, CallArgs...>(args...) + first).getIndex();
+				Ret parsum = F::forward(MapFunc::CPU, index, get<EI, CallArgs...>(args...)(first)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+				for (size_t i = first + 1; i < last; ++i)
+				{
+					index = (get<0, CallArgs...>(args...) + i).getIndex();
+					Temp tempMap = F::forward(MapFunc::CPU, index, get<EI, CallArgs...>(args...)(i)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+					parsum = ReduceFunc::CPU(parsum, tempMap);
+				}
+				
+				parsums[worker] = used[worker] ? ReduceFunc::CPU(parsums[worker], parsum) : parsum;
+				used[worker] = true;
+			});
+			
+			// Final Reduce sequentially
+			for (size_t worker = 0; worker < parsums.size(); ++worker)
+				if (used[worker])
+					res = ReduceFunc::CPU(res, parsums[worker]);
+			
+			return res;
+		}
+		
+		
+		/*!
+		 *  Without element-wise arguments there is nothing to fuse with, executes on the CPU.
+		 */
+		template<size_t arity, typename MapFunc, typename ReduceFunc, typename CUDAKernel, typename CUDAReduceKernel, typename CLKernel>
+		template<size_t... AI, size_t... CI, typename ...CallArgs>
+		typename ReduceFunc::Ret MapReduce<arity, MapFunc, ReduceFunc, CUDAKernel, CUDAReduceKernel, CLKernel>
+		::Lazy(size_t size, pack_indices<> ei, pack_indices<AI...> ai, pack_indices<CI...> ci, Ret &res, CallArgs&&... args)
+		{
+			return this->CPU(size, ei, ai, ci, res, std::forward<CallArgs>(args)...);
+		}
+		
+	} // namespace backend
+} // namespace skepu
+
+#endif
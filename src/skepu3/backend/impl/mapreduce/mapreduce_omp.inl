@@ -42,6 +42,7 @@ namespace skepu
 			}
 			
 			// Final Reduce sequentially
+			TraceScope tail(TracePhase::ReduceTail, this, *this->m_selected_spec, parsums.size(), parsums.size() * sizeof(Ret));
 			for (Ret &parsum : parsums)
 				res = ReduceFunc::OMP(res, parsum);
 			
@@ -79,6 +80,7 @@ namespace skepu
 			}
 			
 			// Final Reduce sequentially
+			TraceScope tail(TracePhase::ReduceTail, this, *this->m_selected_spec, parsums.size(), parsums.size() * sizeof(Ret));
 			for (Ret &parsum : parsums)
 				res = ReduceFunc::OMP(res, parsum);
 			
@@ -0,0 +1,79 @@
+/*! \file mapreduce_tp.inl
+*  \brief Contains the definitions of TaskPool specific member functions for the MapReduce skeleton.
+*/
+
+#ifdef SKEPU_TASKPOOL
+
+namespace skepu
+{
+	namespace backend
+	{
+		template<size_t arity, typename MapFunc, typename ReduceFunc, typename CUDAKernel, typename CUDAReduceKernel, typename CLKernel>
+		template<size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+		typename ReduceFunc::Ret MapReduce<arity, MapFunc, ReduceFunc, CUDAKernel, CUDAReduceKernel, CLKernel>
+		::TP(size_t size, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args)
+		{
+			// Sync with device data
+			pack_expand((get<EI, CallArgs...>(args...).getParent().updateHost(), 0)...);
+			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapFunc::anyAccessMode[AI-arity])), 0)...);
+			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapFunc::anyAccessMode[AI-arity])), 0)...);
+			
+			if (size == 0)
+				return res;
+			
+			// Perform Map and partial Reduce per block, combine the partial results in block order
+			Ret total = TaskPool::instance().parallelReduce<Ret>(0, size, this->m_selected_spec->CPUThreads(), [&](size_t first, size_t last)
+			{
+				auto index = (get<0, CallArgs...>(args...) + first).getIndex();
+				Ret parsum = F::forward(MapFunc::CPU, index, get<EI, CallArgs...>(args...)(first)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+				for (size_t i = first + 1; i < last; ++i)
+				{
+					index = (get<0, CallArgs...>(args...) + i).getIndex();
+					Temp tempMap = F::forward(MapFunc::CPU, index, get<EI, CallArgs...>(args...)(i)..., get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+					parsum = ReduceFunc::CPU(parsum, tempMap);
+				}
+				return parsum;
+			}, [](Ret a, Ret b) { return ReduceFunc::CPU(a, b); }, this->m_selected_spec->CPUChunkSize());
+			
+			res = ReduceFunc::CPU(res, total);
+			
+			return res;
+		}
+		
+		
+		
+		template<size_t arity, typename MapFunc, typename ReduceFunc, typename CUDAKernel, typename CUDAReduceKernel, typename CLKernel>
+		template<size_t... AI, size_t... CI, typename ...CallArgs>
+		typename ReduceFunc::Ret MapReduce<arity, MapFunc, ReduceFunc, CUDAKernel, CUDAReduceKernel, CLKernel>
+		::TP(size_t size, pack_indices<>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args)
+		{
+			// Sync with device data
+			pack_expand((get<AI, CallArgs...>(args...).getParent().updateHost(hasReadAccess(MapFunc::anyAccessMode[AI-arity])), 0)...);
+			pack_expand((get<AI, CallArgs...>(args...).getParent().invalidateDeviceData(hasWriteAccess(MapFunc::anyAccessMode[AI-arity])), 0)...);
+			
+			if (size == 0)
+				return res;
+			
+			// Perform Map and partial Reduce per block, combine the partial results in block order
+			Ret total = TaskPool::instance().parallelReduce<Ret>(0, size, this->m_selected_spec->CPUThreads(), [&](size_t first, size_t last)
+			{
+				auto index = make_index(defaultDim{}, first, this->default_size_j, this->default_size_k, this->default_size_l);
+				Ret parsum = F::forward(MapFunc::CPU, index, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+				for (size_t i = first + 1; i < last; ++i)
+				{
+					index = make_index(defaultDim{}, i, this->default_size_j, this->default_size_k, this->default_size_l);
+					Temp tempMap = F::forward(MapFunc::CPU, index, get<AI, CallArgs...>(args...).hostProxy()..., get<CI, CallArgs...>(args...)...);
+					parsum = ReduceFunc::CPU(parsum, tempMap);
+				}
+				return parsum;
+			}, [](Ret a, Ret b) { return ReduceFunc::CPU(a, b); }, this->m_selected_spec->CPUChunkSize());
+			
+			res = ReduceFunc::CPU(res, total);
+			
+			return res;
+		}
+		
+	} // namespace backend
+} // namespace skepu
+
+#endif
@@ -125,6 +125,51 @@ void Matrix<T>::load(const std::string& filename, size_type rowWidth, size_type
 }
 
 
+/*!
+*  \brief Saves the Matrix to a binary file.
+*
+*  Writes a header with the element size, dimensions, byte order and a checksum, followed by the raw
+*  elements in row-major order. Large matrices are written in chunks by several threads.
+*
+*  \param filename Name of file to save to.
+*/
+template<typename T>
+void Matrix<T>::saveBinary(const std::string& filename)
+{
+   static_assert(std::is_trivially_copyable<T>::value, "Binary files require trivially copyable elements");
+   updateHost();
+
+   const size_t dims[2] = {m_rows, m_cols};
+   backend::writeBinaryFile(filename, m_data.data(), m_data.size(), sizeof(T), 2, dims);
+}
+
+/*!
+*  \brief Loads the Matrix from a binary file written by \p saveBinary.
+*
+*  The matrix takes the dimensions stored in the file. Large files are read in chunks by several threads.
+*
+*  \param filename Name of file to load from.
+*/
+template<typename T>
+void Matrix<T>::loadBinary(const std::string& filename)
+{
+   static_assert(std::is_trivially_copyable<T>::value, "Binary files require trivially copyable elements");
+   backend::BinaryFile file(filename, sizeof(T));
+   file.requireRank(2);
+
+   releaseDeviceAllocations();
+
+   // The old contents are overwritten, only reallocate on a size change
+   if (m_data.size() != file.count())
+      container_type(file.count()).swap(m_data);
+
+   file.read(m_data.data());
+   m_rows = file.dim(0);
+   m_cols = file.dim(1);
+   m_dataChanged = true;
+}
+
+
 /*!
 * Private helper to swap any two elements of same type
 */
@@ -145,7 +190,9 @@ void Matrix<T>::item_swap(Type &t1, Type &t2)
 template<typename T>
 Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_type _cols)
 : m_rows(_rows), m_cols(_cols), m_data(_rows * _cols), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(true)
-{}
+{
+   backend::fillHostMemory(m_data.data(), m_data.size(), T{});
+}
 
 /*!
  *  Constructor, used to allocate memory ($_rows * _cols$). With a value ot initialize all elements.
@@ -155,8 +202,29 @@ Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_
  */
 template<typename T>
 Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_type _cols, const T& val)
-: m_rows(_rows), m_cols(_cols),m_data(m_rows * m_cols, val), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(true)
-{}
+: m_rows(_rows), m_cols(_cols),m_data(m_rows * m_cols), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(true)
+{
+   backend::fillHostMemory(m_data.data(), m_data.size(), val);
+}
+
+/*!
+ *  Constructor, used to allocate memory ($_rows * _cols$) without initializing the elements.
+ *  Meant for results that are completely overwritten before they are read.
+ * \param _rows Number of rows in the matrix.
+ * \param _cols Number of columns in the matrix.
+ */
+template<typename T>
+Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_type _cols, uninitialized_t)
+: m_rows(_rows), m_cols(_cols), m_data(_rows * _cols), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(true)
+{
+}
+
+/*
+ * Default constructor of an empty matrix.
+ */
+template<typename T>
+Matrix<T>::Matrix()
+: m_rows(0), m_cols(0), m_data(), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(false) {}
 
 /*!
  *  Constructor, used to allocate memory ($_rows * _cols$) with a vector to initialize all elements.
@@ -169,7 +237,7 @@ template<typename T>
 Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_type _cols, const std::vector<T>& vals):
 	m_rows(_rows),
 	m_cols(_cols),
-	m_data(vals),
+	m_data(vals.begin(), vals.end()),
 	m_dataChanged(false),
 	m_transpose_matrix(0),
 	m_noValidDeviceCopy(true),
@@ -190,7 +258,7 @@ template<typename T>
 Matrix<T>::Matrix(typename Matrix<T>::size_type _rows, typename Matrix<T>::size_type _cols, std::vector<T>&& vals):
 	m_rows(_rows),
 	m_cols(_cols),
-	m_data(std::move(vals)),
+	m_data(std::make_move_iterator(vals.begin()), std::make_move_iterator(vals.end())),
 	m_dataChanged(false),
 	m_transpose_matrix(0),
 	m_noValidDeviceCopy(true),
@@ -212,9 +280,53 @@ Matrix<T>::Matrix(const Matrix<T>& copy): m_noValidDeviceCopy(true), m_valid(tru
    copy.updateHost();
    this->m_rows = copy.m_rows;
    this->m_cols = copy.m_cols;
-   this->m_data= copy.m_data;
-   this->m_transpose_matrix = copy.m_transpose_matrix;
-   this->m_dataChanged = copy.m_dataChanged;
+   this->m_data.resize(copy.m_data.size());
+   backend::copyHostMemory(copy.m_data.data(), copy.m_data.size(), this->m_data.data());
+   this->m_transpose_matrix = 0;
+   this->m_dataChanged = false;
+}
+
+/*!
+ *  Move Constructor, takes over the storage of another matrix without copying the elements.
+ * \param other Matrix that is moved from, it is left empty.
+ */
+template<typename T>
+Matrix<T>::Matrix(Matrix<T>&& other)
+: m_rows(0), m_cols(0), m_data(), m_dataChanged(false), m_transpose_matrix(0), m_noValidDeviceCopy(true), m_valid(true)
+{
+   this->swap(other);
+}
+
+// Initializers
+
+template<typename T>
+void Matrix<T>::init(size_type _rows, size_type _cols)
+{
+  if (!this->m_data.size())
+  {
+    if (_rows * _cols < 1)
+      SKEPU_ERROR("The container size must be positive.");
+    this->m_rows = _rows;
+    this->m_cols = _cols;
+    this->m_data.resize(this->m_rows * this->m_cols);
+    backend::fillHostMemory(this->m_data.data(), this->m_data.size(), T{});
+  }
+  else SKEPU_ERROR("Container is already initialized");
+}
+
+template<typename T>
+void Matrix<T>::init(size_type _rows, size_type _cols, const T& val)
+{
+  if (!this->m_data.size())
+  {
+    if (_rows * _cols < 1)
+      SKEPU_ERROR("The container size must be positive.");
+    this->m_rows = _rows;
+    this->m_cols = _cols;
+    this->m_data.resize(this->m_rows * this->m_cols);
+    backend::fillHostMemory(this->m_data.data(), this->m_data.size(), val);
+  }
+  else SKEPU_ERROR("Container is already initialized");
 }
 
 
@@ -231,15 +343,36 @@ Matrix<T>::Matrix(const Matrix<T>& copy): m_noValidDeviceCopy(true), m_valid(tru
 template <typename T>
 Matrix<T>& Matrix<T>::operator=(const Matrix<T>& other)
 {
-   if(*this == other)
+   if(this == &other)
       return *this;
    
    other.updateHost();
    invalidateDeviceData();
 
-   m_data = other.m_data;
+   if (m_data.size() != other.m_data.size())
+      container_type(other.m_data.size()).swap(m_data);
+   backend::copyHostMemory(other.m_data.data(), other.m_data.size(), m_data.data());
    m_rows = other.m_rows;
    m_cols = other.m_cols;
+   m_dataChanged = true;
+   return *this;
+}
+
+/*!
+ *  move matrix, takes over the storage of \p other which is left empty
+ */
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix<T>&& other)
+{
+   if(this == &other)
+      return *this;
+   
+   releaseDeviceAllocations();
+   container_type().swap(m_data);
+   m_rows = 0;
+   m_cols = 0;
+   
+   this->swap(other);
    return *this;
 }
 
@@ -427,7 +560,99 @@ void Matrix<T>::swap(Matrix<T>& from)
 
    item_swap<typename Matrix<T>::size_type>(m_rows, from.m_rows);
    item_swap<typename Matrix<T>::size_type>(m_cols, from.m_cols);
-   item_swap<typename Matrix::container_type>(m_data, from.m_data);
+   item_swap<Matrix<T>*>(m_transpose_matrix, from.m_transpose_matrix);
+   item_swap<bool>(m_dataChanged, from.m_dataChanged);
+   m_data.swap(from.m_data);
+}
+
+/*!
+ *  Changes the size of the matrix to ($_rows * _cols$), keeping the elements in row-major order.
+ *  Added elements are left uninitialized.
+ */
+template <typename T>
+void Matrix<T>::resize(size_type _rows, size_type _cols)
+{
+   const size_type size = _rows * _cols;
+   if (size < 1)
+      SKEPU_ERROR("The container size must be positive.");
+
+   if (size != m_data.size())
+   {
+      updateHostAndReleaseDeviceAllocations();
+      container_type data(size);
+      backend::copyHostMemory(m_data.data(), std::min(size, m_data.size()), data.data());
+      m_data.swap(data);
+   }
+   m_rows = _rows;
+   m_cols = _cols;
+   m_dataChanged = true;
+}
+
+/*!
+ *  Changes the size of the matrix to ($_rows * _cols$), keeping the elements in row-major order.
+ *  Added elements are set to \p val.
+ */
+template <typename T>
+void Matrix<T>::resize(size_type _rows, size_type _cols, const T& val)
+{
+   const size_type old = m_data.size();
+   resize(_rows, _cols);
+   if (m_data.size() > old)
+      backend::fillHostMemory(m_data.data() + old, m_data.size() - old, val);
+}
+
+/*!
+ *  Replaces the contents with \p data, which must hold ($_rows * _cols$) elements. The storage is taken
+ *  over without copying.
+ */
+template <typename T>
+void Matrix<T>::adopt(size_type _rows, size_type _cols, container_type&& data)
+{
+   if (data.size() != _rows * _cols)
+      SKEPU_ERROR("The adopted storage does not match the matrix size.");
+
+   releaseDeviceAllocations();
+   m_data.swap(data);
+   container_type().swap(data);
+   m_rows = _rows;
+   m_cols = _cols;
+   m_dataChanged = true;
+}
+
+/*!
+ *  Gives up the storage of the matrix without copying it, the matrix is left empty.
+ */
+template <typename T>
+typename Matrix<T>::container_type Matrix<T>::release()
+{
+   updateHostAndReleaseDeviceAllocations();
+   container_type data;
+   data.swap(m_data);
+   m_rows = 0;
+   m_cols = 0;
+   m_dataChanged = true;
+   return data;
+}
+
+/*!
+ *  Moves the host data to the pages given by \p placement. Interleave and node placements migrate the pages
+ *  in place where possible, otherwise the data is copied into storage allocated under the new placement.
+ */
+template <typename T>
+void Matrix<T>::place(Placement placement)
+{
+   if (m_data.empty())
+      return;
+
+   updateHostAndReleaseDeviceAllocations();
+
+   if (placement.policy != Placement::Policy::FirstTouch && backend::bindHostMemory(m_data.data(), m_data.size() * sizeof(T), placement, true))
+      return;
+
+   PlacementScope scope(placement);
+   container_type data(m_data.size());
+   backend::copyHostMemory(m_data.data(), m_data.size(), data.data());
+   m_data.swap(data);
 }
 
 ///////////////////////////////////////////////
@@ -0,0 +1,47 @@
+/*! \file reduce_lazy.inl
+*  \brief Contains the definitions of the fused (lazy) member functions for the Reduce skeleton.
+ */
+
+#ifdef SKEPU_LAZY
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Performs the Reduction on a range produced by pending lazy calls. The pending calls are executed and each
+		 *  block is reduced right after it has been produced, while it is still in cache. The partial results of
+		 *  each worker are then reduced on the CPU.
+		 */
+		template<typename ReduceFunc, typename CUDAKernel, typename CLKernel>
+		template<typename Iterator>
+		typename ReduceFunc::Ret Reduce1D<ReduceFunc, CUDAKernel, CLKernel>
+		::Lazy(size_t size, T &res, Iterator arg)
+		{
+			DEBUG_TEXT_LEVEL1("Lazy Reduce (Vector): size= " << size << "\n");
+			
+			LazyQueue &queue = LazyQueue::instance();
+			std::vector<T> parsums(queue.workers());
+			std::vector<char> used(queue.workers(), false);
+			
+			queue.flush([&](size_t first, size_t last, size_t worker)
+			{
+				T parsum = arg(first);
+				for (size_t i = first + 1; i < last; ++i)
+					parsum = ReduceFunc::CPU(parsum, arg(i));
+				
+				parsums[worker] = used[worker] ? ReduceFunc::CPU(parsums[worker], parsum) : parsum;
+				used[worker] = true;
+			});
+			
+			for (size_t worker = 0; worker < parsums.size(); ++worker)
+				if (used[worker])
+					res = ReduceFunc::CPU(res, parsums[worker]);
+			
+			return res;
+		}
+		
+	} // end namespace backend
+} // end namespace skepu
+
+#endif
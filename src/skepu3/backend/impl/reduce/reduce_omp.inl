@@ -70,6 +70,7 @@ namespace skepu
 					parsums[myid] = ReduceFunc::OMP(parsums[myid], arg(i));
 			}
 			
+			TraceScope tail(TracePhase::ReduceTail, this, *this->m_selected_spec, parsums.size(), parsums.size() * sizeof(T));
 			for (auto& el : parsums)
 				res = ReduceFunc::OMP(res, el);
 			
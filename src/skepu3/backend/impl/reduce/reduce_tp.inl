@@ -0,0 +1,75 @@
+/*! \file reduce_tp.inl
+*  \brief Contains the definitions of TaskPool specific member functions for the Reduce skeleton.
+ */
+
+#ifdef SKEPU_TASKPOOL
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Performs the Reduction on a whole Matrix. Returns a \em SkePU vector of reduction result.
+		 *  Using the \em TaskPool as backend, rows are distributed among the pool threads.
+		 */
+		template<typename ReduceFunc, typename CUDAKernel, typename CLKernel>
+		void Reduce1D<ReduceFunc, CUDAKernel, CLKernel>
+		::TP(Vector<T> &res, Matrix<T>& arg)
+		{
+			const size_t rows = arg.total_rows();
+			const size_t cols = arg.total_cols();
+			
+			DEBUG_TEXT_LEVEL1("TaskPool Reduce (Matrix 1D): rows = " << rows << ", cols = " << cols << "\n");
+			
+			// Make sure we are properly synched with device data
+			arg.updateHost();
+			T *data = arg.getAddress();
+			
+			TaskPool::instance().parallelFor(0, rows, this->m_selected_spec->CPUThreads(), [&](size_t first, size_t last)
+			{
+				for (size_t row = first; row < last; ++row)
+				{
+					T parsum = this->m_start;
+					size_t base = row * cols;
+					for (size_t col = 0; col < cols; ++col)
+						parsum = ReduceFunc::CPU(parsum, data[base + col]);
+					res(row) = parsum;
+				}
+			}, this->m_selected_spec->CPUChunkSize());
+		}
+		
+		
+		/*!
+		 *  Performs the Reduction on a range of elements. Returns a scalar result. Each task reduces its own
+		 *  blocks, the partial results of the blocks are then combined in order.
+		 */
+		template<typename ReduceFunc, typename CUDAKernel, typename CLKernel>
+		template<typename Iterator>
+		typename ReduceFunc::Ret Reduce1D<ReduceFunc, CUDAKernel, CLKernel>
+		::TP(size_t size, T &res, Iterator arg)
+		{
+			DEBUG_TEXT_LEVEL1("TaskPool Reduce (Vector): size= " << size << "\n");
+			
+			// Make sure we are properly synched with device data
+			arg.getParent().updateHost();
+			
+			if (size == 0)
+				return res;
+			
+			T total = TaskPool::instance().parallelReduce<T>(0, size, this->m_selected_spec->CPUThreads(), [&](size_t first, size_t last)
+			{
+				T parsum = arg(first);
+				for (size_t i = first + 1; i < last; ++i)
+					parsum = ReduceFunc::CPU(parsum, arg(i));
+				return parsum;
+			}, [](T a, T b) { return ReduceFunc::CPU(a, b); }, this->m_selected_spec->CPUChunkSize());
+			
+			res = ReduceFunc::CPU(res, total);
+			
+			return res;
+		}
+		
+	} // end namespace backend
+} // end namespace skepu
+
+#endif
@@ -0,0 +1,52 @@
+/*! \file reducebykey_cpu.inl
+ *  \brief Contains the definitions of CPU specific member functions for the ReduceByKey and Histogram skeletons.
+ */
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Performs the ReduceByKey on the \em CPU, reducing every element into its bin in order.
+		 */
+		template<typename KeyFunc, typename RedFunc, typename CUDAKernel, typename CLKernel>
+		void ReduceByKey<KeyFunc, RedFunc, CUDAKernel, CLKernel>
+		::CPU(T *res, size_t bins, const T *arg, size_t size)
+		{
+			DEBUG_TEXT_LEVEL1("CPU ReduceByKey: size = " << size << ", bins = " << bins << "\n");
+			
+			for (size_t k = 0; k < bins; ++k)
+				res[k] = this->m_start;
+			
+			for (size_t i = 0; i < size; ++i)
+			{
+				const size_t k = static_cast<size_t>(KeyFunc::CPU(arg[i]));
+				if (k < bins)
+					res[k] = RedFunc::CPU(res[k], arg[i]);
+			}
+		}
+		
+		
+		/*!
+		 *  Performs the Histogram on the \em CPU.
+		 */
+		template<typename KeyFunc, typename CUDAKernel, typename CLKernel>
+		template<typename C>
+		void Histogram<KeyFunc, CUDAKernel, CLKernel>
+		::CPU(C *res, size_t bins, const T *arg, size_t size)
+		{
+			DEBUG_TEXT_LEVEL1("CPU Histogram: size = " << size << ", bins = " << bins << "\n");
+			
+			for (size_t k = 0; k < bins; ++k)
+				res[k] = 0;
+			
+			for (size_t i = 0; i < size; ++i)
+			{
+				const size_t k = static_cast<size_t>(KeyFunc::CPU(arg[i]));
+				if (k < bins)
+					res[k] += 1;
+			}
+		}
+	
+	} // end namespace backend
+} // end namespace skepu
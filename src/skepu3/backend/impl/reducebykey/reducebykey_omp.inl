@@ -0,0 +1,216 @@
+/*! \file reducebykey_omp.inl
+ *  \brief Contains the definitions of OpenMP specific member functions for the ReduceByKey and Histogram skeletons.
+ */
+
+#ifdef SKEPU_OPENMP
+
+#include <omp.h>
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Reduces value(x) for the elements x of \p arg into res(key(x)) using \em OpenMP, starting every bin from \p start
+		 *  and combining in the order of the elements. When \p Dense, \p start is an identity of \p combine.
+		 *
+		 *  When a copy of the bins fits in \p SKEPU_REDUCEBYKEY_PRIVATE_BYTES, the elements are split in contiguous ranges,
+		 *  each reduced into private bins (the first range directly into the result). The bins are then merged pairwise
+		 *  in a tree, every round in parallel over the pairs and bins. Otherwise the keys are split in partitions of about
+		 *  that size: the elements are counted and scattered by partition, keeping their order, and every partition is
+		 *  then reduced into its part of the result by a single thread.
+		 */
+		template<bool Dense, typename V, typename E, typename Key, typename Value, typename Combine>
+		void groupedReduceOMP(V *res, size_t bins, const E *arg, size_t size, V start, size_t maxThreads, Key key, Value value, Combine combine)
+		{
+			if (bins * sizeof(V) <= SKEPU_REDUCEBYKEY_PRIVATE_BYTES)
+			{
+				// Every thread processes at least as many elements as it merges bins
+				const size_t numThreads = std::max<size_t>(1, std::min<size_t>(maxThreads, size / std::max<size_t>(bins, 1)));
+				std::vector<V> privateBins((numThreads - 1) * bins);
+				std::vector<char> privateTouched(Dense ? 0 : (numThreads - 1) * bins);
+				
+				auto binsOf = [&](size_t t) { return (t == 0) ? res : privateBins.data() + (t - 1) * bins; };
+				auto touchedOf = [&](size_t t) { return privateTouched.data() + (t - 1) * bins; };
+
+#pragma omp parallel num_threads(numThreads)
+				{
+#pragma omp for schedule(static)
+					for (size_t t = 0; t < numThreads; ++t)
+					{
+						V *own = binsOf(t);
+						const size_t first = size * t / numThreads;
+						const size_t last = size * (t + 1) / numThreads;
+						
+						if (Dense || t == 0)
+						{
+							for (size_t k = 0; k < bins; ++k)
+								own[k] = start;
+							
+							for (size_t i = first; i < last; ++i)
+							{
+								const size_t k = key(arg[i]);
+								if (k < bins)
+									own[k] = combine(own[k], value(arg[i]));
+							}
+						}
+						else
+						{
+							// Bins not yet reached hold no value, as there may be no identity to start from
+							char *touched = touchedOf(t);
+							for (size_t k = 0; k < bins; ++k)
+								touched[k] = 0;
+							
+							for (size_t i = first; i < last; ++i)
+							{
+								const size_t k = key(arg[i]);
+								if (k >= bins)
+									continue;
+								
+								if (touched[k])
+									own[k] = combine(own[k], value(arg[i]));
+								else
+								{
+									own[k] = value(arg[i]);
+									touched[k] = 1;
+								}
+							}
+						}
+					}
+					
+					// Tree merge, the bins of thread t + stride are merged into those of thread t
+					for (size_t stride = 1; stride < numThreads; stride *= 2)
+					{
+						const size_t pairs = (numThreads - stride - 1) / (2 * stride) + 1;
+
+#pragma omp for schedule(static)
+						for (size_t j = 0; j < pairs * bins; ++j)
+						{
+							const size_t t = (j / bins) * 2 * stride;
+							const size_t k = j % bins;
+							V *own = binsOf(t);
+							const V *other = binsOf(t + stride);
+							
+							if (Dense)
+								own[k] = combine(own[k], other[k]);
+							else if (touchedOf(t + stride)[k])
+							{
+								if (t == 0 || touchedOf(t)[k])
+									own[k] = combine(own[k], other[k]);
+								else
+								{
+									own[k] = other[k];
+									touchedOf(t)[k] = 1;
+								}
+							}
+						}
+					}
+				}
+				return;
+			}
+			
+			const size_t numThreads = std::max<size_t>(1, std::min<size_t>(maxThreads, size));
+			size_t span = std::max<size_t>(1, SKEPU_REDUCEBYKEY_PRIVATE_BYTES / sizeof(V));
+			
+			// Enough partitions to balance the reduction between the threads
+			span = std::min(span, std::max<size_t>(1, bins / (4 * numThreads)));
+			const size_t numParts = (bins + span - 1) / span;
+			
+			// counts(t, p) is turned into the offset of the elements of thread t in partition p
+			std::vector<size_t> counts(numThreads * numParts, 0);
+			std::vector<size_t> partStart(numParts + 1);
+			std::vector<std::pair<size_t, V>> scattered;
+
+#pragma omp parallel num_threads(numThreads)
+			{
+#pragma omp for schedule(static)
+				for (size_t t = 0; t < numThreads; ++t)
+				{
+					size_t *count = counts.data() + t * numParts;
+					for (size_t i = size * t / numThreads; i < size * (t + 1) / numThreads; ++i)
+					{
+						const size_t k = key(arg[i]);
+						if (k < bins)
+							++count[k / span];
+					}
+				}
+
+#pragma omp single
+				{
+					size_t offset = 0;
+					for (size_t p = 0; p < numParts; ++p)
+					{
+						partStart[p] = offset;
+						for (size_t t = 0; t < numThreads; ++t)
+						{
+							const size_t count = counts[t * numParts + p];
+							counts[t * numParts + p] = offset;
+							offset += count;
+						}
+					}
+					partStart[numParts] = offset;
+					scattered.resize(offset);
+				}
+
+#pragma omp for schedule(static)
+				for (size_t t = 0; t < numThreads; ++t)
+				{
+					size_t *offset = counts.data() + t * numParts;
+					for (size_t i = size * t / numThreads; i < size * (t + 1) / numThreads; ++i)
+					{
+						const size_t k = key(arg[i]);
+						if (k < bins)
+							scattered[offset[k / span]++] = std::make_pair(k, value(arg[i]));
+					}
+				}
+
+#pragma omp for schedule(dynamic)
+				for (size_t p = 0; p < numParts; ++p)
+				{
+					const size_t last = std::min(bins, (p + 1) * span);
+					for (size_t k = p * span; k < last; ++k)
+						res[k] = start;
+					
+					for (size_t j = partStart[p]; j < partStart[p + 1]; ++j)
+						res[scattered[j].first] = combine(res[scattered[j].first], scattered[j].second);
+				}
+			}
+		}
+		
+		
+		/*!
+		 *  Performs the ReduceByKey using \em OpenMP as backend.
+		 */
+		template<typename KeyFunc, typename RedFunc, typename CUDAKernel, typename CLKernel>
+		void ReduceByKey<KeyFunc, RedFunc, CUDAKernel, CLKernel>
+		::OMP(T *res, size_t bins, const T *arg, size_t size)
+		{
+			DEBUG_TEXT_LEVEL1("OpenMP ReduceByKey: size = " << size << ", bins = " << bins << "\n");
+			
+			groupedReduceOMP<false>(res, bins, arg, size, this->m_start, this->m_selected_spec->CPUThreads(),
+				[](const T &x) { return static_cast<size_t>(KeyFunc::OMP(x)); },
+				[](const T &x) { return x; },
+				[](T a, T b) { return RedFunc::OMP(a, b); });
+		}
+		
+		
+		/*!
+		 *  Performs the Histogram using \em OpenMP as backend.
+		 */
+		template<typename KeyFunc, typename CUDAKernel, typename CLKernel>
+		template<typename C>
+		void Histogram<KeyFunc, CUDAKernel, CLKernel>
+		::OMP(C *res, size_t bins, const T *arg, size_t size)
+		{
+			DEBUG_TEXT_LEVEL1("OpenMP Histogram: size = " << size << ", bins = " << bins << "\n");
+			
+			groupedReduceOMP<true>(res, bins, arg, size, C(0), this->m_selected_spec->CPUThreads(),
+				[](const T &x) { return static_cast<size_t>(KeyFunc::OMP(x)); },
+				[](const T &) { return C(1); },
+				[](C a, C b) { return C(a + b); });
+		}
+	
+	} // end namespace backend
+} // end namespace skepu
+
+#endif // SKEPU_OPENMP
@@ -7,19 +7,35 @@ namespace skepu
 	namespace backend
 	{
 		template<typename ScanFunc, typename CUDAScan, typename CUDAScanUpdate, typename CUDAScanAdd, typename CLKernel>
-		template<typename OutIterator, typename InIterator>
+		template<typename OutIterator, typename InIterator, typename Segments>
 		void Scan<ScanFunc, CUDAScan, CUDAScanUpdate, CUDAScanAdd, CLKernel>
-		::CPU(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial)
+		::CPU(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial, Segments segments)
 		{
 			// Make sure we are properly synched with device data
 			res.getParent().invalidateDeviceData();
 			arg.getParent().updateHost();
+			segments.updateHost();
 			
-			// Process first element here
-			*res = (mode == ScanMode::Inclusive) ? *arg++ : initial;
-			
-			for (size_t i = 1; i < size; ++i)
-				res(i) = ScanFunc::CPU(res(i-1), arg(i-1));
+			// Every element is read before the result at its index is written, so res may alias arg
+			auto isHead = segments.from(0);
+			T running = initial;
+			for (size_t i = 0; i < size; ++i)
+			{
+				const T value = arg(i);
+				const bool head = (i == 0) || isHead(i);
+				if (mode == ScanMode::Inclusive)
+				{
+					running = head ? value : ScanFunc::CPU(running, value);
+					res(i) = running;
+				}
+				else
+				{
+					if (head)
+						running = initial;
+					res(i) = running;
+					running = ScanFunc::CPU(running, value);
+				}
+			}
 		}
 		
 	}
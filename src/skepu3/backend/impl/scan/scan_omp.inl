@@ -1,68 +1,157 @@
-/*! \file scan_cpu.inl
- *  \brief Contains the definitions of CPU specific member functions for the Scan skeleton.
+/*! \file scan_omp.inl
+ *  \brief Contains the definitions of OpenMP specific member functions for the Scan skeleton.
  */
 
 #ifdef SKEPU_OPENMP
 
+#include <omp.h>
+
 namespace skepu
 {
 	namespace backend
 	{
 		template<typename ScanFunc, typename CUDAScan, typename CUDAScanUpdate, typename CUDAScanAdd, typename CLKernel>
-		template<typename OutIterator, typename InIterator>
+		template<typename OutIterator, typename InIterator, typename Segments>
 		void Scan<ScanFunc, CUDAScan, CUDAScanUpdate, CUDAScanAdd, CLKernel>
-		::OMP(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial)
+		::OMP(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial, Segments segments)
 		{
 			// Make sure we are properly synched with device data
 			res.getParent().invalidateDeviceData();
 			arg.getParent().updateHost();
+			segments.updateHost();
 			
-			// Setup parameters needed to parallelize with OpenMP
-			omp_set_num_threads(std::min(this->m_selected_spec->CPUThreads(), size / 2));
-			const size_t nthr = omp_get_max_threads();
-			const size_t q = size / nthr;
-			const size_t rest = size % nthr;
+			if (size == 0)
+				return;
 			
-			// Array to store partial thread results in.
-			std::vector<T> offset_array(nthr);
+			// No more threads than blocks, a single block is scanned by the calling thread alone
+			const size_t block = SKEPU_SCAN_BLOCK;
+			const size_t nthr = std::max<size_t>(1, std::min<size_t>(this->m_selected_spec->CPUThreads(), (size + block - 1) / block));
 			
-			// Process first element here
-			*res = (mode == ScanMode::Inclusive) ? *arg++ : initial;
+			// Without segments, the first element of an inclusive scan is its own result
+			size_t begin = 0;
+			T carry = initial;
+			if (!Segments::segmented && mode == ScanMode::Inclusive)
+			{
+				carry = arg(0);
+				res(0) = carry;
+				begin = 1;
+			}
 			
-#pragma omp parallel
+			std::vector<std::pair<bool, T>> partials(nthr);
+			std::vector<T> carries(nthr);
+			
+			// Reduce-then-scan over rounds of one block per thread. Every thread reduces its block, the block
+			// results are scanned by one thread, and every thread scans its block from the carry while it is
+			// still in cache, so that the input is read from memory once. A single thread scans directly.
+#pragma omp parallel num_threads(nthr)
 			{
-				const size_t myid = omp_get_thread_num();
-				const size_t first = myid * q;
-				const size_t last = (myid + 1) * q + ((myid == nthr - 1) ? rest : 0);
-				
-				// First let each thread make their own scan and saved the result in a partial result array.
-				if (myid != 0) res(first) = arg(first-1);
-				for (size_t i = first + 1; i < last; ++i)
+				const size_t nt = omp_get_num_threads(), tid = omp_get_thread_num();
+				for (size_t round = begin; round < size; round += nt * block)
 				{
-					res(i) = ScanFunc::OMP(res(i-1), arg(i-1));
-				}
-				offset_array[myid] = res(last-1);
-				
+					const size_t first = std::min(round + tid * block, size), last = std::min(first + block, size);
+					if (nt == 1)
+					{
+						carry = this->scanBlock_OMP(first, last, res, arg, mode, initial, carry, segments);
+						continue;
+					}
+					
+					if (first < last)
+						partials[tid] = this->reduceBlock_OMP(first, last, arg, mode, initial, segments);
+					
 #pragma omp barrier
-				
-				// Let the master thread scan the partial result array
-#pragma omp master
-				for (size_t i = 1; i < nthr; ++i)
+					
+#pragma omp single
+					for (size_t t = 0; t < nt && round + t * block < size; ++t)
+					{
+						carries[t] = carry;
+						carry = partials[t].first ? partials[t].second : ScanFunc::OMP(carry, partials[t].second);
+					}
+					
+					if (first < last)
+						this->scanBlock_OMP(first, last, res, arg, mode, initial, carries[tid], segments);
+				}
+			}
+		}
+		
+		
+		/*!
+		 *  Reduces the block [first, last), from its last segment head if any. The first of the result tells
+		 *  whether the block has a head, in which case the carry out of the block does not depend on the carry in.
+		 */
+		template<typename ScanFunc, typename CUDAScan, typename CUDAScanUpdate, typename CUDAScanAdd, typename CLKernel>
+		template<typename InIterator, typename Segments>
+		std::pair<bool, typename ScanFunc::Ret> Scan<ScanFunc, CUDAScan, CUDAScanUpdate, CUDAScanAdd, CLKernel>
+		::reduceBlock_OMP(size_t first, size_t last, InIterator arg, ScanMode mode, T initial, const Segments &segments)
+		{
+			if (Segments::segmented)
+			{
+				auto isHead = segments.from(first);
+				bool anyHead = false;
+				T sum = arg(first);
+				for (size_t i = first; i < last; ++i)
 				{
-					offset_array[i] = ScanFunc::OMP(offset_array[i-1], offset_array[i]);
+					const T value = arg(i);
+					if (isHead(i))
+					{
+						anyHead = true;
+						sum = (mode == ScanMode::Inclusive) ? value : ScanFunc::OMP(initial, value);
+					}
+					else if (i != first)
+						sum = ScanFunc::OMP(sum, value);
 				}
-				
-#pragma omp barrier
-				
-				if (myid != 0)
+				return {anyHead, sum};
+			}
+			
+			T sum = arg(first);
+			for (size_t i = first + 1; i < last; ++i)
+				sum = ScanFunc::OMP(sum, arg(i));
+			return {false, sum};
+		}
+		
+		
+		/*!
+		 *  Scans the block [first, last) starting from \p carry and returns the carry out of the block.
+		 *  Every element is read before the result at its index is written, so res may alias arg.
+		 */
+		template<typename ScanFunc, typename CUDAScan, typename CUDAScanUpdate, typename CUDAScanAdd, typename CLKernel>
+		template<typename OutIterator, typename InIterator, typename Segments>
+		typename ScanFunc::Ret Scan<ScanFunc, CUDAScan, CUDAScanUpdate, CUDAScanAdd, CLKernel>
+		::scanBlock_OMP(size_t first, size_t last, OutIterator res, InIterator arg, ScanMode mode, T initial, T carry, const Segments &segments)
+		{
+			if (Segments::segmented)
+			{
+				auto isHead = segments.from(first);
+				for (size_t i = first; i < last; ++i)
 				{
-					// Add the scanned partial results to each threads work batch.
-					for (size_t i = first; i < last; ++i)
+					const T value = arg(i);
+					const bool head = isHead(i);
+					if (mode == ScanMode::Inclusive)
+					{
+						carry = head ? value : ScanFunc::OMP(carry, value);
+						res(i) = carry;
+					}
+					else
 					{
-						res(i) = ScanFunc::OMP(res(i), offset_array[myid-1]);
+						if (head)
+							carry = initial;
+						res(i) = carry;
+						carry = ScanFunc::OMP(carry, value);
 					}
 				}
+				return carry;
 			}
+			
+			if (mode == ScanMode::Inclusive)
+				for (size_t i = first; i < last; ++i)
+					res(i) = carry = ScanFunc::OMP(carry, arg(i));
+			else
+				for (size_t i = first; i < last; ++i)
+				{
+					const T value = arg(i);
+					res(i) = carry;
+					carry = ScanFunc::OMP(carry, value);
+				}
+			return carry;
 		}
 		
 	}
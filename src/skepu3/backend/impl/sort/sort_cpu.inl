@@ -0,0 +1,72 @@
+/*! \file sort_cpu.inl
+ *  \brief Contains the definitions of CPU specific member functions for the Sort skeleton.
+ */
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Row \p row of the values permuted along with the keys, none when sorting keys only.
+		 */
+		template<typename V>
+		V *sortValuesRow(V *values, size_t row, size_t cols)
+		{
+			return values + row * cols;
+		}
+		
+		inline std::nullptr_t *sortValuesRow(std::nullptr_t *, size_t, size_t)
+		{
+			return nullptr;
+		}
+		
+		
+		/*!
+		 *  Stably sorts a sequence of keys.
+		 */
+		template<typename T, typename Less>
+		void stableSortRow(T *keys, std::nullptr_t *, size_t size, Less less)
+		{
+			std::stable_sort(keys, keys + size, less);
+		}
+		
+		/*!
+		 *  Stably sorts a sequence of keys, permuting the values along with them.
+		 */
+		template<typename T, typename V, typename Less>
+		void stableSortRow(T *keys, V *values, size_t size, Less less)
+		{
+			std::vector<std::pair<T, V>> pairs(size);
+			for (size_t i = 0; i < size; ++i)
+				pairs[i] = std::make_pair(keys[i], values[i]);
+			
+			std::stable_sort(pairs.begin(), pairs.end(), [less](const std::pair<T, V> &a, const std::pair<T, V> &b)
+			{
+				return less(a.first, b.first);
+			});
+			
+			for (size_t i = 0; i < size; ++i)
+			{
+				keys[i] = pairs[i].first;
+				values[i] = pairs[i].second;
+			}
+		}
+		
+		
+		/*!
+		 *  Performs the Sort on the \em CPU, one row at a time.
+		 */
+		template<typename SortFunc, typename CUDAKernel, typename CLKernel>
+		template<typename V>
+		void Sort<SortFunc, CUDAKernel, CLKernel>
+		::CPU(T *keys, V *values, size_t rows, size_t cols)
+		{
+			DEBUG_TEXT_LEVEL1("CPU Sort: rows = " << rows << ", cols = " << cols << "\n");
+			
+			auto less = [](const T &a, const T &b) { return SortOrder<SortFunc>::lessCPU(a, b); };
+			for (size_t r = 0; r < rows; ++r)
+				stableSortRow(keys + r * cols, sortValuesRow(values, r, cols), cols, less);
+		}
+	
+	} // end namespace backend
+} // end namespace skepu
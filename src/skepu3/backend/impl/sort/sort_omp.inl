@@ -0,0 +1,288 @@
+/*! \file sort_omp.inl
+ *  \brief Contains the definitions of OpenMP specific member functions for the Sort skeleton.
+ */
+
+#ifdef SKEPU_OPENMP
+
+#include <omp.h>
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Finds how many elements of \p a are among the first \p diagonal elements of the stable merge of \p a and \p b.
+		 */
+		template<typename Item, typename Less>
+		size_t mergeCoRank(size_t diagonal, const Item *a, size_t sizeA, const Item *b, size_t sizeB, Less less)
+		{
+			size_t lo = (diagonal > sizeB) ? diagonal - sizeB : 0;
+			size_t hi = std::min(diagonal, sizeA);
+			
+			while (lo < hi)
+			{
+				size_t pivot = (lo + hi) / 2;
+				if (!less(b[diagonal - pivot - 1], a[pivot]))
+					lo = pivot + 1;
+				else
+					hi = pivot;
+			}
+			
+			return lo;
+		}
+		
+		
+		/*!
+		 *  Stably sorts \p data using \em OpenMP, by sorting one run per thread and merging the runs pairwise.
+		 *  Every merge round splits the output evenly between the threads, each finding its part of the input
+		 *  runs by a binary search along the merge path.
+		 */
+		template<typename Item, typename Less>
+		void parallelMergeSort(Item *data, size_t size, size_t numThreads, Less less)
+		{
+			std::vector<Item> buffer(size);
+			auto runStart = [=](size_t run) { return size * std::min(run, numThreads) / numThreads; };
+
+#pragma omp parallel num_threads(numThreads)
+			{
+#pragma omp for schedule(static)
+				for (size_t t = 0; t < numThreads; ++t)
+					std::stable_sort(data + runStart(t), data + runStart(t + 1), less);
+				
+				Item *src = data;
+				Item *dst = buffer.data();
+				
+				for (size_t width = 1; width < numThreads; width *= 2)
+				{
+#pragma omp for schedule(static)
+					for (size_t t = 0; t < numThreads; ++t)
+					{
+						const size_t outFirst = runStart(t);
+						const size_t outLast = runStart(t + 1);
+						
+						for (size_t run = 0; run < numThreads; run += 2 * width)
+						{
+							const size_t first = runStart(run);
+							const size_t middle = runStart(run + width);
+							const size_t last = runStart(run + 2 * width);
+							const size_t lo = std::max(outFirst, first);
+							const size_t hi = std::min(outLast, last);
+							if (lo >= hi)
+								continue;
+							
+							const Item *a = src + first;
+							const Item *b = src + middle;
+							const size_t aLo = mergeCoRank(lo - first, a, middle - first, b, last - middle, less);
+							const size_t aHi = mergeCoRank(hi - first, a, middle - first, b, last - middle, less);
+							std::merge(a + aLo, a + aHi, b + (lo - first - aLo), b + (hi - first - aHi), dst + lo, less);
+						}
+					}
+					
+					std::swap(src, dst);
+				}
+				
+				if (src != data)
+				{
+#pragma omp for schedule(static)
+					for (size_t i = 0; i < size; ++i)
+						data[i] = src[i];
+				}
+			}
+		}
+		
+		
+		/*!
+		 *  Stably sorts a sequence of keys using \em OpenMP.
+		 */
+		template<typename T, typename Less>
+		void parallelMergeSortRow(T *keys, std::nullptr_t *, size_t size, size_t numThreads, Less less)
+		{
+			parallelMergeSort(keys, size, numThreads, less);
+		}
+		
+		/*!
+		 *  Stably sorts a sequence of keys using \em OpenMP, permuting the values along with them.
+		 */
+		template<typename T, typename V, typename Less>
+		void parallelMergeSortRow(T *keys, V *values, size_t size, size_t numThreads, Less less)
+		{
+			std::vector<std::pair<T, V>> pairs(size);
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+			for (size_t i = 0; i < size; ++i)
+				pairs[i] = std::make_pair(keys[i], values[i]);
+			
+			parallelMergeSort(pairs.data(), size, numThreads, [less](const std::pair<T, V> &a, const std::pair<T, V> &b)
+			{
+				return less(a.first, b.first);
+			});
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+			for (size_t i = 0; i < size; ++i)
+			{
+				keys[i] = pairs[i].first;
+				values[i] = pairs[i].second;
+			}
+		}
+		
+		
+		/*!
+		 *  Moves \p data into the sorted order given by \p order, which holds the original index of every position.
+		 */
+		template<typename T, typename Entry>
+		void radixGather(T *data, const Entry *order, size_t size, size_t numThreads)
+		{
+			std::vector<T> sorted(size);
+
+#pragma omp parallel num_threads(numThreads)
+			{
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < size; ++i)
+					sorted[i] = data[order[i].index];
+
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < size; ++i)
+					data[i] = sorted[i];
+			}
+		}
+		
+		template<typename Entry>
+		void radixGather(std::nullptr_t *, const Entry *, size_t, size_t) {}
+		
+		
+		/*!
+		 *  Stably sorts a sequence by the arithmetic keys \p key returns using \em OpenMP, permuting the values
+		 *  along with it. This is an LSD radix sort on the encoded keys, eight bits per pass: every thread counts
+		 *  the digits of a contiguous range, the counts are turned into offsets ordered by digit and then thread,
+		 *  and every thread scatters its range. Passes where all keys have the same digit are skipped. The keys and
+		 *  values are only moved once, after the last pass.
+		 */
+		template<typename T, typename V, typename Key>
+		void parallelRadixSort(T *keys, V *values, size_t size, size_t numThreads, Key key)
+		{
+			using Radix = RadixKey<decltype(key(*keys))>;
+			using Bits = typename Radix::Bits;
+			struct Entry { Bits bits; size_t index; };
+			constexpr size_t Digits = 256;
+			
+			std::vector<Entry> entries(size), buffer(size);
+			std::vector<size_t> counts(numThreads * Digits);
+			Entry *src = entries.data();
+			Entry *dst = buffer.data();
+			bool skip = false;
+			
+			auto rangeStart = [=](size_t t) { return size * t / numThreads; };
+
+#pragma omp parallel num_threads(numThreads)
+			{
+#pragma omp for schedule(static)
+				for (size_t i = 0; i < size; ++i)
+					src[i] = Entry{Radix::encode(key(keys[i])), i};
+				
+				for (size_t shift = 0; shift < sizeof(Bits) * 8; shift += 8)
+				{
+#pragma omp for schedule(static)
+					for (size_t t = 0; t < numThreads; ++t)
+					{
+						size_t *count = counts.data() + t * Digits;
+						std::fill(count, count + Digits, 0);
+						for (size_t i = rangeStart(t); i < rangeStart(t + 1); ++i)
+							++count[(src[i].bits >> shift) & (Digits - 1)];
+					}
+
+#pragma omp single
+					{
+						size_t offset = 0;
+						skip = false;
+						for (size_t d = 0; d < Digits; ++d)
+						{
+							size_t total = 0;
+							for (size_t t = 0; t < numThreads; ++t)
+							{
+								const size_t count = counts[t * Digits + d];
+								counts[t * Digits + d] = offset;
+								offset += count;
+								total += count;
+							}
+							skip = skip || (total == size);
+						}
+					}
+					
+					if (!skip)
+					{
+#pragma omp for schedule(static)
+						for (size_t t = 0; t < numThreads; ++t)
+						{
+							size_t *offset = counts.data() + t * Digits;
+							for (size_t i = rangeStart(t); i < rangeStart(t + 1); ++i)
+								dst[offset[(src[i].bits >> shift) & (Digits - 1)]++] = src[i];
+						}
+
+#pragma omp single
+						std::swap(src, dst);
+					}
+				}
+			}
+			
+			radixGather(keys, src, size, numThreads);
+			radixGather(values, src, size, numThreads);
+		}
+		
+		
+		/*!
+		 *  Sorts a single sequence with several threads, by radix sort for arithmetic keys.
+		 */
+		template<typename SortFunc, typename T, typename V>
+		void parallelSortRow(T *keys, V *values, size_t size, size_t numThreads, std::true_type)
+		{
+			parallelRadixSort(keys, values, size, numThreads, [](const T &x) { return SortOrder<SortFunc>::keyOMP(x); });
+		}
+		
+		/*!
+		 *  Sorts a single sequence with several threads, by merge sort for comparators and other keys.
+		 */
+		template<typename SortFunc, typename T, typename V>
+		void parallelSortRow(T *keys, V *values, size_t size, size_t numThreads, std::false_type)
+		{
+			parallelMergeSortRow(keys, values, size, numThreads, [](const T &a, const T &b) { return SortOrder<SortFunc>::lessOMP(a, b); });
+		}
+		
+		
+		/*!
+		 *  Performs the Sort using \em OpenMP as backend. Matrices with at least as many rows as threads are sorted one
+		 *  row per thread, otherwise the rows are sorted in turn by all threads.
+		 */
+		template<typename SortFunc, typename CUDAKernel, typename CLKernel>
+		template<typename V>
+		void Sort<SortFunc, CUDAKernel, CLKernel>
+		::OMP(T *keys, V *values, size_t rows, size_t cols)
+		{
+			DEBUG_TEXT_LEVEL1("OpenMP Sort: rows = " << rows << ", cols = " << cols << "\n");
+			
+			const size_t maxThreads = this->m_selected_spec->CPUThreads();
+			auto less = [](const T &a, const T &b) { return SortOrder<SortFunc>::lessOMP(a, b); };
+			
+			if (rows > 1 && rows >= maxThreads)
+			{
+#pragma omp parallel for num_threads(maxThreads) schedule(dynamic)
+				for (size_t r = 0; r < rows; ++r)
+					stableSortRow(keys + r * cols, sortValuesRow(values, r, cols), cols, less);
+				return;
+			}
+			
+			const size_t numThreads = std::min(maxThreads, cols / SKEPU_SORT_GRAIN);
+			using useRadix = std::integral_constant<bool, byKey && RadixKey<typename SortFunc::Ret>::sortable>;
+			
+			for (size_t r = 0; r < rows; ++r)
+			{
+				if (numThreads > 1)
+					parallelSortRow<SortFunc>(keys + r * cols, sortValuesRow(values, r, cols), cols, numThreads, useRadix{});
+				else
+					stableSortRow(keys + r * cols, sortValuesRow(values, r, cols), cols, less);
+			}
+		}
+	
+	} // end namespace backend
+} // end namespace skepu
+
+#endif // SKEPU_OPENMP
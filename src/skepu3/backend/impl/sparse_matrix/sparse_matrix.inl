@@ -26,7 +26,7 @@ namespace skepu
  * \param transMatrix A boolean that specifies whether the matrix is a transpose matrix or a normal one.
  */
 template<typename T>
-SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T *values, size_t *rowPtr, size_t *colInd, bool dealloc, T zeroValue, bool transMatrix): m_rows(rows), m_cols(cols), m_nnz(nnz), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(dealloc), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_transMatrix(transMatrix)
+SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T *values, size_t *rowPtr, size_t *colInd, bool dealloc, T zeroValue, bool transMatrix): m_rows(rows), m_cols(cols), m_nnz(nnz), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(dealloc), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_layout(CSR_LAYOUT), m_sellChunk(8), m_sellSigma(256), m_blockHeight(4), m_blockWidth(4), m_layoutValid(false), m_transMatrix(transMatrix)
 {
 
 #if defined(SKEPU_CUDA) && defined(USE_PINNED_MEMORY)
@@ -71,7 +71,7 @@ SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T *values, s
  * \param zeroValue value that represent zero value for the given elements type, default will be initial value of that data type.
  */
 template<typename T>
-SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T min, T max, T zeroValue): m_rows(rows), m_cols(cols), m_nnz(nnz), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(true), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_transMatrix(false)
+SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T min, T max, T zeroValue): m_rows(rows), m_cols(cols), m_nnz(nnz), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(true), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_layout(CSR_LAYOUT), m_sellChunk(8), m_sellSigma(256), m_blockHeight(4), m_blockWidth(4), m_layoutValid(false), m_transMatrix(false)
 {
    if(m_rows<2 || m_cols<2)
    {
@@ -150,7 +150,7 @@ SparseMatrix<T>::SparseMatrix(size_t rows, size_t cols, size_t nnz, T min, T max
  * \param zeroValue value that represent zero value for the given elements type, default will be initial value of that data type.
  */
 template<typename T>
-SparseMatrix<T>::SparseMatrix(const std::string &inputfile, enum SparseFileFormat format, T zeroValue): m_rows(0), m_cols(0), m_nnz(0), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(true), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_transMatrix(false)
+SparseMatrix<T>::SparseMatrix(const std::string &inputfile, enum SparseFileFormat format, T zeroValue): m_rows(0), m_cols(0), m_nnz(0), m_values(NULL), m_rowPtr(NULL), m_colInd(NULL), m_dealloc(true), m_zeroValue(zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_layout(CSR_LAYOUT), m_sellChunk(8), m_sellSigma(256), m_blockHeight(4), m_blockWidth(4), m_layoutValid(false), m_transMatrix(false)
 {
    if(format==MATRIX_MARKET_FORMAT)
       readMTXFile(inputfile);
@@ -165,7 +165,7 @@ SparseMatrix<T>::SparseMatrix(const std::string &inputfile, enum SparseFileForma
  * \param copy sparse matrix which we are aopying from.
  */
 template<typename T>
-SparseMatrix<T>::SparseMatrix(const SparseMatrix<T> &copy): m_rows(copy.m_rows), m_cols(copy.m_cols), m_nnz(copy.m_nnz), m_dealloc(true), m_zeroValue(copy.m_zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_transMatrix(false)
+SparseMatrix<T>::SparseMatrix(const SparseMatrix<T> &copy): m_rows(copy.m_rows), m_cols(copy.m_cols), m_nnz(copy.m_nnz), m_dealloc(true), m_zeroValue(copy.m_zeroValue), m_transposeValid(false), m_colPtrCSC(NULL), m_rowIndCSC(NULL), m_valuesCSC(NULL), m_cscMatrix(NULL), m_layout(copy.m_layout), m_sellChunk(copy.m_sellChunk), m_sellSigma(copy.m_sellSigma), m_blockHeight(copy.m_blockHeight), m_blockWidth(copy.m_blockWidth), m_layoutValid(false), m_transMatrix(false)
 {
    backend::allocateHostMemory<T>(m_values, m_nnz); // can be pinned if enabled
 
@@ -226,6 +226,7 @@ void SparseMatrix<T>::operator=(const SparseMatrix<T> &other)
    m_valuesCSC = NULL;
    m_cscMatrix = NULL;
    m_transMatrix = false;
+   deleteLayoutFormats();
    
    if(other.m_values)
       std::copy(&(other.m_values[0]), &(other.m_values[m_nnz]), m_values);
@@ -433,6 +434,10 @@ template <typename T>
 void SparseMatrix<T>::resize(SparseMatrix<T> &copy, bool retainData)
 {
    bool copyData = (retainData && (m_values!=NULL));
+
+   // The caller changes the contents, so cached layouts are stale even when the size is kept
+   deleteLayoutFormats();
+
    if(m_nnz != copy.m_nnz)
    {
       deleteCSCFormat(); // First delete CSC format if generated already
@@ -0,0 +1,454 @@
+/*! \file sparse_matrix_layout.inl
+ *  \brief Contains the definitions of the SparseMatrix SELL-C-sigma and blocked CSR layouts and the row product kernels using them.
+ */
+
+namespace skepu
+{
+
+namespace backend
+{
+
+/*!
+ *  Computes one slice of a SELL-C-sigma row product. The inner loop runs across the \p C rows of the slice,
+ *  lanes that are shorter than the slice width are masked so padding never reaches \p add.
+ */
+template<size_t C, typename T, typename MultFunc, typename AddFunc>
+inline void sellSliceProduct(const SellMat<T> &A, size_t slice, const T *x, T *y, MultFunc &mult, AddFunc &add, T init)
+{
+   T acc[C];
+   size_t len[C];
+   const size_t *lengths = A.row_lengths + slice * C;
+
+   for(size_t lane = 0; lane < C; ++lane)
+   {
+      acc[lane] = init;
+      len[lane] = lengths[lane];
+   }
+
+   const size_t offset = A.slice_offsets[slice];
+   const size_t width = (A.slice_offsets[slice+1] - offset) / C;
+   const T *values = A.data + offset;
+   const size_t *cols = A.col_indices + offset;
+
+   for(size_t k = 0; k < width; ++k)
+   {
+      SKEPU_PRAGMA_SIMD
+      for(size_t lane = 0; lane < C; ++lane)
+      {
+         T prod = mult(values[k * C + lane], x[cols[k * C + lane]]);
+         acc[lane] = (k < len[lane]) ? add(acc[lane], prod) : acc[lane];
+      }
+   }
+
+   const size_t *perm = A.row_perm + slice * C;
+   for(size_t lane = 0; lane < C; ++lane)
+      if(perm[lane] < A.rows)
+         y[perm[lane]] = acc[lane];
+}
+
+/*!
+ *  Computes one block row of a blocked CSR row product. Fill entries of a block hold the zero value of the matrix,
+ *  so this layout should only be used when \p mult of the zero value is neutral for \p add.
+ */
+template<typename T, typename MultFunc, typename AddFunc>
+inline void blockRowProduct(const BlockedSparseMat<T> &A, size_t blockRow, const T *x, T *y, MultFunc &mult, AddFunc &add, T init)
+{
+   const size_t H = A.block_height;
+   const size_t W = A.block_width;
+   const size_t firstRow = blockRow * H;
+   const size_t height = std::min(H, A.rows - firstRow);
+   T acc[8];
+
+   for(size_t r = 0; r < height; ++r)
+      acc[r] = init;
+
+   for(size_t b = A.block_row_offsets[blockRow]; b < A.block_row_offsets[blockRow+1]; ++b)
+   {
+      const T *block = A.data + b * H * W;
+      const size_t firstCol = A.block_col_indices[b] * W;
+      const size_t width = std::min(W, A.cols - firstCol);
+      const T *xs = x + firstCol;
+
+      for(size_t r = 0; r < height; ++r)
+      {
+         T sum = acc[r];
+         for(size_t c = 0; c < width; ++c)
+            sum = add(sum, mult(block[r * W + c], xs[c]));
+         acc[r] = sum;
+      }
+   }
+
+   for(size_t r = 0; r < height; ++r)
+      y[firstRow + r] = acc[r];
+}
+
+} // end namespace backend
+
+
+// **********************************************************************************//
+// **********************************************************************************//
+// ----------------------------    LAYOUT CONVERSION   ------------------------------//
+// **********************************************************************************//
+// **********************************************************************************//
+
+
+/*!
+ *  Releases the SELL-C-sigma and blocked CSR arrays, they will be rebuilt from CSR on next use.
+ */
+template <typename T>
+void SparseMatrix<T>::deleteLayoutFormats()
+{
+   m_layoutValid = false;
+
+   std::vector<T>().swap(m_valuesSELL);
+   std::vector<size_t>().swap(m_colIndSELL);
+   std::vector<size_t>().swap(m_sliceOffsetsSELL);
+   std::vector<size_t>().swap(m_rowLengthsSELL);
+   std::vector<size_t>().swap(m_rowPermSELL);
+
+   std::vector<T>().swap(m_valuesBCSR);
+   std::vector<size_t>().swap(m_blockRowPtrBCSR);
+   std::vector<size_t>().swap(m_blockColIndBCSR);
+}
+
+
+/*!
+ *  Builds the SELL-C-sigma arrays from CSR. Rows are sorted by decreasing length within windows of sigma rows,
+ *  then packed into slices of C rows padded to the longest row of the slice.
+ */
+template <typename T>
+void SparseMatrix<T>::convertToSELLFormat()
+{
+   const size_t C = m_sellChunk;
+   const size_t slices = (m_rows + C - 1) / C;
+   const size_t paddedRows = slices * C;
+
+   // rows past m_rows are padding lanes of the last slice
+   m_rowPermSELL.resize(paddedRows);
+   for(size_t i = 0; i < paddedRows; ++i)
+      m_rowPermSELL[i] = i;
+
+   for(size_t first = 0; first < m_rows; first += m_sellSigma)
+   {
+      size_t last = std::min(first + m_sellSigma, m_rows);
+      std::stable_sort(m_rowPermSELL.begin() + first, m_rowPermSELL.begin() + last, [this](size_t a, size_t b)
+      {
+         return this->get_rowSize(a) > this->get_rowSize(b);
+      });
+   }
+
+   m_rowLengthsSELL.assign(paddedRows, 0);
+   m_sliceOffsetsSELL.resize(slices + 1);
+   m_sliceOffsetsSELL[0] = 0;
+
+   for(size_t s = 0; s < slices; ++s)
+   {
+      size_t width = 0;
+      for(size_t lane = 0; lane < C; ++lane)
+      {
+         size_t row = m_rowPermSELL[s * C + lane];
+         if(row < m_rows)
+         {
+            m_rowLengthsSELL[s * C + lane] = get_rowSize(row);
+            width = std::max(width, get_rowSize(row));
+         }
+      }
+      m_sliceOffsetsSELL[s+1] = m_sliceOffsetsSELL[s] + width * C;
+   }
+
+   // padding entries point at column 0 so that the kernel can load them unconditionally
+   m_valuesSELL.assign(m_sliceOffsetsSELL[slices], m_zeroValue);
+   m_colIndSELL.assign(m_sliceOffsetsSELL[slices], 0);
+
+   for(size_t s = 0; s < slices; ++s)
+   {
+      for(size_t lane = 0; lane < C; ++lane)
+      {
+         size_t row = m_rowPermSELL[s * C + lane];
+         if(row >= m_rows)
+            continue;
+
+         for(size_t k = 0; k < m_rowLengthsSELL[s * C + lane]; ++k)
+         {
+            size_t pos = m_sliceOffsetsSELL[s] + k * C + lane;
+            m_valuesSELL[pos] = m_values[m_rowPtr[row] + k];
+            m_colIndSELL[pos] = m_colInd[m_rowPtr[row] + k];
+         }
+      }
+   }
+}
+
+
+/*!
+ *  Builds the blocked CSR arrays from CSR, every block that holds at least one non-zero element is stored densely.
+ */
+template <typename T>
+void SparseMatrix<T>::convertToBCSRFormat()
+{
+   const size_t H = m_blockHeight;
+   const size_t W = m_blockWidth;
+   const size_t blockRows = (m_rows + H - 1) / H;
+
+   m_blockRowPtrBCSR.assign(blockRows + 1, 0);
+   m_blockColIndBCSR.clear();
+   m_valuesBCSR.clear();
+
+   std::map<size_t, size_t> blocks;
+
+   for(size_t br = 0; br < blockRows; ++br)
+   {
+      const size_t firstRow = br * H;
+      const size_t lastRow = std::min(firstRow + H, m_rows);
+
+      blocks.clear();
+      for(size_t row = firstRow; row < lastRow; ++row)
+         for(size_t jj = m_rowPtr[row]; jj < m_rowPtr[row+1]; ++jj)
+            blocks.insert(std::make_pair(m_colInd[jj] / W, 0));
+
+      size_t b = m_blockColIndBCSR.size();
+      for(std::map<size_t, size_t>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+      {
+         it->second = b++;
+         m_blockColIndBCSR.push_back(it->first);
+      }
+
+      m_valuesBCSR.resize(b * H * W, m_zeroValue);
+
+      for(size_t row = firstRow; row < lastRow; ++row)
+         for(size_t jj = m_rowPtr[row]; jj < m_rowPtr[row+1]; ++jj)
+            m_valuesBCSR[blocks[m_colInd[jj] / W] * H * W + (row - firstRow) * W + m_colInd[jj] % W] = m_values[jj];
+
+      m_blockRowPtrBCSR[br+1] = b;
+   }
+}
+
+
+// **********************************************************************************//
+// **********************************************************************************//
+// ----------------------------    LAYOUT FUNCTIONS   -------------------------------//
+// **********************************************************************************//
+// **********************************************************************************//
+
+
+/*!
+ *  Selects the layout used by row products. The layout arrays are built lazily from CSR, the CSR arrays are kept.
+ *  \param layout The layout to use.
+ */
+template <typename T>
+void SparseMatrix<T>::setLayout(SparseLayout layout)
+{
+   if(layout == m_layout)
+      return;
+
+   deleteLayoutFormats();
+   m_layout = layout;
+}
+
+
+/*!
+ *  Sets the SELL-C-sigma parameters.
+ *  \param chunk Number of rows per slice (C), one of 4, 8, 16 or 32.
+ *  \param sigma Size of the sorting window in rows, rounded up to a multiple of \p chunk.
+ */
+template <typename T>
+void SparseMatrix<T>::setSELLParameters(size_t chunk, size_t sigma)
+{
+   if(chunk != 4 && chunk != 8 && chunk != 16 && chunk != 32)
+   {
+      SKEPU_ERROR("SELL-C-sigma chunk size must be one of 4, 8, 16 or 32, got: "<<chunk<<"\n");
+   }
+
+   deleteLayoutFormats();
+   m_sellChunk = chunk;
+   m_sellSigma = std::max(sigma, chunk);
+   m_sellSigma = ((m_sellSigma + chunk - 1) / chunk) * chunk;
+}
+
+
+/*!
+ *  Sets the block size of the blocked CSR layout.
+ *  \param height Rows per block, at most 8.
+ *  \param width Columns per block, at most 8.
+ */
+template <typename T>
+void SparseMatrix<T>::setBlockSize(size_t height, size_t width)
+{
+   if(height < 1 || height > 8 || width < 1 || width > 8)
+   {
+      SKEPU_ERROR("Blocked CSR block size must be between 1x1 and 8x8, got: "<<height<<"x"<<width<<"\n");
+   }
+
+   deleteLayoutFormats();
+   m_blockHeight = height;
+   m_blockWidth = width;
+}
+
+
+/*!
+ *  Builds the arrays of the selected layout from CSR if they are not already valid.
+ */
+template <typename T>
+void SparseMatrix<T>::updateLayout()
+{
+   if(m_layout == CSR_LAYOUT || m_layoutValid)
+      return;
+
+   updateHost();
+
+   if(m_layout == SELL_C_SIGMA_LAYOUT)
+      convertToSELLFormat();
+   else
+      convertToBCSRFormat();
+
+   m_layoutValid = true;
+}
+
+
+/*!
+ *  Returns the number of independent work units of the selected layout: rows for CSR,
+ *  slices for SELL-C-sigma and block rows for blocked CSR.
+ */
+template <typename T>
+size_t SparseMatrix<T>::layoutUnits() const
+{
+   switch(m_layout)
+   {
+   case SELL_C_SIGMA_LAYOUT:
+      return (m_rows + m_sellChunk - 1) / m_sellChunk;
+   case BLOCKED_CSR_LAYOUT:
+      return (m_rows + m_blockHeight - 1) / m_blockHeight;
+   default:
+      return m_rows;
+   }
+}
+
+
+template <typename T>
+SellMat<T> SparseMatrix<T>::sellProxy()
+{
+   if(m_layout != SELL_C_SIGMA_LAYOUT)
+   {
+      SKEPU_ERROR("SELL-C-sigma proxy requested for a sparse matrix that is not in SELL-C-sigma layout.\n");
+   }
+   updateLayout();
+
+   SellMat<T> proxy;
+   proxy.data = m_valuesSELL.data();
+   proxy.col_indices = m_colIndSELL.data();
+   proxy.slice_offsets = m_sliceOffsetsSELL.data();
+   proxy.row_lengths = m_rowLengthsSELL.data();
+   proxy.row_perm = m_rowPermSELL.data();
+   proxy.slices = layoutUnits();
+   proxy.chunk = m_sellChunk;
+   proxy.rows = m_rows;
+   return proxy;
+}
+
+
+template <typename T>
+BlockedSparseMat<T> SparseMatrix<T>::blockedProxy()
+{
+   if(m_layout != BLOCKED_CSR_LAYOUT)
+   {
+      SKEPU_ERROR("Blocked CSR proxy requested for a sparse matrix that is not in blocked CSR layout.\n");
+   }
+   updateLayout();
+
+   BlockedSparseMat<T> proxy;
+   proxy.data = m_valuesBCSR.data();
+   proxy.block_row_offsets = m_blockRowPtrBCSR.data();
+   proxy.block_col_indices = m_blockColIndBCSR.data();
+   proxy.block_rows = layoutUnits();
+   proxy.block_height = m_blockHeight;
+   proxy.block_width = m_blockWidth;
+   proxy.rows = m_rows;
+   proxy.cols = m_cols;
+   return proxy;
+}
+
+
+/*!
+ *  Computes y[row] = add(...add(init, mult(a(row, j0), x[j0]))..., mult(a(row, jn), x[jn])) for the rows covered by
+ *  the work units [\p firstUnit, \p lastUnit) of the selected layout. Requires updateLayout() to have been called,
+ *  different unit ranges can be computed concurrently.
+ *
+ *  \param x Dense input vector with total_cols() elements.
+ *  \param y Dense output vector with total_rows() elements.
+ *  \param mult Binary function combining a matrix element with a vector element.
+ *  \param add Binary function accumulating the products of a row.
+ *  \param init Start value of each row.
+ */
+template <typename T>
+template<typename MultFunc, typename AddFunc>
+void SparseMatrix<T>::rowProducts(const T *x, T *y, MultFunc mult, AddFunc add, T init, size_t firstUnit, size_t lastUnit) const
+{
+   if(m_layout == SELL_C_SIGMA_LAYOUT)
+   {
+      SellMat<T> A;
+      A.data = const_cast<T*>(m_valuesSELL.data());
+      A.col_indices = const_cast<size_t*>(m_colIndSELL.data());
+      A.slice_offsets = const_cast<size_t*>(m_sliceOffsetsSELL.data());
+      A.row_lengths = const_cast<size_t*>(m_rowLengthsSELL.data());
+      A.row_perm = const_cast<size_t*>(m_rowPermSELL.data());
+      A.slices = layoutUnits();
+      A.chunk = m_sellChunk;
+      A.rows = m_rows;
+
+      for(size_t s = firstUnit; s < lastUnit; ++s)
+      {
+         switch(m_sellChunk)
+         {
+         case 4:  backend::sellSliceProduct<4>(A, s, x, y, mult, add, init); break;
+         case 8:  backend::sellSliceProduct<8>(A, s, x, y, mult, add, init); break;
+         case 16: backend::sellSliceProduct<16>(A, s, x, y, mult, add, init); break;
+         default: backend::sellSliceProduct<32>(A, s, x, y, mult, add, init); break;
+         }
+      }
+   }
+   else if(m_layout == BLOCKED_CSR_LAYOUT)
+   {
+      BlockedSparseMat<T> A;
+      A.data = const_cast<T*>(m_valuesBCSR.data());
+      A.block_row_offsets = const_cast<size_t*>(m_blockRowPtrBCSR.data());
+      A.block_col_indices = const_cast<size_t*>(m_blockColIndBCSR.data());
+      A.block_rows = layoutUnits();
+      A.block_height = m_blockHeight;
+      A.block_width = m_blockWidth;
+      A.rows = m_rows;
+      A.cols = m_cols;
+
+      for(size_t br = firstUnit; br < lastUnit; ++br)
+         backend::blockRowProduct(A, br, x, y, mult, add, init);
+   }
+   else
+   {
+      for(size_t row = firstUnit; row < lastUnit; ++row)
+      {
+         T sum = init;
+         for(size_t jj = m_rowPtr[row]; jj < m_rowPtr[row+1]; ++jj)
+            sum = add(sum, mult(m_values[jj], x[m_colInd[jj]]));
+         y[row] = sum;
+      }
+   }
+}
+
+
+/*!
+ *  Computes the row products of all rows, see above. With the OpenMP backend the work units are
+ *  distributed over the threads of the global backend specification using the runtime schedule.
+ */
+template <typename T>
+template<typename MultFunc, typename AddFunc>
+void SparseMatrix<T>::rowProducts(const T *x, T *y, MultFunc mult, AddFunc add, T init)
+{
+   updateLayout();
+   const size_t units = layoutUnits();
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel for schedule(runtime) num_threads(m_globalBackendSpec.CPUThreads())
+#endif
+   for(size_t u = 0; u < units; ++u)
+      rowProducts(x, y, mult, add, init, u, u + 1);
+}
+
+} // end namespace skepu
@@ -0,0 +1,70 @@
+/*! \file spmv_cpu.inl
+ *  \brief Contains the definitions of CPU specific member functions for the SpMV skeleton.
+ */
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Performs the sparse matrix-vector product on the \em CPU, using the layout selected on the matrix.
+		 */
+		template<typename MultFunc, typename AddFunc, typename CUDAKernel, typename CLKernel>
+		void SpMV<MultFunc, AddFunc, CUDAKernel, CLKernel>
+		::CPU(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x)
+		{
+			DEBUG_TEXT_LEVEL1("CPU SpMV: rows = " << A.total_rows() << ", nnz = " << A.total_nnz() << "\n");
+			
+			// Make sure we are properly synched with device data
+			A.updateLayout();
+			x.updateHost();
+			res.invalidateDeviceData();
+			
+			auto mult = [](T a, T b) { return MultFunc::CPU(a, b); };
+			auto add = [](T a, T b) { return AddFunc::CPU(a, b); };
+			A.rowProducts(x.getAddress(), res.getAddress(), mult, add, this->m_start, 0, A.layoutUnits());
+		}
+		
+		
+		/*!
+		 *  Performs the sparse matrix-dense matrix product on the \em CPU. The inner loop runs along a row of the dense operand.
+		 */
+		template<typename MultFunc, typename AddFunc, typename CUDAKernel, typename CLKernel>
+		void SpMV<MultFunc, AddFunc, CUDAKernel, CLKernel>
+		::CPU(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X)
+		{
+			const size_t rows = A.total_rows();
+			const size_t k = X.total_cols();
+			
+			DEBUG_TEXT_LEVEL1("CPU SpMM: rows = " << rows << ", nnz = " << A.total_nnz() << ", cols = " << k << "\n");
+			
+			// Make sure we are properly synched with device data
+			A.updateHost();
+			X.updateHost();
+			res.invalidateDeviceData();
+			
+			const T *values = A.get_values();
+			const size_t *rowPtr = A.get_row_pointers();
+			const size_t *colInd = A.get_col_indices();
+			const T *in = X.getAddress();
+			T *out = res.getAddress();
+			
+			for (size_t r = 0; r < rows; ++r)
+			{
+				T *outRow = out + r * k;
+				for (size_t j = 0; j < k; ++j)
+					outRow[j] = this->m_start;
+				
+				for (size_t jj = rowPtr[r]; jj < rowPtr[r+1]; ++jj)
+				{
+					const T a = values[jj];
+					const T *inRow = in + colInd[jj] * k;
+					SKEPU_PRAGMA_SIMD
+					for (size_t j = 0; j < k; ++j)
+						outRow[j] = AddFunc::CPU(outRow[j], MultFunc::CPU(a, inRow[j]));
+				}
+			}
+		}
+		
+	} // end namespace backend
+} // end namespace skepu
@@ -0,0 +1,174 @@
+/*! \file spmv_omp.inl
+ *  \brief Contains the definitions of OpenMP specific member functions for the SpMV skeleton.
+ */
+
+#ifdef SKEPU_OPENMP
+
+#include <omp.h>
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Finds where diagonal \p diagonal of the merge path between the row end offsets and the non-zero
+		 *  indices crosses, returned as a (row, non-zero) coordinate.
+		 */
+		inline std::pair<size_t, size_t> mergePathSearch(size_t diagonal, const size_t *rowEnds, size_t rows, size_t nnz)
+		{
+			size_t lo = (diagonal > nnz) ? diagonal - nnz : 0;
+			size_t hi = std::min(diagonal, rows);
+			
+			while (lo < hi)
+			{
+				size_t pivot = (lo + hi) / 2;
+				if (rowEnds[pivot] <= diagonal - pivot - 1)
+					lo = pivot + 1;
+				else
+					hi = pivot;
+			}
+			
+			return std::make_pair(lo, diagonal - lo);
+		}
+		
+		
+		/*!
+		 *  Performs the sparse matrix-vector product using \em OpenMP as backend.
+		 *  For CSR the rows and non-zero elements are merged into a single path which is split evenly between the threads,
+		 *  so that every thread processes the same amount of work regardless of row lengths. A row shared by several threads
+		 *  is completed by the thread that reaches its end, the partial results of the other threads are added afterwards.
+		 *  The SELL-C-sigma and blocked CSR layouts are already balanced per slice and are distributed over the threads directly.
+		 */
+		template<typename MultFunc, typename AddFunc, typename CUDAKernel, typename CLKernel>
+		void SpMV<MultFunc, AddFunc, CUDAKernel, CLKernel>
+		::OMP(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x)
+		{
+			const size_t rows = A.total_rows();
+			const size_t nnz = A.total_nnz();
+			
+			DEBUG_TEXT_LEVEL1("OpenMP SpMV: rows = " << rows << ", nnz = " << nnz << "\n");
+			
+			// Make sure we are properly synched with device data
+			A.updateLayout();
+			x.updateHost();
+			res.invalidateDeviceData();
+			
+			auto mult = [](T a, T b) { return MultFunc::OMP(a, b); };
+			auto add = [](T a, T b) { return AddFunc::OMP(a, b); };
+			const T *in = x.getAddress();
+			T *out = res.getAddress();
+			
+			if (A.get_layout() != CSR_LAYOUT)
+			{
+				const size_t units = A.layoutUnits();
+#pragma omp parallel for schedule(runtime) num_threads(this->m_selected_spec->CPUThreads())
+				for (size_t u = 0; u < units; ++u)
+					A.rowProducts(in, out, mult, add, this->m_start, u, u + 1);
+				return;
+			}
+			
+			const T *values = A.get_values();
+			const size_t *rowPtr = A.get_row_pointers();
+			const size_t *colInd = A.get_col_indices();
+			
+			const size_t numThreads = std::max<size_t>(1, std::min<size_t>(this->m_selected_spec->CPUThreads(), rows + nnz));
+			std::vector<size_t> carryRows(numThreads);
+			std::vector<T> carryValues(numThreads);
+			std::vector<char> carryValid(numThreads, 0);
+			
+#pragma omp parallel num_threads(numThreads)
+			{
+				const size_t t = omp_get_thread_num();
+				const size_t nt = omp_get_num_threads();
+				const size_t pathLength = rows + nnz;
+				const size_t perThread = (pathLength + nt - 1) / nt;
+				
+				std::pair<size_t, size_t> start = mergePathSearch(std::min(t * perThread, pathLength), rowPtr + 1, rows, nnz);
+				std::pair<size_t, size_t> end = mergePathSearch(std::min((t + 1) * perThread, pathLength), rowPtr + 1, rows, nnz);
+				
+				size_t row = start.first;
+				size_t jj = start.second;
+				
+				for (; row < end.first; ++row)
+				{
+					T sum = this->m_start;
+					for (; jj < rowPtr[row + 1]; ++jj)
+						sum = add(sum, mult(values[jj], in[colInd[jj]]));
+					out[row] = sum;
+				}
+				
+				// Partial row, carried out to be added when the row is complete
+				if (jj < end.second)
+				{
+					T carry = mult(values[jj], in[colInd[jj]]);
+					for (++jj; jj < end.second; ++jj)
+						carry = add(carry, mult(values[jj], in[colInd[jj]]));
+					
+					carryRows[t] = row;
+					carryValues[t] = carry;
+					carryValid[t] = 1;
+				}
+			}
+			
+			for (size_t t = 0; t < numThreads; ++t)
+				if (carryValid[t])
+					out[carryRows[t]] = AddFunc::OMP(out[carryRows[t]], carryValues[t]);
+		}
+		
+		
+		/*!
+		 *  Performs the sparse matrix-dense matrix product using \em OpenMP as backend.
+		 *  Rows are statically partitioned so that every thread gets about the same number of non-zero elements.
+		 */
+		template<typename MultFunc, typename AddFunc, typename CUDAKernel, typename CLKernel>
+		void SpMV<MultFunc, AddFunc, CUDAKernel, CLKernel>
+		::OMP(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X)
+		{
+			const size_t rows = A.total_rows();
+			const size_t nnz = A.total_nnz();
+			const size_t k = X.total_cols();
+			
+			DEBUG_TEXT_LEVEL1("OpenMP SpMM: rows = " << rows << ", nnz = " << nnz << ", cols = " << k << "\n");
+			
+			// Make sure we are properly synched with device data
+			A.updateHost();
+			X.updateHost();
+			res.invalidateDeviceData();
+			
+			const T *values = A.get_values();
+			const size_t *rowPtr = A.get_row_pointers();
+			const size_t *colInd = A.get_col_indices();
+			const T *in = X.getAddress();
+			T *out = res.getAddress();
+			
+#pragma omp parallel num_threads(this->m_selected_spec->CPUThreads())
+			{
+				const size_t t = omp_get_thread_num();
+				const size_t nt = omp_get_num_threads();
+				
+				// Rows whose first non-zero element falls in this thread's share of the non-zero elements
+				const size_t first = std::lower_bound(rowPtr, rowPtr + rows, (t * nnz + nt - 1) / nt) - rowPtr;
+				const size_t last = (t + 1 == nt) ? rows : std::lower_bound(rowPtr, rowPtr + rows, ((t + 1) * nnz + nt - 1) / nt) - rowPtr;
+				
+				for (size_t r = first; r < last; ++r)
+				{
+					T *outRow = out + r * k;
+					for (size_t j = 0; j < k; ++j)
+						outRow[j] = this->m_start;
+					
+					for (size_t jj = rowPtr[r]; jj < rowPtr[r+1]; ++jj)
+					{
+						const T a = values[jj];
+						const T *inRow = in + colInd[jj] * k;
+						SKEPU_PRAGMA_SIMD
+						for (size_t j = 0; j < k; ++j)
+							outRow[j] = AddFunc::OMP(outRow[j], MultFunc::OMP(a, inRow[j]));
+					}
+				}
+			}
+		}
+		
+	} // end namespace backend
+} // end namespace skepu
+
+#endif // SKEPU_OPENMP
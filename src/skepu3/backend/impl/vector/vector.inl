@@ -94,6 +94,83 @@ namespace skepu
 		}
 	}
 	
+	
+	/*!
+	 *  \brief Saves the vector to a binary file.
+	 *
+	 *  Writes a header with the element size, dimensions, byte order and a checksum, followed by the raw
+	 *  elements. Large vectors are written in chunks by several threads.
+	 *
+	 *  \param filename Name of file to save to.
+	 */
+	template<typename T>
+	void Vector<T>::saveBinary(const std::string& filename)
+	{
+		const size_t dims[1] = {this->m_size};
+		this->writeBinary(filename, 1, dims);
+	}
+	
+	
+	/*!
+	 *  \brief Loads the vector from a binary file written by \p saveBinary.
+	 *
+	 *  The vector is resized to the number of elements in the file, files written by other containers are read
+	 *  as a flat sequence of elements.
+	 *
+	 *  \param filename Name of file to load from.
+	 *  \param mapped Map the file as storage instead of reading it, see the \p memory_mapped constructor.
+	 */
+	template<typename T>
+	void Vector<T>::loadBinary(const std::string& filename, bool mapped)
+	{
+		backend::BinaryFile file(filename, sizeof(T));
+		this->readBinary(file, mapped);
+	}
+	
+	
+	template<typename T>
+	void Vector<T>::writeBinary(const std::string& filename, size_t rank, const size_t *dims)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Binary files require trivially copyable elements");
+		this->updateHost();
+		backend::writeBinaryFile(filename, this->m_data, this->m_size, sizeof(T), rank, dims);
+	}
+	
+	
+	/*!
+	 *  Replaces the contents with the elements of \p file, either read into own storage or mapped.
+	 */
+	template<typename T>
+	void Vector<T>::readBinary(backend::BinaryFile& file, bool mapped)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Binary files require trivially copyable elements");
+		const size_type count = file.count();
+		
+		if (mapped)
+		{
+			deleter_type deleter;
+			T *data = file.map<T>(deleter);
+			this->adopt(data, count, std::move(deleter));
+			return;
+		}
+		
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+		releaseDeviceAllocations();
+		
+		// The old contents are overwritten, only reallocate on a size change
+		if (!this->m_data || this->m_size != count)
+		{
+			this->releaseHostData();
+			this->m_deleter = nullptr;
+			this->init(count);
+		}
+		
+		file.read(this->m_data);
+		this->m_valid = true;
+	}
+	
 ///////////////////////////////////////////////
 // Constructors START
 ///////////////////////////////////////////////
@@ -116,7 +193,7 @@ namespace skepu
 			SKEPU_ERROR("The vector size should be positive.");
 		this->init(this->m_size);
 		c.updateHost();
-		std::copy(c.m_data, c.m_data + this->m_size, this->m_data);
+		backend::copyHostMemory(c.m_data, this->m_size, this->m_data);
 	}
 	
 	
@@ -160,6 +237,28 @@ namespace skepu
 		}
 		
 		this->m_data = ptr;
+		this->m_deleter = backend::deallocateHostMemory<T>;
+	}
+	
+	
+	/*!
+	 *  Takes ownership of \p ptr without copying, the data is freed by calling \p deleter on it.
+	 */
+	template <typename T>
+	inline Vector<T>::Vector(T * const ptr, size_type size, deleter_type deleter): m_size(0), m_deallocEnabled(false), m_valid(true), m_noValidDeviceCopy(true)
+	{
+		this->adopt(ptr, size, std::move(deleter));
+	}
+	
+	
+	/*!
+	 *  Maps the binary file \p filename as storage, without reading it. Pages are loaded on first access and
+	 *  the mapping is private, so modifications are never written back to the file.
+	 */
+	template <typename T>
+	inline Vector<T>::Vector(const std::string& filename, memory_mapped_t): m_size(0), m_deallocEnabled(false), m_valid(true), m_noValidDeviceCopy(true)
+	{
+		this->loadBinary(filename, true);
 	}
 	
 	
@@ -171,6 +270,16 @@ namespace skepu
 	{
 		this->init(num, val);
 	}
+	
+	
+	/*!
+	 *  Allocates storage for \p num elements without initializing them, for results that are about to be overwritten.
+	 */
+	template <typename T>
+	inline Vector<T>::Vector(size_type num, uninitialized_t): m_size(num), m_deallocEnabled(true), m_valid(true), m_noValidDeviceCopy(true)
+	{
+		this->init(num);
+	}
 
 
 	// Init
@@ -183,7 +292,9 @@ namespace skepu
 			if (size < 1)
 				SKEPU_ERROR("The container size must be positive.");
 			this->m_size = size;
-			backend::allocateHostMemory<T>(this->m_data, this->m_size);
+			this->m_allocator = &getHostAllocator();
+			this->m_data = backend::allocateHostArray<T>(*this->m_allocator, this->m_size);
+			this->m_deallocEnabled = true;
 		}
 		else SKEPU_ERROR("Container is already initialized");
 	}
@@ -192,7 +303,7 @@ namespace skepu
 	void Vector<T>::init(size_type size, const T& val)
 	{
 		this->init(size);
-		std::fill(this->m_data, this->m_data + m_size, val);
+		backend::fillHostMemory(this->m_data, this->m_size, val);
 	}
 	
 ///////////////////////////////////////////////
@@ -209,10 +320,27 @@ namespace skepu
 	template <typename T>
 	Vector<T>::~Vector()
 	{
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
 		releaseDeviceAllocations();
-		
-		if (m_data && m_deallocEnabled)
-			backend::deallocateHostMemory<T>(m_data);
+		this->releaseHostData();
+	}
+	
+	/*!
+	 *  Frees the host data if this vector owns it.
+	 */
+	template <typename T>
+	void Vector<T>::releaseHostData()
+	{
+		if (this->m_data && this->m_deallocEnabled)
+		{
+			if (this->m_deleter)
+				this->m_deleter(this->m_data);
+			else
+				backend::deallocateHostArray<T>(*this->m_allocator, this->m_data, this->m_size);
+		}
+		this->m_data = nullptr;
 	}
 	
 ///////////////////////////////////////////////
@@ -233,6 +361,10 @@ namespace skepu
 		if (!enable)
 			return;
 	
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+
 #ifdef SKEPU_OPENCL
 		updateHost_CL();
 #endif
@@ -256,6 +388,10 @@ namespace skepu
 	{
 		if (!enable)
 			return;
+
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
 	
 #ifdef SKEPU_OPENCL
 		invalidateDeviceData_CL();
@@ -367,30 +503,55 @@ namespace skepu
 	template <typename T>
 	Vector<T>& Vector<T>::operator=(const Vector<T>& other)
 	{
-		if (*this == other)
+		if (this == &other)
 			return *this;
-		 
-		updateHostAndReleaseDeviceAllocations();
+		
+		// All elements are overwritten, so device copies are dropped without updating the host first
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+		releaseDeviceAllocations();
 		other.updateHost();
 		
-		if (m_size < other.m_size)
+		if (m_size != other.m_size)
 		{
-			if (m_data)
-				backend::deallocateHostMemory<T>(m_data);
-			
-			m_size = m_size = other.m_size;
+			this->releaseHostData();
 			
-			backend::allocateHostMemory<T>(m_data, m_size);
-		}
-		else
-		{
 			m_size = other.m_size;
+			m_allocator = &getHostAllocator();
+			m_data = backend::allocateHostArray<T>(*m_allocator, m_size);
+			m_deallocEnabled = true;
+			m_deleter = nullptr;
 		}
 		
-		std::copy(other.m_data, other.m_data + m_size, m_data);
+		backend::copyHostMemory(other.m_data, m_size, m_data);
+		m_valid = true;
 		
 		return *this;
 	}
+	
+	
+	/*!
+	 *  Takes over the storage of \p other, which is left empty. No elements are copied.
+	 */
+	template <typename T>
+	Vector<T>& Vector<T>::operator=(Vector<T>&& other)
+	{
+		if (this == &other)
+			return *this;
+		
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+		releaseDeviceAllocations();
+		this->releaseHostData();
+		m_size = 0;
+		m_deallocEnabled = false;
+		m_deleter = nullptr;
+		
+		this->swap(other);
+		return *this;
+	}
 
 ///////////////////////////////////////////////
 // Operators END
@@ -487,6 +648,137 @@ namespace skepu
 		
 		std::swap(m_data, from.m_data);
 		std::swap(m_size, from.m_size);
+		std::swap(m_deallocEnabled, from.m_deallocEnabled);
+		std::swap(m_deleter, from.m_deleter);
+		std::swap(m_allocator, from.m_allocator);
+	}
+	
+	
+	/*!
+	 *  Please refer to the documentation of \p std::vector.
+	 *
+	 *  Added elements are left uninitialized.
+	 */
+	template <typename T>
+	void Vector<T>::resize(size_type num)
+	{
+		if (num == m_size)
+			return;
+		
+		if (num < 1)
+			SKEPU_ERROR("The vector size must be positive.");
+		
+		updateHostAndReleaseDeviceAllocations();
+		
+		HostAllocator &allocator = getHostAllocator();
+		T *data = backend::allocateHostArray<T>(allocator, num);
+		if (this->m_data)
+			backend::copyHostMemory(this->m_data, std::min(num, this->m_size), data);
+		this->releaseHostData();
+		
+		this->m_data = data;
+		this->m_size = num;
+		this->m_allocator = &allocator;
+		this->m_deallocEnabled = true;
+		this->m_deleter = nullptr;
+	}
+	
+	
+	/*!
+	 *  Please refer to the documentation of \p std::vector.
+	 */
+	template <typename T>
+	void Vector<T>::resize(size_type num, const T& val)
+	{
+		const size_type old = this->m_data ? this->m_size : 0;
+		this->resize(num);
+		if (num > old)
+			backend::fillHostMemory(this->m_data + old, num - old, val);
+	}
+	
+	
+	/*!
+	 *  Replaces the contents with the \p size elements at \p ptr without copying them. The vector takes
+	 *  ownership of \p ptr and frees it by calling \p deleter, an empty deleter leaves it to the caller.
+	 */
+	template <typename T>
+	void Vector<T>::adopt(T *ptr, size_type size, deleter_type deleter)
+	{
+		if (!ptr || size < 1)
+			SKEPU_ERROR("Error: The supplied pointer for initializing vector object is invalid");
+		
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+		releaseDeviceAllocations();
+		this->releaseHostData();
+		
+		this->m_data = ptr;
+		this->m_size = size;
+		this->m_deallocEnabled = static_cast<bool>(deleter);
+		this->m_deleter = std::move(deleter);
+		this->m_allocator = nullptr;
+		this->m_valid = true;
+	}
+	
+	
+	/*!
+	 *  Gives up ownership of the host data, which is returned together with the matching deleter. The vector
+	 *  is left empty. Data the vector did not own is returned with a deleter that does nothing.
+	 */
+	template <typename T>
+	std::unique_ptr<T[], typename Vector<T>::deleter_type> Vector<T>::release()
+	{
+		updateHostAndReleaseDeviceAllocations();
+		
+		deleter_type deleter = [](T*) {};
+		if (this->m_deallocEnabled && this->m_deleter)
+			deleter = std::move(this->m_deleter);
+		else if (this->m_deallocEnabled)
+		{
+			HostAllocator *allocator = this->m_allocator;
+			size_type size = this->m_size;
+			deleter = [allocator, size](T *data) { backend::deallocateHostArray<T>(*allocator, data, size); };
+		}
+		
+		std::unique_ptr<T[], deleter_type> data(this->m_data, std::move(deleter));
+		this->m_data = nullptr;
+		this->m_size = 0;
+		this->m_deallocEnabled = false;
+		this->m_deleter = nullptr;
+		return data;
+	}
+	
+	
+	/*!
+	 *  Moves the host data to the pages given by \p placement. Interleave and node placements migrate the pages
+	 *  in place where possible, otherwise the data is copied into storage allocated under the new placement.
+	 */
+	template <typename T>
+	void Vector<T>::place(Placement placement)
+	{
+		if (!this->m_data)
+			return;
+		
+		updateHostAndReleaseDeviceAllocations();
+		
+		if (placement.policy != Placement::Policy::FirstTouch && backend::bindHostMemory(this->m_data, this->m_size * sizeof(T), placement, true))
+			return;
+		
+		if (!this->m_deallocEnabled)
+		{
+			SKEPU_WARNING("Vector does not own its data, placement not changed");
+			return;
+		}
+		
+		PlacementScope scope(placement);
+		HostAllocator &allocator = getHostAllocator();
+		T *data = backend::allocateHostArray<T>(allocator, this->m_size);
+		backend::copyHostMemory(this->m_data, this->m_size, data);
+		this->releaseHostData();
+		this->m_data = data;
+		this->m_allocator = &allocator;
+		this->m_deleter = nullptr;
 	}
 
 ///////////////////////////////////////////////
@@ -506,6 +798,10 @@ namespace skepu
 	template <typename T>
 	void Vector<T>::flush(FlushMode mode)
 	{
+#ifdef SKEPU_LAZY
+		backend::lazyAccess(this);
+#endif
+
 #ifdef SKEPU_OPENCL
 		this->flush_CL(mode);
 #endif
@@ -0,0 +1,249 @@
+/*! \file lazy.h
+ *  \brief Contains the queue of deferred element-wise skeleton calls used for lazy fusion.
+ */
+
+#ifndef LAZY_H
+#define LAZY_H
+
+#ifdef SKEPU_LAZY
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "debug.h"
+
+#ifdef SKEPU_OPENMP
+#include <omp.h>
+#endif
+
+// Number of elements each fused block covers, chosen so that the intermediates of a chain stay in cache
+#ifndef SKEPU_LAZY_BLOCK_SIZE
+#define SKEPU_LAZY_BLOCK_SIZE 2048
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  \class LazyQueue
+		 *
+		 *  \brief Records element-wise Map calls instead of executing them, and runs them fused on flush.
+		 *
+		 *  All recorded calls cover the same number of elements and element i of each call only depends on element
+		 *  i of its arguments. On flush the index space is split into blocks and every recorded call is applied to
+		 *  one block before moving on to the next, so intermediate containers are written and read back while
+		 *  still in cache. A consumer (Reduce, MapReduce) can be attached to the flush to fold each block right
+		 *  after it has been produced.
+		 *
+		 *  Containers call lazyAccess() on host access, synchronization and destruction, which flushes the queue
+		 *  if the container takes part in a pending call. Every application thread has its own queue, so calls
+		 *  recorded by different threads are never fused together or flushed by each other. A thread handing a
+		 *  container written by a deferred call over to another thread has to call skepu::flush() first.
+		 */
+		class LazyQueue
+		{
+		public:
+
+			struct Access
+			{
+				const void *container;
+				const void *address;
+				bool write;
+			};
+
+			static LazyQueue &instance()
+			{
+				static thread_local LazyQueue queue;
+				return queue;
+			}
+
+			bool empty() const
+			{
+				return this->m_nodes.empty();
+			}
+
+			bool paused() const
+			{
+				return this->m_paused;
+			}
+
+			size_t size() const
+			{
+				return this->m_size;
+			}
+
+			// Number of threads used by a flush, consumers index their partial results with the worker id
+			size_t workers() const
+			{
+				return this->m_threads;
+			}
+
+			bool involves(const void *container) const
+			{
+				for (const Access &access : this->m_accesses)
+					if (access.container == container)
+						return true;
+				return false;
+			}
+
+			bool writes(const void *container) const
+			{
+				for (const Access &access : this->m_accesses)
+					if (access.container == container && access.write)
+						return true;
+				return false;
+			}
+
+			/*!
+			 *  Checks if a call over \p size elements with the given accesses can join the pending calls. This holds
+			 *  if it has the same size and every container written by either side is accessed at the same offset.
+			 */
+			bool compatible(size_t size, const std::vector<Access> &accesses) const
+			{
+				if (this->empty())
+					return true;
+
+				if (size != this->m_size)
+					return false;
+
+				for (const Access &access : accesses)
+					for (const Access &pending : this->m_accesses)
+						if (access.container == pending.container && (access.write || pending.write) && access.address != pending.address)
+							return false;
+				return true;
+			}
+
+			/*!
+			 *  Checks if a consuming call with the given accesses can be fused into the flush, i.e. it reads at least
+			 *  one container produced by the pending calls and is compatible with them.
+			 */
+			bool consumes(size_t size, const std::vector<Access> &accesses) const
+			{
+				if (this->empty() || !this->compatible(size, accesses))
+					return false;
+
+				for (const Access &access : accesses)
+					if (this->writes(access.container))
+						return true;
+				return false;
+			}
+
+			/*!
+			 *  Appends a call. \p body(first, last) computes elements [first, last) of the call. Calls recorded with
+			 *  more than one thread make the whole flush parallel.
+			 */
+			void record(size_t size, size_t threads, const std::vector<Access> &accesses, std::function<void(size_t, size_t)> body)
+			{
+				if (!this->compatible(size, accesses))
+					this->flush();
+
+				this->m_size = size;
+				this->m_threads = std::max(this->m_threads, threads);
+				this->m_accesses.insert(this->m_accesses.end(), accesses.begin(), accesses.end());
+				this->m_nodes.push_back(std::move(body));
+
+				DEBUG_TEXT_LEVEL1("Lazy: recorded call " << this->m_nodes.size() << ", size = " << size);
+			}
+
+			void flush()
+			{
+				this->flush([](size_t, size_t, size_t) {});
+			}
+
+			/*!
+			 *  Executes all pending calls, then calls \p consumer(first, last, worker) on each block after the
+			 *  pending calls have produced it.
+			 */
+			template<typename Consumer>
+			void flush(Consumer &&consumer)
+			{
+				if (this->empty() || this->m_paused)
+					return;
+
+				DEBUG_TEXT_LEVEL1("Lazy: flushing " << this->m_nodes.size() << " calls, size = " << this->m_size);
+
+				this->m_paused = true;
+				const size_t size = this->m_size;
+				const size_t blocks = (size + SKEPU_LAZY_BLOCK_SIZE - 1) / SKEPU_LAZY_BLOCK_SIZE;
+
+#ifdef SKEPU_OPENMP
+#pragma omp parallel for schedule(static) num_threads(this->m_threads) if(this->m_threads > 1)
+#endif
+				for (size_t block = 0; block < blocks; ++block)
+				{
+					const size_t first = block * SKEPU_LAZY_BLOCK_SIZE;
+					const size_t last = std::min(first + SKEPU_LAZY_BLOCK_SIZE, size);
+					for (auto &node : this->m_nodes)
+						node(first, last);
+#ifdef SKEPU_OPENMP
+					consumer(first, last, omp_get_thread_num());
+#else
+					consumer(first, last, 0);
+#endif
+				}
+
+				this->m_nodes.clear();
+				this->m_accesses.clear();
+				this->m_size = 0;
+				this->m_threads = 1;
+				this->m_paused = false;
+			}
+
+			/*!
+			 *  Keeps container hooks from flushing, used while a call synchronizes its arguments before recording.
+			 */
+			struct Pause
+			{
+				Pause(): m_previous{LazyQueue::instance().m_paused} { LazyQueue::instance().m_paused = true; }
+				~Pause() { LazyQueue::instance().m_paused = this->m_previous; }
+
+			private:
+				bool m_previous;
+			};
+
+		private:
+
+			LazyQueue() = default;
+
+			std::vector<std::function<void(size_t, size_t)>> m_nodes;
+			std::vector<Access> m_accesses;
+			size_t m_size = 0;
+			size_t m_threads = 1;
+			bool m_paused = false;
+		};
+
+
+		/*!
+		 *  Called by containers before their host data is accessed, synchronized or released.
+		 */
+		inline void lazyAccess(const void *container)
+		{
+			LazyQueue &queue = LazyQueue::instance();
+			if (SKEPU_UNLIKELY(!queue.empty()) && !queue.paused() && queue.involves(container))
+				queue.flush();
+		}
+
+	} // namespace backend
+
+	/*!
+	 *  Executes all skeleton calls deferred by the calling thread.
+	 */
+	inline void flush()
+	{
+		backend::LazyQueue::instance().flush();
+	}
+
+} // namespace skepu
+
+#else
+
+namespace skepu
+{
+	inline void flush() {}
+}
+
+#endif // SKEPU_LAZY
+
+#endif // LAZY_H
@@ -68,6 +68,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<Map>(tuner::userFunctionHash<MapFunc>());
+			}
+			
 			// =======================      Call operators      ==========================
 			
 			template<typename... CallArgs>
@@ -100,9 +105,31 @@ namespace skepu
 			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
 			void OMP(size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args);
 			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			void OMP_loop(std::true_type, size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args);
+			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			void OMP_loop(std::false_type, size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args);
+			
 #endif // SKEPU_OPENMP
 			
 			
+#ifdef SKEPU_LAZY
+			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			void Lazy(size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args);
+			
+#endif // SKEPU_LAZY
+			
+			
+#ifdef SKEPU_TASKPOOL
+			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			void TP(size_t size, pack_indices<OI...>, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, CallArgs&&... args);
+			
+#endif // SKEPU_TASKPOOL
+			
+			
 #ifdef SKEPU_CUDA
 			
 			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs> 
@@ -152,6 +179,37 @@ namespace skepu
 					SKEPU_ERROR("Non-matching input container sizes");
 				
 				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
+				
+				// Views and structure-of-arrays containers refer to host storage, calls involving them are restricted to the host backends
+				constexpr bool hostOnly = trait_count_all<is_skepu_view, typename std::decay<CallArgs>::type...>::value > 0
+					|| trait_count_all<is_skepu_soa, typename std::decay<CallArgs>::type...>::value > 0;
+				this->dispatch(std::integral_constant<bool, hostOnly>{}, size, oi, ei, ai, ci, std::forward<CallArgs>(args)...);
+			}
+			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs>
+			void dispatch(std::true_type, size_t size, pack_indices<OI...> oi, pack_indices<EI...> ei, pack_indices<AI...> ai, pack_indices<CI...> ci, CallArgs&&... args)
+			{
+#ifdef SKEPU_OPENMP
+				if (this->m_selected_spec->activateBackend() == Backend::Type::OpenMP)
+				{
+					this->OMP(size, oi, ei, ai, ci, get<OI, CallArgs...>(args...).begin()..., get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+					return;
+				}
+#endif
+				this->CPU(size, oi, ei, ai, ci, get<OI, CallArgs...>(args...).begin()..., get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+			}
+			
+			template<size_t... OI, size_t... EI, size_t... AI, size_t... CI, typename... CallArgs>
+			void dispatch(std::false_type, size_t size, pack_indices<OI...> oi, pack_indices<EI...> ei, pack_indices<AI...> ai, pack_indices<CI...> ci, CallArgs&&... args)
+			{
+#ifdef SKEPU_LAZY
+				if (sizeof...(AI) == 0 && this->lazyBackend())
+				{
+					this->Lazy(size, oi, ei, ai, ci, get<OI, CallArgs...>(args...).begin()..., get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+					return;
+				}
+#endif
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -169,6 +227,11 @@ namespace skepu
 #ifdef SKEPU_OPENCL
 					this->CL(0, size, oi, ei, ai, ci, get<OI, CallArgs...>(args...).begin()..., get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
 					break;
+#endif
+				case Backend::Type::TaskPool:
+#ifdef SKEPU_TASKPOOL
+					this->TP(size, oi, ei, ai, ci, get<OI, CallArgs...>(args...).begin()..., get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+					break;
 #endif
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
@@ -223,6 +286,8 @@ Map(T op)
 
 #include "impl/map/map_cpu.inl"
 #include "impl/map/map_omp.inl"
+#include "impl/map/map_tp.inl"
+#include "impl/map/map_lazy.inl"
 #include "impl/map/map_cl.inl"
 #include "impl/map/map_cu.inl"
 #include "impl/map/map_hy.inl"
@@ -5,6 +5,22 @@
 #ifndef MAPOVERLAP_H
 #define MAPOVERLAP_H
 
+#include <algorithm>
+#include <vector>
+
+// Tile extents used by the host backends of MapOverlap2D/3D, the innermost (column) extent is the contiguous one
+#ifndef SKEPU_MAPOVERLAP_TILE_PLANES
+#define SKEPU_MAPOVERLAP_TILE_PLANES 8
+#endif
+
+#ifndef SKEPU_MAPOVERLAP_TILE_ROWS
+#define SKEPU_MAPOVERLAP_TILE_ROWS 32
+#endif
+
+#ifndef SKEPU_MAPOVERLAP_TILE_COLS
+#define SKEPU_MAPOVERLAP_TILE_COLS 256
+#endif
+
 namespace skepu
 {
 	/*!
@@ -90,6 +106,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapOverlap1D>(tuner::userFunctionHash<MapOverlapFunc>());
+			}
+			
 		private:
 			CUDAKernel m_cuda_kernel;
 			C2 m_cuda_rowwise_kernel;
@@ -234,6 +255,7 @@ namespace skepu
 				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 					
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -252,6 +274,8 @@ namespace skepu
 					this->vector_OpenCL(0, res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapOverlap");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->vector_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -276,6 +300,7 @@ namespace skepu
 				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 				
 				size_t numrows = arg.total_rows();
 				size_t numcols = arg.total_cols();
@@ -283,7 +308,7 @@ namespace skepu
 				switch (this->m_overlapPolicy)
 				{
 					case Overlap::RowColWise: {
-						Matrix<Ret> tmp(res.total_rows(), res.total_cols());
+						Matrix<Ret> tmp(res.total_rows(), res.total_cols(), uninitialized);
 						switch (this->m_selected_spec->activateBackend())
 						{
 						case Backend::Type::Hybrid:
@@ -304,6 +329,8 @@ namespace skepu
 							this->colwise_OpenCL(numcols, res, tmp, any_indices, const_indices, std::forward<CallArgs>(args)...);
 							break;
 #endif
+						case Backend::Type::TaskPool:
+							this->taskPoolFallback("MapOverlap");
 						case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 							this->rowwise_OpenMP(tmp, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -319,7 +346,7 @@ namespace skepu
 					}
 					
 					case Overlap::ColRowWise: {
-						Matrix<Ret> tmp(res.total_rows(), res.total_cols());
+						Matrix<Ret> tmp(res.total_rows(), res.total_cols(), uninitialized);
 						switch (this->m_selected_spec->activateBackend())
 						{
 						case Backend::Type::Hybrid:
@@ -340,6 +367,8 @@ namespace skepu
 							this->rowwise_OpenCL(numrows, res, tmp, any_indices, const_indices, std::forward<CallArgs>(args)...);
 							break;
 #endif
+						case Backend::Type::TaskPool:
+							this->taskPoolFallback("MapOverlap");
 						case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 							this->colwise_OpenMP(tmp, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -372,6 +401,8 @@ namespace skepu
 							this->colwise_OpenCL(numcols, res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 							break;
 #endif
+						case Backend::Type::TaskPool:
+							this->taskPoolFallback("MapOverlap");
 						case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 							this->colwise_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -401,6 +432,8 @@ namespace skepu
 							this->rowwise_OpenCL(numrows, res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 							break;
 #endif
+						case Backend::Type::TaskPool:
+							this->taskPoolFallback("MapOverlap");
 						case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 							this->rowwise_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -470,12 +503,26 @@ namespace skepu
 				return std::make_pair(this->m_overlap_x, this->m_overlap_y);
 			}
 			
+			/*!
+			 *  Sets how many time steps \p iterate computes per tile before writing it back, 0 selects it from the
+			 *  tile size and overlap.
+			 */
+			void setTemporalBlocking(size_t steps)
+			{
+				this->m_time_block = steps;
+			}
+			
 			template<typename... Args>
 			void tune(Args&&... args)
 			{
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapOverlap2D>(tuner::userFunctionHash<MapOverlapFunc>());
+			}
+			
 		private:
 			CUDAKernel m_cuda_kernel;
 			
@@ -483,16 +530,20 @@ namespace skepu
 			T m_pad {};
 			
 			size_t m_overlap_x, m_overlap_y;
+			size_t m_time_block = 0;
 			
 			
 		private:
+			template<typename Input, size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
+			void helper_CPU(Matrix<Ret>& res, Input& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
+			
 			template<size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
-			void helper_CPU(Matrix<Ret>& res, Matrix<T>& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
+			void iterate_Host(size_t steps, size_t threads, Matrix<Ret>& res, Matrix<T>& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
 			
 #ifdef SKEPU_OPENMP
 			
-			template<size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
-			void helper_OpenMP(Matrix<Ret>& res, Matrix<T>& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
+			template<typename Input, size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
+			void helper_OpenMP(Matrix<Ret>& res, Input& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
 			
 #endif
 		
@@ -548,6 +599,7 @@ namespace skepu
 					SKEPU_ERROR("MapOverlap 2D: Non-matching container sizes");
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 					
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -566,6 +618,8 @@ namespace skepu
 					this->helper_OpenCL(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapOverlap");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->helper_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -578,6 +632,74 @@ namespace skepu
 				
 				return res;
 			}
+			
+			/*!
+			 *  Applies the stencil to a view of a matrix, e.g. a sub-block, without copying it. The columns of the view
+			 *  have to be contiguous, rows may be apart. Views refer to host storage, so only the host backends are used.
+			 */
+			template<typename Parent, typename... CallArgs>
+			Matrix<Ret> &operator()(Matrix<Ret> &res, MatrixView<T, Parent> arg, CallArgs&&... args)
+			{
+				static constexpr size_t anyCont = std::tuple_size<typename MapOverlapFunc::ContainerArgs>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				
+				const size_t overlap_x = this->m_overlap_x;
+				const size_t overlap_y = this->m_overlap_y;
+				const size_t in_rows = arg.total_rows();
+				const size_t in_cols = arg.total_cols();
+				const size_t out_rows = res.total_rows();
+				const size_t out_cols = res.total_cols();
+				
+				if ((in_rows - overlap_y*2 != out_rows) && (in_cols - overlap_x*2 != out_cols))
+					SKEPU_ERROR("MapOverlap 2D: Non-matching container sizes");
+				
+				if (arg.colStride() != 1)
+					SKEPU_ERROR("MapOverlap 2D: Input view must have contiguous columns");
+				
+				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
+				
+#ifdef SKEPU_OPENMP
+				if (this->m_selected_spec->activateBackend() == Backend::Type::OpenMP)
+				{
+					this->helper_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
+					return res;
+				}
+#endif
+				this->helper_CPU(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
+				return res;
+			}
+			
+			/*!
+			 *  Applies the stencil \p steps times to \p arg and stores the final state in \p res. Both matrices have
+			 *  the same size, the border cells within the overlap distance of the edge are kept fixed. The host
+			 *  backends process cache-sized tiles several time steps at a time (overlapped temporal blocking), the
+			 *  device backends fall back to the host.
+			 */
+			template<typename... CallArgs>
+			Matrix<Ret> &iterate(size_t steps, Matrix<Ret> &res, Matrix<T> &arg, CallArgs&&... args)
+			{
+				static_assert(std::is_same<Ret, T>::value, "MapOverlap 2D: iterate requires the same input and output element type");
+				static constexpr size_t anyCont = std::tuple_size<typename MapOverlapFunc::ContainerArgs>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				
+				if (arg.total_rows() != res.total_rows() || arg.total_cols() != res.total_cols())
+					SKEPU_ERROR("MapOverlap 2D: Non-matching container sizes");
+				
+				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
+				
+				size_t threads = 1;
+#ifdef SKEPU_OPENMP
+				if (this->m_selected_spec->backend() != Backend::Type::CPU)
+					threads = this->m_selected_spec->CPUThreads();
+#endif
+				this->iterate_Host(steps, threads, res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
+				
+				return res;
+			}
 		};
 		
 		
@@ -638,12 +760,26 @@ namespace skepu
 				return std::make_tuple(this->m_overlap_i, this->m_overlap_j, this->m_overlap_k);
 			}
 			
+			/*!
+			 *  Sets how many time steps \p iterate computes per tile before writing it back, 0 selects it from the
+			 *  tile size and overlap.
+			 */
+			void setTemporalBlocking(size_t steps)
+			{
+				this->m_time_block = steps;
+			}
+			
 			template<typename... Args>
 			void tune(Args&&... args)
 			{
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapOverlap3D>(tuner::userFunctionHash<MapOverlapFunc>());
+			}
+			
 		private:
 			CUDAKernel m_cuda_kernel;
 			
@@ -651,12 +787,16 @@ namespace skepu
 			T m_pad {};
 			
 			int m_overlap_i, m_overlap_j, m_overlap_k;
+			size_t m_time_block = 0;
 			
 			
 		private:
 			template<size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
 			void helper_CPU(Tensor3<Ret>& res, Tensor3<T>& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
 			
+			template<size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
+			void iterate_Host(size_t steps, size_t threads, Tensor3<Ret>& res, Tensor3<T>& arg, pack_indices<AnyIndx...>, pack_indices<ConstIndx...>,  CallArgs&&... args);
+			
 #ifdef SKEPU_OPENMP
 			
 			template<size_t... AnyIndx, size_t... ConstIndx, typename... CallArgs>
@@ -711,6 +851,7 @@ namespace skepu
 					SKEPU_ERROR("MapOverlap3D: Non-matching container sizes");
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 					
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -729,6 +870,8 @@ namespace skepu
 					this->helper_OpenCL(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapOverlap");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->helper_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -741,6 +884,36 @@ namespace skepu
 				
 				return res;
 			}
+			
+			/*!
+			 *  Applies the stencil \p steps times to \p arg and stores the final state in \p res. Both tensors have
+			 *  the same size, the border cells within the overlap distance of the edge are kept fixed. The host
+			 *  backends process cache-sized tiles several time steps at a time (overlapped temporal blocking), the
+			 *  device backends fall back to the host.
+			 */
+			template<typename... CallArgs>
+			Tensor3<Ret> &iterate(size_t steps, Tensor3<Ret> &res, Tensor3<T> &arg, CallArgs&&... args)
+			{
+				static_assert(std::is_same<Ret, T>::value, "MapOverlap3D: iterate requires the same input and output element type");
+				static constexpr size_t anyCont = std::tuple_size<typename MapOverlapFunc::ContainerArgs>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				
+				if (arg.size_i() != res.size_i() || arg.size_j() != res.size_j() || arg.size_k() != res.size_k())
+					SKEPU_ERROR("MapOverlap3D: Non-matching container sizes");
+				
+				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
+				
+				size_t threads = 1;
+#ifdef SKEPU_OPENMP
+				if (this->m_selected_spec->backend() != Backend::Type::CPU)
+					threads = this->m_selected_spec->CPUThreads();
+#endif
+				this->iterate_Host(steps, threads, res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
+				
+				return res;
+			}
 		};
 		
 		
@@ -809,6 +982,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapOverlap4D>(tuner::userFunctionHash<MapOverlapFunc>());
+			}
+			
 		private:
 			CUDAKernel m_cuda_kernel;
 			
@@ -877,6 +1055,7 @@ namespace skepu
 					SKEPU_ERROR("MapOverlap4D: Non-matching container sizes");
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 					
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -895,6 +1074,8 @@ namespace skepu
 					this->helper_OpenCL(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapOverlap");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->helper_OpenMP(res, arg, any_indices, const_indices, std::forward<CallArgs>(args)...);
@@ -1019,6 +1200,7 @@ MapOverlap(T op)
 
 #include "impl/mapoverlap/mapoverlap_cpu.inl"
 #include "impl/mapoverlap/mapoverlap_omp.inl"
+#include "impl/mapoverlap/mapoverlap_iterate.inl"
 #include "impl/mapoverlap/mapoverlap_cl.inl"
 #include "impl/mapoverlap/mapoverlap_cu.inl"
 #include "impl/mapoverlap/mapoverlap_hy.inl"
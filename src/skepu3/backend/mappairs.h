@@ -5,10 +5,40 @@
 #ifndef MAPPAIRS_H
 #define MAPPAIRS_H
 
+#include <utility>
+#include <vector>
+
+// Tile extent of the blocked triangular iteration used by the host backends for symmetric pairs
+#ifndef SKEPU_MAPPAIRS_TILE
+#define SKEPU_MAPPAIRS_TILE 64
+#endif
+
+// Tile extents of the OpenMP backends of MapPairs and MapPairsReduce. A tile reuses a block of horizontal elements,
+// sized to stay in cache, for all of its rows.
+#ifndef SKEPU_MAPPAIRS_TILE_ROWS
+#define SKEPU_MAPPAIRS_TILE_ROWS 16
+#endif
+
+#ifndef SKEPU_MAPPAIRS_TILE_COLS
+#define SKEPU_MAPPAIRS_TILE_COLS 1024
+#endif
+
 namespace skepu
 {
 	namespace backend
 	{
+		/*!
+		 *  The (row block, column block) tiles on or above the diagonal of a \p size by \p size iteration space.
+		 */
+		inline std::vector<std::pair<size_t, size_t>> upperTriangleTiles(size_t size, size_t tile)
+		{
+			std::vector<std::pair<size_t, size_t>> tiles;
+			for (size_t i = 0; i < size; i += tile)
+				for (size_t j = i; j < size; j += tile)
+					tiles.emplace_back(i, j);
+			return tiles;
+		}
+		
 		/*!
 		 *  \ingroup skeletons
  		 */
@@ -41,6 +71,8 @@ namespace skepu
 			size_t default_size_x;
 			size_t default_size_y;
 			
+			Symmetry m_symmetry = Symmetry::None;
+			
 		public:
 			
 			static constexpr auto skeletonType = SkeletonType::MapPairs;
@@ -72,12 +104,27 @@ namespace skepu
 				this->default_size_y = y;
 			}
 			
+			/*!
+			 *  Declares that the user function gives the same (Symmetric) or negated (Antisymmetric) result when
+			 *  the vertical and horizontal elements are swapped. The host backends then only evaluate the pairs
+			 *  on and above the diagonal and mirror the results.
+			 */
+			void setSymmetry(Symmetry symmetry)
+			{
+				this->m_symmetry = symmetry;
+			}
+			
 			template<typename... Args>
 			void tune(Args&&... args)
 			{
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapPairs>(tuner::userFunctionHash<MapPairsFunc>());
+			}
+			
 			// =======================      Call operators      ==========================
 			
 			template<typename... CallArgs>
@@ -155,7 +202,11 @@ namespace skepu
 				if (disjunction((get<HEI, CallArgs...>(args...).size() < Hsize)...))
 					SKEPU_ERROR("Non-matching horizontal container sizes");
 				
+				if (this->m_symmetry != Symmetry::None && Vsize != Hsize)
+					SKEPU_ERROR("Symmetric MapPairs requires equally sized vertical and horizontal dimensions");
+				
 				this->selectBackend(Vsize + Hsize);
+				auto trace = this->traceCall(this, Vsize + Hsize);
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -175,6 +226,8 @@ namespace skepu
 					this->CL(0, Vsize, Hsize, oi, vei, hei, ai, ci, get<OI, CallArgs...>(args...)..., get<VEI, CallArgs...>(args...).begin()..., get<HEI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapPairs");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->OMP(Vsize, Hsize, oi, vei, hei, ai, ci, get<OI, CallArgs...>(args...)..., get<VEI, CallArgs...>(args...).begin()..., get<HEI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
@@ -59,6 +59,7 @@ namespace skepu
 			
 			Ret m_start{};
 			ReduceMode m_mode = ReduceMode::RowWise;
+			Symmetry m_symmetry = Symmetry::None;
 			
 #pragma mark - Backend agnostic
 			
@@ -79,12 +80,28 @@ namespace skepu
 				this->m_mode = mode;
 			}
 			
+			/*!
+			 *  Declares that the user function gives the same (Symmetric) or negated (Antisymmetric) result when
+			 *  the vertical and horizontal elements are swapped. The host backends then evaluate each unordered
+			 *  pair once and reduce it into both rows (or columns), which requires a commutative and associative
+			 *  reduction.
+			 */
+			void setSymmetry(Symmetry symmetry)
+			{
+				this->m_symmetry = symmetry;
+			}
+			
 			template<typename... Args>
 			void tune(Args&&... args)
 			{
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapPairsReduce>(tuner::userFunctionHash<MapPairsFunc, ReduceFunc>());
+			}
+			
 			template<typename... CallArgs>
 			Vector<Ret> &operator()(Vector<Ret> &res, CallArgs&&... args)
 			{
@@ -118,7 +135,11 @@ namespace skepu
 					  (this->m_mode == ReduceMode::RowWise && res.size() < Vsize))
 					SKEPU_ERROR("Non-matching output container size");
 
+				if (this->m_symmetry != Symmetry::None && Vsize != Hsize)
+					SKEPU_ERROR("Symmetric MapPairsReduce requires equally sized vertical and horizontal dimensions");
+
 				this->selectBackend(Vsize + Hsize);
+				auto trace = this->traceCall(this, Vsize + Hsize);
 
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -139,6 +160,8 @@ namespace skepu
 					this->CL(0, Vsize, Hsize, vei, hei, ai, ci, res.begin(), get<VEI, CallArgs...>(args...).begin()..., get<HEI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("MapPairsReduce");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->OMP(Vsize, Hsize, vei, hei, ai, ci, res.begin(), get<VEI, CallArgs...>(args...).begin()..., get<HEI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
@@ -89,6 +89,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<MapReduce>(tuner::userFunctionHash<MapFunc, ReduceFunc>());
+			}
+			
 			template<template<class> class Container, typename... CallArgs, REQUIRES(is_skepu_container<Container<First>>::value)>
 			Ret operator()(const Container<First> &arg1, CallArgs&&... args)
 			{
@@ -132,6 +137,13 @@ namespace skepu
 					SKEPU_ERROR("Non-matching container sizes");
 				
 				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
+				
+#ifdef SKEPU_LAZY
+				if (sizeof...(AI) == 0 && this->lazyBackend()
+					&& LazyQueue::instance().consumes(size, {{&get<EI, CallArgs...>(args...).getParent(), get<EI, CallArgs...>(args...).begin().getAddress(), false}...}))
+					return Lazy(size, ei, ai, ci, res, get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+#endif
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -146,6 +158,10 @@ namespace skepu
 				case Backend::Type::OpenCL:
 #ifdef SKEPU_OPENCL
 					return   CL(0, size, ei, ai, ci, res, get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
+#endif
+				case Backend::Type::TaskPool:
+#ifdef SKEPU_TASKPOOL
+					return   TP(size, ei, ai, ci, res, get<EI, CallArgs...>(args...).begin()..., get<AI, CallArgs...>(args...)..., get<CI, CallArgs...>(args...)...);
 #endif
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
@@ -174,6 +190,26 @@ namespace skepu
 			
 #endif // SKEPU_OPENMP
 			
+#ifdef SKEPU_LAZY
+			
+			template<size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			Ret Lazy(size_t size, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args);
+			
+			template<size_t... AI, size_t... CI, typename ...CallArgs>
+			Ret Lazy(size_t size, pack_indices<>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args);
+			
+#endif // SKEPU_LAZY
+			
+#ifdef SKEPU_TASKPOOL
+			
+			template<size_t... EI, size_t... AI, size_t... CI, typename ...CallArgs>
+			Ret TP(size_t size, pack_indices<EI...>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args);
+			
+			template<size_t... AI, size_t... CI, typename ...CallArgs>
+			Ret TP(size_t size, pack_indices<>, pack_indices<AI...>, pack_indices<CI...>, Ret &res, CallArgs&&... args);
+			
+#endif // SKEPU_TASKPOOL
+			
 #ifdef SKEPU_CUDA
 			
 			template<size_t... EI, size_t... AI, size_t... CI, typename... CallArgs>
@@ -279,6 +315,8 @@ MapReduce(T map_op, U red_op)
 
 #include "impl/mapreduce/mapreduce_cpu.inl"
 #include "impl/mapreduce/mapreduce_omp.inl"
+#include "impl/mapreduce/mapreduce_tp.inl"
+#include "impl/mapreduce/mapreduce_lazy.inl"
 #include "impl/mapreduce/mapreduce_cl.inl"
 #include "impl/mapreduce/mapreduce_cu.inl"
 #include "impl/mapreduce/mapreduce_hy.inl"
@@ -79,6 +79,11 @@ namespace skepu
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<Reduce1D>(tuner::userFunctionHash<ReduceFunc>());
+			}
+			
 		protected:
 			CUDAKernel m_cuda_kernel;
 			
@@ -100,6 +105,22 @@ namespace skepu
 			
 #endif
 			
+#ifdef SKEPU_LAZY
+			
+			template<typename Iterator>
+			T Lazy(size_t size, T &res, Iterator arg);
+			
+#endif
+			
+#ifdef SKEPU_TASKPOOL
+			
+			void TP(Vector<T> &res, Matrix<T>& arg);
+			
+			template<typename Iterator>
+			T TP(size_t size, T &res, Iterator arg);
+			
+#endif
+			
 #ifdef SKEPU_CUDA
 			
 			void reduceSingleThreadOneDim_CU(size_t deviceID, VectorIterator<T> &res, const MatrixIterator<T> &arg, size_t numRows);
@@ -170,6 +191,7 @@ namespace skepu
 				// TODO: check size
 				
 				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
 				
 				VectorIterator<T> it = res.begin();
 				Matrix<T> &arg_tr = (this->m_mode == ReduceMode::ColWise) ? arg.transpose(*this->m_selected_spec) : arg;
@@ -190,6 +212,11 @@ namespace skepu
 #ifdef SKEPU_OPENCL
 					this->CL(it, arg_tr.begin(), arg_tr.total_rows());
 					break;
+#endif
+				case Backend::Type::TaskPool:
+#ifdef SKEPU_TASKPOOL
+					this->TP(res, arg_tr);
+					break;
 #endif
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
@@ -212,6 +239,12 @@ namespace skepu
 				T res = this->m_start;
 				
 				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
+				
+#ifdef SKEPU_LAZY
+				if (this->lazyBackend() && LazyQueue::instance().consumes(size, {{&arg.getParent(), arg.getAddress(), false}}))
+					return this->Lazy(size, res, arg);
+#endif
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -226,6 +259,10 @@ namespace skepu
 				case Backend::Type::OpenCL:
 #ifdef SKEPU_OPENCL
 					return this->CL(size, res, arg);
+#endif
+				case Backend::Type::TaskPool:
+#ifdef SKEPU_TASKPOOL
+					return this->TP(size, res, arg);
 #endif
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
@@ -271,6 +308,11 @@ namespace skepu
 			
 			Reduce2D(CUDARowWise row, CUDAColWise col) : Reduce1D<ReduceFuncRowWise, CUDARowWise, CLKernel>(row), m_cuda_colwise_kernel(col) {}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<Reduce2D>(tuner::userFunctionHash<ReduceFuncRowWise, ReduceFuncColWise>());
+			}
+			
 		private:
 			CUDAColWise m_cuda_colwise_kernel;
 			
@@ -325,6 +367,7 @@ namespace skepu
 			//	assert(this->m_execPlan != NULL && this->m_execPlan->isCalibrated());
 				
 				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
 				
 				T res = this->m_start;
 				
@@ -345,6 +388,8 @@ namespace skepu
 #ifdef SKEPU_OPENCL
 					return this->CL(res, arg_tr.begin(), arg_tr.total_rows());
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("Reduce");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					return this->OMP(res, arg_tr);
@@ -434,6 +479,8 @@ Reduce(T row, U col)
 
 #include "impl/reduce/reduce_cpu.inl"
 #include "impl/reduce/reduce_omp.inl"
+#include "impl/reduce/reduce_tp.inl"
+#include "impl/reduce/reduce_lazy.inl"
 #include "impl/reduce/reduce_cl.inl"
 #include "impl/reduce/reduce_cu.inl"
 #include "impl/reduce/reduce_hy.inl"
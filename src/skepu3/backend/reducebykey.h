@@ -0,0 +1,198 @@
+/*! \file reducebykey.h
+ *  \brief Contains class declarations for the ReduceByKey and Histogram skeletons.
+ */
+
+#ifndef REDUCEBYKEY_H
+#define REDUCEBYKEY_H
+
+#include <algorithm>
+#include <vector>
+
+// Size in bytes up to which every OpenMP thread gets a private copy of the bins. Larger key ranges are
+// partitioned by key instead, each partition of the result spanning about this many bytes.
+#ifndef SKEPU_REDUCEBYKEY_PRIVATE_BYTES
+#define SKEPU_REDUCEBYKEY_PRIVATE_BYTES 65536
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  \ingroup skeletons
+		 */
+		/*!
+		 *  \class ReduceByKey
+		 *
+		 *  \brief A class representing the ReduceByKey skeleton, a reduction of the elements grouped by an integral key.
+		 *
+		 *  Each element of the result vector is the \p RedFunc reduction, starting from the start value, of the elements
+		 *  of the argument for which \p KeyFunc returns its index. Elements are reduced in the order of the argument,
+		 *  so \p RedFunc only has to be associative. Elements with keys outside of the result vector are skipped.
+		 *  The OpenMP backend reduces into per-thread private bins which are merged pairwise in a tree when the bins
+		 *  are small, and otherwise partitions the elements by key range so that every partition of the result is
+		 *  reduced by a single thread while in cache. There are no device implementations, the CUDA and OpenCL
+		 *  backends fall back to the host backends.
+		 */
+		template<typename KeyFunc, typename RedFunc, typename CUDAKernel, typename CLKernel>
+		class ReduceByKey : public SkeletonBase
+		{
+		public:
+			using T = typename RedFunc::Ret;
+			using K = typename KeyFunc::Ret;
+			
+			static_assert(std::is_integral<K>::value, "ReduceByKey: The key function must return an integral type");
+			
+			static constexpr auto skeletonType = SkeletonType::ReduceByKey;
+			using ResultArg = std::tuple<T>;
+			using ElwiseArgs = std::tuple<T>;
+			using ContainerArgs = std::tuple<>;
+			using UniformArgs = std::tuple<>;
+			static constexpr bool prefers_matrix = false;
+		
+		public:
+			ReduceByKey(CUDAKernel kernel) : m_cuda_kernel(kernel) {}
+			
+			void setStartValue(T val)
+			{
+				this->m_start = val;
+			}
+		
+		private:
+			CUDAKernel m_cuda_kernel;
+			
+			T m_start{};
+			
+			
+			void CPU(T *res, size_t bins, const T *arg, size_t size);
+
+#ifdef SKEPU_OPENMP
+
+			void OMP(T *res, size_t bins, const T *arg, size_t size);
+
+#endif
+
+
+		public:
+			template<template<class> class Container,
+				REQUIRES(is_skepu_container<Container<T>>::value)>
+			Vector<T> &operator()(Vector<T> &res, Container<T> &arg)
+			{
+				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
+				
+				// Make sure we are properly synched with device data
+				arg.updateHost();
+				res.invalidateDeviceData();
+				
+				switch (this->m_selected_spec->activateBackend())
+				{
+				case Backend::Type::Hybrid:
+				case Backend::Type::CUDA:
+				case Backend::Type::OpenCL:
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("ReduceByKey");
+				case Backend::Type::OpenMP:
+#ifdef SKEPU_OPENMP
+					this->OMP(res.getAddress(), res.size(), arg.getAddress(), arg.size());
+					break;
+#endif
+				default:
+					this->CPU(res.getAddress(), res.size(), arg.getAddress(), arg.size());
+				}
+				
+				return res;
+			}
+		
+		};
+		
+		
+		/*!
+		 *  \ingroup skeletons
+		 */
+		/*!
+		 *  \class Histogram
+		 *
+		 *  \brief A class representing the Histogram skeleton, counting the elements per integral key.
+		 *
+		 *  Each element of the result vector, which can be of any arithmetic type, is set to the number of elements
+		 *  of the argument for which \p KeyFunc returns its index. Elements with keys outside of the result vector
+		 *  are skipped. The backends are those of ReduceByKey.
+		 */
+		template<typename KeyFunc, typename CUDAKernel, typename CLKernel>
+		class Histogram : public SkeletonBase
+		{
+		public:
+			using T = typename std::decay<typename std::tuple_element<0, typename KeyFunc::ElwiseArgs>::type>::type;
+			using K = typename KeyFunc::Ret;
+			
+			static_assert(std::is_integral<K>::value, "Histogram: The key function must return an integral type");
+			
+			static constexpr auto skeletonType = SkeletonType::Histogram;
+			using ResultArg = std::tuple<size_t>;
+			using ElwiseArgs = std::tuple<T>;
+			using ContainerArgs = std::tuple<>;
+			using UniformArgs = std::tuple<>;
+			static constexpr bool prefers_matrix = false;
+		
+		public:
+			Histogram(CUDAKernel kernel) : m_cuda_kernel(kernel) {}
+		
+		private:
+			CUDAKernel m_cuda_kernel;
+			
+			
+			template<typename C>
+			void CPU(C *res, size_t bins, const T *arg, size_t size);
+
+#ifdef SKEPU_OPENMP
+
+			template<typename C>
+			void OMP(C *res, size_t bins, const T *arg, size_t size);
+
+#endif
+
+
+		public:
+			template<typename C, template<class> class Container,
+				REQUIRES(is_skepu_container<Container<T>>::value)>
+			Vector<C> &operator()(Vector<C> &res, Container<T> &arg)
+			{
+				static_assert(std::is_arithmetic<C>::value, "Histogram: The result must be of arithmetic type");
+				
+				this->selectBackend(arg.size());
+				auto trace = this->traceCall(this, arg.size());
+				
+				// Make sure we are properly synched with device data
+				arg.updateHost();
+				res.invalidateDeviceData();
+				
+				switch (this->m_selected_spec->activateBackend())
+				{
+				case Backend::Type::Hybrid:
+				case Backend::Type::CUDA:
+				case Backend::Type::OpenCL:
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("Histogram");
+				case Backend::Type::OpenMP:
+#ifdef SKEPU_OPENMP
+					this->OMP(res.getAddress(), res.size(), arg.getAddress(), arg.size());
+					break;
+#endif
+				default:
+					this->CPU(res.getAddress(), res.size(), arg.getAddress(), arg.size());
+				}
+				
+				return res;
+			}
+		
+		};
+	
+	} // end namespace backend
+} // end namespace skepu
+
+
+#include "impl/reducebykey/reducebykey_cpu.inl"
+#include "impl/reducebykey/reducebykey_omp.inl"
+
+#endif // REDUCEBYKEY_H
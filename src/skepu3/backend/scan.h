@@ -5,6 +5,14 @@
 #ifndef SCAN_H
 #define SCAN_H
 
+#include <algorithm>
+#include <vector>
+
+// Elements per block of the OpenMP scan, every block is reduced and then scanned while in cache
+#ifndef SKEPU_SCAN_BLOCK
+#define SKEPU_SCAN_BLOCK 16384
+#endif
+
 namespace skepu
 {
 	enum class ScanMode
@@ -12,8 +20,106 @@ namespace skepu
 		Inclusive, Exclusive
 	};
 	
+	/*!
+	 *  How the segments of a segmented scan are given. With Flags, the segment container has one element per
+	 *  input element, and nonzero elements start a new segment. With Heads, the segment container holds the
+	 *  ascending indices where segments start, such as the row pointers of a CSR matrix; indices past the end
+	 *  are ignored. The first element always starts a segment.
+	 */
+	enum class SegmentMode
+	{
+		Flags, Heads
+	};
+	
 	namespace backend
 	{
+		/*!
+		 *  Segment heads of a segmented scan, see \p SegmentMode.
+		 */
+		template<typename Iterator>
+		class ScanSegments
+		{
+		public:
+			static constexpr bool segmented = true;
+			
+			/*!
+			 *  Tells whether elements start a segment, for indices asked in ascending order.
+			 */
+			class Cursor
+			{
+			public:
+				Cursor(const ScanSegments &segments, size_t first): m_segments(segments), m_next(0)
+				{
+					if (segments.m_mode == SegmentMode::Heads)
+					{
+						size_t high = segments.m_count;
+						while (this->m_next < high)
+						{
+							const size_t mid = (this->m_next + high) / 2;
+							if (static_cast<size_t>(segments.m_heads(mid)) < first)
+								this->m_next = mid + 1;
+							else
+								high = mid;
+						}
+					}
+				}
+				
+				bool operator()(size_t i)
+				{
+					if (i == 0)
+						return true;
+					
+					if (this->m_segments.m_mode == SegmentMode::Flags)
+						return static_cast<bool>(this->m_segments.m_heads(i));
+					
+					while (this->m_next < this->m_segments.m_count && static_cast<size_t>(this->m_segments.m_heads(this->m_next)) < i)
+						++this->m_next;
+					return this->m_next < this->m_segments.m_count && static_cast<size_t>(this->m_segments.m_heads(this->m_next)) == i;
+				}
+				
+			private:
+				const ScanSegments &m_segments;
+				size_t m_next;
+			};
+			
+			ScanSegments(Iterator heads, size_t count, SegmentMode mode): m_heads(heads), m_count(count), m_mode(mode) {}
+			
+			Cursor from(size_t first) const
+			{
+				return Cursor(*this, first);
+			}
+			
+			void updateHost() const
+			{
+				this->m_heads.getParent().updateHost();
+			}
+			
+		private:
+			Iterator m_heads;
+			size_t m_count;
+			SegmentMode m_mode;
+		};
+		
+		/*!
+		 *  The single segment of an ordinary scan.
+		 */
+		struct NoScanSegments
+		{
+			static constexpr bool segmented = false;
+			
+			struct Cursor
+			{
+				constexpr bool operator()(size_t) const { return false; }
+			};
+			
+			Cursor from(size_t) const
+			{
+				return Cursor{};
+			}
+			
+			void updateHost() const {}
+		};
+		
 		/*!
 		 *  \ingroup skeletons
 		 */
@@ -66,18 +172,29 @@ namespace skepu
 				this->m_initial = initial;
 			}
 			
+			void setSegmentMode(SegmentMode mode)
+			{
+				this->m_segment_mode = mode;
+			}
+			
 			template<typename... Args>
 			void tune(Args&&... args)
 			{
 				tuner::tune(*this, std::forward<Args>(args)...);
 			}
 			
+			std::string tuningKey() const override
+			{
+				return tuner::tuningKey<Scan>(tuner::userFunctionHash<ScanFunc>());
+			}
+			
 		private:
 			CUDAScan m_cuda_scan_kernel;
 			CUDAScanUpdate m_cuda_scan_update_kernel;
 			CUDAScanAdd m_cuda_scan_add_kernel;
 			
 			ScanMode m_mode {ScanMode::Inclusive};
+			SegmentMode m_segment_mode {SegmentMode::Flags};
 			
 			// Default initial value is a default-initialized value
 			T m_initial {};
@@ -86,7 +203,7 @@ namespace skepu
 #pragma mark - Backend agnostic
 		public:
 			
-			template<typename Iterator, typename In>
+			template<typename Iterator, typename In, REQUIRES(!is_skepu_container<Iterator>::value)>
 			Iterator operator()(Iterator res, Iterator res_end, In&& arg)
 			{
 				this->backendDispatch(res_end - res, res, arg.begin());
@@ -100,7 +217,49 @@ namespace skepu
 				return res;
 			}
 			
+			/*!
+			 *  Segmented scan, restarting at every segment head given by \p segments, see \p setSegmentMode.
+			 *  Runs on the host backends.
+			 */
+			template<typename Iterator, typename In, typename Segments>
+			Iterator operator()(Iterator res, Iterator res_end, In&& arg, Segments&& segments)
+			{
+				this->segmentedDispatch(res_end - res, res, arg.begin(), segments);
+				return res;
+			}
+			
+			template<template<class> class Container, typename In, typename Segments, REQUIRES(is_skepu_container<Container<T>>::value)>
+			Container<T>& operator()(Container<T>& res, In&& arg, Segments&& segments)
+			{
+				this->segmentedDispatch(res.size(), res.begin(), arg.begin(), segments);
+				return res;
+			}
+			
 		private:
+			template<typename OutIterator, typename InIterator, typename Segments>
+			void segmentedDispatch(size_t size, OutIterator res, InIterator arg, Segments &segments)
+			{
+				if (arg.size() < size)
+					SKEPU_ERROR("Scan: Non-matching container sizes");
+				
+				if (this->m_segment_mode == SegmentMode::Flags && segments.size() < size)
+					SKEPU_ERROR("Scan: Segment flags do not cover the input");
+				
+				ScanSegments<decltype(segments.begin())> heads(segments.begin(), segments.size(), this->m_segment_mode);
+				
+				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
+				
+#ifdef SKEPU_OPENMP
+				if (this->m_selected_spec->activateBackend() != Backend::Type::CPU)
+				{
+					this->OMP(size, res, arg, this->m_mode, this->m_initial, heads);
+					return;
+				}
+#endif
+				this->CPU(size, res, arg, this->m_mode, this->m_initial, heads);
+			}
+			
 			template<typename OutIterator, typename InIterator>
 			void backendDispatch(size_t size, OutIterator res, InIterator arg)
 			{
@@ -110,6 +269,7 @@ namespace skepu
 					SKEPU_ERROR("Map: Non-matching container sizes");
 				
 				this->selectBackend(size);
+				auto trace = this->traceCall(this, size);
 				
 				switch (this->m_selected_spec->activateBackend())
 				{
@@ -128,6 +288,8 @@ namespace skepu
 					this->CL(size, res, arg, this->m_mode, this->m_initial);
 					break;
 #endif
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("Scan");
 				case Backend::Type::OpenMP:
 #ifdef SKEPU_OPENMP
 					this->OMP(size, res, arg, this->m_mode, this->m_initial);
@@ -141,13 +303,19 @@ namespace skepu
 			
 			
 #pragma mark - CPU
-			template<typename OutIterator, typename InIterator>
-			void CPU(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial);
+			template<typename OutIterator, typename InIterator, typename Segments = NoScanSegments>
+			void CPU(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial, Segments segments = {});
 			
 			
 #ifdef SKEPU_OPENMP
-			template<typename OutIterator, typename InIterator>
-			void OMP(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial);
+			template<typename OutIterator, typename InIterator, typename Segments = NoScanSegments>
+			void OMP(size_t size, OutIterator res, InIterator arg, ScanMode mode, T initial, Segments segments = {});
+			
+			template<typename InIterator, typename Segments>
+			std::pair<bool, T> reduceBlock_OMP(size_t first, size_t last, InIterator arg, ScanMode mode, T initial, const Segments &segments);
+			
+			template<typename OutIterator, typename InIterator, typename Segments>
+			T scanBlock_OMP(size_t first, size_t last, OutIterator res, InIterator arg, ScanMode mode, T initial, T carry, const Segments &segments);
 			
 #endif
 
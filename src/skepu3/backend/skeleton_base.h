@@ -6,6 +6,10 @@
 #define SKELETON_BASE_H
 
 #include "skepu3/backend/environment.h"
+#include "skepu3/backend/task_pool.h"
+#include "skepu3/backend/lazy.h"
+#include "skepu3/backend/tuning_db.h"
+#include "skepu3/backend/trace.h"
 
 namespace skepu
 {
@@ -31,6 +35,7 @@ namespace skepu
 			
 			void setBackend(BackendSpec const& spec)
 			{
+				this->resetBackend();
 				this->m_user_spec = new BackendSpec(spec);
 			}
 			
@@ -41,8 +46,23 @@ namespace skepu
 				this->m_user_spec = nullptr;
 			}
 			
+			// Identifies the instance in the tuning database, empty for skeletons which cannot be tuned
+			virtual std::string tuningKey() const
+			{
+				return std::string{};
+			}
+			
 			const BackendSpec& selectBackend(size_t size = 0)
 			{
+				// Look for a plan tuned in an earlier run on the first call
+				if (!this->m_execPlan && !this->m_user_spec && !this->m_tuningLoaded)
+				{
+					this->m_tuningLoaded = true;
+					std::string key = this->tuningKey();
+					if (!key.empty())
+						this->m_execPlan = TuningDatabase::global().lookup(key);
+				}
+				
 				if (this->m_user_spec)
 					this->m_selected_spec = this->m_user_spec;
 				else if (this->m_execPlan)
@@ -53,10 +73,50 @@ namespace skepu
 			//	this->m_selected_spec = (this->m_user_spec != nullptr)
 			//		? this->m_user_spec
 			//		: &this->m_execPlan->find(size);
+				
+#ifdef SKEPU_LAZY
+				// Device backends read host data directly, so pending lazy calls must be executed first
+				auto type = this->m_selected_spec->backend();
+				if (type == Backend::Type::CUDA || type == Backend::Type::OpenCL || type == Backend::Type::Hybrid)
+					LazyQueue::instance().flush();
+#endif
 				return *this->m_selected_spec;
 			}
 			
 		protected:
+			
+			// Times the backend call made in the enclosing scope, after selectBackend, when tracing is enabled
+			template<typename Skeleton>
+			TraceScope traceCall(const Skeleton *skeleton, size_t size) const
+			{
+				constexpr size_t elementBytes = tuple_bytes<typename Skeleton::ResultArg>::value + tuple_bytes<typename Skeleton::ElwiseArgs>::value;
+				return TraceScope(TracePhase::Compute, skeleton, *this->m_selected_spec, size, size * elementBytes);
+			}
+			
+#ifdef SKEPU_LAZY
+			// Element-wise calls on the host backends can be deferred and fused
+			bool lazyBackend() const
+			{
+				auto type = this->m_selected_spec->backend();
+				return type == Backend::Type::CPU || type == Backend::Type::OpenMP;
+			}
+#endif
+			
+			// Skeletons without a TaskPool implementation run on OpenMP instead, or sequentially without OpenMP.
+			// Backends that are not compiled in fall through here as well, so only an explicit TaskPool request warns
+			void taskPoolFallback(const char *skeleton)
+			{
+				if (this->m_selected_spec->backend() != Backend::Type::TaskPool || this->m_taskPoolWarned)
+					return;
+				
+				this->m_taskPoolWarned = true;
+#ifdef SKEPU_OPENMP
+				SKEPU_WARNING(skeleton << " has no TaskPool backend, using OpenMP instead");
+#else
+				SKEPU_WARNING(skeleton << " has no TaskPool backend, using the CPU backend instead");
+#endif
+			}
+			
 			SkeletonBase()
 			{
 				this->m_environment = Environment<int>::getInstance();
@@ -96,6 +156,10 @@ namespace skepu
 			
 			const BackendSpec *m_selected_spec = nullptr;
 			
+			bool m_tuningLoaded = false;
+			
+			bool m_taskPoolWarned = false;
+			
 		}; // class SkeletonBase
 		
 	} // namespace backend
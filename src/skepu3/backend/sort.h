@@ -0,0 +1,217 @@
+/*! \file sort.h
+ *  \brief Contains a class declaration for the Sort skeleton.
+ */
+
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Minimum number of elements per OpenMP thread when sorting, smaller sequences use fewer threads
+#ifndef SKEPU_SORT_GRAIN
+#define SKEPU_SORT_GRAIN 8192
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  Order-preserving mapping of arithmetic sort keys to unsigned integers, used by the radix sort.
+		 */
+		template<typename K, typename Enable = void>
+		struct RadixKey
+		{
+			static constexpr bool sortable = false;
+		};
+		
+		template<typename K>
+		struct RadixKey<K, typename std::enable_if<std::is_arithmetic<K>::value && (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 || sizeof(K) == 8)>::type>
+		{
+			static constexpr bool sortable = true;
+			using Bits = typename std::conditional<sizeof(K) == 1, uint8_t,
+				typename std::conditional<sizeof(K) == 2, uint16_t,
+				typename std::conditional<sizeof(K) == 4, uint32_t, uint64_t>::type>::type>::type;
+			static constexpr Bits sign = Bits(1) << (sizeof(K) * 8 - 1);
+			
+			// Negative floating-point keys have all bits flipped, all other keys only the sign bit. Negative zero
+			// compares equal to positive zero and is encoded as such, so that stability is kept between them.
+			static Bits encode(K key)
+			{
+				if (key == K(0))
+					key = K(0);
+				
+				Bits bits;
+				std::memcpy(&bits, &key, sizeof(K));
+				if (std::is_floating_point<K>::value)
+					return (bits & sign) ? Bits(~bits) : Bits(bits | sign);
+				return std::is_signed<K>::value ? Bits(bits ^ sign) : bits;
+			}
+		};
+		
+		
+		/*!
+		 *  The order defined by the user function of a Sort, a less-than comparator of two elements.
+		 */
+		template<typename SortFunc, typename Enable = void>
+		struct SortOrder
+		{
+			template<typename T>
+			static bool lessCPU(const T &a, const T &b) { return SortFunc::CPU(a, b); }
+			
+			template<typename T>
+			static bool lessOMP(const T &a, const T &b) { return SortFunc::OMP(a, b); }
+		};
+		
+		/*!
+		 *  The order defined by the user function of a Sort, ascending keys returned for each element.
+		 */
+		template<typename SortFunc>
+		struct SortOrder<SortFunc, typename std::enable_if<SortFunc::totalArity == 1>::type>
+		{
+			template<typename T>
+			static bool lessCPU(const T &a, const T &b) { return SortFunc::CPU(a) < SortFunc::CPU(b); }
+			
+			template<typename T>
+			static bool lessOMP(const T &a, const T &b) { return SortFunc::OMP(a) < SortFunc::OMP(b); }
+			
+			template<typename T>
+			static typename SortFunc::Ret keyOMP(const T &a) { return SortFunc::OMP(a); }
+		};
+		
+		
+		/*!
+		 *  \ingroup skeletons
+		 */
+		/*!
+		 *  \class Sort
+		 *
+		 *  \brief A class representing the Sort skeleton.
+		 *
+		 *  Stably sorts a vector, or each row of a matrix, in place. \p SortFunc is either a less-than comparator
+		 *  of two elements or a function of one element returning the sort key, elements are then ordered by
+		 *  ascending keys. With a second container of the same size, its elements are permuted along with the keys.
+		 *  The OpenMP backend uses a parallel LSD radix sort for key functions with integral or floating-point
+		 *  keys and a parallel merge sort otherwise. Matrices with enough rows are sorted one row per thread.
+		 *  There are no device implementations, the CUDA and OpenCL backends fall back to the host backends.
+		 */
+		template<typename SortFunc, typename CUDAKernel, typename CLKernel>
+		class Sort : public SkeletonBase
+		{
+		public:
+			using T = typename std::decay<typename std::tuple_element<0, typename SortFunc::ElwiseArgs>::type>::type;
+			
+			static constexpr auto skeletonType = SkeletonType::Sort;
+			using ResultArg = std::tuple<T>;
+			using ElwiseArgs = std::tuple<T>;
+			using ContainerArgs = std::tuple<>;
+			using UniformArgs = std::tuple<>;
+			static constexpr bool prefers_matrix = false;
+			
+			// Whether the user function returns a sort key rather than comparing two elements
+			static constexpr bool byKey = (SortFunc::totalArity == 1);
+		
+		public:
+			Sort(CUDAKernel kernel) : m_cuda_kernel(kernel) {}
+		
+		private:
+			CUDAKernel m_cuda_kernel;
+			
+			
+			template<typename V>
+			void CPU(T *keys, V *values, size_t rows, size_t cols);
+
+#ifdef SKEPU_OPENMP
+
+			template<typename V>
+			void OMP(T *keys, V *values, size_t rows, size_t cols);
+
+#endif
+
+			template<typename V>
+			void backendDispatch(T *keys, V *values, size_t rows, size_t cols)
+			{
+				this->selectBackend(rows * cols);
+				auto trace = this->traceCall(this, rows * cols);
+				
+				switch (this->m_selected_spec->activateBackend())
+				{
+				case Backend::Type::Hybrid:
+				case Backend::Type::CUDA:
+				case Backend::Type::OpenCL:
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("Sort");
+				case Backend::Type::OpenMP:
+#ifdef SKEPU_OPENMP
+					this->OMP(keys, values, rows, cols);
+					break;
+#endif
+				default:
+					this->CPU(keys, values, rows, cols);
+				}
+			}
+		
+		
+		public:
+			Vector<T> &operator()(Vector<T> &data)
+			{
+				// Make sure we are properly synched with device data
+				data.updateHost();
+				data.invalidateDeviceData();
+				
+				this->backendDispatch(data.getAddress(), (std::nullptr_t *)nullptr, 1, data.size());
+				return data;
+			}
+			
+			Matrix<T> &operator()(Matrix<T> &data)
+			{
+				data.updateHost();
+				data.invalidateDeviceData();
+				
+				this->backendDispatch(data.getAddress(), (std::nullptr_t *)nullptr, data.total_rows(), data.total_cols());
+				return data;
+			}
+			
+			template<typename V>
+			Vector<T> &operator()(Vector<T> &keys, Vector<V> &values)
+			{
+				if (keys.size() != values.size())
+					SKEPU_ERROR("Sort: Non-matching container sizes");
+				
+				keys.updateHost();
+				values.updateHost();
+				keys.invalidateDeviceData();
+				values.invalidateDeviceData();
+				
+				this->backendDispatch(keys.getAddress(), values.getAddress(), 1, keys.size());
+				return keys;
+			}
+			
+			template<typename V>
+			Matrix<T> &operator()(Matrix<T> &keys, Matrix<V> &values)
+			{
+				if (keys.total_rows() != values.total_rows() || keys.total_cols() != values.total_cols())
+					SKEPU_ERROR("Sort: Non-matching container sizes");
+				
+				keys.updateHost();
+				values.updateHost();
+				keys.invalidateDeviceData();
+				values.invalidateDeviceData();
+				
+				this->backendDispatch(keys.getAddress(), values.getAddress(), keys.total_rows(), keys.total_cols());
+				return keys;
+			}
+		
+		};
+	
+	} // end namespace backend
+} // end namespace skepu
+
+
+#include "impl/sort/sort_cpu.inl"
+#include "impl/sort/sort_omp.inl"
+
+#endif // SORT_H
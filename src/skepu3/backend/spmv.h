@@ -0,0 +1,139 @@
+/*! \file spmv.h
+ *  \brief Contains a class declaration for the SpMV skeleton.
+ */
+
+#ifndef SPMV_H
+#define SPMV_H
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  \ingroup skeletons
+		 */
+		/*!
+		 *  \class SpMV
+		 *
+		 *  \brief A class representing the SpMV skeleton, sparse matrix-vector and sparse matrix-dense matrix products.
+		 *
+		 *  Each output element is the \p AddFunc reduction, starting from the start value, of \p MultFunc applied
+		 *  to the non-zero elements of a sparse matrix row and the matching elements of the dense operand.
+		 *  \p AddFunc is assumed to be associative and commutative, as for Reduce. The OpenMP backend balances
+		 *  CSR products by non-zero count (merge-path partitioning) and uses the SELL-C-sigma or blocked CSR kernels
+		 *  when such a layout has been selected on the matrix. Transposed products use the CSC copy cached by the container.
+		 *  There are no device implementations yet, the CUDA and OpenCL backends fall back to the host backends.
+		 */
+		template<typename MultFunc, typename AddFunc, typename CUDAKernel, typename CLKernel>
+		class SpMV : public SkeletonBase
+		{
+		public:
+			using T = typename MultFunc::Ret;
+			
+			static constexpr auto skeletonType = SkeletonType::SpMV;
+			using ResultArg = std::tuple<T>;
+			using ElwiseArgs = std::tuple<T>;
+			using ContainerArgs = std::tuple<>;
+			using UniformArgs = std::tuple<>;
+			static constexpr bool prefers_matrix = false;
+			
+		public:
+			SpMV(CUDAKernel kernel) : m_cuda_kernel(kernel) {}
+			
+			void setStartValue(T val)
+			{
+				this->m_start = val;
+			}
+			
+			void setTransposed(bool transposed)
+			{
+				this->m_transposed = transposed;
+			}
+			
+		private:
+			CUDAKernel m_cuda_kernel;
+			
+			T m_start{};
+			bool m_transposed = false;
+			
+			
+			void CPU(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x);
+			void CPU(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X);
+			
+#ifdef SKEPU_OPENMP
+			
+			void OMP(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x);
+			void OMP(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X);
+			
+#endif
+			
+			
+		public:
+			Vector<T> &operator()(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x)
+			{
+				SparseMatrix<T> &arg = this->m_transposed ? ~A : A;
+				
+				if (arg.total_rows() != res.size() || arg.total_cols() != x.size())
+					SKEPU_ERROR("SpMV: Non-matching container sizes");
+				
+				this->selectBackend(arg.total_nnz());
+				auto trace = this->traceCall(this, arg.total_nnz());
+				
+				switch (this->m_selected_spec->activateBackend())
+				{
+				case Backend::Type::Hybrid:
+				case Backend::Type::CUDA:
+				case Backend::Type::OpenCL:
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("SpMV");
+				case Backend::Type::OpenMP:
+#ifdef SKEPU_OPENMP
+					this->OMP(res, arg, x);
+					break;
+#endif
+				default:
+					this->CPU(res, arg, x);
+				}
+				
+				return res;
+			}
+			
+			Matrix<T> &operator()(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X)
+			{
+				SparseMatrix<T> &arg = this->m_transposed ? ~A : A;
+				
+				if (arg.total_rows() != res.total_rows() || arg.total_cols() != X.total_rows() || res.total_cols() != X.total_cols())
+					SKEPU_ERROR("SpMM: Non-matching container sizes");
+				
+				this->selectBackend(arg.total_nnz() * X.total_cols());
+				auto trace = this->traceCall(this, arg.total_nnz() * X.total_cols());
+				
+				switch (this->m_selected_spec->activateBackend())
+				{
+				case Backend::Type::Hybrid:
+				case Backend::Type::CUDA:
+				case Backend::Type::OpenCL:
+				case Backend::Type::TaskPool:
+					this->taskPoolFallback("SpMV");
+				case Backend::Type::OpenMP:
+#ifdef SKEPU_OPENMP
+					this->OMP(res, arg, X);
+					break;
+#endif
+				default:
+					this->CPU(res, arg, X);
+				}
+				
+				return res;
+			}
+			
+		};
+		
+	} // end namespace backend
+} // end namespace skepu
+
+
+#include "impl/spmv/spmv_cpu.inl"
+#include "impl/spmv/spmv_omp.inl"
+
+#endif // SPMV_H
@@ -0,0 +1,316 @@
+/*! \file task_pool.h
+ *  \brief Contains the work-stealing thread pool used by the TaskPool backend.
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#ifdef SKEPU_TASKPOOL
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of pool worker threads, the thread calling a skeleton always participates as well.
+#ifndef SKEPU_TASKPOOL_WORKERS
+#define SKEPU_TASKPOOL_WORKERS (std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1)
+#endif
+
+// Number of application threads that can run skeletons on the pool at the same time.
+#ifndef SKEPU_TASKPOOL_EXTERNAL_SLOTS
+#define SKEPU_TASKPOOL_EXTERNAL_SLOTS 32
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		/*!
+		 *  \class TaskPool
+		 *
+		 *  \brief A work-stealing thread pool shared by all skeletons using the TaskPool backend.
+		 *
+		 *  Every worker, and every application thread currently inside a skeleton, owns a deque of range tasks.
+		 *  A range is split in halves until it is no larger than the grain size, the right halves are pushed to the
+		 *  bottom of the own deque and idle threads steal from the top of other deques. A thread waiting for its
+		 *  ranges to finish keeps executing tasks (help-first join), so nested skeleton calls never block a worker.
+		 *  The number of threads working on one call is bounded per call, no global threading state is modified.
+		 */
+		class TaskPool
+		{
+			struct Job
+			{
+				std::function<void(size_t, size_t)> body;
+				size_t grain;
+				size_t maxThreads;
+				std::atomic<size_t> remaining;
+				std::atomic<size_t> participants;
+				std::unique_ptr<std::atomic<bool>[]> joined;
+			};
+
+			struct Task
+			{
+				Job *job;
+				size_t first;
+				size_t last;
+			};
+
+			struct Queue
+			{
+				std::mutex lock;
+				std::deque<Task> tasks;
+			};
+
+		public:
+
+			static TaskPool &instance()
+			{
+				static TaskPool pool(SKEPU_TASKPOOL_WORKERS);
+				return pool;
+			}
+
+			size_t workers() const
+			{
+				return this->m_workers.size();
+			}
+
+			/*!
+			 *  Calls \p body(first, last) on disjoint subranges covering [\p begin, \p end), using at most \p maxThreads
+			 *  threads including the calling one. Returns when all subranges are done.
+			 */
+			template<typename Body>
+			void parallelFor(size_t begin, size_t end, size_t maxThreads, Body &&body, size_t grain = 0)
+			{
+				const size_t size = end - begin;
+				if (size == 0)
+					return;
+
+				maxThreads = std::max<size_t>(maxThreads, 1);
+				if (grain == 0)
+					grain = std::max<size_t>(size / (maxThreads * 8), 1);
+
+				const bool outermost = (currentSlot() == NO_SLOT);
+				if (outermost && !this->acquireExternalSlot())
+				{
+					// All external slots taken, run sequentially rather than oversubscribing
+					body(begin, end);
+					return;
+				}
+				const size_t slot = currentSlot();
+
+				Job job;
+				job.body = std::forward<Body>(body);
+				job.grain = grain;
+				job.maxThreads = maxThreads;
+				job.remaining = size;
+				job.participants = 1;
+				job.joined.reset(new std::atomic<bool>[this->m_queues.size()]);
+				for (size_t i = 0; i < this->m_queues.size(); ++i)
+					job.joined[i] = false;
+				job.joined[slot] = true;
+
+				this->execute(Task{&job, begin, end}, slot);
+
+				while (job.remaining.load(std::memory_order_acquire) > 0)
+				{
+					Task task;
+					if (this->pop(slot, task) || this->steal(slot, task))
+						this->execute(task, slot);
+					else
+						std::this_thread::yield();
+				}
+
+				if (outermost)
+					this->releaseExternalSlot();
+			}
+
+			/*!
+			 *  Splits the non-empty range [\p begin, \p end) in consecutive blocks of \p grain elements and returns
+			 *  the partial results \p body(first, last) of the blocks, computed as in parallelFor, combined in the order
+			 *  of the blocks by \p combine. The result is deterministic and \p combine need not be commutative.
+			 */
+			template<typename T, typename Body, typename Combine>
+			T parallelReduce(size_t begin, size_t end, size_t maxThreads, Body &&body, Combine &&combine, size_t grain = 0)
+			{
+				const size_t size = end - begin;
+				maxThreads = std::max<size_t>(maxThreads, 1);
+				if (grain == 0)
+					grain = std::max<size_t>(size / (maxThreads * 8), 1);
+
+				const size_t numBlocks = (size + grain - 1) / grain;
+				std::vector<T> partials(numBlocks);
+
+				this->parallelFor(0, numBlocks, maxThreads, [&](size_t firstBlock, size_t lastBlock)
+				{
+					for (size_t b = firstBlock; b < lastBlock; ++b)
+						partials[b] = body(begin + b * grain, std::min(end, begin + (b + 1) * grain));
+				}, 1);
+
+				T result = partials[0];
+				for (size_t b = 1; b < numBlocks; ++b)
+					result = combine(result, partials[b]);
+				return result;
+			}
+
+			~TaskPool()
+			{
+				this->m_stop = true;
+				this->m_idle.notify_all();
+				for (std::thread &worker : this->m_workers)
+					worker.join();
+			}
+
+		private:
+
+			static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+			// Queue owned by the calling thread, NO_SLOT for application threads outside the pool
+			static size_t &currentSlot()
+			{
+				static thread_local size_t slot = NO_SLOT;
+				return slot;
+			}
+
+			std::vector<std::thread> m_workers;
+			std::unique_ptr<Queue[]> m_queueStorage;
+			std::vector<Queue*> m_queues;
+			std::unique_ptr<std::atomic<bool>[]> m_externalUsed;
+
+			std::atomic<bool> m_stop {false};
+			std::atomic<size_t> m_pushed {0};
+			std::mutex m_idleLock;
+			std::condition_variable m_idle;
+
+			TaskPool(size_t numWorkers)
+			{
+				const size_t numQueues = numWorkers + SKEPU_TASKPOOL_EXTERNAL_SLOTS;
+				this->m_queueStorage.reset(new Queue[numQueues]);
+				for (size_t i = 0; i < numQueues; ++i)
+					this->m_queues.push_back(&this->m_queueStorage[i]);
+
+				this->m_externalUsed.reset(new std::atomic<bool>[SKEPU_TASKPOOL_EXTERNAL_SLOTS]);
+				for (size_t i = 0; i < SKEPU_TASKPOOL_EXTERNAL_SLOTS; ++i)
+					this->m_externalUsed[i] = false;
+
+				for (size_t i = 0; i < numWorkers; ++i)
+					this->m_workers.emplace_back([this, i] { this->workerLoop(i); });
+			}
+
+			bool acquireExternalSlot()
+			{
+				for (size_t i = 0; i < SKEPU_TASKPOOL_EXTERNAL_SLOTS; ++i)
+				{
+					bool expected = false;
+					if (this->m_externalUsed[i].compare_exchange_strong(expected, true))
+					{
+						currentSlot() = this->m_workers.size() + i;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void releaseExternalSlot()
+			{
+				this->m_externalUsed[currentSlot() - this->m_workers.size()] = false;
+				currentSlot() = NO_SLOT;
+			}
+
+			void workerLoop(size_t slot)
+			{
+				currentSlot() = slot;
+				while (!this->m_stop)
+				{
+					const size_t pushed = this->m_pushed.load(std::memory_order_acquire);
+					Task task;
+					if (this->pop(slot, task) || this->steal(slot, task))
+						this->execute(task, slot);
+					else
+					{
+						// Any tasks left belong to jobs this worker cannot join, sleep until new tasks are pushed
+						std::unique_lock<std::mutex> lock(this->m_idleLock);
+						this->m_idle.wait_for(lock, std::chrono::milliseconds(1), [this, pushed] { return this->m_stop || this->m_pushed.load(std::memory_order_acquire) != pushed; });
+					}
+				}
+			}
+
+			void execute(Task task, size_t slot)
+			{
+				Job &job = *task.job;
+
+				// Split until the range is small enough, the right halves are left for thieves
+				while (task.last - task.first > job.grain)
+				{
+					size_t mid = task.first + (task.last - task.first) / 2;
+					this->push(slot, Task{task.job, mid, task.last});
+					task.last = mid;
+				}
+
+				job.body(task.first, task.last);
+				job.remaining.fetch_sub(task.last - task.first, std::memory_order_release);
+			}
+
+			void push(size_t slot, Task task)
+			{
+				{
+					std::lock_guard<std::mutex> lock(this->m_queues[slot]->lock);
+					this->m_queues[slot]->tasks.push_back(task);
+				}
+				this->m_pushed.fetch_add(1, std::memory_order_release);
+				this->m_idle.notify_one();
+			}
+
+			bool pop(size_t slot, Task &task)
+			{
+				std::lock_guard<std::mutex> lock(this->m_queues[slot]->lock);
+				if (this->m_queues[slot]->tasks.empty())
+					return false;
+
+				task = this->m_queues[slot]->tasks.back();
+				this->m_queues[slot]->tasks.pop_back();
+				return true;
+			}
+
+			bool steal(size_t slot, Task &task)
+			{
+				const size_t numQueues = this->m_queues.size();
+				for (size_t i = 1; i < numQueues; ++i)
+				{
+					Queue &victim = *this->m_queues[(slot + i) % numQueues];
+					std::lock_guard<std::mutex> lock(victim.lock);
+					if (victim.tasks.empty())
+						continue;
+
+					// Join the job of the oldest task if it still accepts threads
+					Job &job = *victim.tasks.front().job;
+					if (!job.joined[slot])
+					{
+						if (job.participants.fetch_add(1) >= job.maxThreads)
+						{
+							job.participants.fetch_sub(1);
+							continue;
+						}
+						job.joined[slot] = true;
+					}
+
+					task = victim.tasks.front();
+					victim.tasks.pop_front();
+					return true;
+				}
+				return false;
+			}
+		};
+
+	} // namespace backend
+} // namespace skepu
+
+#endif // SKEPU_TASKPOOL
+
+#endif // TASK_POOL_H
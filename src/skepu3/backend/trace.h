@@ -0,0 +1,482 @@
+/*! \file trace.h
+ *  \brief Contains the skeleton tracing facility and its Chrome trace and CSV exporters.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include "skepu3/impl/backend.hpp"
+
+// Number of events in each block of a thread's trace buffer
+#ifndef SKEPU_TRACE_CHUNK_SIZE
+#define SKEPU_TRACE_CHUNK_SIZE 4096
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		enum class TracePhase
+		{
+			Compute, HostToDevice, DeviceToHost, ReduceTail
+		};
+
+		inline std::ostream &operator<<(std::ostream &o, TracePhase phase)
+		{
+			switch (phase)
+			{
+			case TracePhase::Compute:      o << "compute"; break;
+			case TracePhase::HostToDevice: o << "host to device"; break;
+			case TracePhase::DeviceToHost: o << "device to host"; break;
+			case TracePhase::ReduceTail:   o << "reduce tail"; break;
+			}
+			return o;
+		}
+
+		/*!
+		 *  One timed region. \p name is the mangled type of the skeleton or container and \p instance its address, the
+		 *  remaining fields are copied from the BackendSpec the region ran with.
+		 */
+		struct TraceEvent
+		{
+			const char *name;
+			const void *instance;
+			TracePhase phase;
+			Backend::Type backend;
+			Backend::Scheduling scheduling;
+			size_t CPUThreads;
+			size_t chunkSize;
+			size_t devices;
+			size_t GPUBlocks;
+			size_t GPUThreads;
+			float CPUPartitionRatio;
+			uint64_t start;    // ns since tracing was enabled
+			uint64_t duration; // ns
+			size_t elements;
+			size_t bytes;
+		};
+
+		/*!
+		 *  \class TraceBuffer
+		 *
+		 *  \brief The events recorded by one thread.
+		 *
+		 *  Only the owning thread appends, so no locks are taken. Events are stored in fixed blocks which are never
+		 *  moved, and the event count of a block is published after the event is written, which lets an exporter
+		 *  read the buffer while the thread keeps recording.
+		 */
+		class TraceBuffer
+		{
+		public:
+			TraceBuffer(size_t thread)
+			: m_thread(thread), m_head(new Chunk), m_tail(m_head) {}
+
+			~TraceBuffer()
+			{
+				this->release(this->m_head);
+			}
+
+			size_t thread() const
+			{
+				return this->m_thread;
+			}
+
+			void push(const TraceEvent &event)
+			{
+				size_t count = this->m_tail->count.load(std::memory_order_relaxed);
+				if (count == SKEPU_TRACE_CHUNK_SIZE)
+				{
+					Chunk *chunk = new Chunk;
+					this->m_tail->next.store(chunk, std::memory_order_release);
+					this->m_tail = chunk;
+					count = 0;
+				}
+				this->m_tail->events[count] = event;
+				this->m_tail->count.store(count + 1, std::memory_order_release);
+			}
+
+			template<typename Func>
+			void forEach(Func func) const
+			{
+				for (const Chunk *chunk = this->m_head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+				{
+					size_t count = chunk->count.load(std::memory_order_acquire);
+					for (size_t i = 0; i < count; ++i)
+						func(chunk->events[i]);
+				}
+			}
+
+			// Not safe while the owning thread records
+			void clear()
+			{
+				this->release(this->m_head->next.exchange(nullptr));
+				this->m_head->count.store(0);
+				this->m_tail = this->m_head;
+			}
+
+		private:
+			struct Chunk
+			{
+				TraceEvent events[SKEPU_TRACE_CHUNK_SIZE];
+				std::atomic<size_t> count{0};
+				std::atomic<Chunk*> next{nullptr};
+			};
+
+			size_t m_thread;
+			Chunk *m_head;
+			Chunk *m_tail;
+
+			static void release(Chunk *chunk)
+			{
+				while (chunk)
+				{
+					Chunk *next = chunk->next.load();
+					delete chunk;
+					chunk = next;
+				}
+			}
+		};
+
+		/*!
+		 *  \class Tracer
+		 *
+		 *  \brief Owns the trace buffers of all threads and writes them out.
+		 *
+		 *  Tracing is off unless SKEPU_TRACE is set in the environment or skepu::enableTracing() is called. With
+		 *  SKEPU_TRACE=<prefix>, the trace is written to <prefix>.json and <prefix>.csv when the program exits.
+		 */
+		class Tracer
+		{
+		public:
+			static Tracer &instance()
+			{
+				static Tracer tracer;
+				return tracer;
+			}
+
+			// The single branch taken by every traced region
+			static bool enabled()
+			{
+				return State<>::enabled;
+			}
+
+			static void setEnabled(bool enable)
+			{
+				if (enable)
+					instance();
+				State<>::enabled = enable;
+			}
+
+			uint64_t now() const
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->m_epoch).count();
+			}
+
+			TraceBuffer &buffer()
+			{
+				thread_local TraceBuffer *buffer = nullptr;
+				if (!buffer)
+				{
+					std::lock_guard<std::mutex> lock(this->m_mutex);
+					this->m_buffers.emplace_back(new TraceBuffer(this->m_buffers.size()));
+					buffer = this->m_buffers.back().get();
+				}
+				return *buffer;
+			}
+
+			// The recorded events of all threads, ordered by start time
+			std::vector<std::pair<size_t, TraceEvent>> events()
+			{
+				std::vector<std::pair<size_t, TraceEvent>> res;
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				for (auto &buffer : this->m_buffers)
+					buffer->forEach([&](const TraceEvent &event) { res.emplace_back(buffer->thread(), event); });
+				std::stable_sort(res.begin(), res.end(), [](const std::pair<size_t, TraceEvent> &a, const std::pair<size_t, TraceEvent> &b)
+				{
+					return a.second.start < b.second.start;
+				});
+				return res;
+			}
+
+			void clear()
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				for (auto &buffer : this->m_buffers)
+					buffer->clear();
+			}
+
+			/*!
+			 *  Writes the trace in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto.
+			 *  Each thread is a row, the arguments of an event hold the element count, bytes and backend specification.
+			 */
+			void writeChromeTrace(std::ostream &o)
+			{
+				o << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+				bool first = true;
+				for (auto &entry : this->events())
+				{
+					const TraceEvent &event = entry.second;
+					o << (first ? "\n" : ",\n");
+					first = false;
+					o << "{\"name\":\"" << escape(demangle(event.name)) << "\",\"cat\":\"" << event.phase
+						<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << entry.first
+						<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0
+						<< ",\"args\":{\"instance\":\"" << event.instance << "\",\"backend\":\"" << event.backend
+						<< "\",\"elements\":" << event.elements << ",\"bytes\":" << event.bytes
+						<< ",\"CPU threads\":" << event.CPUThreads << ",\"scheduling\":\"" << event.scheduling
+						<< "\",\"chunk size\":" << event.chunkSize << ",\"devices\":" << event.devices
+						<< ",\"GPU blocks\":" << event.GPUBlocks << ",\"GPU threads\":" << event.GPUThreads
+						<< ",\"CPU ratio\":" << event.CPUPartitionRatio << "}}";
+				}
+				o << "\n]}\n";
+			}
+
+			/*!
+			 *  Writes one CSV row per skeleton instance, phase, backend and element count with the number of calls and
+			 *  the total, mean, minimum and maximum time in microseconds.
+			 */
+			void writeSummary(std::ostream &o)
+			{
+				struct Stats
+				{
+					size_t calls = 0;
+					size_t bytes = 0;
+					uint64_t total = 0;
+					uint64_t min = UINT64_MAX;
+					uint64_t max = 0;
+				};
+
+				using Key = std::tuple<std::string, const void*, int, int, size_t>;
+				std::map<Key, Stats> stats;
+				for (auto &entry : this->events())
+				{
+					const TraceEvent &event = entry.second;
+					Stats &s = stats[Key{demangle(event.name), event.instance, (int)event.phase, (int)event.backend, event.elements}];
+					s.calls++;
+					s.bytes += event.bytes;
+					s.total += event.duration;
+					s.min = std::min(s.min, event.duration);
+					s.max = std::max(s.max, event.duration);
+				}
+
+				o << std::fixed << std::setprecision(3) << "skeleton,instance,phase,backend,elements,calls,total_us,mean_us,min_us,max_us,GB_per_s\n";
+				for (auto &entry : stats)
+				{
+					const Stats &s = entry.second;
+					std::string name = std::get<0>(entry.first);
+					std::replace(name.begin(), name.end(), '"', '\'');
+					o << "\"" << name << "\"," << std::get<1>(entry.first) << "," << (TracePhase)std::get<2>(entry.first) << ","
+						<< (Backend::Type)std::get<3>(entry.first) << "," << std::get<4>(entry.first) << "," << s.calls << ","
+						<< s.total / 1000.0 << "," << s.total / 1000.0 / s.calls << "," << s.min / 1000.0 << "," << s.max / 1000.0 << ","
+						<< (s.total ? (double)s.bytes / s.total : 0.0) << "\n";
+				}
+			}
+
+			bool write(const std::string &prefix)
+			{
+				std::ofstream json(prefix + ".json"), csv(prefix + ".csv");
+				if (!json || !csv)
+				{
+					SKEPU_WARNING("Could not write trace " << prefix);
+					return false;
+				}
+				this->writeChromeTrace(json);
+				this->writeSummary(csv);
+				return true;
+			}
+
+		private:
+			template<typename Dummy = void>
+			struct State
+			{
+				static bool enabled;
+			};
+
+			std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+			std::vector<std::unique_ptr<TraceBuffer>> m_buffers;
+			std::mutex m_mutex;
+
+			Tracer() = default;
+
+			static bool fromEnvironment()
+			{
+				if (!std::getenv("SKEPU_TRACE"))
+					return false;
+
+				// Constructed first so that it outlives the exit handler
+				instance();
+				std::atexit([]
+				{
+					instance().write(std::getenv("SKEPU_TRACE"));
+				});
+				return true;
+			}
+
+			static std::string demangle(const char *name)
+			{
+#ifdef __GNUG__
+				int status;
+				std::unique_ptr<char, void(*)(void*)> res{abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free};
+				if (status == 0)
+					return res.get();
+#endif
+				return name;
+			}
+
+			static std::string escape(const std::string &s)
+			{
+				std::string res;
+				for (char c : s)
+				{
+					if (c == '"' || c == '\\')
+						res += '\\';
+					res += c;
+				}
+				return res;
+			}
+		};
+
+		template<typename Dummy>
+		bool Tracer::State<Dummy>::enabled = Tracer::fromEnvironment();
+
+		/*!
+		 *  \class TraceScope
+		 *
+		 *  \brief Records the time from its construction to its destruction when tracing is enabled.
+		 *
+		 *  When tracing is disabled, construction and destruction amount to one test of a flag each.
+		 */
+		class TraceScope
+		{
+		public:
+			template<typename Instance>
+			TraceScope(TracePhase phase, const Instance *instance, const BackendSpec &spec, size_t elements, size_t bytes)
+			{
+				if (!Tracer::enabled())
+					return;
+
+				this->start(phase, instance, spec.backend(), elements, bytes);
+				this->m_event.scheduling = spec.schedulingMode();
+				this->m_event.CPUThreads = spec.CPUThreads();
+				this->m_event.chunkSize = spec.CPUChunkSize();
+				this->m_event.devices = spec.devices();
+				this->m_event.GPUBlocks = spec.GPUBlocks();
+				this->m_event.GPUThreads = spec.GPUThreads();
+				this->m_event.CPUPartitionRatio = spec.CPUPartitionRatio();
+			}
+
+			template<typename Instance>
+			TraceScope(TracePhase phase, const Instance *instance, Backend::Type backend, size_t elements, size_t bytes)
+			{
+				if (!Tracer::enabled())
+					return;
+
+				this->start(phase, instance, backend, elements, bytes);
+				this->m_event.scheduling = Backend::Scheduling::Static;
+				this->m_event.CPUThreads = 1;
+				this->m_event.chunkSize = 0;
+				this->m_event.devices = 1;
+				this->m_event.GPUBlocks = 0;
+				this->m_event.GPUThreads = 0;
+				this->m_event.CPUPartitionRatio = 0;
+			}
+
+			TraceScope(TraceScope &&other)
+			: m_tracer(other.m_tracer), m_event(other.m_event)
+			{
+				other.m_tracer = nullptr;
+			}
+
+			TraceScope(const TraceScope&) = delete;
+			TraceScope &operator=(const TraceScope&) = delete;
+
+			~TraceScope()
+			{
+				if (!this->m_tracer)
+					return;
+
+				this->m_event.duration = this->m_tracer->now() - this->m_event.start;
+				this->m_tracer->buffer().push(this->m_event);
+			}
+
+		private:
+			Tracer *m_tracer = nullptr;
+			TraceEvent m_event;
+
+			template<typename Instance>
+			void start(TracePhase phase, const Instance *instance, Backend::Type backend, size_t elements, size_t bytes)
+			{
+				this->m_tracer = &Tracer::instance();
+				this->m_event.name = typeid(Instance).name();
+				this->m_event.instance = instance;
+				this->m_event.phase = phase;
+				this->m_event.backend = backend;
+				this->m_event.elements = elements;
+				this->m_event.bytes = bytes;
+				this->m_event.start = this->m_tracer->now();
+			}
+		};
+
+		// Size in bytes of one element of each type in a tuple, used to estimate the memory traffic of a call
+		template<typename Tuple>
+		struct tuple_bytes;
+
+		template<>
+		struct tuple_bytes<std::tuple<>>
+		{
+			static constexpr size_t value = 0;
+		};
+
+		template<typename First, typename... Rest>
+		struct tuple_bytes<std::tuple<First, Rest...>>
+		{
+			static constexpr size_t value = sizeof(First) + tuple_bytes<std::tuple<Rest...>>::value;
+		};
+
+	} // namespace backend
+
+	inline void enableTracing()
+	{
+		backend::Tracer::setEnabled(true);
+	}
+
+	inline void disableTracing()
+	{
+		backend::Tracer::setEnabled(false);
+	}
+
+	// Discards the recorded events, must not be called while skeletons are executing
+	inline void clearTrace()
+	{
+		backend::Tracer::instance().clear();
+	}
+
+	//! Writes the trace to <prefix>.json in Chrome trace format and a per-instance summary to <prefix>.csv.
+	inline bool writeTrace(const std::string &prefix)
+	{
+		return backend::Tracer::instance().write(prefix);
+	}
+
+} // namespace skepu
+
+#endif // TRACE_H
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <skepu3/backend/benchmark.h>
+#include <skepu3/backend/tuning_db.h>
 
 #define MEASURE_REPEATS 9
 #define ARG_SIZE_STEP_FACTOR 4
 #define ARG_SIZE_MIN 16
 #define ARG_SIZE_MAX (1 << 18)
 
+// Time in seconds the tuner may spend on one skeleton instance
+#ifndef SKEPU_TUNING_BUDGET
+#define SKEPU_TUNING_BUDGET 30
+#endif
+
 namespace skepu
 {	
 	namespace backend
@@ -43,19 +49,6 @@ namespace skepu
 					typename future_std::make_index_sequence<std::tuple_size<typename std::decay<Tuple>::type>::value>::type());
 			}
 			
-			template<typename T>
-			void container_reserve(skepu::Vector<T> &v, size_t size)
-			{
-				v.reserve(size);
-			}
-			
-			
-			template<typename T>
-			void container_reserve(skepu::Matrix<T> &m, size_t size)
-			{
-			//	c.reserve(size);
-			}
-			
 			template<typename T, typename Skeleton>
 			void container_resize(skepu::Vector<T> &v, size_t size, Skeleton &, bool = false)
 			{
@@ -90,19 +83,6 @@ namespace skepu
 				}
 			}
 			
-			template<class Tuple, size_t...Is>
-			void reserve_all_in_tuple(Tuple&& tuple, size_t size, future_std::index_sequence<Is...>)
-			{
-				int hej[] = { 0, (container_reserve(std::get<Is>(std::forward<Tuple>(tuple)), size), 0)... };
-			}
-			
-			template<class Tuple>
-			void reserve_all_in_tuple(Tuple&& tuple, size_t size)
-			{
-				reserve_all_in_tuple(std::forward<Tuple>(tuple), size,
-					typename future_std::make_index_sequence<std::tuple_size<typename std::decay<Tuple>::type>::value>::type());
-			}
-			
 			template<class Tuple, typename Skeleton, size_t...Is>
 			void resize_all_in_tuple(Tuple&& tuple, size_t size, Skeleton &s, bool isResult, future_std::index_sequence<Is...>)
 			{
@@ -119,11 +99,219 @@ namespace skepu
 			
 #ifdef SKEPU_PRECOMPILED
 			
+			// Hash of the user function source, emitted by the precompiler (0 for hand-written user function structs)
+			template<typename UF, typename = void>
+			struct user_function_hash: std::integral_constant<uint64_t, 0> {};
+			
+			template<typename UF>
+			struct user_function_hash<UF, typename std::conditional<true, void, decltype(UF::sourceHash)>::type>
+			: std::integral_constant<uint64_t, UF::sourceHash> {};
+			
+			template<typename... UFs>
+			uint64_t userFunctionHash()
+			{
+				uint64_t hashes[] = { 0, user_function_hash<UFs>::value... };
+				uint64_t res = 0;
+				for (uint64_t hash : hashes)
+					res = res * 0x100000001b3ull ^ hash;
+				return res;
+			}
+			
+			// Describes an argument type the same way for every compiler: arithmetic types by kind and width,
+			// proxy containers by their size and element type, and other types by their size
+			template<typename T, typename = void>
+			struct type_tag
+			{
+				static std::string get() { return "s" + std::to_string(sizeof(T)); }
+			};
+			
+			template<typename T>
+			struct type_tag<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+			{
+				static std::string get()
+				{
+					return (std::is_floating_point<T>::value ? "f" : std::is_signed<T>::value ? "i" : "u") + std::to_string(sizeof(T) * 8);
+				}
+			};
+			
+			template<typename T>
+			struct type_tag<T, typename std::conditional<true, void, typename T::ContainerType::value_type>::type>
+			{
+				static std::string get() { return "c" + std::to_string(sizeof(T)) + type_tag<typename T::ContainerType::value_type>::get(); }
+			};
+			
+			// Arity and argument types of one argument group, e.g. "2(f32,i32)"
+			template<typename... Types>
+			std::string tupleTag(std::tuple<Types...>*)
+			{
+				std::string tags[] = { "", type_tag<typename std::decay<Types>::type>::get()... };
+				std::string res = std::to_string(sizeof...(Types)) + "(";
+				for (size_t i = 1; i <= sizeof...(Types); ++i)
+					res += (i > 1 ? "," : "") + tags[i];
+				return res + ")";
+			}
+			
+			/*!
+			 *  Key of a skeleton instance in the tuning database, made of the skeleton type, the arity and element types
+			 *  of its argument groups and the source hash of the user functions, which covers their template arguments
+			 *  as well. All are the same for every compiler and build. Empty, so that no plan is stored or looked up,
+			 *  when the user functions carry no source hash.
+			 */
+			template<typename Skeleton>
+			std::string tuningKey(uint64_t userFunctionHash)
+			{
+				if (userFunctionHash == 0)
+					return std::string{};
+				
+				std::ostringstream key;
+				key << std::hex << static_cast<int>(Skeleton::skeletonType) << ":"
+					<< tupleTag((typename Skeleton::ResultArg*)nullptr) << tupleTag((typename Skeleton::ElwiseArgs*)nullptr)
+					<< tupleTag((typename Skeleton::ContainerArgs*)nullptr) << tupleTag((typename Skeleton::UniformArgs*)nullptr)
+					<< ":" << userFunctionHash;
+				return key.str();
+			}
+			
+			// Largest size covered by a plan
+			inline size_t tunedUpTo(const ExecPlan &plan)
+			{
+				size_t res = 0;
+				for (auto &range : plan.sizePlan())
+					res = std::max(res, range.first.second);
+				return res;
+			}
+			
+			/*!
+			 *  Measures backend configurations for one input size. Each configuration is measured once, and once the
+			 *  deadline has passed nothing more is measured, so the search continues with what it has.
+			 */
+			class ConfigurationTimer
+			{
+			public:
+				using Clock = std::chrono::steady_clock;
+				using Measure = std::function<benchmark::TimeSpan(const BackendSpec&)>;
+				
+				ConfigurationTimer(Measure measure, Clock::time_point deadline)
+				: m_measure(measure), m_deadline(deadline) {}
+				
+				benchmark::TimeSpan operator()(const BackendSpec &spec)
+				{
+					auto key = std::make_tuple(spec.backend(), spec.CPUThreads(), spec.schedulingMode(), spec.CPUChunkSize());
+					auto it = this->m_times.find(key);
+					if (it != this->m_times.end())
+						return it->second;
+					
+					if (this->expired())
+						return benchmark::TimeSpan::max();
+					
+					return this->m_times[key] = this->m_measure(spec);
+				}
+				
+				bool expired() const
+				{
+					return Clock::now() > this->m_deadline;
+				}
+				
+			private:
+				Measure m_measure;
+				Clock::time_point m_deadline;
+				std::map<std::tuple<Backend::Type, size_t, Backend::Scheduling, size_t>, benchmark::TimeSpan> m_times;
+			};
+			
+#ifdef SKEPU_OPENMP
+			
+			// Thread count of the OpenMP runtime before the tuner starts changing it
+			inline size_t hardwareThreads()
+			{
+				static const size_t threads = omp_get_max_threads();
+				return threads;
+			}
+			
+			/*!
+			 *  Coordinate descent over the OpenMP thread count, schedule and chunk size, starting from \p spec. A pass
+			 *  varies one parameter at a time, keeping the others at their best values so far, and the search stops
+			 *  after a pass without improvement. This typically measures a few dozen of the several hundred
+			 *  configurations in the full grid.
+			 */
+			inline BackendSpec tuneOpenMP(BackendSpec spec, size_t size, ConfigurationTimer &time)
+			{
+				auto bestTime = time(spec);
+				bool improved = true;
+				
+				auto tryCandidates = [&] (std::function<void(BackendSpec&, size_t)> apply, std::vector<size_t> values)
+				{
+					for (size_t value : values)
+					{
+						BackendSpec candidate = spec;
+						apply(candidate, value);
+						auto duration = time(candidate);
+						if (duration < bestTime)
+						{
+							bestTime = duration;
+							spec = candidate;
+							improved = true;
+						}
+					}
+				};
+				
+				while (improved && !time.expired())
+				{
+					improved = false;
+					
+					std::vector<size_t> threads;
+					for (size_t t = 1; t < hardwareThreads(); t *= 2)
+						threads.push_back(t);
+					threads.push_back(hardwareThreads());
+					tryCandidates([] (BackendSpec &s, size_t t) { s.setCPUThreads(t); }, threads);
+					
+					tryCandidates([] (BackendSpec &s, size_t mode) { s.setSchedulingMode((Backend::Scheduling)mode); },
+						{ (size_t)Backend::Scheduling::Static, (size_t)Backend::Scheduling::Dynamic, (size_t)Backend::Scheduling::Guided });
+					
+					// Chunk size 0 leaves the choice to the OpenMP runtime
+					std::vector<size_t> chunks{Backend::chunkSizeDefault};
+					for (size_t chunk = 16; chunk <= size / spec.CPUThreads(); chunk *= 4)
+						chunks.push_back(chunk);
+					tryCandidates([] (BackendSpec &s, size_t chunk) { s.setCPUChunkSize(chunk); }, chunks);
+				}
+				
+				return spec;
+			}
+			
+#endif
+			
 			template<typename Skeleton, size_t... ResultIdx, size_t... ElwiseIdx, size_t... ContainerIdx, size_t... UniformIdx>
-			void tune_impl(Skeleton& instance, const size_t min, const size_t max, const size_t factor, const size_t repeats,
+			void tune_impl(Skeleton& instance, const size_t min, const size_t max, const size_t factor, const size_t repeats, const double budget,
 				future_std::index_sequence<ResultIdx...>,    future_std::index_sequence<ElwiseIdx...>,
 				future_std::index_sequence<ContainerIdx...>, future_std::index_sequence<UniformIdx...>)
 			{
+				// The plan which will be generated
+				ExecPlan *plan = new ExecPlan();
+				plan->setCalibrated();
+				BackendSpec bestBackendSpec;
+				size_t first = min, tuned = 0;
+				
+				// Reuse a plan tuned on this kind of host in an earlier run. If it stops short of the requested sizes,
+				// only the larger sizes are measured and added to its ranges.
+				TuningDatabase &db = TuningDatabase::global();
+				const std::string key = instance.tuningKey();
+				if (ExecPlan *stored = key.empty() ? nullptr : db.lookup(key))
+				{
+					tuned = tunedUpTo(*stored);
+					while (first <= tuned)
+						first *= factor;
+					
+					if (first > max)
+					{
+						delete plan;
+						instance.setExecPlan(stored);
+						return;
+					}
+					
+					for (auto &range : stored->sizePlan())
+						plan->add(range.first.first, range.first.second, range.second);
+					bestBackendSpec = stored->find(tuned);
+					delete stored;
+				}
+				
 				// Tuple with container for the output container (can be empty)
 				typename select_if<Skeleton::prefers_matrix,
 					typename add_container_layer<Matrix, typename Skeleton::ResultArg>::type,
@@ -140,47 +328,64 @@ namespace skepu
 				// Tuple with uniform arguments (can be empty)
 				typename Skeleton::UniformArgs uniformArgs;
 				
-				// Reserve memory for the maximum input size in advance
-				reserve_all_in_tuple(resultArg,  max);
-				reserve_all_in_tuple(elwiseArgs, max);
+				auto measure = [&] (const BackendSpec &spec)
+				{
+					instance.setBackend(spec);
+					return benchmark::basicBenchmark(
+						repeats, 0,
+						[&] (size_t) {
+							instance(
+								std::get<ResultIdx>(resultArg)...,
+								std::get<ElwiseIdx>(elwiseArgs)...,
+								std::get<ContainerIdx>(containerArgs)...,
+								std::get<UniformIdx>(uniformArgs)...);
+						},
+						[&](benchmark::TimeSpan duration)
+						{
+							skepu::containerutils::updateHostAndInvalidateDevice(
+								std::get<ResultIdx>(resultArg)...,
+								std::get<ElwiseIdx>(elwiseArgs)...,
+								std::get<ContainerIdx>(containerArgs)...);
+						}
+					);
+				};
 				
-				// The plan which will be generated
-				ExecPlan *plan = new ExecPlan();
-				plan->setCalibrated();
+				auto deadline = ConfigurationTimer::Clock::now() + std::chrono::milliseconds((size_t)(budget * 1000));
+#ifdef SKEPU_OPENMP
+				// Measuring OpenMP configurations changes the thread count of the runtime, restored when done
+				const int previousThreads = omp_get_max_threads();
+				BackendSpec bestOpenMPSpec{Backend::Type::OpenMP};
+				bestOpenMPSpec.setCPUThreads(hardwareThreads());
+#endif
 				
 				// Run tests for all input sizes
-				for (size_t i = min, prev_i = 0; i <= max; prev_i = i, i *= factor)
+				for (size_t i = first, prev_i = tuned; i <= max; prev_i = i, i *= factor)
 				{
+					// Out of time, the last winner covers the remaining sizes
+					if (ConfigurationTimer::Clock::now() > deadline && prev_i != 0)
+					{
+						SKEPU_WARNING("Tuning budget exhausted at size " << prev_i);
+						plan->add(prev_i, max, bestBackendSpec);
+						break;
+					}
+					
 					resize_all_in_tuple(resultArg,  i, instance, true);
 					resize_all_in_tuple(elwiseArgs, i, instance);
 					resize_all_in_tuple(containerArgs, i, instance);
 					
+					ConfigurationTimer time(measure, deadline);
 					auto mintime = benchmark::TimeSpan::max();
-					BackendSpec bestBackendSpec;
 					
 					// Run tests for all available backends
 					for (auto backend : Backend::availableTypes())
 					{
 						BackendSpec spec{backend};
-						instance.setBackend(spec);
-						
-						auto duration = benchmark::basicBenchmark(
-							MEASURE_REPEATS, i,
-							[&] (size_t) {
-								instance(
-									std::get<ResultIdx>(resultArg)...,
-									std::get<ElwiseIdx>(elwiseArgs)...,
-									std::get<ContainerIdx>(containerArgs)...,
-									std::get<UniformIdx>(uniformArgs)...);
-							},
-							[&](benchmark::TimeSpan duration)
-							{
-								skepu::containerutils::updateHostAndInvalidateDevice(
-									std::get<ResultIdx>(resultArg)...,
-									std::get<ElwiseIdx>(elwiseArgs)...,
-									std::get<ContainerIdx>(containerArgs)...);
-							}
-						);
+#ifdef SKEPU_OPENMP
+						// Search the OpenMP parameters, starting from the winner of the previous size
+						if (backend == Backend::Type::OpenMP)
+							spec = bestOpenMPSpec = tuneOpenMP(bestOpenMPSpec, i, time);
+#endif
+						auto duration = time(spec);
 						
 						// If best time, save this
 						if (duration < mintime)
@@ -193,14 +398,24 @@ namespace skepu
 					plan->add(prev_i, i, bestBackendSpec);
 				}
 				
+#ifdef SKEPU_OPENMP
+				omp_set_num_threads(previousThreads);
+#endif
+				if (!key.empty())
+				{
+					db.store(key, *plan);
+					db.save();
+				}
+				
+				instance.resetBackend();
 				instance.setExecPlan(std::move(plan));
 			}
 			
 			
 			template<typename Skeleton>
-			void tune(Skeleton& instance, size_t maxSize = ARG_SIZE_MAX)
+			void tune(Skeleton& instance, size_t maxSize = ARG_SIZE_MAX, double budget = SKEPU_TUNING_BUDGET)
 			{
-				tune_impl(instance, ARG_SIZE_MIN, maxSize, ARG_SIZE_STEP_FACTOR, MEASURE_REPEATS,
+				tune_impl(instance, ARG_SIZE_MIN, maxSize, ARG_SIZE_STEP_FACTOR, MEASURE_REPEATS, budget,
 					typename future_std::make_index_sequence<std::tuple_size<typename Skeleton::ResultArg>::value>::type(),
 					typename future_std::make_index_sequence<std::tuple_size<typename Skeleton::ElwiseArgs>::value>::type(),
 					typename future_std::make_index_sequence<std::tuple_size<typename Skeleton::ContainerArgs>::value>::type(),
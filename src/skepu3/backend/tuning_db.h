@@ -0,0 +1,314 @@
+/*! \file tuning_db.h
+ *  \brief Contains the on-disk database of tuned execution plans.
+ */
+
+#ifndef TUNING_DB_H
+#define TUNING_DB_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "skepu3/impl/backend.hpp"
+
+// Database file used when SKEPU_TUNING_DB is not set in the environment
+#ifndef SKEPU_TUNING_DB
+#define SKEPU_TUNING_DB "skepu_tuning.db"
+#endif
+
+namespace skepu
+{
+	namespace backend
+	{
+		// 64-bit FNV-1a, stable across compilers and runs unlike std::hash
+		inline uint64_t tuningHash(const std::string &s, uint64_t hash = 0xcbf29ce484222325ull)
+		{
+			for (unsigned char c : s)
+				hash = (hash ^ c) * 0x100000001b3ull;
+			return hash;
+		}
+
+		/*!
+		 *  Describes the machine a plan was tuned on: CPU model, hardware thread count and the backends SkePU was
+		 *  built with. Plans are only reused on a host with the same fingerprint.
+		 */
+		inline const std::string &hostFingerprint()
+		{
+			static const std::string fingerprint = []
+			{
+				std::string model = "unknown";
+				std::ifstream cpuinfo("/proc/cpuinfo");
+				for (std::string line; std::getline(cpuinfo, line); )
+					if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos)
+					{
+						model = line.substr(line.find_first_not_of(" ", line.find(':') + 1));
+						break;
+					}
+
+				std::ostringstream ss;
+				ss << model << " x" << std::thread::hardware_concurrency();
+				for (auto type : Backend::availableTypes())
+					ss << " " << type;
+
+				std::string res = ss.str();
+				std::replace(res.begin(), res.end(), '\t', ' ');
+				return res;
+			}();
+			return fingerprint;
+		}
+
+		/*!
+		 *  \class TuningDatabase
+		 *
+		 *  \brief A file of tuned execution plans, keyed by host fingerprint and skeleton instance.
+		 *
+		 *  The file is plain text, one record per plan:
+		 *
+		 *      plan <timestamp>\t<host fingerprint>\t<skeleton key>
+		 *      <low> <high> <backend> <CPU threads> <scheduling> <chunk size> <devices> <GPU blocks> <GPU threads> <CPU ratio>
+		 *      ...
+		 *      end
+		 *
+		 *  Files written on different machines are merged by taking the union of their records. When both contain a
+		 *  plan for the same host and skeleton, the most recently tuned one is kept.
+		 */
+		class TuningDatabase
+		{
+		public:
+			using SizePlan = std::map<std::pair<size_t, size_t>, BackendSpec>;
+
+			TuningDatabase(std::string filename)
+			: m_filename(filename) {}
+
+			/*!
+			 *  The database used by the skeletons. SKEPU_TUNING_DB in the environment is a colon-separated list of
+			 *  files; new plans are saved to the first one, the others are read-only sources such as a database
+			 *  shared between the machines of a cluster. An empty value disables the database.
+			 */
+			static TuningDatabase &global()
+			{
+				static TuningDatabase db = []
+				{
+					const char *env = std::getenv("SKEPU_TUNING_DB");
+					std::string paths = env ? env : SKEPU_TUNING_DB;
+					std::vector<std::string> files;
+					std::istringstream ss(paths);
+					for (std::string file; std::getline(ss, file, ':'); )
+						if (!file.empty())
+							files.push_back(file);
+
+					TuningDatabase res(files.empty() ? std::string{} : files.front());
+					for (size_t i = 1; i < files.size(); ++i)
+						res.m_sources.push_back(files[i]);
+					return res;
+				}();
+				return db;
+			}
+
+			TuningDatabase(TuningDatabase &&other)
+			: m_filename(std::move(other.m_filename)), m_sources(std::move(other.m_sources)),
+			  m_records(std::move(other.m_records)), m_loaded(other.m_loaded) {}
+
+			const std::string &filename() const
+			{
+				return this->m_filename;
+			}
+
+			bool enabled() const
+			{
+				return !this->m_filename.empty();
+			}
+
+			size_t size()
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				this->load();
+				return this->m_records.size();
+			}
+
+			/*!
+			 *  Returns a new plan for \p key tuned on \p host, or nullptr if there is none. The files are read on the
+			 *  first lookup.
+			 */
+			ExecPlan *lookup(const std::string &key, const std::string &host = hostFingerprint())
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				this->load();
+
+				auto it = this->m_records.find(std::make_pair(host, key));
+				if (it == this->m_records.end())
+					return nullptr;
+
+				DEBUG_TEXT_LEVEL1("Loaded tuned execution plan for " << key << " from " << this->m_filename);
+				ExecPlan *plan = new ExecPlan();
+				for (auto &range : it->second.plan)
+					plan->add(range.first.first, range.first.second, range.second);
+				plan->setCalibrated();
+				return plan;
+			}
+
+			void store(const std::string &key, const ExecPlan &plan, const std::string &host = hostFingerprint())
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				this->load();
+				this->m_records[std::make_pair(host, key)] = Record{(int64_t)std::time(nullptr), plan.sizePlan()};
+			}
+
+			//! Adds the records of another database file, keeping the newest plan of each host and skeleton.
+			bool merge(const std::string &filename)
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				this->load();
+				return read(filename, this->m_records);
+			}
+
+			/*!
+			 *  Writes the database, merged with what other processes saved to the file since it was read. The file is
+			 *  replaced atomically, so concurrent jobs never see a partially written database.
+			 */
+			void save()
+			{
+				if (!this->enabled())
+					return;
+
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				this->load();
+				read(this->m_filename, this->m_records);
+
+				// Named after the process, so concurrent jobs sharing the file never write the same temporary file
+				std::ostringstream tmpstream;
+#ifdef _WIN32
+				tmpstream << this->m_filename << ".tmp." << _getpid();
+#else
+				tmpstream << this->m_filename << ".tmp." << getpid();
+#endif
+				const std::string tmpname = tmpstream.str();
+				{
+					std::ofstream file(tmpname);
+					if (!file)
+					{
+						SKEPU_WARNING("Could not write tuning database " << tmpname);
+						return;
+					}
+
+					file << "# SkePU tuning database\n";
+					for (auto &record : this->m_records)
+					{
+						file << "plan " << record.second.timestamp << "\t" << record.first.first << "\t" << record.first.second << "\n";
+						for (auto &range : record.second.plan)
+						{
+							const BackendSpec &spec = range.second;
+							file << range.first.first << " " << range.first.second << " " << spec.backend() << " "
+								<< spec.CPUThreads() << " " << spec.schedulingMode() << " " << spec.CPUChunkSize() << " "
+								<< spec.devices() << " " << spec.GPUBlocks() << " " << spec.GPUThreads() << " "
+								<< spec.CPUPartitionRatio() << "\n";
+						}
+						file << "end\n";
+					}
+				}
+
+				if (std::rename(tmpname.c_str(), this->m_filename.c_str()) != 0)
+					SKEPU_WARNING("Could not replace tuning database " << this->m_filename);
+			}
+
+		private:
+			struct Record
+			{
+				int64_t timestamp;
+				SizePlan plan;
+			};
+
+			using RecordMap = std::map<std::pair<std::string, std::string>, Record>;
+
+			std::string m_filename;
+			std::vector<std::string> m_sources;
+			RecordMap m_records;
+			bool m_loaded = false;
+			std::mutex m_mutex;
+
+			void load()
+			{
+				if (this->m_loaded)
+					return;
+				this->m_loaded = true;
+
+				if (this->enabled())
+					read(this->m_filename, this->m_records);
+				for (auto &source : this->m_sources)
+					read(source, this->m_records);
+			}
+
+			static bool read(const std::string &filename, RecordMap &records)
+			{
+				std::ifstream file(filename);
+				if (!file)
+					return false;
+
+				std::string line;
+				while (std::getline(file, line))
+				{
+					if (line.compare(0, 5, "plan ") != 0)
+						continue;
+
+					size_t tab1 = line.find('\t'), tab2 = line.find('\t', tab1 + 1);
+					if (tab1 == std::string::npos || tab2 == std::string::npos)
+					{
+						SKEPU_WARNING("Malformed record in tuning database " << filename);
+						continue;
+					}
+
+					Record record;
+					record.timestamp = std::strtoll(line.c_str() + 5, nullptr, 10);
+					auto id = std::make_pair(line.substr(tab1 + 1, tab2 - tab1 - 1), line.substr(tab2 + 1));
+
+					while (std::getline(file, line) && line != "end")
+					{
+						std::istringstream ss(line);
+						size_t low, high, threads, chunk, devices, blocks, gpuThreads;
+						std::string type, scheduling;
+						float ratio;
+						if (!(ss >> low >> high >> type >> threads >> scheduling >> chunk >> devices >> blocks >> gpuThreads >> ratio))
+						{
+							SKEPU_WARNING("Malformed plan in tuning database " << filename);
+							continue;
+						}
+
+						BackendSpec spec{Backend::typeFromString(type)};
+						spec.setCPUThreads(threads);
+						spec.setSchedulingMode(Backend::schedulingFromString(scheduling));
+						spec.setCPUChunkSize(chunk);
+						spec.setDevices(devices);
+						spec.setGPUBlocks(blocks);
+						spec.setGPUThreads(gpuThreads);
+						spec.setCPUPartitionRatio(ratio);
+						record.plan.insert(std::make_pair(std::make_pair(low, high), spec));
+					}
+
+					auto it = records.find(id);
+					if (!record.plan.empty() && (it == records.end() || it->second.timestamp < record.timestamp))
+						records[id] = record;
+				}
+				return true;
+			}
+		};
+
+	} // namespace backend
+
+} // namespace skepu
+
+#endif // TUNING_DB_H
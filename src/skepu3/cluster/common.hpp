@@ -57,6 +57,10 @@ namespace skepu
 		struct MatRow {};
 	};
 
+	// Tag for container constructors that allocate storage without initializing the elements
+	struct uninitialized_t {};
+	constexpr uninitialized_t uninitialized {};
+
 Index1D make_index(
 	std::integral_constant<int, 1>,
 	size_t index,
@@ -46,6 +46,12 @@ public:
 			init(rows, cols, val);
 	}
 
+	Matrix(size_type rows, size_type cols, uninitialized_t) noexcept
+	{
+		if(rows && cols)
+			m_data.init(rows, cols);
+	}
+
 	Matrix(std::initializer_list<T> const & l)
 	{
 		auto l_it = l.begin();
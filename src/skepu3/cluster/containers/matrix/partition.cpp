@@ -76,6 +76,8 @@ public:
 	operator=(matrix_partition && other) noexcept
 	-> matrix_partition &
 	{
+		if(this == &other)
+			return *this;
 		this->~matrix_partition();
 		new(this) matrix_partition(std::move(other));
 		return *this;
@@ -51,10 +51,20 @@ protected:
 		m_capacity(std::move(other.m_capacity)),
 		m_data_handle(std::move(other.m_data_handle)),
 		m_handles(std::move(other.m_handles)),
-		m_external(false)
+		m_external(other.m_external)
 	{
+		/* Leave other as a valid empty partition, its destructor must not
+		 * unregister the handles that now belong to this one. */
 		other.m_data = 0;
 		other.m_part_data = 0;
+		other.m_data_valid = false;
+		other.m_part_valid = false;
+		other.m_size = 0;
+		other.m_part_size = 0;
+		other.m_capacity = 0;
+		other.m_data_handle = 0;
+		other.m_handles.assign(cluster::mpi_size(), 0);
+		other.m_external = false;
 	}
 
 	~partition_base() noexcept
@@ -41,7 +41,12 @@ public:
 	}
 
 	tensor3_partition(tensor3_partition && other) noexcept
-	: base(std::move(other))
+	: base(std::move(other)),
+		m_size_i(other.m_size_i),
+		m_size_j(other.m_size_j),
+		m_size_k(other.m_size_k),
+		m_size_jk(other.m_size_jk),
+		m_part_i(other.m_part_i)
 	{}
 
 	~tensor3_partition() noexcept = default;
@@ -75,6 +80,8 @@ public:
 	operator=(tensor3_partition && other) noexcept
 	-> tensor3_partition &
 	{
+		if(this == &other)
+			return *this;
 		this->~tensor3_partition();
 		new(this) tensor3_partition(std::move(other));
 		return *this;
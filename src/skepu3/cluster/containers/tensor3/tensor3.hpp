@@ -34,14 +34,12 @@ private:
 public:
 	explicit Tensor3() noexcept : m_partition() {}
 
-	explicit
 	Tensor3(Tensor3 const & other) noexcept
 	: m_partition(other.m_partition)
 	{}
 
-	explicit
 	Tensor3(Tensor3 && other) noexcept
-	: m_partition(std::move(other))
+	: m_partition(std::move(other.m_partition))
 	{}
 
 	explicit
@@ -58,6 +56,12 @@ public:
 			init(i, j, k, val);
 	}
 
+	Tensor3(size_type i, size_type j, size_type k, uninitialized_t)
+	{
+		if(i && j && k)
+			m_partition.init(i, j, k);
+	}
+
 	~Tensor3() noexcept = default;
 
 	auto
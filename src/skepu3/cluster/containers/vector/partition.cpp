@@ -62,6 +62,8 @@ public:
 	operator=(vector_partition && other) noexcept
 	-> vector_partition &
 	{
+		if(this == &other)
+			return *this;
 		this->~vector_partition();
 		new(this) vector_partition(std::move(other));
 
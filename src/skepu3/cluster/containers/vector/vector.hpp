@@ -65,6 +65,12 @@ public:
 			init(count, val);
 	}
 
+	Vector(size_type count, uninitialized_t) noexcept
+	{
+		if(count)
+			m_data.init(count);
+	}
+
 	Vector(pointer p, size_type count, bool deallocEnabled)
 	{
 		// TODO: p shoudl realy live as long as the container lives.
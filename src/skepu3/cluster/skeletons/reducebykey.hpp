@@ -0,0 +1,40 @@
+#pragma once
+#ifndef SKEPU_CLUSTER_REDUCEBYKEY_HPP
+#define SKEPU_CLUSTER_REDUCEBYKEY_HPP 1
+
+namespace skepu {
+namespace backend {
+
+/* The StarPU MPI backend has no ReduceByKey or Histogram. A key can occur in
+ * any block of a distributed container, so every rank would need a copy of the
+ * bins and an all-reduce over them, which the skeleton tasks do not provide.
+ * Programs using them are rejected when the skeleton instance is created
+ * instead of failing on a missing type in the precompiled source. */
+template<typename KeyFunc, typename RedFunc, typename CUDAKernel, typename CLKernel>
+class ReduceByKey
+{
+public:
+	template<typename... Args>
+	ReduceByKey(Args&&...)
+	{
+		static_assert(sizeof(KeyFunc) == 0,
+			"ReduceByKey is not supported by the StarPU MPI backend");
+	}
+};
+
+template<typename KeyFunc, typename CUDAKernel, typename CLKernel>
+class Histogram
+{
+public:
+	template<typename... Args>
+	Histogram(Args&&...)
+	{
+		static_assert(sizeof(KeyFunc) == 0,
+			"Histogram is not supported by the StarPU MPI backend");
+	}
+};
+
+} // namespace backend
+} // namespace skepu
+
+#endif // SKEPU_CLUSTER_REDUCEBYKEY_HPP
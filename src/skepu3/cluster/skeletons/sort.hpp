@@ -0,0 +1,28 @@
+#pragma once
+#ifndef SKEPU_CLUSTER_SORT_HPP
+#define SKEPU_CLUSTER_SORT_HPP 1
+
+namespace skepu {
+namespace backend {
+
+/* The StarPU MPI backend has no Sort. Sorting a distributed container moves
+ * elements between the blocks of different ranks, e.g. by a sample sort with
+ * an all-to-all exchange, while the skeleton tasks only work on the blocks each
+ * rank owns. Programs using it are rejected when the skeleton instance is
+ * created instead of failing on a missing type in the precompiled source. */
+template<typename SortFunc, typename CUDAKernel, typename CLKernel>
+class Sort
+{
+public:
+	template<typename... Args>
+	Sort(Args&&...)
+	{
+		static_assert(sizeof(SortFunc) == 0,
+			"Sort is not supported by the StarPU MPI backend");
+	}
+};
+
+} // namespace backend
+} // namespace skepu
+
+#endif // SKEPU_CLUSTER_SORT_HPP
@@ -6,6 +6,8 @@
 #include <cassert>
 #include <algorithm>
 #include <map>
+#include <array>
+#include <limits>
 
 
 #ifdef SKEPU_OPENMP
@@ -35,6 +37,11 @@
 #define SKEPU_DEFAULT_GPU_THREADS 65535
 #endif
 
+// Number of recently selected problem sizes an execution plan remembers.
+#ifndef SKEPU_SELECTION_CACHE_SIZE
+#define SKEPU_SELECTION_CACHE_SIZE 4
+#endif
+
 // Set default hybrid partition ratio if not supplied from elsewhere.
 #ifndef SKEPU_DEFAULT_CPU_PARTITION_RATIO
 #define SKEPU_DEFAULT_CPU_PARTITION_RATIO 0.2f
@@ -46,7 +53,7 @@ namespace skepu
 	{
 		enum class Type
 		{
-			Auto, CPU, OpenMP, OpenCL, CUDA, Hybrid
+			Auto, CPU, OpenMP, OpenCL, CUDA, Hybrid, TaskPool
 		};
 		
 		enum class Scheduling
@@ -60,7 +67,7 @@ namespace skepu
 		{
 			static const std::vector<Backend::Type> types
 			{
-				Backend::Type::CPU, Backend::Type::OpenMP, Backend::Type::OpenCL, Backend::Type::CUDA, Backend::Type::Hybrid
+				Backend::Type::CPU, Backend::Type::OpenMP, Backend::Type::OpenCL, Backend::Type::CUDA, Backend::Type::Hybrid, Backend::Type::TaskPool
 			};
 			
 			return types;
@@ -82,6 +89,9 @@ namespace skepu
 #endif
 #ifdef SKEPU_HYBRID
 				Backend::Type::Hybrid,
+#endif
+#ifdef SKEPU_TASKPOOL
+				Backend::Type::TaskPool,
 #endif
 			};
 			
@@ -110,10 +120,21 @@ namespace skepu
 			else if (s == "opencl") return Type::OpenCL;
 			else if (s == "cuda") return Type::CUDA;
 			else if (s == "hybrid") return Type::Hybrid;
+			else if (s == "taskpool") return Type::TaskPool;
 			else if (s == "auto") return Type::CUDA;
 			else SKEPU_ERROR("Invalid string for backend type conversion");
 		}
 		
+		static Scheduling schedulingFromString(std::string s)
+		{
+			std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+			if (s == "static") return Scheduling::Static;
+			else if (s == "dynamic") return Scheduling::Dynamic;
+			else if (s == "guided") return Scheduling::Guided;
+			else if (s == "auto") return Scheduling::Auto;
+			else SKEPU_ERROR("Invalid string for scheduling mode conversion");
+		}
+		
 		static bool isTypeAvailable(Type type)
 		{
 			return type == Backend::Type::Auto ||
@@ -135,6 +156,7 @@ namespace skepu
 		case Backend::Type::OpenCL: o << "OpenCL"; break;
 		case Backend::Type::CUDA:   o << "CUDA"; break;
 		case Backend::Type::Hybrid:   o << "Hybrid"; break;
+		case Backend::Type::TaskPool: o << "TaskPool"; break;
 		case Backend::Type::Auto:   o << "Auto"; break;
 		default: o << ("Invalid backend type");
 		}
@@ -303,7 +325,7 @@ namespace skepu
 		size_t m_GPUThreads {defaultGPUThreads};
 		size_t m_blocks {defaultGPUBlocks};
 		
-		// OpenMP parameters
+		// OpenMP and TaskPool parameters
 #ifdef SKEPU_OPENMP
 		size_t m_CPUThreads {(size_t)omp_get_max_threads()};
 #else
@@ -330,6 +352,11 @@ namespace skepu
 			o << " - OpenMP Scheduling: " << b.m_openmp_scheduling_mode << "\n";
 			o << " - OpenMP Chunk Size: " << b.m_openmp_chunk_size << "\n";
 		}
+		if (b.m_backend == Backend::Type::TaskPool)
+		{
+			o << " - TaskPool Threads:    " << b.m_CPUThreads << "\n";
+			o << " - TaskPool Grain Size: " << b.m_openmp_chunk_size << "\n";
+		}
 		if (b.m_backend == Backend::Type::OpenCL || b.m_backend == Backend::Type::CUDA || b.m_backend == Backend::Type::Hybrid)
 		{
 			o << " - GPU Devices: " << b.m_devices << "\n";
@@ -377,15 +404,12 @@ namespace skepu
 	public:
 		ExecPlan() : m_calibrated(false)
 		{
-			this->m_cacheEntry.first = 0;
 			cpuModel = nullptr;
 			gpuModel = nullptr;
 		}
 		
 		ExecPlan(skepu::ExecutionTimeModel* _cpuModel, skepu::ExecutionTimeModel* _gpuModel) : cpuModel{_cpuModel}, gpuModel{_gpuModel}, m_calibrated(false)
-		{
-			this->m_cacheEntry.first = 0;
-		}
+		{}
 		
 		~ExecPlan()
 		{
@@ -401,6 +425,7 @@ namespace skepu
 			bspec.setGPUThreads(bs);
 			bspec.setGPUBlocks(gs);
 			this->m_sizePlan.insert(std::make_pair(std::make_pair(lowBound, highBound), bspec));
+			this->invalidate();
 		}
 		
 		void add(size_t lowBound, size_t highBound, Backend::Type backend, size_t numOmpThreads)
@@ -408,17 +433,20 @@ namespace skepu
 			BackendSpec bspec(backend);
 			bspec.setCPUThreads(numOmpThreads);
 			this->m_sizePlan.insert(std::make_pair(std::make_pair(lowBound, highBound), bspec));
+			this->invalidate();
 		}
 		
 		void add(size_t lowBound, size_t highBound, BackendSpec bspec)
 		{
 			this->m_sizePlan.insert(std::make_pair(std::make_pair(lowBound, highBound), bspec));
+			this->invalidate();
 		}
 		
 		void add(size_t lowBound, size_t highBound, Backend::Type backend)
 		{
 			BackendSpec bspec(backend);
 			this->m_sizePlan.insert(std::make_pair(std::make_pair(lowBound, highBound), bspec));
+			this->invalidate();
 		}
 		
 		
@@ -427,7 +455,8 @@ namespace skepu
 			if (this->m_sizePlan.empty())
 				SKEPU_ERROR("Empty execution plan!");
 			
-			this->find(size).setCPUThreads(maxthreads);
+			this->entry(size).setCPUThreads(maxthreads);
+			this->invalidate();
 		}
 		
 		size_t CPUThreads(size_t size)
@@ -444,7 +473,8 @@ namespace skepu
 			if (this->m_sizePlan.empty())
 				SKEPU_ERROR("Empty execution plan!");
 			
-			this->find(size).setGPUThreads(maxthreads);
+			this->entry(size).setGPUThreads(maxthreads);
+			this->invalidate();
 		}
 		
 		size_t GPUThreads(size_t size)
@@ -461,7 +491,8 @@ namespace skepu
 			if (this->m_sizePlan.empty())
 				SKEPU_ERROR("Empty execution plan!");
 			
-			this->find(size).setGPUBlocks(maxblocks);
+			this->entry(size).setGPUBlocks(maxblocks);
+			this->invalidate();
 		}
 		
 		size_t GPUblocks(size_t size)
@@ -478,7 +509,8 @@ namespace skepu
 			if (this->m_sizePlan.empty())
 				SKEPU_ERROR("Empty execution plan!");
 			
-			this->find(size).setDevices(maxdevices);
+			this->entry(size).setDevices(maxdevices);
+			this->invalidate();
 		}
 		
 		size_t devices(size_t size)
@@ -495,12 +527,22 @@ namespace skepu
 			if (this->m_sizePlan.empty())
 				return false;
 			
-			for (auto plan : this->m_sizePlan)
-			{
-				if (size >= plan.first.first && size <= plan.first.second)
-					return true;
-			}
-			return false;
+			return this->owner(size) != nullptr;
+		}
+		
+		/*!
+		 * Feeds the measured times of the CPU and GPU parts of a hybrid call back into the execution time models,
+		 * so that the partitioning follows the problem sizes seen in production.
+		 */
+		void observeHybrid(size_t cpuSize, double cpuTime, size_t gpuSize, double gpuTime)
+		{
+			if (!cpuModel || !gpuModel)
+				return;
+			
+			bool refitted = cpuModel->observe(cpuSize, cpuTime);
+			refitted = gpuModel->observe(gpuSize, gpuTime) || refitted;
+			if (refitted)
+				this->invalidate();
 		}
 		
 		bool isCalibrated()
@@ -513,47 +555,106 @@ namespace skepu
 			this->m_calibrated = true;
 		}
 		
+		/*!
+		 * The backend specification for a problem size. Recently used sizes are served from a small cache, others
+		 * by a binary search over the size ranges, so the cost does not grow with the number of ranges.
+		 */
 		BackendSpec &find(size_t size)
 		{
 			if (this->m_sizePlan.empty())
 				SKEPU_ERROR("Empty execution plan!");
 			
-			if (this->m_cacheEntry.first == size)
-				return m_cacheEntry.second;
+			for (size_t i = 0; i < this->m_cacheUsed; ++i)
+				if (this->m_cache[i].first == size)
+					return this->m_cache[i].second;
 			
-			for (auto plan : this->m_sizePlan)
-			{
-				if (size >= plan.first.first && size <= plan.first.second)
-				{
-					if(cpuModel and gpuModel)
-					{
-						float cpuRatio = ExecutionTimeModel::predictCPUPartitionRatio(*cpuModel, *gpuModel, size);
-						plan.second.setCPUPartitionRatio(cpuRatio);
-					}
-					
-					this->m_cacheEntry = std::make_pair(size, plan.second);
-					return this->m_cacheEntry.second;
-				}
-			}
+			auto &cached = this->m_cache[this->m_cacheNext];
+			this->m_cacheNext = (this->m_cacheNext + 1) % SKEPU_SELECTION_CACHE_SIZE;
+			if (this->m_cacheUsed < SKEPU_SELECTION_CACHE_SIZE)
+				this->m_cacheUsed++;
 			
-			if(cpuModel and gpuModel)
+			cached.first = size;
+			cached.second = this->entry(size);
+			if(cpuModel and gpuModel and cpuModel->isFitted() and gpuModel->isFitted())
 			{
 				float cpuRatio = ExecutionTimeModel::predictCPUPartitionRatio(*cpuModel, *gpuModel, size);
-				this->m_sizePlan.rbegin()->second.setCPUPartitionRatio(cpuRatio);
+				cached.second.setCPUPartitionRatio(cpuRatio);
 			}
-			this->m_cacheEntry = std::make_pair(size, this->m_sizePlan.rbegin()->second);
-			return this->m_cacheEntry.second;
+			return cached.second;
 		}
 		
 		void clear()
 		{
 			this->m_sizePlan.clear();
+			this->invalidate();
+		}
+		
+		const std::map<std::pair<size_t, size_t>, BackendSpec> &sizePlan() const
+		{
+			return this->m_sizePlan;
 		}
 		
 	private:
-		std::pair<size_t, BackendSpec> m_cacheEntry;
 		std::map<std::pair<size_t, size_t>, BackendSpec> m_sizePlan;
 		
+		// The ranges resolved into disjoint intervals starting at ´m_bounds´, covered by ´m_owners´ (nullptr if
+		// no range covers the interval). Where ranges overlap, the first in the map wins.
+		std::vector<size_t> m_bounds;
+		std::vector<BackendSpec*> m_owners;
+		bool m_indexed = false;
+		
+		std::array<std::pair<size_t, BackendSpec>, SKEPU_SELECTION_CACHE_SIZE> m_cache;
+		size_t m_cacheUsed = 0;
+		size_t m_cacheNext = 0;
+		
+		void invalidate()
+		{
+			this->m_indexed = false;
+			this->m_cacheUsed = 0;
+			this->m_cacheNext = 0;
+		}
+		
+		void buildIndex()
+		{
+			std::vector<size_t> bounds;
+			for (auto &range : this->m_sizePlan)
+			{
+				bounds.push_back(range.first.first);
+				if (range.first.second != std::numeric_limits<size_t>::max())
+					bounds.push_back(range.first.second + 1);
+			}
+			std::sort(bounds.begin(), bounds.end());
+			bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+			
+			this->m_bounds = bounds;
+			this->m_owners.assign(bounds.size(), nullptr);
+			for (size_t i = 0; i < bounds.size(); ++i)
+				for (auto &range : this->m_sizePlan)
+					if (bounds[i] >= range.first.first && bounds[i] <= range.first.second)
+					{
+						this->m_owners[i] = &range.second;
+						break;
+					}
+			
+			this->m_indexed = true;
+		}
+		
+		BackendSpec *owner(size_t size)
+		{
+			if (!this->m_indexed)
+				this->buildIndex();
+			
+			auto it = std::upper_bound(this->m_bounds.begin(), this->m_bounds.end(), size);
+			return (it == this->m_bounds.begin()) ? nullptr : this->m_owners[it - this->m_bounds.begin() - 1];
+		}
+		
+		// The range containing ´size´, or the last range if there is none
+		BackendSpec &entry(size_t size)
+		{
+			BackendSpec *spec = this->owner(size);
+			return spec ? *spec : this->m_sizePlan.rbegin()->second;
+		}
+		
 		skepu::ExecutionTimeModel* cpuModel;
 		skepu::ExecutionTimeModel* gpuModel;
 		
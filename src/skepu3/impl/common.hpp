@@ -51,6 +51,14 @@ namespace skepu
 		struct MatRow {};
 	};
 	
+	// Tag for container constructors that allocate storage without initializing the elements
+	struct uninitialized_t {};
+	constexpr uninitialized_t uninitialized {};
+	
+	// Tag for container constructors that map a binary file as storage instead of reading it
+	struct memory_mapped_t {};
+	constexpr memory_mapped_t memory_mapped {};
+	
 	inline Index1D make_index(std::integral_constant<int, 1>, size_t index, size_t, size_t, size_t)
 	{
 		return Index1D{index};
@@ -227,6 +235,17 @@ namespace skepu
 		return m == AccessMode::Write || m == AccessMode::ReadWrite;
 	}
 	
+	static inline constexpr bool anyWriteAccess()
+	{
+		return false;
+	}
+	
+	template<typename... Modes>
+	static inline constexpr bool anyWriteAccess(AccessMode m, Modes... modes)
+	{
+		return hasWriteAccess(m) || anyWriteAccess(modes...);
+	}
+	
 	enum class SkeletonType
 	{
 		Map,
@@ -241,6 +260,10 @@ namespace skepu
 		MapOverlap3D,
 		MapOverlap4D,
 		Call,
+		SpMV,
+		ReduceByKey,
+		Histogram,
+		Sort,
 	};
 	
 	
@@ -307,6 +330,8 @@ namespace skepu
 #include "skepu3/matrix.hpp"
 #include "skepu3/tensor.hpp"
 #include "skepu3/sparse_matrix.hpp"
+#include "skepu3/view.hpp"
+#include "skepu3/soa.hpp"
 
 namespace skepu
 {
@@ -374,13 +399,38 @@ namespace skepu
 	struct is_skepu_tensor4<skepu::Tensor4<T>>: std::true_type {};
 	
 	
+	template<typename T>
+	struct is_skepu_view: std::false_type {};
+	
+	template<typename T>
+	struct is_skepu_view<skepu::VectorView<T>>: std::true_type {};
+	
+	template<typename T, typename Parent>
+	struct is_skepu_view<skepu::MatrixView<T, Parent>>: std::true_type {};
+	
+	template<typename T>
+	struct is_skepu_view<skepu::Tensor3View<T>>: std::true_type {};
+	
+	
+	template<typename T>
+	struct is_skepu_soa: std::false_type {};
+	
+	template<typename T>
+	struct is_skepu_soa<skepu::VectorSoA<T>>: std::true_type {};
+	
+	template<typename T>
+	struct is_skepu_soa<skepu::MatrixSoA<T>>: std::true_type {};
+	
+	
 	template<typename T>
 	struct is_skepu_container:
 		std::integral_constant<bool,
 			is_skepu_vector<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value ||
 			is_skepu_matrix<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value ||
 			is_skepu_tensor3<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value ||
-			is_skepu_tensor4<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value> {};
+			is_skepu_tensor4<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value ||
+			is_skepu_view<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value ||
+			is_skepu_soa<typename std::remove_cv<typename std::remove_reference<T>::type>::type>::value> {};
 
 	/** Check that all parameters in a pack are SkePU containers. */
 	template<typename ...> struct are_skepu_containers;
@@ -447,6 +497,22 @@ namespace skepu
 		std::is_same<T, typename Matrix<Ret>::iterator>::value
 	> {};
 	
+	// true iff T iterates over the dense storage of a container, so that the elements are reachable through a raw pointer
+	template<typename T>
+	struct is_contiguous_iterator: std::false_type {};
+	
+	template<typename T>
+	struct is_contiguous_iterator<VectorIterator<T>>: std::true_type {};
+	
+	template<typename T>
+	struct is_contiguous_iterator<MatrixIterator<T>>: std::true_type {};
+	
+	template<typename T>
+	struct is_contiguous_iterator<Tensor3Iterator<T>>: std::true_type {};
+	
+	template<typename T>
+	struct is_contiguous_iterator<Tensor4Iterator<T>>: std::true_type {};
+	
 	
 	// ----------------------------------------------------------------
 	// index trait classes for skepu::IndexND (N in [1,2,3,4])
@@ -584,4 +650,79 @@ namespace skepu
 		}
 	};
 	
+	
+	// ----------------------------------------------------------------
+	// Binding user function results to output elements
+	// ----------------------------------------------------------------
+	
+	template<typename T>
+	inline std::tuple<const T&> result_tuple(const T &res)
+	{
+		return std::tuple<const T&>(res);
+	}
+	
+	template<typename... T>
+	inline const std::tuple<T...> &result_tuple(const std::tuple<T...> &res)
+	{
+		return res;
+	}
+	
+	// Assigns a (multiple) return value to the output elements, which are references or element proxies such as SoARef
+	template<typename Res, typename... Outs>
+	inline void bind_result(const Res &res, Outs&&... outs)
+	{
+		std::forward_as_tuple(std::forward<Outs>(outs)...) = result_tuple(res);
+	}
+	
+	
+	// ----------------------------------------------------------------
+	// Symmetry of MapPairs user functions
+	// ----------------------------------------------------------------
+	
+	/*!
+	 *  Declares how the result for pair (j, i) follows from the result for pair (i, j) in MapPairs and MapPairsReduce.
+	 *  With symmetric or antisymmetric pairs the host backends only evaluate the upper triangle, which requires
+	 *  equally long vertical and horizontal operands.
+	 */
+	enum class Symmetry
+	{
+		None, Symmetric, Antisymmetric
+	};
+	
+	inline std::ostream &operator<<(std::ostream &o, Symmetry s)
+	{
+		switch (s)
+		{
+		case Symmetry::None:
+			o << "None"; break;
+		case Symmetry::Symmetric:
+			o << "Symmetric"; break;
+		case Symmetry::Antisymmetric:
+			o << "Antisymmetric"; break;
+		default:
+			o << "<Invalid symmetry>";
+		}
+		return o;
+	}
+	
+	template<typename T>
+	inline auto negate_pair(const T &value, int) -> decltype(T(-value))
+	{
+		return T(-value);
+	}
+	
+	template<typename T>
+	inline T negate_pair(const T &value, long)
+	{
+		SKEPU_ERROR("Antisymmetric pairs require a result type with unary minus");
+		return value;
+	}
+	
+	// The result for pair (j, i) given the result for pair (i, j)
+	template<typename T>
+	inline T mirror_pair(const T &value, Symmetry symmetry)
+	{
+		return (symmetry == Symmetry::Antisymmetric) ? negate_pair(value, 0) : value;
+	}
+	
 }
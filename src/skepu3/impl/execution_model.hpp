@@ -5,6 +5,18 @@
 #include <vector> 
 #include <utility> 
 #include <cmath> 
+#include <algorithm>
+#include <limits>
+
+// Most recent data points kept by a model refitted online
+#ifndef SKEPU_MODEL_MAX_POINTS
+#define SKEPU_MODEL_MAX_POINTS 128
+#endif
+
+// Number of online observations between two refits
+#ifndef SKEPU_MODEL_REFIT_INTERVAL
+#define SKEPU_MODEL_REFIT_INTERVAL 16
+#endif
 
 
 namespace skepu
@@ -21,44 +33,235 @@ namespace skepu
 	 * Add data points to the model by using the addDataPoint() method. Then calculate the 
 	 * model from the data using fitModel(). New data point can be added after the model is fitted, 
 	 * but the fitModel() method must be executed again, to refit the model.
+	 * 
+	 * Timings observed during normal calls are added with observe() instead, which keeps the model
+	 * fitted and refits it every SKEPU_MODEL_REFIT_INTERVAL observations on the most recent
+	 * SKEPU_MODEL_MAX_POINTS data points.
 	 */
 	class ExecutionTimeModel
 	{
-		std::vector<std::pair<size_t, double> > m_entries;
-		double m_sumX = 0.0;
-		double m_sumY = 0.0;
+	public:
+		/*!
+		 * The shape of the model. Linear fits a single line y = a*x + b. LogLog fits a line to
+		 * log(y) over log(x), i.e. a power law. Piecewise fits log-log lines between breakpoints
+		 * found in the data, such as the problem sizes where the working set leaves a cache level.
+		 */
+		enum class Kind
+		{
+			Linear, LogLog, Piecewise
+		};
+	
+	private:
+		// A line valid from ´from´ up to the next segment, in log-log space unless the model is linear
+		struct Segment
+		{
+			double from;
+			double a;
+			double b;
+			double sigma; // Standard deviation of the residuals
+		};
 		
-		// The model y = a*x + b
-		double m_a = 0.0;
-		double m_b = 0.0;
+		Kind m_kind;
+		std::vector<std::pair<size_t, double> > m_entries;
+		std::vector<Segment> m_segments;
 		
 		bool m_fitted;
+		size_t m_newPoints = 0;
+		
+		bool logarithmic() const {
+			return m_kind != Kind::Linear;
+		}
+		
+		// Data points in the space the model is fitted in, sorted on x
+		std::vector<std::pair<double, double> > transformedPoints() const {
+			std::vector<std::pair<double, double> > points;
+			for (auto &entry : m_entries) {
+				if (not logarithmic())
+					points.emplace_back((double)entry.first, entry.second);
+				else if (entry.first > 0 && entry.second > 0.0)
+					points.emplace_back(std::log((double)entry.first), std::log(entry.second));
+			}
+			std::sort(points.begin(), points.end());
+			return points;
+		}
+		
+		/*!
+		 * Least squares line through points [first, last) using the prefix sums of x, y, x^2, xy and y^2.
+		 * Returns the sum of squared residuals.
+		 */
+		static double fitLine(const std::vector<double> (&sums)[5], size_t first, size_t last, Segment &segment) {
+			const double n = (double)(last - first);
+			const double sx = sums[0][last] - sums[0][first], sy = sums[1][last] - sums[1][first];
+			const double sxx = sums[2][last] - sums[2][first], sxy = sums[3][last] - sums[3][first];
+			const double syy = sums[4][last] - sums[4][first];
+			
+			const double varX = sxx - sx*sx/n;
+			segment.a = (varX > 1e-12) ? (sxy - sx*sy/n) / varX : 0.0;
+			segment.b = (sy - segment.a*sx) / n;
+			
+			double sse = syy - 2*segment.a*sxy - 2*segment.b*sy + segment.a*segment.a*sxx + 2*segment.a*segment.b*sx + n*segment.b*segment.b;
+			sse = std::max(sse, 0.0);
+			segment.sigma = (n > 2) ? std::sqrt(sse / (n - 2)) : 0.0;
+			return sse;
+		}
+		
+		/*!
+		 * Segmented least squares by dynamic programming: the best fit with k segments is found for each k,
+		 * and the number of segments is chosen by the Bayesian information criterion so that breakpoints are
+		 * only introduced where they explain the data substantially better.
+		 */
+		bool fit() {
+			const size_t maxSegments = 6;
+			const size_t minSegmentPoints = 3;
+			
+			auto points = transformedPoints();
+			const size_t n = points.size();
+			if (n < 2 || points.front().first == points.back().first)
+				return false;
+			
+			std::vector<double> sums[5];
+			for (auto &s : sums)
+				s.assign(n + 1, 0.0);
+			for (size_t i = 0; i < n; ++i) {
+				const double x = points[i].first, y = points[i].second;
+				sums[0][i+1] = sums[0][i] + x;
+				sums[1][i+1] = sums[1][i] + y;
+				sums[2][i+1] = sums[2][i] + x*x;
+				sums[3][i+1] = sums[3][i] + x*y;
+				sums[4][i+1] = sums[4][i] + y*y;
+			}
+			
+			const size_t kMax = (m_kind == Kind::Piecewise) ? std::max<size_t>(1, std::min(maxSegments, n / minSegmentPoints)) : 1;
+			const double inf = std::numeric_limits<double>::infinity();
+			
+			// cost[k][j]: least error of k segments over the first j points, split[k][j]: start of the last one
+			std::vector<std::vector<double> > cost(kMax + 1, std::vector<double>(n + 1, inf));
+			std::vector<std::vector<size_t> > split(kMax + 1, std::vector<size_t>(n + 1, 0));
+			cost[0][0] = 0.0;
+			Segment segment;
+			
+			for (size_t k = 1; k <= kMax; ++k)
+				for (size_t j = 1; j <= n; ++j) {
+					// Segments end between distinct sizes and hold enough points, except a single segment
+					if (j < n && points[j].first == points[j-1].first)
+						continue;
+					for (size_t i = (k - 1) * minSegmentPoints; i < j; ++i) {
+						if (cost[k-1][i] == inf || (kMax > 1 && j - i < minSegmentPoints))
+							continue;
+						const double c = cost[k-1][i] + fitLine(sums, i, j, segment);
+						if (c < cost[k][j]) {
+							cost[k][j] = c;
+							split[k][j] = i;
+						}
+					}
+				}
+			
+			size_t bestK = 0;
+			double bestScore = inf;
+			for (size_t k = 1; k <= kMax; ++k) {
+				if (cost[k][n] == inf)
+					continue;
+				const double score = n * std::log(std::max(cost[k][n] / n, 1e-12)) + 3.0 * k * std::log((double)n);
+				if (score < bestScore) {
+					bestScore = score;
+					bestK = k;
+				}
+			}
+			if (bestK == 0)
+				return false;
+			
+			m_segments.assign(bestK, Segment{});
+			for (size_t k = bestK, j = n; k > 0; j = split[k][j], --k) {
+				const size_t i = split[k][j];
+				fitLine(sums, i, j, m_segments[k-1]);
+				m_segments[k-1].from = points[i].first;
+			}
+			
+			if (m_kind == Kind::Linear && m_segments[0].a < 0.0) {
+				// Don't allow execution time to reduce with the input size
+				m_segments[0].a = 0.0;
+			}
+			
+			m_fitted = true;
+			m_newPoints = 0;
+			return true;
+		}
 		
+		const Segment &segmentFor(double x) const {
+			auto it = std::upper_bound(m_segments.begin(), m_segments.end(), x,
+				[] (double value, const Segment &s) { return value < s.from; });
+			return (it == m_segments.begin()) ? *it : *(it - 1);
+		}
+	
 	public:
-		ExecutionTimeModel() : m_fitted{false} 
+		ExecutionTimeModel(Kind kind = Kind::Piecewise) : m_kind{kind}, m_fitted{false}
 		{
 		};
 		
+		Kind kind() const {
+			return m_kind;
+		}
+		
 		void addDataPoint(size_t problemSize, double executionTime) {
 			m_fitted = false;
 			
 			m_entries.push_back(std::make_pair(problemSize, executionTime));
-			m_sumX += (double) problemSize;
-			m_sumY += executionTime;
+		}
+		
+		/*!
+		 * Adds a timing observed outside of tuning. The oldest data points are dropped so that the
+		 * model follows the current workload, and the model is refitted periodically. Returns true if
+		 * the model was refitted.
+		 */
+		bool observe(size_t problemSize, double executionTime) {
+			m_entries.push_back(std::make_pair(problemSize, executionTime));
+			if (m_entries.size() > SKEPU_MODEL_MAX_POINTS)
+				m_entries.erase(m_entries.begin(), m_entries.end() - SKEPU_MODEL_MAX_POINTS);
+			
+			return ++m_newPoints >= SKEPU_MODEL_REFIT_INTERVAL && fit();
 		}
 		
 		double getPredictedTime(size_t problemSize) const {
 			if(not m_fitted)
 				SKEPU_ERROR("getPredictedTime(): ExecutionTimeModel is not fitted!");
 			
-			return m_a*problemSize + m_b;
+			if (not logarithmic())
+				return m_segments[0].a*problemSize + m_segments[0].b;
+			
+			if (problemSize == 0)
+				return 0.0;
+			
+			const double x = std::log((double)problemSize);
+			const Segment &s = segmentFor(x);
+			return std::exp(s.a*x + s.b);
+		}
+		
+		/*!
+		 * Interval expected to contain the execution time, \p z residual standard deviations around the
+		 * prediction. For the logarithmic models the bounds are relative to the prediction.
+		 */
+		std::pair<double, double> getPredictionInterval(size_t problemSize, double z = 2.0) const {
+			const double predicted = getPredictedTime(problemSize);
+			
+			if (not logarithmic())
+				return std::make_pair(std::max(0.0, predicted - z*m_segments[0].sigma), predicted + z*m_segments[0].sigma);
+			
+			if (problemSize == 0)
+				return std::make_pair(0.0, 0.0);
+			
+			const double factor = std::exp(z * segmentFor(std::log((double)problemSize)).sigma);
+			return std::make_pair(predicted / factor, predicted * factor);
 		}
 		
 		double getR2Error() const {
 			if(not m_fitted)
 				SKEPU_ERROR("getR2Error(): ExecutionTimeModel is not fitted!");
 			
-			double yMean = m_sumY / (double) m_entries.size();
+			double yMean = 0.0;
+			for (auto &entry : m_entries)
+				yMean += entry.second;
+			yMean /= (double) m_entries.size();
+			
 			double res = 0.0;
 			double tot = 0.0;
 			
@@ -72,44 +275,27 @@ namespace skepu
 		}
 		
 		
+		// Coefficients of the last segment, in log-log space for the logarithmic models
 		double getA() const {
-			return m_a;
+			return m_segments.empty() ? 0.0 : m_segments.back().a;
 		}
 		
 		double getB() const {
-			return m_b;
+			return m_segments.empty() ? 0.0 : m_segments.back().b;
+		}
+		
+		// Problem sizes where a new segment starts
+		std::vector<size_t> getBreakpoints() const {
+			std::vector<size_t> res;
+			for (size_t i = 1; i < m_segments.size(); ++i)
+				res.push_back((size_t)std::round(logarithmic() ? std::exp(m_segments[i].from) : m_segments[i].from));
+			return res;
 		}
 		
 		
-		/*!
-		 * Simple linear regression implemented based on: https://en.wikipedia.org/wiki/Simple_linear_regression#Fitting_the_regression_line
-		 */
 		void fitModel() {
-			int numPoints = m_entries.size();
-			if(numPoints < 2)
-				SKEPU_ERROR("Must have at least two points for a polynomial fit!");
-			
-			double nominator = 0.0;
-			double denominator = 0.0;
-			double xMean = m_sumX / (double)numPoints;
-			double yMean = m_sumY / (double)numPoints;
-			
-			for(size_t i = 0; i < numPoints; ++i) {
-				double xi = (double) m_entries[i].first;
-				double yi = m_entries[i].second;
-				nominator += (xi - xMean)*(yi - yMean);
-				denominator += (xi - xMean)*(xi - xMean);
-			}
-			
-			if(std::abs(denominator) < 1e-9)
-				SKEPU_ERROR("Error in linear fitting, seems to be a vertical line");
-			
-			m_a = nominator / denominator;
-			m_b = yMean - m_a*xMean;
-			if(m_a < 0.0)
-				m_a = 0.0; // Don't allow execution time to reduce with the input size
-			
-			m_fitted = true;
+			if (not fit())
+				SKEPU_ERROR("Must have at least two points of different problem sizes to fit a model!");
 		}
 		
 		
@@ -128,25 +314,32 @@ namespace skepu
 			if(not gpuModel.isFitted())
 				SKEPU_ERROR("GPU model is not fitted!");
 			
-			// Based on cpu.a*x*pS + cpu.b == gpu.a*(1-x)*pS + gpu.b, where x is CPU partition ratio and pS is problemSize.
-			double nominator = gpuModel.m_a*problemSize - cpuModel.m_b + gpuModel.m_b;
-			double denominator = (cpuModel.m_a + gpuModel.m_a)*problemSize;
-
-			if(std::abs(denominator) < 1e-9) {
-				// Lines does not cross, choose to map whole problemSize to CPU or GPU
-				return cpuModel.getPredictedTime(problemSize) < gpuModel.getPredictedTime(problemSize) ? 1.0 : 0.0;
+			// Find x where cpu(x*pS) == gpu((1-x)*pS), x is CPU partition ratio and pS is problemSize. The models
+			// need not be linear, so the crossing is found by bisection.
+			auto imbalance = [&] (double ratio) {
+				const size_t cpuSize = (size_t)(ratio*problemSize);
+				return cpuModel.getPredictedTime(cpuSize) - gpuModel.getPredictedTime(problemSize - cpuSize);
+			};
+			
+			if (imbalance(0.0) >= 0.0)
+				return 0.0; // The CPU is slower even without work, map whole problemSize to GPU
+			if (imbalance(1.0) <= 0.0)
+				return 1.0;
+			
+			double low = 0.0, high = 1.0;
+			while (high - low > 1e-4) {
+				const double mid = (low + high) / 2;
+				if (imbalance(mid) < 0.0)
+					low = mid;
+				else
+					high = mid;
 			}
-
-			double ratio = nominator/denominator;
-			if(ratio < 0.0)
-				ratio = 0.0;
-			else if(ratio > 1.0)
-				ratio = 1.0;
 			
+			double ratio = (low + high) / 2;
 			ratio = roundf(ratio*100.0)/100.0;
 			return ratio;
 		}
-		
+	
 	};
 }
 
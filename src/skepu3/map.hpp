@@ -65,7 +65,7 @@ namespace skepu
 					get<AI>(args...).hostProxy(typename pack_element<AI-OutArity+(indexed ? 1 : 0), typename proxy_tag<Args>::type...>::type{}, index)...,
 					get<CI>(args...)...
 				);
-				std::tie(*std::get<OI>(out)++...) = res;
+				bind_result(res, *std::get<OI>(out)++...);
 			}
 		}
 		
@@ -335,13 +335,13 @@ namespace skepu
 				switch (this->m_overlapPolicy)
 				{
 					case Overlap::RowColWise: {
-						skepu::Matrix<Ret> tmp_m(res.total_rows(), res.total_cols());
+						skepu::Matrix<Ret> tmp_m(res.total_rows(), res.total_cols(), skepu::uninitialized);
 						this->apply_rowwise(tmp_m, arg, any_indices, const_indices, args...);
 						this->apply_colwise(res, tmp_m, any_indices, const_indices, args...);
 						break;
 					}
 					case Overlap::ColRowWise: {
-						skepu::Matrix<Ret> tmp_m(res.total_rows(), res.total_cols());
+						skepu::Matrix<Ret> tmp_m(res.total_rows(), res.total_cols(), skepu::uninitialized);
 						this->apply_colwise(tmp_m, arg, any_indices, const_indices, args...);
 						this->apply_rowwise(res, tmp_m, any_indices, const_indices, args...);
 						break;
@@ -400,8 +400,8 @@ namespace skepu
 				return std::make_pair(this->m_overlap_x, this->m_overlap_y);
 			}
 			
-			template<size_t... AI, size_t... CI, typename... CallArgs>
-			void apply_helper(Matrix<Ret> &res, Matrix<T> &arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+			template<typename Input, size_t... AI, size_t... CI, typename... CallArgs>
+			void apply_helper(Matrix<Ret> &res, Input &arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
 			{
 				const int overlap_x = (int)this->m_overlapX;
 				const int overlap_y = (int)this->m_overlapY;
@@ -409,13 +409,14 @@ namespace skepu
 				const size_t in_cols = arg.total_cols();
 				const size_t out_rows = res.total_rows();
 				const size_t out_cols = res.total_cols();
+				const size_t stride = backend::rowStride(arg);
 				
 				if ((in_rows - overlap_y*2 != out_rows) && (in_cols - overlap_x*2 != out_cols))
 					SKEPU_ERROR("Non-matching container sizes");
 				
 				for (size_t i = 0; i < out_rows; i++)
 					for (size_t j = 0; j < out_cols; j++)
-						res(i, j) = this->mapFunc({overlap_x, overlap_y, in_cols, &arg((i+overlap_y)*in_cols + (j+overlap_x))},
+						res(i, j) = this->mapFunc({overlap_x, overlap_y, stride, arg.getAddress() + (i+overlap_y)*stride + (j+overlap_x)},
 							get<AI>(args...).hostProxy()..., get<CI>(args...)...);
 			}
 			
@@ -429,6 +430,64 @@ namespace skepu
 				return res;
 			}
 			
+			template<typename Parent, typename... CallArgs>
+			Matrix<Ret> &operator()(Matrix<Ret> &res, MatrixView<T, Parent> arg, CallArgs&&... args)
+			{
+				if (arg.colStride() != 1)
+					SKEPU_ERROR("MapOverlap 2D: Input view must have contiguous columns");
+				
+				constexpr size_t anyCont = trait_count_first<is_skepu_container, CallArgs...>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				apply_helper(res, arg, any_indices, const_indices, args...);
+				return res;
+			}
+			
+			void setTemporalBlocking(size_t) {}
+			
+			template<size_t... AI, size_t... CI, typename... CallArgs>
+			void iterate_helper(size_t steps, Matrix<Ret> &res, Matrix<T> &arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+			{
+				const int overlap_x = (int)this->m_overlapX;
+				const int overlap_y = (int)this->m_overlapY;
+				const size_t rows = arg.total_rows();
+				const size_t cols = arg.total_cols();
+				
+				if (rows != res.total_rows() || cols != res.total_cols())
+					SKEPU_ERROR("Non-matching container sizes");
+				
+				std::vector<T> current(rows * cols);
+				for (size_t i = 0; i < rows; i++)
+					for (size_t j = 0; j < cols; j++)
+						current[i * cols + j] = arg(i, j);
+				std::vector<T> next = current;
+				
+				// Border cells within the overlap distance of the edge are kept fixed
+				for (size_t step = 0; step < steps && rows > 2 * (size_t)overlap_y && cols > 2 * (size_t)overlap_x; ++step)
+				{
+					for (size_t i = overlap_y; i < rows - overlap_y; i++)
+						for (size_t j = overlap_x; j < cols - overlap_x; j++)
+							next[i * cols + j] = this->mapFunc({overlap_x, overlap_y, cols, &current[i * cols + j]},
+								get<AI>(args...).hostProxy()..., get<CI>(args...)...);
+					std::swap(current, next);
+				}
+				
+				for (size_t i = 0; i < rows; i++)
+					for (size_t j = 0; j < cols; j++)
+						res(i, j) = current[i * cols + j];
+			}
+			
+			template<typename... CallArgs>
+			Matrix<Ret> &iterate(size_t steps, Matrix<Ret> &res, Matrix<T>& arg, CallArgs&&... args)
+			{
+				static_assert(std::is_same<Ret, T>::value, "MapOverlap 2D: iterate requires the same input and output element type");
+				constexpr size_t anyCont = trait_count_first<is_skepu_container, CallArgs...>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				iterate_helper(steps, res, arg, any_indices, const_indices, args...);
+				return res;
+			}
+			
 		private:
 			MapFunc mapFunc;
 			MapOverlap2D(MapFunc map): mapFunc(map) {}
@@ -484,7 +543,7 @@ namespace skepu
 					for (size_t j = 0; j < res.size_j(); j++)
 						for (size_t k = 0; k < res.size_k(); k++)
 							res(i, j, k) = this->mapFunc(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
-								arg.size_i(), arg.size_j(), &arg(i+this->m_overlap_i, + j+this->m_overlap_j, + k+this->m_overlap_k)},
+								arg.size_j(), arg.size_k(), &arg(i+this->m_overlap_i, + j+this->m_overlap_j, + k+this->m_overlap_k)},
 								get<AI>(args...).hostProxy()..., get<CI>(args...)...);
 			}
 			
@@ -498,6 +557,53 @@ namespace skepu
 				return res;
 			}
 			
+			void setTemporalBlocking(size_t) {}
+			
+			template<size_t... AI, size_t... CI, typename... CallArgs>
+			void iterate_helper(size_t steps, Tensor3<Ret> &res, Tensor3<T> &arg, pack_indices<AI...>, pack_indices<CI...>,  CallArgs&&... args)
+			{
+				const size_t oi = this->m_overlap_i, oj = this->m_overlap_j, ok = this->m_overlap_k;
+				const size_t si = arg.size_i(), sj = arg.size_j(), sk = arg.size_k();
+				
+				if (si != res.size_i() || sj != res.size_j() || sk != res.size_k())
+					SKEPU_ERROR("Non-matching container sizes");
+				
+				std::vector<T> current(si * sj * sk);
+				for (size_t i = 0; i < si; i++)
+					for (size_t j = 0; j < sj; j++)
+						for (size_t k = 0; k < sk; k++)
+							current[(i * sj + j) * sk + k] = arg(i, j, k);
+				std::vector<T> next = current;
+				
+				// Border cells within the overlap distance of the edge are kept fixed
+				for (size_t step = 0; step < steps && si > 2 * oi && sj > 2 * oj && sk > 2 * ok; ++step)
+				{
+					for (size_t i = oi; i < si - oi; i++)
+						for (size_t j = oj; j < sj - oj; j++)
+							for (size_t k = ok; k < sk - ok; k++)
+								next[(i * sj + j) * sk + k] = this->mapFunc(Region3D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k,
+									sj, sk, &current[(i * sj + j) * sk + k]},
+									get<AI>(args...).hostProxy()..., get<CI>(args...)...);
+					std::swap(current, next);
+				}
+				
+				for (size_t i = 0; i < si; i++)
+					for (size_t j = 0; j < sj; j++)
+						for (size_t k = 0; k < sk; k++)
+							res(i, j, k) = current[(i * sj + j) * sk + k];
+			}
+			
+			template<typename... CallArgs>
+			Tensor3<Ret> &iterate(size_t steps, Tensor3<Ret> &res, Tensor3<T>& arg, CallArgs&&... args)
+			{
+				static_assert(std::is_same<Ret, T>::value, "MapOverlap3D: iterate requires the same input and output element type");
+				constexpr size_t anyCont = trait_count_first<is_skepu_container, CallArgs...>::value;
+				typename make_pack_indices<anyCont, 0>::type any_indices;
+				typename make_pack_indices<sizeof...(CallArgs), anyCont>::type const_indices;
+				iterate_helper(steps, res, arg, any_indices, const_indices, args...);
+				return res;
+			}
+			
 		private:
 			MapFunc mapFunc;
 			MapOverlap3D(MapFunc map): mapFunc(map) {}
@@ -556,7 +662,7 @@ namespace skepu
 							for (size_t l = 0; l < res.size_l(); l++)
 							{
 								res(i, j, k, l) = this->mapFunc(Region4D<T>{this->m_overlap_i, this->m_overlap_j, this->m_overlap_k, this->m_overlap_l,
-									arg.size_i(), arg.size_j(), arg.size_k(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
+									arg.size_j(), arg.size_k(), arg.size_l(), &arg(i + this->m_overlap_i, j + this->m_overlap_j, k + this->m_overlap_k, l + this->m_overlap_l)},
 									get<AI>(args...).hostProxy()..., get<CI>(args...)...);
 							}
 			}
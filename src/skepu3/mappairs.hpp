@@ -59,19 +59,25 @@ namespace skepu
 			if (disjunction((get<HEI>(args...).size() < Hsize)...))
 				SKEPU_ERROR("Non-matching horizontal container sizes");
 			
+			if (this->m_symmetry != Symmetry::None && Vsize != Hsize)
+				SKEPU_ERROR("Symmetric MapPairs requires equally sized vertical and horizontal dimensions");
+			
 			auto out = std::forward_as_tuple(get<OI>(args...)...);
 			auto HelwiseIterators = std::make_tuple(get<VEI>(args...).begin()...);
 			auto VelwiseIterators = std::make_tuple(get<HEI>(args...).begin()...);
 			
 			for (size_t i = 0; i < Vsize; ++i)
 			{
-				for (size_t j = 0; j < Hsize; ++j)
+				// With symmetry only the upper triangle is evaluated, the pairs below the diagonal are mirrored
+				for (size_t j = (this->m_symmetry != Symmetry::None) ? i : 0; j < Hsize; ++j)
 				{
 					auto index = Index2D { i, j };
 					auto res = F::forward(mapPairsFunc, index,
 						std::get<VEI-OutArity>(HelwiseIterators)(i)..., std::get<HEI-Varity-OutArity>(VelwiseIterators)(j)...,
 						get<AI>(args...).hostProxy()..., get<CI>(args...)...);
 					std::tie(std::get<OI>(out)(i, j)...) = res;
+					if (this->m_symmetry != Symmetry::None && i != j)
+						pack_expand((std::get<OI>(out)(j, i) = mirror_pair(std::get<OI>(out)(i, j), this->m_symmetry), 0)...);
 				}
 			}
 			
@@ -86,6 +92,11 @@ namespace skepu
 			this->default_size_y = y;
 		}
 		
+		void setSymmetry(Symmetry symmetry)
+		{
+			this->m_symmetry = symmetry;
+		}
+		
 		template<typename... CallArgs>
 		auto operator()(CallArgs&&... args) -> typename std::add_lvalue_reference<decltype(get<0>(args...))>::type
 		{
@@ -100,6 +111,7 @@ namespace skepu
 		
 		size_t default_size_x = 1;
 		size_t default_size_y = 1;
+		Symmetry m_symmetry = Symmetry::None;
 		
 		friend MapPairsImpl<Varity, Harity, Ret, Args...> MapPairsWrapper<Varity, Harity, Ret, Args...>(MapPairsFunc);
 		
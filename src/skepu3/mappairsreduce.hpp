@@ -60,10 +60,31 @@ namespace skepu
 			if ((this->m_mode == ReduceMode::RowWise && size < Vsize) || (this->m_mode == ReduceMode::ColWise && size < Hsize))
 				SKEPU_ERROR("Non-matching output container size");
 			
+			if (this->m_symmetry != Symmetry::None && Vsize != Hsize)
+				SKEPU_ERROR("Symmetric MapPairsReduce requires equally sized vertical and horizontal dimensions");
+			
 			auto HelwiseIterators = std::make_tuple(get<VEI>(args...).begin()...);
 			auto VelwiseIterators = std::make_tuple(get<HEI>(args...).begin()...);
 			
-			if (this->m_mode == ReduceMode::RowWise)
+			if (this->m_symmetry != Symmetry::None)
+			{
+				// Each unordered pair is evaluated once and reduced into both of its rows (or columns)
+				for (size_t k = 0; k < Vsize; ++k)
+					res(k) = this->m_start;
+				
+				for (size_t i = 0; i < Vsize; ++i)
+					for (size_t j = i; j < Hsize; ++j)
+					{
+						auto index = Index2D { i, j };
+						Ret temp = F::forward(mapPairsFunc, index, std::get<VEI>(HelwiseIterators)(i)..., std::get<HEI-Varity>(VelwiseIterators)(j)..., get<AI>(args...).hostProxy()..., get<CI>(args...)...);
+						const size_t own = (this->m_mode == ReduceMode::RowWise) ? i : j;
+						const size_t other = (this->m_mode == ReduceMode::RowWise) ? j : i;
+						res(own) = redFunc(res(own), temp);
+						if (i != j)
+							res(other) = redFunc(res(other), mirror_pair(temp, this->m_symmetry));
+					}
+			}
+			else if (this->m_mode == ReduceMode::RowWise)
 				for (size_t i = 0; i < Vsize; ++i)
 				{
 					res(i) = this->m_start;
@@ -101,6 +122,11 @@ namespace skepu
 			this->m_mode = mode;
 		}
 		
+		void setSymmetry(Symmetry symmetry)
+		{
+			this->m_symmetry = symmetry;
+		}
+		
 		void setDefaultSize(size_t x, size_t y = 0)
 		{
 			this->default_size_x = x;
@@ -129,6 +155,7 @@ namespace skepu
 		MapPairsReduceImpl(MapPairsFunc mapPairs, RedFunc red): mapPairsFunc(mapPairs), redFunc(red) {}
 		
 		ReduceMode m_mode = ReduceMode::RowWise;
+		Symmetry m_symmetry = Symmetry::None;
 		Ret m_start{};
 		size_t default_size_x = 1;
 		size_t default_size_y = 1;
@@ -14,6 +14,9 @@
 
 
 #include "backend/malloc_allocator.h"
+#include "backend/host_memory.h"
+#include "backend/binary_io.h"
+#include "backend/lazy.h"
 
 #ifdef SKEPU_PRECOMPILED
 
@@ -28,6 +31,9 @@ namespace skepu
 	template<typename T>
 	class Matrix;
 	
+	template<typename T, typename Parent = Matrix<T>>
+	class MatrixView;
+	
 	// Proxy matrix for user functions
 	template<typename T>
 	struct Mat
@@ -125,14 +131,14 @@ namespace skepu
 		typedef typename std::vector<T, malloc_allocator<T> >::reference reference;
 		typedef typename std::vector<T, malloc_allocator<T> >::const_reference const_reference;
 #else
-		typedef std::vector<T> container_type;
-		typedef typename std::vector<T>::iterator vector_iterator;
-		typedef typename std::vector<T>::size_type size_type;
-		typedef typename std::vector<T>::value_type value_type;
-		typedef typename std::vector<T>::difference_type difference_type;
-		typedef typename std::vector<T>::pointer pointer;
-		typedef typename std::vector<T>::reference reference;
-		typedef typename std::vector<T>::const_reference const_reference;
+		typedef std::vector<T, backend::host_allocator<T> > container_type;
+		typedef typename container_type::iterator vector_iterator;
+		typedef typename container_type::size_type size_type;
+		typedef typename container_type::value_type value_type;
+		typedef typename container_type::difference_type difference_type;
+		typedef typename container_type::pointer pointer;
+		typedef typename container_type::reference reference;
+		typedef typename container_type::const_reference const_reference;
 #endif
 		
 	public: //-- For Testing --//
@@ -142,6 +148,8 @@ namespace skepu
 		void randomize(int min = 0, int max = RAND_MAX);
 		void save(const std::string& filename);
 		void load(const std::string& filename, size_type rowWidth, size_type numRows = 0);
+		void saveBinary(const std::string& filename);
+		void loadBinary(const std::string& filename);
 		
 		friend std::ostream& operator<<(std::ostream &os, Matrix<T>& matrix)
 		{
@@ -165,6 +173,10 @@ namespace skepu
 		 */
 		~Matrix()
 		{
+#ifdef SKEPU_LAZY
+			backend::lazyAccess(this);
+#endif
+
 #ifdef SKEPU_OPENCL
 			releaseDeviceAllocations_CL();
 #endif
@@ -179,9 +191,11 @@ namespace skepu
 		Matrix();
 		Matrix(size_type _rows, size_type _cols);
 		Matrix(size_type _rows, size_type _cols, const T& val);
+		Matrix(size_type _rows, size_type _cols, uninitialized_t);
 		Matrix(size_type _rows, size_type _cols, const std::vector<T>& vals);
 		Matrix(size_type _rows, size_type _cols, std::vector<T>&& vals);
 		Matrix(const Matrix<T>& copy);
+		Matrix(Matrix<T>&& other);
 		
 		void init(size_type _rows, size_type _cols);
 		void init(size_type _rows, size_type _cols, const T& val);
@@ -295,11 +309,7 @@ namespace skepu
 		mutable bool m_dataChanged;
 		mutable bool m_noValidDeviceCopy;
 		
-#ifdef USE_PINNED_MEMORY
-		mutable std::vector<T, malloc_allocator<T> > m_data;
-#else
-		mutable std::vector<T> m_data;
-#endif
+		mutable container_type m_data;
 		
 		mutable bool m_valid; /*! to keep track of whether the main copy is valid or not */
 		
@@ -318,6 +328,7 @@ namespace skepu
 	public: //-- Operators --//
 		
 		Matrix<T>& operator=(const Matrix<T>& other);
+		Matrix<T>& operator=(Matrix<T>&& other);
 		Matrix<T>& operator=(const T& elem);
 		void set(const size_t & row, const size_t & col, const T & value);
 		
@@ -349,6 +360,16 @@ namespace skepu
 		
 		void swap(Matrix<T>& from);
 		
+		void resize(size_type _rows, size_type _cols);
+		void resize(size_type _rows, size_type _cols, const T& val);
+		
+		void adopt(size_type _rows, size_type _cols, container_type&& data);
+		container_type release();
+		
+		void place(Placement placement);
+		
+		MatrixView<T> view(size_type row, size_type col, size_type rows, size_type cols, size_type row_step = 1, size_type col_step = 1);
+		
 	public: //-- Additions to interface --//
 		
 	#ifdef SKEPU_OPENCL
@@ -561,7 +582,7 @@ namespace skepu
 #ifdef USE_PINNED_MEMORY
 		typedef typename std::vector<typename std::remove_const<T>::type, malloc_allocator<typename std::remove_const<T>::type> >::iterator iterator_type;
 #else
-		typedef typename std::vector<typename std::remove_const<T>::type>::iterator iterator_type;
+		typedef typename std::vector<typename std::remove_const<T>::type, backend::host_allocator<typename std::remove_const<T>::type> >::iterator iterator_type;
 #endif
 	
 		MatrixIterator(parent_type *mat, iterator_type std_iterator);
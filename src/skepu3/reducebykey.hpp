@@ -0,0 +1,150 @@
+#pragma once
+
+#include "skepu3/impl/common.hpp"
+
+namespace skepu
+{
+	namespace impl
+	{
+		template<typename, typename>
+		class ReduceByKeyImpl;
+		
+		template<typename, typename>
+		class HistogramImpl;
+	}
+	
+	template<typename K, typename T>
+	impl::ReduceByKeyImpl<K, T> ReduceByKeyWrapper(std::function<K(T)> key, std::function<T(T, T)> red)
+	{
+		return impl::ReduceByKeyImpl<K, T>(key, red);
+	}
+	
+	// For function pointers
+	template<typename K, typename T>
+	impl::ReduceByKeyImpl<K, T> ReduceByKey(K(*key)(T), T(*red)(T, T))
+	{
+		return ReduceByKeyWrapper((std::function<K(T)>)key, (std::function<T(T, T)>)red);
+	}
+	
+	// For lambdas and functors
+	template<typename T1, typename T2>
+	auto ReduceByKey(T1 key, T2 red) -> decltype(ReduceByKeyWrapper(lambda_cast(key), lambda_cast(red)))
+	{
+		return ReduceByKeyWrapper(lambda_cast(key), lambda_cast(red));
+	}
+	
+	template<typename K, typename T>
+	impl::HistogramImpl<K, T> HistogramWrapper(std::function<K(T)> key)
+	{
+		return impl::HistogramImpl<K, T>(key);
+	}
+	
+	// For function pointers
+	template<typename K, typename T>
+	impl::HistogramImpl<K, T> Histogram(K(*key)(T))
+	{
+		return HistogramWrapper((std::function<K(T)>)key);
+	}
+	
+	// For lambdas and functors
+	template<typename T1>
+	auto Histogram(T1 key) -> decltype(HistogramWrapper(lambda_cast(key)))
+	{
+		return HistogramWrapper(lambda_cast(key));
+	}
+	
+	namespace impl
+	{
+		/* ReduceByKey "semantic guide" for the SkePU precompiler.
+		 * Sequential implementation when used with any C++ compiler.
+		 * Computes res(k) = red(...red(start, x0)..., xn) over the elements x of the argument, in order,
+		 * for which key(x) == k. Elements with keys outside of the result vector are skipped.
+		 */
+		template<typename K, typename T>
+		class ReduceByKeyImpl: public SeqSkeletonBase
+		{
+			static_assert(std::is_integral<K>::value, "ReduceByKey: The key function must return an integral type");
+			
+			using KeyFunc = std::function<K(T)>;
+			using RedFunc = std::function<T(T, T)>;
+		
+		public:
+		
+			void setStartValue(T val)
+			{
+				this->m_start = val;
+			}
+			
+			template<template<class> class Container,
+				REQUIRES(is_skepu_container<Container<T>>::value)>
+			Vector<T> &operator()(Vector<T> &res, Container<T> &arg)
+			{
+				const size_t bins = res.size();
+				const T *in = arg.getAddress();
+				T *out = res.getAddress();
+				
+				for (size_t k = 0; k < bins; ++k)
+					out[k] = this->m_start;
+				
+				for (size_t i = 0; i < arg.size(); ++i)
+				{
+					const size_t k = static_cast<size_t>(this->keyFunc(in[i]));
+					if (k < bins)
+						out[k] = this->redFunc(out[k], in[i]);
+				}
+				return res;
+			}
+		
+		private:
+			KeyFunc keyFunc;
+			RedFunc redFunc;
+			ReduceByKeyImpl(KeyFunc key, RedFunc red): keyFunc(key), redFunc(red) {}
+			
+			T m_start{};
+			
+			friend ReduceByKeyImpl<K, T> ReduceByKeyWrapper<K, T>(KeyFunc, RedFunc);
+		};
+		
+		
+		/* Histogram "semantic guide" for the SkePU precompiler.
+		 * Sequential implementation when used with any C++ compiler.
+		 * Computes res(k) as the number of elements x of the argument for which key(x) == k.
+		 * Elements with keys outside of the result vector are skipped.
+		 */
+		template<typename K, typename T>
+		class HistogramImpl: public SeqSkeletonBase
+		{
+			static_assert(std::is_integral<K>::value, "Histogram: The key function must return an integral type");
+			
+			using KeyFunc = std::function<K(T)>;
+		
+		public:
+		
+			template<typename C, template<class> class Container,
+				REQUIRES(is_skepu_container<Container<T>>::value)>
+			Vector<C> &operator()(Vector<C> &res, Container<T> &arg)
+			{
+				const size_t bins = res.size();
+				const T *in = arg.getAddress();
+				C *out = res.getAddress();
+				
+				for (size_t k = 0; k < bins; ++k)
+					out[k] = 0;
+				
+				for (size_t i = 0; i < arg.size(); ++i)
+				{
+					const size_t k = static_cast<size_t>(this->keyFunc(in[i]));
+					if (k < bins)
+						out[k] += 1;
+				}
+				return res;
+			}
+		
+		private:
+			KeyFunc keyFunc;
+			HistogramImpl(KeyFunc key): keyFunc(key) {}
+			
+			friend HistogramImpl<K, T> HistogramWrapper<K, T>(KeyFunc);
+		};
+	}
+}
@@ -9,6 +9,17 @@ namespace skepu
 		Inclusive, Exclusive
 	};
 	
+	/*!
+	 *  How the segments of a segmented scan are given. With Flags, the segment container has one element per
+	 *  input element, and nonzero elements start a new segment. With Heads, the segment container holds the
+	 *  ascending indices where segments start, such as the row pointers of a CSR matrix; indices past the end
+	 *  are ignored. The first element always starts a segment.
+	 */
+	enum class SegmentMode
+	{
+		Flags, Heads
+	};
+	
 	namespace impl
 	{
 		template<typename>
@@ -43,6 +54,7 @@ namespace skepu
 			using ScanFunc = std::function<T(T, T)>;
 		
 			ScanMode m_mode {ScanMode::Inclusive};
+			SegmentMode m_segment_mode {SegmentMode::Flags};
 			
 			// Default initial value is a default-initialized value
 			T m_initial {};
@@ -55,20 +67,54 @@ namespace skepu
 			
 			template<typename OutIterator, typename InIterator>
 			void apply(size_t size, OutIterator res, InIterator arg)
+			{
+				this->scan(size, res, arg, [](size_t) { return false; });
+			}
+			
+			// Every element is read before the result at its index is written, so res may alias arg
+			template<typename OutIterator, typename InIterator, typename IsHead>
+			void scan(size_t size, OutIterator res, InIterator arg, IsHead isHead)
 			{
 				T running = this->m_initial;
 				
 				if (size != res.size())
 					SKEPU_ERROR("Non-matching container sizes");
 				
-				// First element
-				if (this->m_mode == ScanMode::Inclusive)
-					running = *arg++;
-				*res++ = running;
-				
-				// Rest of elements
-				while (--size > 0)
-					*res++ = running = this->m_scanFunc(running, *arg++);
+				for (size_t i = 0; i < size; ++i)
+				{
+					const T value = *arg++;
+					const bool head = (i == 0) || isHead(i);
+					if (this->m_mode == ScanMode::Inclusive)
+						*res++ = running = head ? value : this->m_scanFunc(running, value);
+					else
+					{
+						if (head)
+							running = this->m_initial;
+						*res++ = running;
+						running = this->m_scanFunc(running, value);
+					}
+				}
+			}
+			
+			template<typename OutIterator, typename InIterator, typename Segments>
+			void applySegmented(size_t size, OutIterator res, InIterator arg, Segments &segments)
+			{
+				if (this->m_segment_mode == SegmentMode::Flags)
+				{
+					if (segments.size() < size)
+						SKEPU_ERROR("Segment flags do not cover the input");
+					this->scan(size, res, arg, [&](size_t i) { return static_cast<bool>(segments[i]); });
+				}
+				else
+				{
+					size_t next = 0;
+					this->scan(size, res, arg, [&](size_t i)
+					{
+						while (next < segments.size() && static_cast<size_t>(segments[next]) < i)
+							++next;
+						return next < segments.size() && static_cast<size_t>(segments[next]) == i;
+					});
+				}
 			}
 			
 			friend impl::ScanImpl<T> skepu::ScanWrapper<T>(ScanFunc);
@@ -85,7 +131,12 @@ namespace skepu
 				this->m_initial = initial;
 			}
 			
-			template<typename OutIterator, typename In>
+			void setSegmentMode(SegmentMode mode)
+			{
+				this->m_segment_mode = mode;
+			}
+			
+			template<typename OutIterator, typename In, REQUIRES(!is_skepu_container<OutIterator>::value)>
 			OutIterator operator()(OutIterator res, OutIterator res_end, In&& arg)
 			{
 				this->apply(res_end - res, res, arg.begin());
@@ -99,6 +150,23 @@ namespace skepu
 				return res;
 			}
 			
+			/*!
+			 *  Segmented scan, restarting at every segment head given by \p segments, see \p setSegmentMode.
+			 */
+			template<typename OutIterator, typename In, typename Segments>
+			OutIterator operator()(OutIterator res, OutIterator res_end, In&& arg, Segments&& segments)
+			{
+				this->applySegmented(res_end - res, res, arg.begin(), segments);
+				return res;
+			}
+			
+			template<template<class> class Container, typename In, typename Segments, REQUIRES(is_skepu_container<Container<T>>::value)>
+			Container<T> &operator()(Container<T>& res, In&& arg, Segments&& segments)
+			{
+				this->applySegmented(res.size(), res.begin(), arg.begin(), segments);
+				return res;
+			}
+			
 		};
 		
 	}
@@ -0,0 +1,359 @@
+/*! \file soa.hpp
+ *  \brief Contains the structure-of-arrays containers for user-defined element types.
+ */
+
+#ifndef SOA_HPP
+#define SOA_HPP
+
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+/*!
+ *  Names the member \p field of the user type \p type in a structure-of-arrays layout.
+ */
+#define SKEPU_SOA_FIELD(type, field) ::skepu::soa_field<type, decltype(type::field), &type::field>
+
+namespace skepu
+{
+	/*!
+	 *  A member of a user type stored in an array of its own.
+	 */
+	template<typename T, typename M, M T::*Member>
+	struct soa_field
+	{
+		using type = M;
+
+		static M &get(T &value) { return value.*Member; }
+		static const M &get(const T &value) { return value.*Member; }
+	};
+
+	/*!
+	 *  \brief The members of a user type which are stored as separate arrays.
+	 *
+	 *  Loading an element gathers its members from the arrays, storing it scatters them. Members which are
+	 *  not listed are value-initialized in loaded elements and are not stored.
+	 */
+	template<typename... Fields>
+	struct soa_fields
+	{
+		static constexpr size_t count = sizeof...(Fields);
+		using storage = std::tuple<std::vector<typename Fields::type>...>;
+		using pointers = std::tuple<typename Fields::type*...>;
+
+		static pointers addresses(storage &data)
+		{
+			return addresses(data, typename make_pack_indices<count>::type{});
+		}
+
+		static void resize(storage &data, size_t size)
+		{
+			resize(data, size, typename make_pack_indices<count>::type{});
+		}
+
+		template<typename T>
+		static T load(const pointers &fields, size_t pos)
+		{
+			T value{};
+			load(value, fields, pos, typename make_pack_indices<count>::type{});
+			return value;
+		}
+
+		template<typename T>
+		static void store(const pointers &fields, size_t pos, const T &value)
+		{
+			store(fields, pos, value, typename make_pack_indices<count>::type{});
+		}
+
+	private:
+
+		template<size_t... FI>
+		static pointers addresses(storage &data, pack_indices<FI...>)
+		{
+			return pointers(std::get<FI>(data).data()...);
+		}
+
+		template<size_t... FI>
+		static void resize(storage &data, size_t size, pack_indices<FI...>)
+		{
+			pack_expand((std::get<FI>(data).resize(size), 0)...);
+		}
+
+		template<typename T, size_t... FI>
+		static void load(T &value, const pointers &fields, size_t pos, pack_indices<FI...>)
+		{
+			pack_expand((Fields::get(value) = std::get<FI>(fields)[pos], 0)...);
+		}
+
+		template<typename T, size_t... FI>
+		static void store(const pointers &fields, size_t pos, const T &value, pack_indices<FI...>)
+		{
+			pack_expand((std::get<FI>(fields)[pos] = Fields::get(value), 0)...);
+		}
+	};
+
+	/*!
+	 *  Members of \p T stored by the structure-of-arrays containers. Specialize it as a \p soa_fields of
+	 *  \p SKEPU_SOA_FIELD entries, e.g.
+	 *
+	 *    template<> struct skepu::soa_layout<Particle>:
+	 *      skepu::soa_fields<SKEPU_SOA_FIELD(Particle, x), SKEPU_SOA_FIELD(Particle, y)> {};
+	 *
+	 *  When not specialized, the layout generated by skepu-tool for user types of only arithmetic members is used.
+	 */
+	template<typename T>
+	struct soa_generated_layout;
+
+	template<typename T>
+	struct soa_layout: soa_generated_layout<T> {};
+
+
+	/*!
+	 *  \class SoARef
+	 *
+	 *  \brief Reference to an element of a structure-of-arrays container.
+	 *
+	 *  Converts to the user type by gathering the members and is assigned by scattering them, so that user
+	 *  functions keep their signature. After inlining only the members a user function reads are loaded.
+	 */
+	template<typename T>
+	class SoARef
+	{
+		using layout = soa_layout<T>;
+
+	public:
+
+		SoARef(const typename layout::pointers &fields, size_t pos): m_fields(fields), m_pos(pos) {}
+
+		operator T() const { return layout::template load<T>(this->m_fields, this->m_pos); }
+
+		SoARef &operator=(const T &value)
+		{
+			layout::store(this->m_fields, this->m_pos, value);
+			return *this;
+		}
+
+		SoARef &operator=(const SoARef &other) { return *this = static_cast<T>(other); }
+
+	private:
+		typename layout::pointers m_fields;
+		size_t m_pos;
+	};
+
+
+	/*!
+	 *  \class SoAIterator
+	 *
+	 *  \brief Iterator over a structure-of-arrays container, yielding element references.
+	 */
+	template<typename Container>
+	class SoAIterator : public std::iterator<std::random_access_iterator_tag, typename Container::value_type>
+	{
+		using layout = soa_layout<typename Container::value_type>;
+
+	public:
+		typedef typename Container::value_type value_type;
+		typedef SoARef<value_type> reference;
+		typedef SoAIterator<Container> iterator;
+
+		SoAIterator(Container &parent, typename layout::pointers fields, size_t pos): m_parent(&parent), m_fields(fields), m_pos(pos) {}
+
+		auto getIndex() const -> decltype(std::declval<Container>().index(0)) { return this->m_parent->index(this->m_pos); }
+
+		Container &getParent() const { return *this->m_parent; }
+		iterator &begin() { return *this; }
+		size_t size() const { return this->m_parent->size() - this->m_pos; }
+
+		reference operator()(const ssize_t index = 0) const { return reference(this->m_fields, this->m_pos + index); }
+		reference operator[](const ssize_t index) const { return reference(this->m_fields, this->m_pos + index); }
+		reference operator*() const { return reference(this->m_fields, this->m_pos); }
+
+		bool operator==(const iterator &i) const { return this->m_pos == i.m_pos; }
+		bool operator!=(const iterator &i) const { return this->m_pos != i.m_pos; }
+		bool operator<(const iterator &i) const  { return this->m_pos < i.m_pos; }
+		bool operator>(const iterator &i) const  { return this->m_pos > i.m_pos; }
+		bool operator<=(const iterator &i) const { return this->m_pos <= i.m_pos; }
+		bool operator>=(const iterator &i) const { return this->m_pos >= i.m_pos; }
+
+		iterator &operator++() { ++this->m_pos; return *this; }
+		iterator operator++(int) { iterator tmp = *this; ++this->m_pos; return tmp; }
+		iterator &operator--() { --this->m_pos; return *this; }
+		iterator operator--(int) { iterator tmp = *this; --this->m_pos; return tmp; }
+
+		iterator &operator+=(const ssize_t i) { this->m_pos += i; return *this; }
+		iterator &operator-=(const ssize_t i) { this->m_pos -= i; return *this; }
+
+		iterator operator+(const ssize_t i) const { return iterator(*this->m_parent, this->m_fields, this->m_pos + i); }
+		iterator operator-(const ssize_t i) const { return iterator(*this->m_parent, this->m_fields, this->m_pos - i); }
+
+		ptrdiff_t operator-(const iterator &i) const { return (ptrdiff_t)this->m_pos - (ptrdiff_t)i.m_pos; }
+
+	private:
+		Container *m_parent;
+		typename layout::pointers m_fields;
+		size_t m_pos;
+	};
+
+
+	/*!
+	 *  \class VectorSoA
+	 *
+	 *  \brief A vector of user-defined elements stored as one array per member, see \p soa_layout.
+	 *
+	 *  Skeletons pass the elements to user functions as values of the user type, a Map reading a few
+	 *  members of each element only streams the arrays of those members. The data is kept on the host, the
+	 *  containers are accepted as element-wise arguments of Map on the CPU and OpenMP backends.
+	 */
+	template<typename T>
+	class VectorSoA
+	{
+		using layout = soa_layout<T>;
+
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef SoARef<T> reference;
+		typedef SoAIterator<VectorSoA<T>> iterator;
+		typedef iterator const_iterator;
+
+		VectorSoA(size_type size = 0): m_size(size)
+		{
+			layout::resize(this->m_data, size);
+		}
+
+		VectorSoA(size_type size, const T &val): VectorSoA(size)
+		{
+			for (size_type i = 0; i < size; ++i)
+				(*this)(i) = val;
+		}
+
+		size_type size() const   { return this->m_size; }
+		size_type size_i() const { return this->m_size; }
+		size_type size_j() const { return 0; }
+		size_type size_k() const { return 0; }
+		size_type size_l() const { return 0; }
+
+		std::tuple<size_type> size_info() const
+		{
+			return {this->m_size};
+		}
+
+		void resize(size_type size)
+		{
+			layout::resize(this->m_data, size);
+			this->m_size = size;
+		}
+
+		VectorSoA<T> &getParent() { return *this; }
+		const VectorSoA<T> &getParent() const { return *this; }
+
+		/*!
+		 *  Returns the array of member \p F in the layout.
+		 */
+		template<size_t F>
+		typename std::tuple_element<F, typename layout::pointers>::type field()
+		{
+			return std::get<F>(this->m_data).data();
+		}
+
+		iterator begin() { return iterator(*this, layout::addresses(this->m_data), 0); }
+		iterator end()   { return iterator(*this, layout::addresses(this->m_data), this->m_size); }
+
+		reference operator()(const size_type index) { return reference(layout::addresses(this->m_data), index); }
+		reference operator[](const size_type index) { return reference(layout::addresses(this->m_data), index); }
+
+		Index1D index(size_type pos) const { return Index1D{pos}; }
+
+		// The data only lives on the host
+		void updateHost(bool = true) const {}
+		void invalidateDeviceData(bool = true) const {}
+		void flush(FlushMode = FlushMode::Default) {}
+
+	private:
+		typename layout::storage m_data;
+		size_type m_size;
+	};
+
+
+	/*!
+	 *  \class MatrixSoA
+	 *
+	 *  \brief A row-major matrix of user-defined elements stored as one array per member, see \p VectorSoA.
+	 */
+	template<typename T>
+	class MatrixSoA
+	{
+		using layout = soa_layout<T>;
+
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef SoARef<T> reference;
+		typedef SoAIterator<MatrixSoA<T>> iterator;
+		typedef iterator const_iterator;
+
+		MatrixSoA(size_type rows = 0, size_type cols = 0): m_rows(rows), m_cols(cols)
+		{
+			layout::resize(this->m_data, rows * cols);
+		}
+
+		MatrixSoA(size_type rows, size_type cols, const T &val): MatrixSoA(rows, cols)
+		{
+			for (size_type i = 0; i < this->size(); ++i)
+				reference(layout::addresses(this->m_data), i) = val;
+		}
+
+		size_type size() const       { return this->m_rows * this->m_cols; }
+		size_type total_rows() const { return this->m_rows; }
+		size_type total_cols() const { return this->m_cols; }
+		size_type size_i() const { return this->m_rows; }
+		size_type size_j() const { return this->m_cols; }
+		size_type size_k() const { return 0; }
+		size_type size_l() const { return 0; }
+
+		std::tuple<size_type, size_type> size_info() const
+		{
+			return {this->m_rows, this->m_cols};
+		}
+
+		void resize(size_type rows, size_type cols)
+		{
+			layout::resize(this->m_data, rows * cols);
+			this->m_rows = rows;
+			this->m_cols = cols;
+		}
+
+		MatrixSoA<T> &getParent() { return *this; }
+		const MatrixSoA<T> &getParent() const { return *this; }
+
+		/*!
+		 *  Returns the array of member \p F in the layout, in row-major order.
+		 */
+		template<size_t F>
+		typename std::tuple_element<F, typename layout::pointers>::type field()
+		{
+			return std::get<F>(this->m_data).data();
+		}
+
+		iterator begin() { return iterator(*this, layout::addresses(this->m_data), 0); }
+		iterator end()   { return iterator(*this, layout::addresses(this->m_data), this->size()); }
+
+		reference operator()(const size_type row, const size_type col)
+		{
+			return reference(layout::addresses(this->m_data), row * this->m_cols + col);
+		}
+
+		Index2D index(size_type pos) const { return Index2D{pos / this->m_cols, pos % this->m_cols}; }
+
+		// The data only lives on the host
+		void updateHost(bool = true) const {}
+		void invalidateDeviceData(bool = true) const {}
+		void flush(FlushMode = FlushMode::Default) {}
+
+	private:
+		typename layout::storage m_data;
+		size_type m_rows, m_cols;
+	};
+}
+
+#endif // SOA_HPP
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "skepu3/impl/common.hpp"
+
+namespace skepu
+{
+	namespace impl
+	{
+		template<typename>
+		class SortImpl;
+	}
+	
+	template<typename T>
+	impl::SortImpl<T> SortWrapper(std::function<bool(T, T)> comp)
+	{
+		return impl::SortImpl<T>(comp);
+	}
+	
+	// Sorting by a key function orders the elements by ascending keys
+	template<typename K, typename T>
+	impl::SortImpl<T> SortWrapper(std::function<K(T)> key)
+	{
+		return SortWrapper(std::function<bool(T, T)>([key](T a, T b) { return key(a) < key(b); }));
+	}
+	
+	// For function pointers
+	template<typename T>
+	impl::SortImpl<T> Sort(bool(*comp)(T, T))
+	{
+		return SortWrapper((std::function<bool(T, T)>)comp);
+	}
+	
+	template<typename K, typename T>
+	impl::SortImpl<T> Sort(K(*key)(T))
+	{
+		return SortWrapper((std::function<K(T)>)key);
+	}
+	
+	// For lambdas and functors
+	template<typename T1>
+	auto Sort(T1 func) -> decltype(SortWrapper(lambda_cast(func)))
+	{
+		return SortWrapper(lambda_cast(func));
+	}
+	
+	namespace impl
+	{
+		/* Sort "semantic guide" for the SkePU precompiler.
+		 * Sequential implementation when used with any C++ compiler.
+		 * Stably sorts a vector, or each row of a matrix, in place. The user function is either a less-than
+		 * comparator of two elements or a function of one element returning an arithmetic sort key.
+		 * With a second container, its elements are permuted along with the keys.
+		 */
+		template<typename T>
+		class SortImpl: public SeqSkeletonBase
+		{
+			using LessFunc = std::function<bool(T, T)>;
+		
+		public:
+		
+			Vector<T> &operator()(Vector<T> &data)
+			{
+				std::stable_sort(data.getAddress(), data.getAddress() + data.size(), this->lessFunc);
+				return data;
+			}
+			
+			Matrix<T> &operator()(Matrix<T> &data)
+			{
+				const size_t cols = data.total_cols();
+				for (size_t r = 0; r < data.total_rows(); ++r)
+					std::stable_sort(data.getAddress() + r * cols, data.getAddress() + (r + 1) * cols, this->lessFunc);
+				return data;
+			}
+			
+			template<typename V>
+			Vector<T> &operator()(Vector<T> &keys, Vector<V> &values)
+			{
+				if (keys.size() != values.size())
+					SKEPU_ERROR("Sort: Non-matching container sizes");
+				
+				this->sortByKey(keys.getAddress(), values.getAddress(), keys.size());
+				return keys;
+			}
+			
+			template<typename V>
+			Matrix<T> &operator()(Matrix<T> &keys, Matrix<V> &values)
+			{
+				if (keys.total_rows() != values.total_rows() || keys.total_cols() != values.total_cols())
+					SKEPU_ERROR("Sort: Non-matching container sizes");
+				
+				const size_t cols = keys.total_cols();
+				for (size_t r = 0; r < keys.total_rows(); ++r)
+					this->sortByKey(keys.getAddress() + r * cols, values.getAddress() + r * cols, cols);
+				return keys;
+			}
+		
+		private:
+			LessFunc lessFunc;
+			SortImpl(LessFunc comp): lessFunc(comp) {}
+			
+			template<typename V>
+			void sortByKey(T *keys, V *values, size_t size)
+			{
+				std::vector<std::pair<T, V>> pairs(size);
+				for (size_t i = 0; i < size; ++i)
+					pairs[i] = std::make_pair(keys[i], values[i]);
+				
+				std::stable_sort(pairs.begin(), pairs.end(), [this](const std::pair<T, V> &a, const std::pair<T, V> &b)
+				{
+					return this->lessFunc(a.first, b.first);
+				});
+				
+				for (size_t i = 0; i < size; ++i)
+				{
+					keys[i] = pairs[i].first;
+					values[i] = pairs[i].second;
+				}
+			}
+			
+			friend SortImpl<T> SortWrapper<T>(LessFunc);
+		};
+	}
+}
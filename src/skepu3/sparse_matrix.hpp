@@ -14,6 +14,7 @@
 #include <map>
 #include <iomanip>
 #include <set>
+#include <algorithm>
 
 
 #include "backend/malloc_allocator.h"
@@ -39,6 +40,19 @@ enum SparseFileFormat
    RUTHERFOR_BOEING_FORMAT
 };
 
+/*!
+*  \brief Can be used to specify an additional storage layout for a sparse matrix.
+*
+*  The CSR arrays are always kept. SELL_C_SIGMA_LAYOUT (sliced ELLPACK with a sorting window) and
+*  BLOCKED_CSR_LAYOUT (register-blocked CSR) are built from them on request and used by row products.
+*/
+enum SparseLayout
+{
+   CSR_LAYOUT,
+   SELL_C_SIGMA_LAYOUT,
+   BLOCKED_CSR_LAYOUT
+};
+
 
 
 
@@ -57,6 +71,41 @@ struct SparseMat
 };
 
 
+/*!
+*  Proxy for the SELL-C-sigma layout. Slice \em s stores its values column-major, lane by lane, starting
+*  at \em slice_offsets[s]. Rows are permuted by \em row_perm and padded lanes have \em row_lengths of 0.
+*/
+template<typename T>
+struct SellMat
+{
+	T *data;
+	size_t *col_indices;
+	size_t *slice_offsets;
+	size_t *row_lengths;
+	size_t *row_perm;
+	size_t slices;
+	size_t chunk;
+	size_t rows;
+};
+
+
+/*!
+*  Proxy for the register-blocked CSR layout. Each block is stored densely in row-major order.
+*/
+template<typename T>
+struct BlockedSparseMat
+{
+	T *data;
+	size_t *block_row_offsets;
+	size_t *block_col_indices;
+	size_t block_rows;
+	size_t block_height;
+	size_t block_width;
+	size_t rows;
+	size_t cols;
+};
+
+
 /*!
 *  \class SparseMatrix
 *
@@ -115,7 +164,24 @@ private:
    bool m_transposeValid;
    SparseMatrix *m_cscMatrix;
 
-   
+   // ***** RELATED to alternative SpMV layouts ****/
+   SparseLayout m_layout;
+   size_t m_sellChunk;
+   size_t m_sellSigma;
+   size_t m_blockHeight;
+   size_t m_blockWidth;
+   bool m_layoutValid;
+
+   std::vector<T> m_valuesSELL;
+   std::vector<size_t> m_colIndSELL;
+   std::vector<size_t> m_sliceOffsetsSELL;
+   std::vector<size_t> m_rowLengthsSELL;
+   std::vector<size_t> m_rowPermSELL;
+
+   std::vector<T> m_valuesBCSR;
+   std::vector<size_t> m_blockRowPtrBCSR;
+   std::vector<size_t> m_blockColIndBCSR;
+
 
 public:
    class iterator;
@@ -233,6 +299,10 @@ private:
       m_transposeValid = true;
    }
 
+   void deleteLayoutFormats();
+   void convertToSELLFormat();
+   void convertToBCSRFormat();
+
 
    void readMTXFile(const std::string &inputfile);
 
@@ -411,6 +481,29 @@ public:
       return proxy;
    }
 
+   // ----- SpMV LAYOUTS       -------//
+
+   void setLayout(SparseLayout layout);
+   void setSELLParameters(size_t chunk, size_t sigma);
+   void setBlockSize(size_t height, size_t width);
+   void updateLayout();
+
+   SparseLayout get_layout() const
+   {
+      return m_layout;
+   }
+
+   size_t layoutUnits() const;
+
+   SellMat<T> sellProxy();
+   BlockedSparseMat<T> blockedProxy();
+
+   template<typename MultFunc, typename AddFunc>
+   void rowProducts(const T *x, T *y, MultFunc mult, AddFunc add, T init, size_t firstUnit, size_t lastUnit) const;
+
+   template<typename MultFunc, typename AddFunc>
+   void rowProducts(const T *x, T *y, MultFunc mult, AddFunc add, T init);
+
 public:
 
    iterator begin(unsigned row = 0);
@@ -557,6 +650,7 @@ private: //-- Data --//
 
 #include "backend/impl/sparse_matrix/sparse_matrix_iterator.inl"
 #include "backend/impl/sparse_matrix/sparse_matrix.inl"
+#include "backend/impl/sparse_matrix/sparse_matrix_layout.inl"
 #include "backend/impl/sparse_matrix/sparse_matrix_cl.inl"
 #include "backend/impl/sparse_matrix/sparse_matrix_cu.inl"
 
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "skepu3/impl/common.hpp"
+
+namespace skepu
+{
+	namespace impl
+	{
+		template<typename>
+		class SpMVImpl;
+	}
+	
+	template<typename T>
+	impl::SpMVImpl<T> SpMVWrapper(std::function<T(T, T)> mult, std::function<T(T, T)> add)
+	{
+		return impl::SpMVImpl<T>(mult, add);
+	}
+	
+	// For function pointers
+	template<typename T>
+	impl::SpMVImpl<T> SpMV(T(*mult)(T, T), T(*add)(T, T))
+	{
+		return SpMVWrapper((std::function<T(T, T)>)mult, (std::function<T(T, T)>)add);
+	}
+	
+	// For lambdas and functors
+	template<typename T1, typename T2>
+	auto SpMV(T1 mult, T2 add) -> decltype(SpMVWrapper(lambda_cast(mult), lambda_cast(add)))
+	{
+		return SpMVWrapper(lambda_cast(mult), lambda_cast(add));
+	}
+	
+	namespace impl
+	{
+		/* SpMV "semantic guide" for the SkePU precompiler.
+		 * Sequential implementation when used with any C++ compiler.
+		 * Computes res(r) = add(...add(start, mult(A(r, c0), x(c0)))..., mult(A(r, cn), x(cn)))
+		 * over the non-zero elements of each row, or the same for each column of a dense matrix X.
+		 */
+		template<typename T>
+		class SpMVImpl: public SeqSkeletonBase
+		{
+			using MultFunc = std::function<T(T, T)>;
+			using AddFunc = std::function<T(T, T)>;
+			
+		public:
+			
+			void setStartValue(T val)
+			{
+				this->m_start = val;
+			}
+			
+			// Use the transpose of the sparse matrix, which is cached in CSC format by the container
+			void setTransposed(bool transposed)
+			{
+				this->m_transposed = transposed;
+			}
+			
+			Vector<T> &operator()(Vector<T> &res, SparseMatrix<T> &A, Vector<T> &x)
+			{
+				SparseMatrix<T> &arg = this->m_transposed ? ~A : A;
+				
+				if (arg.total_rows() != res.size() || arg.total_cols() != x.size())
+					SKEPU_ERROR("SpMV: Non-matching container sizes");
+				
+				arg.rowProducts(x.getAddress(), res.getAddress(), this->multFunc, this->addFunc, this->m_start);
+				return res;
+			}
+			
+			Matrix<T> &operator()(Matrix<T> &res, SparseMatrix<T> &A, Matrix<T> &X)
+			{
+				SparseMatrix<T> &arg = this->m_transposed ? ~A : A;
+				
+				if (arg.total_rows() != res.total_rows() || arg.total_cols() != X.total_rows() || res.total_cols() != X.total_cols())
+					SKEPU_ERROR("SpMM: Non-matching container sizes");
+				
+				const size_t rows = arg.total_rows();
+				const size_t k = X.total_cols();
+				const T *values = arg.get_values();
+				const size_t *rowPtr = arg.get_row_pointers();
+				const size_t *colInd = arg.get_col_indices();
+				
+				for (size_t r = 0; r < rows; ++r)
+				{
+					T *out = res.getAddress() + r * k;
+					for (size_t j = 0; j < k; ++j)
+						out[j] = this->m_start;
+					
+					for (size_t jj = rowPtr[r]; jj < rowPtr[r+1]; ++jj)
+					{
+						const T *in = X.getAddress() + colInd[jj] * k;
+						for (size_t j = 0; j < k; ++j)
+							out[j] = this->addFunc(out[j], this->multFunc(values[jj], in[j]));
+					}
+				}
+				return res;
+			}
+			
+		private:
+			MultFunc multFunc;
+			AddFunc addFunc;
+			SpMVImpl(MultFunc mult, AddFunc add): multFunc(mult), addFunc(add) {}
+			
+			T m_start{};
+			bool m_transposed = false;
+			
+			friend SpMVImpl<T> SpMVWrapper<T>(MultFunc, AddFunc);
+		};
+	}
+}
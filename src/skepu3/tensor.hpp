@@ -56,6 +56,9 @@ namespace skepu
 	template <typename T>
 	class Tensor3Iterator;
 	
+	template<typename T>
+	class Tensor3View;
+	
 	template<typename T>
 	class Tensor3 : public Vector<T>
 	{
@@ -79,6 +82,33 @@ namespace skepu
 		explicit Tensor3(size_type si, size_type sj, size_type sk, const T& val = T())
 		: m_size_i(si), m_size_j(sj), m_size_k(sk), Vector<T>(si * sj * sk, val)
 		{}
+		
+		Tensor3(size_type si, size_type sj, size_type sk, uninitialized_t)
+		: m_size_i(si), m_size_j(sj), m_size_k(sk), Vector<T>(si * sj * sk, uninitialized)
+		{}
+		
+		// Maps a binary file written by saveBinary as storage, see Vector
+		Tensor3(const std::string& filename, memory_mapped_t)
+		: m_size_i(0), m_size_j(0), m_size_k(0), Vector<T>{}
+		{
+			this->loadBinary(filename, true);
+		}
+		
+		void saveBinary(const std::string& filename)
+		{
+			const size_t dims[3] = {this->m_size_i, this->m_size_j, this->m_size_k};
+			this->writeBinary(filename, 3, dims);
+		}
+		
+		void loadBinary(const std::string& filename, bool mapped = false)
+		{
+			backend::BinaryFile file(filename, sizeof(T));
+			file.requireRank(3);
+			this->readBinary(file, mapped);
+			this->m_size_i = file.dim(0);
+			this->m_size_j = file.dim(1);
+			this->m_size_k = file.dim(2);
+		}
 	
 		void init(size_type si, size_type sj, size_type sk)
 		{
@@ -114,6 +144,9 @@ namespace skepu
 		
 		proxy_type hostProxy() { return this->hostProxy(ProxyTag::Default{}, 0); }
 		
+		Tensor3View<T> view(size_type i, size_type j, size_type k, size_type si, size_type sj, size_type sk);
+		MatrixView<T, Vector<T>> slice(size_type i);
+		
 		size_type size() const
 		{
 			return Vector<T>::m_size;
@@ -329,6 +362,35 @@ namespace skepu
 		Vector<T>(si * sj * sk * sl, val)
 		{}
 		
+		Tensor4(size_type si, size_type sj, size_type sk, size_type sl, uninitialized_t)
+		: m_size_i(si), m_size_j(sj), m_size_k(sk), m_size_l(sl),
+		Vector<T>(si * sj * sk * sl, uninitialized)
+		{}
+		
+		// Maps a binary file written by saveBinary as storage, see Vector
+		Tensor4(const std::string& filename, memory_mapped_t)
+		: m_size_i(0), m_size_j(0), m_size_k(0), m_size_l(0), Vector<T>()
+		{
+			this->loadBinary(filename, true);
+		}
+		
+		void saveBinary(const std::string& filename)
+		{
+			const size_t dims[4] = {this->m_size_i, this->m_size_j, this->m_size_k, this->m_size_l};
+			this->writeBinary(filename, 4, dims);
+		}
+		
+		void loadBinary(const std::string& filename, bool mapped = false)
+		{
+			backend::BinaryFile file(filename, sizeof(T));
+			file.requireRank(4);
+			this->readBinary(file, mapped);
+			this->m_size_i = file.dim(0);
+			this->m_size_j = file.dim(1);
+			this->m_size_k = file.dim(2);
+			this->m_size_l = file.dim(3);
+		}
+		
 		void init(size_type si, size_type sj, size_type sk, size_type sl)
 		{
 			Vector<T>::init(si * sj * sk * sl);
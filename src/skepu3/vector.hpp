@@ -14,8 +14,13 @@
 #include <stdexcept>
 #include <cstddef>
 #include <map>
+#include <functional>
+#include <memory>
 
 #include "backend/malloc_allocator.h"
+#include "backend/host_memory.h"
+#include "backend/binary_io.h"
+#include "backend/lazy.h"
 
 #ifdef SKEPU_PRECOMPILED
 
@@ -61,6 +66,9 @@ namespace skepu
 	template <typename T>
 	class VectorIterator;
 	
+	template<typename T>
+	class VectorView;
+	
 	/*!
 	*  \class Vector
 	*
@@ -96,6 +104,8 @@ namespace skepu
 		typedef VectorIterator<T> iterator;
 		typedef VectorIterator<const T> const_iterator;
 		
+		typedef std::function<void(T*)> deleter_type;
+		
 		//-- For Testing --//
 		
 		friend std::ostream& operator<< (std::ostream& output, Vector<T>& vec)
@@ -114,6 +124,8 @@ namespace skepu
 		void randomize(int min = 0, int max = RAND_MAX);
 		void save(const std::string& filename, const std::string& delimiter=" ");
 		void load(const std::string& filename, size_type numElements = 0);
+		void saveBinary(const std::string& filename);
+		void loadBinary(const std::string& filename, bool mapped = false);
 		
 	public: //-- Typedefs --//
 
@@ -133,7 +145,10 @@ namespace skepu
 		Vector(Vector&& vec);
 		Vector(std::initializer_list<T> l);
 		explicit Vector(size_type num, const T& val = T());
+		Vector(size_type num, uninitialized_t);
 		Vector(T * const ptr, size_type size, bool deallocEnabled = true);
+		Vector(T * const ptr, size_type size, deleter_type deleter);
+		Vector(const std::string& filename, memory_mapped_t);
 		
 		~Vector();
 		
@@ -165,6 +180,7 @@ namespace skepu
 		Vec<T> hostProxy() { return this->hostProxy(ProxyTag::Default{}, 0); }
 		
 		Vector<T>& operator=(const Vector<T>&);
+		Vector<T>& operator=(Vector<T>&&);
 		
 		bool operator==(const Vector<T>&);
 		bool operator!=(const Vector<T>&);
@@ -207,8 +223,18 @@ namespace skepu
 		
 		void swap(Vector<T>& from);
 		
+		void resize(size_type num);
+		void resize(size_type num, const T& val);
+		
 		T *getAddress() { return m_data; }
 		
+		void adopt(T *ptr, size_type size, deleter_type deleter);
+		std::unique_ptr<T[], deleter_type> release();
+		
+		void place(Placement placement);
+		
+		VectorView<T> view(size_type offset, size_type size, size_type stride = 1);
+		
 	public: //-- Additions to interface --//
 		
 #ifdef SKEPU_OPENCL
@@ -241,8 +267,13 @@ namespace skepu
 		void flush(FlushMode mode = FlushMode::Default);
 		
 		// Does not care about device data, use with care
+#ifdef SKEPU_LAZY
+		T& operator()(const size_type index) { backend::lazyAccess(this); return m_data[index]; }
+		const T& operator()(const size_type index) const { backend::lazyAccess(this); return m_data[index]; }
+#else
 		T& operator()(const size_type index) { return m_data[index]; }
 		const T& operator()(const size_type index) const { return m_data[index]; }
+#endif
 		
 		// To be able to explicitly force updates without flushing entire vector.
 		// Could be used with operator () above to avoid unneccesary function calls
@@ -263,7 +294,13 @@ namespace skepu
 		mutable bool m_valid; /*! to keep track of whether the main copy is valid or not */
 		size_type m_size = 0;
 		bool m_deallocEnabled;
+		deleter_type m_deleter; /*! frees host data passed in by the user, empty for data from m_allocator */
+		HostAllocator *m_allocator = nullptr; /*! allocator the host data came from */
 		mutable bool m_noValidDeviceCopy;
+		
+		void releaseHostData();
+		void writeBinary(const std::string& filename, size_t rank, const size_t *dims);
+		void readBinary(backend::BinaryFile& file, bool mapped);
 
 #ifdef SKEPU_OPENCL
 		mutable std::map<std::pair<cl_device_id, const T* >, device_pointer_type_cl > m_deviceMemPointers_CL;
@@ -0,0 +1,399 @@
+/*! \file view.hpp
+ *  \brief Contains the sub-range and strided views over Vector, Matrix and Tensor3 containers.
+ */
+
+#ifndef VIEW_HPP
+#define VIEW_HPP
+
+#include <iterator>
+#include <tuple>
+
+namespace skepu
+{
+	/*!
+	 *  \class ViewIterator
+	 *
+	 *  \brief Iterator over the elements of a container view, in row-major order of the view.
+	 *
+	 *  Provides the interface skeletons use for element-wise arguments: indexed access relative to the
+	 *  iterator, the index of the current element within the view and the view itself as parent.
+	 */
+	template<typename View>
+	class ViewIterator : public std::iterator<std::random_access_iterator_tag, typename View::value_type>
+	{
+	public:
+		typedef typename View::value_type value_type;
+		typedef ViewIterator<View> iterator;
+
+		ViewIterator(View &view, size_t pos): m_view(&view), m_pos(pos) {}
+
+		auto getIndex() const -> decltype(std::declval<View>().index(0)) { return this->m_view->index(this->m_pos); }
+
+		View &getParent() const { return *this->m_view; }
+		iterator &begin() { return *this; }
+		size_t size() const { return this->m_view->size() - this->m_pos; }
+
+		value_type *getAddress() const { return &this->m_view->at(this->m_pos); }
+
+		value_type &operator()(const ssize_t index = 0) const { return this->m_view->at(this->m_pos + index); }
+		value_type &operator[](const ssize_t index) const { return this->m_view->at(this->m_pos + index); }
+		value_type &operator*() const { return this->m_view->at(this->m_pos); }
+
+		bool operator==(const iterator &i) const { return this->m_pos == i.m_pos; }
+		bool operator!=(const iterator &i) const { return this->m_pos != i.m_pos; }
+		bool operator<(const iterator &i) const  { return this->m_pos < i.m_pos; }
+		bool operator>(const iterator &i) const  { return this->m_pos > i.m_pos; }
+		bool operator<=(const iterator &i) const { return this->m_pos <= i.m_pos; }
+		bool operator>=(const iterator &i) const { return this->m_pos >= i.m_pos; }
+
+		iterator &operator++() { ++this->m_pos; return *this; }
+		iterator operator++(int) { iterator tmp = *this; ++this->m_pos; return tmp; }
+		iterator &operator--() { --this->m_pos; return *this; }
+		iterator operator--(int) { iterator tmp = *this; --this->m_pos; return tmp; }
+
+		iterator &operator+=(const ssize_t i) { this->m_pos += i; return *this; }
+		iterator &operator-=(const ssize_t i) { this->m_pos -= i; return *this; }
+
+		iterator operator+(const ssize_t i) const { return iterator(*this->m_view, this->m_pos + i); }
+		iterator operator-(const ssize_t i) const { return iterator(*this->m_view, this->m_pos - i); }
+
+		ptrdiff_t operator-(const iterator &i) const { return (ptrdiff_t)this->m_pos - (ptrdiff_t)i.m_pos; }
+
+	private:
+		View *m_view;
+		size_t m_pos;
+	};
+
+
+	/*!
+	 *  \class VectorView
+	 *
+	 *  \brief A view of \p size elements of a vector, starting at an offset and \p stride elements apart.
+	 *
+	 *  No data is copied, the view refers to the host storage of the parent, which must outlive it. Coherence
+	 *  with device copies is handled by the parent: a skeleton updating or invalidating the view does so for
+	 *  the whole parent container. Views are accepted as element-wise and random-access arguments by the host
+	 *  backends, a random-access argument has to be contiguous.
+	 */
+	template<typename T>
+	class VectorView
+	{
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef Vec<T> proxy_type;
+		typedef ViewIterator<VectorView<T>> iterator;
+		typedef iterator const_iterator;
+
+		VectorView(Vector<T> &parent, size_type offset, size_type size, size_type stride = 1)
+		: m_parent(&parent), m_data(parent.getAddress() + offset), m_size(size), m_stride(stride)
+		{
+			if (size > 0 && offset + (size - 1) * stride >= parent.size())
+				SKEPU_ERROR("VectorView: view exceeds the parent vector");
+		}
+
+		size_type size() const   { return this->m_size; }
+		size_type size_i() const { return this->m_size; }
+		size_type size_j() const { return 0; }
+		size_type size_k() const { return 0; }
+		size_type size_l() const { return 0; }
+
+		std::tuple<size_type> size_info() const
+		{
+			return {this->m_size};
+		}
+
+		size_type stride() const { return this->m_stride; }
+		bool isContiguous() const { return this->m_stride == 1; }
+
+		VectorView<T> &getParent() { return *this; }
+		const VectorView<T> &getParent() const { return *this; }
+
+		T *getAddress() const { return this->m_data; }
+
+		iterator begin() { return iterator(*this, 0); }
+		iterator end()   { return iterator(*this, this->m_size); }
+
+		// Does not care about device data, use with care
+		T &operator()(const size_type index) const
+		{
+#ifdef SKEPU_LAZY
+			backend::lazyAccess(this->m_parent);
+#endif
+			return this->at(index);
+		}
+
+		T &at(size_type pos) const { return this->m_data[pos * this->m_stride]; }
+		Index1D index(size_type pos) const { return Index1D{pos}; }
+
+		template<typename Ignore>
+		Vec<T> hostProxy(ProxyTag::Default, Ignore) const
+		{
+			if (!this->isContiguous())
+				SKEPU_ERROR("VectorView: a strided view can not be used as a random-access argument");
+			return {this->m_data, this->m_size};
+		}
+
+		Vec<T> hostProxy() const { return this->hostProxy(ProxyTag::Default{}, 0); }
+
+		void updateHost(bool enable = true) const { this->m_parent->updateHost(enable); }
+		void invalidateDeviceData(bool enable = true) const { this->m_parent->invalidateDeviceData(enable); }
+		void flush(FlushMode mode = FlushMode::Default) { this->m_parent->flush(mode); }
+
+	private:
+		Vector<T> *m_parent;
+		T *m_data;
+		size_type m_size;
+		size_type m_stride;
+	};
+
+
+	/*!
+	 *  \class MatrixView
+	 *
+	 *  \brief A view of a \p rows x \p cols block of a 2D layout, with arbitrary distances between rows
+	 *  and between columns.
+	 *
+	 *  Created by Matrix::view, or by Tensor3::slice in which case \p Parent is the underlying Vector storage.
+	 *  A random-access argument (\p Mat) has to have contiguous rows, a row-wise argument (\p MatRow) only
+	 *  needs contiguous columns. MapOverlap 2D accepts views with contiguous columns as input.
+	 */
+	template<typename T, typename Parent>
+	class MatrixView
+	{
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef Mat<T> proxy_type;
+		typedef ViewIterator<MatrixView<T, Parent>> iterator;
+		typedef iterator const_iterator;
+
+		MatrixView(Parent &parent, T *data, size_type rows, size_type cols, size_type row_stride, size_type col_stride = 1)
+		: m_parent(&parent), m_data(data), m_rows(rows), m_cols(cols), m_row_stride(row_stride), m_col_stride(col_stride)
+		{}
+
+		size_type size() const       { return this->m_rows * this->m_cols; }
+		size_type total_rows() const { return this->m_rows; }
+		size_type total_cols() const { return this->m_cols; }
+		size_type size_i() const { return this->m_rows; }
+		size_type size_j() const { return this->m_cols; }
+		size_type size_k() const { return 0; }
+		size_type size_l() const { return 0; }
+
+		std::tuple<size_type, size_type> size_info() const
+		{
+			return {this->m_rows, this->m_cols};
+		}
+
+		size_type rowStride() const { return this->m_row_stride; }
+		size_type colStride() const { return this->m_col_stride; }
+		bool isContiguous() const { return this->m_col_stride == 1 && this->m_row_stride == this->m_cols; }
+
+		MatrixView<T, Parent> &getParent() { return *this; }
+		const MatrixView<T, Parent> &getParent() const { return *this; }
+
+		T *getAddress() const { return this->m_data; }
+
+		iterator begin() { return iterator(*this, 0); }
+		iterator end()   { return iterator(*this, this->size()); }
+
+		// Does not care about device data, use with care
+		T &operator()(const size_type row, const size_type col) const
+		{
+#ifdef SKEPU_LAZY
+			backend::lazyAccess(this->m_parent);
+#endif
+			return this->m_data[row * this->m_row_stride + col * this->m_col_stride];
+		}
+
+		T &at(size_type pos) const
+		{
+			return this->m_data[(pos / this->m_cols) * this->m_row_stride + (pos % this->m_cols) * this->m_col_stride];
+		}
+
+		Index2D index(size_type pos) const { return Index2D{pos / this->m_cols, pos % this->m_cols}; }
+
+		template<typename Ignore>
+		Mat<T> hostProxy(ProxyTag::Default, Ignore) const
+		{
+			if (!this->isContiguous())
+				SKEPU_ERROR("MatrixView: only a band of full rows can be used as a random-access argument");
+			Mat<T> proxy;
+			proxy.data = this->m_data;
+			proxy.rows = this->m_rows;
+			proxy.cols = this->m_cols;
+			return proxy;
+		}
+
+		Mat<T> hostProxy() const { return this->hostProxy(ProxyTag::Default{}, 0); }
+
+		MatRow<T> hostProxy(ProxyTag::MatRow, Index1D row) const
+		{
+			if (this->m_col_stride != 1)
+				SKEPU_ERROR("MatrixView: a column-strided view can not be used as a row-wise argument");
+			MatRow<T> proxy;
+			proxy.data = this->m_data + row.i * this->m_row_stride;
+			proxy.cols = this->m_cols;
+			return proxy;
+		}
+
+		void updateHost(bool enable = true) const { this->m_parent->updateHost(enable); }
+		void invalidateDeviceData(bool enable = true) const { this->m_parent->invalidateDeviceData(enable); }
+		void flush(FlushMode mode = FlushMode::Default) { this->m_parent->flush(mode); }
+
+	private:
+		Parent *m_parent;
+		T *m_data;
+		size_type m_rows, m_cols;
+		size_type m_row_stride, m_col_stride;
+	};
+
+
+	/*!
+	 *  \class Tensor3View
+	 *
+	 *  \brief A view of a \p si x \p sj x \p sk block of a tensor, with a step along each dimension.
+	 *
+	 *  A random-access argument (\p Ten3) has to be contiguous, i.e. cover full rows and planes.
+	 */
+	template<typename T>
+	class Tensor3View
+	{
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef Ten3<T> proxy_type;
+		typedef ViewIterator<Tensor3View<T>> iterator;
+		typedef iterator const_iterator;
+
+		Tensor3View(Tensor3<T> &parent, T *data, size_type si, size_type sj, size_type sk, size_type stride_i, size_type stride_j, size_type stride_k)
+		: m_parent(&parent), m_data(data), m_size_i(si), m_size_j(sj), m_size_k(sk),
+			m_stride_i(stride_i), m_stride_j(stride_j), m_stride_k(stride_k)
+		{}
+
+		size_type size() const   { return this->m_size_i * this->m_size_j * this->m_size_k; }
+		size_type size_i() const { return this->m_size_i; }
+		size_type size_j() const { return this->m_size_j; }
+		size_type size_k() const { return this->m_size_k; }
+		size_type size_l() const { return 0; }
+
+		std::tuple<size_type, size_type, size_type> size_info() const
+		{
+			return {this->m_size_i, this->m_size_j, this->m_size_k};
+		}
+
+		bool isContiguous() const
+		{
+			return this->m_stride_k == 1 && this->m_stride_j == this->m_size_k && this->m_stride_i == this->m_size_j * this->m_size_k;
+		}
+
+		Tensor3View<T> &getParent() { return *this; }
+		const Tensor3View<T> &getParent() const { return *this; }
+
+		T *getAddress() const { return this->m_data; }
+
+		iterator begin() { return iterator(*this, 0); }
+		iterator end()   { return iterator(*this, this->size()); }
+
+		// Does not care about device data, use with care
+		T &operator()(const size_type i, const size_type j, const size_type k) const
+		{
+#ifdef SKEPU_LAZY
+			backend::lazyAccess(this->m_parent);
+#endif
+			return this->m_data[i * this->m_stride_i + j * this->m_stride_j + k * this->m_stride_k];
+		}
+
+		T &at(size_type pos) const
+		{
+			Index3D idx = this->index(pos);
+			return this->m_data[idx.i * this->m_stride_i + idx.j * this->m_stride_j + idx.k * this->m_stride_k];
+		}
+
+		Index3D index(size_type pos) const
+		{
+			const size_type jk = this->m_size_j * this->m_size_k;
+			return Index3D{pos / jk, (pos % jk) / this->m_size_k, pos % this->m_size_k};
+		}
+
+		template<typename Ignore>
+		Ten3<T> hostProxy(ProxyTag::Default, Ignore) const
+		{
+			if (!this->isContiguous())
+				SKEPU_ERROR("Tensor3View: only a contiguous block can be used as a random-access argument");
+			return {this->m_data, this->m_size_i, this->m_size_j, this->m_size_k};
+		}
+
+		Ten3<T> hostProxy() const { return this->hostProxy(ProxyTag::Default{}, 0); }
+
+		void updateHost(bool enable = true) const { this->m_parent->updateHost(enable); }
+		void invalidateDeviceData(bool enable = true) const { this->m_parent->invalidateDeviceData(enable); }
+		void flush(FlushMode mode = FlushMode::Default) { this->m_parent->flush(mode); }
+
+	private:
+		Tensor3<T> *m_parent;
+		T *m_data;
+		size_type m_size_i, m_size_j, m_size_k;
+		size_type m_stride_i, m_stride_j, m_stride_k;
+	};
+
+
+	// Container member functions creating views
+
+	/*!
+	 *  Returns a view of \p size elements starting at \p offset, \p stride elements apart.
+	 */
+	template<typename T>
+	VectorView<T> Vector<T>::view(size_type offset, size_type size, size_type stride)
+	{
+		return VectorView<T>(*this, offset, size, stride);
+	}
+
+	/*!
+	 *  Returns a view of the \p rows x \p cols block starting at (\p row, \p col), taking every
+	 *  \p row_step:th row and every \p col_step:th column.
+	 */
+	template<typename T>
+	MatrixView<T> Matrix<T>::view(size_type row, size_type col, size_type rows, size_type cols, size_type row_step, size_type col_step)
+	{
+		if (rows == 0 || cols == 0 || row + (rows - 1) * row_step >= this->m_rows || col + (cols - 1) * col_step >= this->m_cols)
+			SKEPU_ERROR("Matrix: view exceeds the matrix");
+		return MatrixView<T>(*this, this->getAddress() + row * this->m_cols + col, rows, cols, row_step * this->m_cols, col_step);
+	}
+
+	/*!
+	 *  Returns a view of the \p si x \p sj x \p sk block starting at (\p i, \p j, \p k).
+	 */
+	template<typename T>
+	Tensor3View<T> Tensor3<T>::view(size_type i, size_type j, size_type k, size_type si, size_type sj, size_type sk)
+	{
+		if (si == 0 || sj == 0 || sk == 0 || i + si > this->m_size_i || j + sj > this->m_size_j || k + sk > this->m_size_k)
+			SKEPU_ERROR("Tensor3: view exceeds the tensor");
+		const size_type stride_i = this->m_size_j * this->m_size_k;
+		return Tensor3View<T>(*this, this->m_data + i * stride_i + j * this->m_size_k + k, si, sj, sk, stride_i, this->m_size_k, 1);
+	}
+
+	/*!
+	 *  Returns plane \p i as a \p size_j x \p size_k matrix view.
+	 */
+	template<typename T>
+	MatrixView<T, Vector<T>> Tensor3<T>::slice(size_type i)
+	{
+		if (i >= this->m_size_i)
+			SKEPU_ERROR("Tensor3: slice index out of range");
+		return MatrixView<T, Vector<T>>(*this, this->m_data + i * this->m_size_j * this->m_size_k, this->m_size_j, this->m_size_k, this->m_size_k);
+	}
+
+
+	namespace backend
+	{
+		// Distance in elements between consecutive rows of a 2D host argument
+		template<typename T>
+		size_t rowStride(Matrix<T> &arg) { return arg.total_cols(); }
+
+		template<typename T, typename Parent>
+		size_t rowStride(MatrixView<T, Parent> &arg) { return arg.rowStride(); }
+	}
+}
+
+#endif // VIEW_HPP
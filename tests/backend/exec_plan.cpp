@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+using Type = skepu::Backend::Type;
+
+TEST_CASE("Execution plan lookup")
+{
+	skepu::ExecPlan plan;
+	for (size_t i = 0; i < 1000; ++i)
+		plan.add(i * 100, i * 100 + 100, i % 2 ? Type::CPU : Type::OpenMP);
+
+	CHECK(plan.find(0).backend() == Type::OpenMP);
+	CHECK(plan.find(100).backend() == Type::OpenMP);
+	CHECK(plan.find(101).backend() == Type::CPU);
+	CHECK(plan.find(99999).backend() == Type::CPU);
+	CHECK(plan.isTrainedFor(100000));
+
+	// Sizes past the last range use the last range
+	CHECK(!plan.isTrainedFor(100001));
+	CHECK(plan.find(1 << 30).backend() == Type::CPU);
+
+	// Repeated lookups of a few sizes return the cached specification
+	for (size_t i = 0; i < 100; ++i)
+		REQUIRE(&plan.find(150 + i % 3) == &plan.find(150 + i % 3));
+}
+
+TEST_CASE("Overlapping and sparse ranges")
+{
+	skepu::ExecPlan plan;
+	plan.add(1000, 5000, Type::OpenMP);
+	plan.add(0, 2000, Type::CPU);
+	plan.add(8000, 9000, Type::CPU);
+
+	// The range with the lowest bound wins where ranges overlap
+	CHECK(plan.find(1500).backend() == Type::CPU);
+	CHECK(plan.find(2001).backend() == Type::OpenMP);
+
+	// Gaps fall back to the last range
+	CHECK(!plan.isTrainedFor(6000));
+	CHECK(plan.find(6000).backend() == Type::CPU);
+
+	// Ranges added later are found, and setters change the plan rather than a cached copy
+	plan.add(5001, 7999, Type::OpenMP);
+	CHECK(plan.find(6000).backend() == Type::OpenMP);
+	plan.setCPUThreads(6000, 3);
+	CHECK(plan.CPUThreads(7000) == 3);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include <skepu>
+
+using skepu::ExecutionTimeModel;
+
+// Time per element triples when the working set no longer fits in cache at 2^16 elements
+double kneeTime(size_t size)
+{
+	return size < (1 << 16) ? 2.0 + 0.01 * size : 2.0 + 0.03 * size - 0.02 * (1 << 16);
+}
+
+TEST_CASE("Linear model")
+{
+	ExecutionTimeModel cpu(ExecutionTimeModel::Kind::Linear), gpu(ExecutionTimeModel::Kind::Linear);
+	for (size_t size = 1000; size <= 10000; size += 1000)
+	{
+		cpu.addDataPoint(size, 2.0 * size + 100);
+		gpu.addDataPoint(size, 0.5 * size + 1000);
+	}
+	cpu.fitModel();
+	gpu.fitModel();
+
+	CHECK(cpu.getA() == Approx(2.0));
+	CHECK(cpu.getB() == Approx(100.0));
+	CHECK(cpu.getR2Error() == Approx(1.0));
+	CHECK(cpu.getPredictedTime(20000) == Approx(40100.0));
+
+	// 2*x*n + 100 == 0.5*(1-x)*n + 1000
+	CHECK(ExecutionTimeModel::predictCPUPartitionRatio(cpu, gpu, 10000) == Approx(0.24f).margin(0.011));
+	CHECK(ExecutionTimeModel::predictCPUPartitionRatio(cpu, gpu, 100) == 1.0f);
+}
+
+TEST_CASE("Piecewise model finds cache knees")
+{
+	ExecutionTimeModel piecewise, linear(ExecutionTimeModel::Kind::Linear);
+	for (size_t size = 1024; size <= (1 << 22); size *= 2)
+		for (double noise : {0.98, 1.0, 1.02})
+		{
+			piecewise.addDataPoint(size, kneeTime(size) * noise);
+			linear.addDataPoint(size, kneeTime(size) * noise);
+		}
+	piecewise.fitModel();
+	linear.fitModel();
+
+	auto breakpoints = piecewise.getBreakpoints();
+	REQUIRE(!breakpoints.empty());
+
+	double worstPiecewise = 0, worstLinear = 0;
+	for (size_t size = 1024; size <= (1 << 22); size *= 2)
+	{
+		worstPiecewise = std::max(worstPiecewise, std::abs(piecewise.getPredictedTime(size) / kneeTime(size) - 1));
+		worstLinear = std::max(worstLinear, std::abs(linear.getPredictedTime(size) / kneeTime(size) - 1));
+	}
+	CHECK(worstPiecewise < 0.1);
+	CHECK(worstLinear > 0.5);
+
+	// The interval covers the measurement noise
+	auto interval = piecewise.getPredictionInterval(1 << 18);
+	CHECK(interval.first < kneeTime(1 << 18) * 0.98);
+	CHECK(interval.second > kneeTime(1 << 18) * 1.02);
+}
+
+TEST_CASE("Log-log model fits a power law")
+{
+	ExecutionTimeModel model(ExecutionTimeModel::Kind::LogLog);
+	for (size_t size = 16; size <= (1 << 20); size *= 4)
+		model.addDataPoint(size, 3.0 * std::pow(size, 1.5));
+	model.fitModel();
+
+	CHECK(model.getA() == Approx(1.5));
+	CHECK(model.getPredictedTime(1000) == Approx(3.0 * std::pow(1000, 1.5)));
+	CHECK(model.getBreakpoints().empty());
+}
+
+TEST_CASE("Models are refitted from observed timings")
+{
+	ExecutionTimeModel model;
+	for (size_t size = 1024; size <= (1 << 20); size *= 2)
+		model.addDataPoint(size, 0.01 * size);
+	model.fitModel();
+	CHECK(model.getPredictedTime(1 << 16) == Approx(0.01 * (1 << 16)).epsilon(0.01));
+
+	// The hardware became twice as slow, old points are replaced by new observations
+	bool refitted = false;
+	for (size_t i = 0; i < SKEPU_MODEL_MAX_POINTS; ++i)
+		refitted = model.observe(1024 << (i % 11), 0.02 * (1024 << (i % 11))) || refitted;
+
+	CHECK(refitted);
+	CHECK(model.isFitted());
+	CHECK(model.getPredictedTime(1 << 16) == Approx(0.02 * (1 << 16)).epsilon(0.01));
+}
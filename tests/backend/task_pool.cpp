@@ -0,0 +1,182 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <skepu>
+
+int twice(int x)
+{
+	return 2 * x;
+}
+
+int square(int x)
+{
+	return x * x;
+}
+
+// Associative but not commutative, the result is the last element
+int last(int a, int b)
+{
+	return b;
+}
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+int add_int(int a, int b)
+{
+	return a + b;
+}
+
+int window(skepu::Region1D<int> r)
+{
+	return r(-1) + 2 * r(0) + r(1);
+}
+
+auto skepu_twice = skepu::Map<1>(twice);
+auto skepu_last = skepu::Reduce(last);
+auto skepu_sum = skepu::Reduce(add);
+auto skepu_square_last = skepu::MapReduce<1>(square, last);
+auto skepu_prefix = skepu::Scan(add_int);
+auto skepu_window = skepu::MapOverlap(window);
+
+#ifdef SKEPU_TASKPOOL
+
+TEST_CASE("TaskPool covers the range once with bounded threads")
+{
+	auto &pool = skepu::backend::TaskPool::instance();
+	
+	for (size_t threads : {1, 2, 4})
+		for (size_t grain : {0, 1, 7, 1000})
+		{
+			const size_t N = 10007;
+			std::vector<std::atomic<int>> visits(N);
+			for (auto &v : visits)
+				v = 0;
+			
+			std::mutex lock;
+			std::set<std::thread::id> ids;
+			
+			pool.parallelFor(0, N, threads, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					visits[i]++;
+				
+				std::lock_guard<std::mutex> guard(lock);
+				ids.insert(std::this_thread::get_id());
+			}, grain);
+			
+			for (size_t i = 0; i < N; ++i)
+				REQUIRE(visits[i] == 1);
+			REQUIRE(ids.size() <= threads);
+		}
+}
+
+TEST_CASE("TaskPool runs nested ranges")
+{
+	auto &pool = skepu::backend::TaskPool::instance();
+	std::atomic<size_t> count{0};
+	
+	pool.parallelFor(0, 64, 4, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+			pool.parallelFor(0, 100, 4, [&](size_t f, size_t l) { count += l - f; }, 3);
+	}, 1);
+	
+	REQUIRE(count == 6400);
+}
+
+TEST_CASE("TaskPool reduction combines blocks in order")
+{
+	auto &pool = skepu::backend::TaskPool::instance();
+	
+	for (size_t grain : {0, 1, 3, 50})
+	{
+		std::string res = pool.parallelReduce<std::string>(0, 200, 4, [](size_t first, size_t last)
+		{
+			std::string part;
+			for (size_t i = first; i < last; ++i)
+				part += std::to_string(i) + ",";
+			return part;
+		}, [](const std::string &a, const std::string &b) { return a + b; }, grain);
+		
+		std::string expected;
+		for (size_t i = 0; i < 200; ++i)
+			expected += std::to_string(i) + ",";
+		REQUIRE(res == expected);
+	}
+}
+
+#endif
+
+TEST_CASE("Map, Reduce and MapReduce on the TaskPool backend")
+{
+	skepu::BackendSpec spec{skepu::Backend::Type::TaskPool};
+	spec.setCPUThreads(4);
+	skepu_twice.setBackend(spec);
+	skepu_last.setBackend(spec);
+	skepu_sum.setBackend(spec);
+	skepu_square_last.setBackend(spec);
+	
+	for (size_t N : {1, 2, 1000, 100003})
+	{
+		skepu::Vector<int> v(N), res(N);
+		skepu::Vector<float> f(N);
+		for (size_t i = 0; i < N; ++i)
+		{
+			v(i) = i % 1000;
+			f(i) = 1.f / (i + 1);
+		}
+		
+		skepu_twice(res, v);
+		for (size_t i = 0; i < N; ++i)
+			REQUIRE(res(i) == 2 * v(i));
+		
+		REQUIRE(skepu_last(v) == v(N - 1));
+		REQUIRE(skepu_square_last(v) == v(N - 1) * v(N - 1));
+		
+		// Partial results are combined in a fixed order, so the floating-point sum does not vary between runs
+		const float sum = skepu_sum(f);
+		for (size_t run = 0; run < 10; ++run)
+			REQUIRE(skepu_sum(f) == sum);
+	}
+}
+
+TEST_CASE("Skeletons without a TaskPool implementation still run when TaskPool is selected")
+{
+	skepu::BackendSpec spec{skepu::Backend::Type::TaskPool};
+	spec.setCPUThreads(4);
+	skepu_prefix.setBackend(spec);
+	skepu_window.setBackend(spec);
+	skepu_window.setOverlapMode(skepu::Overlap::RowWise);
+	skepu_window.setEdgeMode(skepu::Edge::Pad);
+	skepu_window.setPad(0);
+	skepu_window.setOverlap(1);
+	
+	for (size_t N : {1, 2, 1000, 100003})
+	{
+		skepu::Vector<int> v(N), res(N);
+		for (size_t i = 0; i < N; ++i)
+			v(i) = i % 7;
+		
+		skepu_prefix(res, v);
+		int sum = 0;
+		for (size_t i = 0; i < N; ++i)
+		{
+			sum += v(i);
+			REQUIRE(res(i) == sum);
+		}
+		
+		skepu_window(res, v);
+		for (size_t i = 0; i < N; ++i)
+		{
+			const int left = (i > 0) ? v(i - 1) : 0;
+			const int right = (i + 1 < N) ? v(i + 1) : 0;
+			REQUIRE(res(i) == left + 2 * v(i) + right);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include <skepu>
+
+using namespace skepu::backend;
+
+struct Traced {};
+
+TEST_CASE("Nothing is recorded while tracing is disabled")
+{
+	skepu::disableTracing();
+	skepu::clearTrace();
+
+	Traced t;
+	{
+		TraceScope scope(TracePhase::Compute, &t, skepu::BackendSpec{skepu::Backend::Type::CPU}, 100, 400);
+	}
+	CHECK(Tracer::instance().events().empty());
+}
+
+TEST_CASE("Events from several threads are exported")
+{
+	skepu::clearTrace();
+	skepu::enableTracing();
+
+	Traced t;
+	skepu::BackendSpec spec{skepu::Backend::Type::OpenMP};
+	spec.setCPUThreads(3);
+
+	auto work = [&](size_t calls)
+	{
+		for (size_t i = 0; i < calls; ++i)
+			TraceScope scope(TracePhase::Compute, &t, spec, 1000, 8000);
+	};
+	std::thread other(work, 5000);
+	work(10);
+	other.join();
+	{
+		TraceScope scope(TracePhase::DeviceToHost, &t, skepu::Backend::Type::CUDA, 1000, 4000);
+	}
+	skepu::disableTracing();
+
+	auto events = Tracer::instance().events();
+	REQUIRE(events.size() == 5011);
+	CHECK(events.back().second.phase == TracePhase::DeviceToHost);
+	CHECK(events.front().second.CPUThreads == 3);
+	CHECK(events.front().second.bytes == 8000);
+	for (size_t i = 1; i < events.size(); ++i)
+		REQUIRE(events[i - 1].second.start <= events[i].second.start);
+
+	REQUIRE(skepu::writeTrace("trace_test"));
+
+	std::ifstream json("trace_test.json");
+	std::string trace((std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+	CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+	CHECK(trace.find("\"name\":\"Traced\",\"cat\":\"compute\",\"ph\":\"X\"") != std::string::npos);
+	CHECK(trace.find("\"backend\":\"OpenMP\"") != std::string::npos);
+
+	std::ifstream csv("trace_test.csv");
+	std::string header, row;
+	std::getline(csv, header);
+	CHECK(header == "skeleton,instance,phase,backend,elements,calls,total_us,mean_us,min_us,max_us,GB_per_s");
+	std::getline(csv, row);
+	CHECK(row.find("compute,OpenMP,1000,5010,") != std::string::npos);
+	std::getline(csv, row);
+	CHECK(row.find("device to host,CUDA,1000,1,") != std::string::npos);
+
+	skepu::clearTrace();
+	CHECK(Tracer::instance().events().empty());
+
+	std::remove("trace_test.json");
+	std::remove("trace_test.csv");
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <skepu>
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+auto skepu_add = skepu::Map<2>(add);
+
+#if defined(SKEPU_PRECOMPILED) && defined(SKEPU_OPENMP)
+
+using skepu::backend::tuner::ConfigurationTimer;
+using skepu::backend::tuner::tuneOpenMP;
+
+TEST_CASE("OpenMP coordinate descent finds the best configuration")
+{
+	const size_t size = 1 << 16;
+	size_t measured = 0;
+	
+	// Separable cost, smallest for one thread, guided scheduling and chunks of 64
+	ConfigurationTimer time([&] (const skepu::BackendSpec &spec)
+	{
+		++measured;
+		size_t cost = 1000 * spec.CPUThreads();
+		cost += (spec.schedulingMode() == skepu::Backend::Scheduling::Guided) ? 0 : 100;
+		cost += (spec.CPUChunkSize() == 64) ? 0 : 10;
+		return skepu::benchmark::TimeSpan(cost);
+	}, ConfigurationTimer::Clock::now() + std::chrono::hours(1));
+	
+	skepu::BackendSpec start{skepu::Backend::Type::OpenMP};
+	start.setCPUThreads(skepu::backend::tuner::hardwareThreads());
+	skepu::BackendSpec best = tuneOpenMP(start, size, time);
+	
+	CHECK(best.backend() == skepu::Backend::Type::OpenMP);
+	CHECK(best.CPUThreads() == 1);
+	CHECK(best.schedulingMode() == skepu::Backend::Scheduling::Guided);
+	CHECK(best.CPUChunkSize() == 64);
+	
+	// Every configuration is measured once, far fewer than the full grid
+	const size_t measuredFirst = measured;
+	CHECK(measured < 3 * 5 * 8);
+	tuneOpenMP(start, size, time);
+	CHECK(measured == measuredFirst);
+}
+
+TEST_CASE("Nothing is measured after the deadline")
+{
+	size_t measured = 0;
+	ConfigurationTimer time([&] (const skepu::BackendSpec &)
+	{
+		++measured;
+		return skepu::benchmark::TimeSpan(1);
+	}, ConfigurationTimer::Clock::now() - std::chrono::seconds(1));
+	
+	skepu::BackendSpec start{skepu::Backend::Type::OpenMP};
+	start.setCPUThreads(1);
+	skepu::BackendSpec best = tuneOpenMP(start, 1 << 16, time);
+	
+	CHECK(measured == 0);
+	CHECK(time(start) == skepu::benchmark::TimeSpan::max());
+	CHECK(best.CPUThreads() == start.CPUThreads());
+	CHECK(best.schedulingMode() == start.schedulingMode());
+	CHECK(best.CPUChunkSize() == start.CPUChunkSize());
+}
+
+TEST_CASE("A stored plan is extended to larger sizes")
+{
+	setenv("SKEPU_TUNING_DB", "", 1);
+	auto &db = skepu::backend::TuningDatabase::global();
+	const std::string key = skepu_add.tuningKey();
+	REQUIRE(!key.empty());
+	
+	skepu_add.tune(1 << 8);
+	std::unique_ptr<skepu::ExecPlan> small(db.lookup(key));
+	REQUIRE(small);
+	CHECK(skepu::backend::tuner::tunedUpTo(*small) == 1 << 8);
+	
+	// The ranges tuned before are kept, only the larger sizes are added
+	skepu_add.tune(1 << 12);
+	std::unique_ptr<skepu::ExecPlan> large(db.lookup(key));
+	REQUIRE(large);
+	CHECK(skepu::backend::tuner::tunedUpTo(*large) == 1 << 12);
+	for (auto &range : small->sizePlan())
+		CHECK(large->sizePlan().count(range.first) == 1);
+	
+	// A plan covering the requested sizes is reused as it is
+	skepu_add.tune(1 << 10);
+	std::unique_ptr<skepu::ExecPlan> reused(db.lookup(key));
+	CHECK(reused->sizePlan().size() == large->sizePlan().size());
+}
+
+#endif
+
+TEST_CASE("Tuning within an exhausted budget still gives a working plan")
+{
+	// Keep the tuned plans out of any database file
+	setenv("SKEPU_TUNING_DB", "", 1);
+	
+#if defined(SKEPU_PRECOMPILED) && defined(SKEPU_OPENMP)
+	// The thread count set by the application is kept, even when it is not the one the tuner started from
+	const int threads = (int)skepu::backend::tuner::hardwareThreads() + 1;
+	omp_set_num_threads(threads);
+#endif
+	
+	skepu_add.tune(1 << 12, 0.0);
+	
+#if defined(SKEPU_PRECOMPILED) && defined(SKEPU_OPENMP)
+	CHECK(omp_get_max_threads() == threads);
+#endif
+	
+	for (size_t n : {1, 100, 5000})
+	{
+		skepu::Vector<float> a(n, 1.f), b(n, 2.f), c(n);
+		skepu_add(c, a, b);
+		for (size_t i = 0; i < n; ++i)
+			REQUIRE(c(i) == 3.f);
+	}
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <skepu>
+
+using skepu::backend::TuningDatabase;
+
+TEST_CASE("Tuned plans are saved and loaded")
+{
+	std::remove("tuning_db_test.db");
+
+	skepu::ExecPlan plan;
+	skepu::BackendSpec cpu{skepu::Backend::Type::CPU};
+	skepu::BackendSpec omp{skepu::Backend::Type::OpenMP};
+	omp.setCPUThreads(3);
+	omp.setSchedulingMode(skepu::Backend::Scheduling::Dynamic);
+	omp.setCPUChunkSize(64);
+	plan.add(0, 1024, cpu);
+	plan.add(1024, 1 << 18, omp);
+
+	{
+		TuningDatabase db("tuning_db_test.db");
+		CHECK(db.lookup("map") == nullptr);
+		db.store("map", plan);
+		db.save();
+	}
+
+	TuningDatabase db("tuning_db_test.db");
+	REQUIRE(db.size() == 1);
+	CHECK(db.lookup("map", "some other host") == nullptr);
+
+	skepu::ExecPlan *loaded = db.lookup("map");
+	REQUIRE(loaded != nullptr);
+	CHECK(loaded->isCalibrated());
+	CHECK(loaded->find(100).backend() == skepu::Backend::Type::CPU);
+	auto &spec = loaded->find(5000);
+	CHECK(spec.backend() == skepu::Backend::Type::OpenMP);
+	CHECK(spec.CPUThreads() == 3);
+	CHECK(spec.schedulingMode() == skepu::Backend::Scheduling::Dynamic);
+	CHECK(spec.CPUChunkSize() == 64);
+	delete loaded;
+
+	std::remove("tuning_db_test.db");
+}
+
+TEST_CASE("Databases from several hosts are merged")
+{
+	std::ofstream("tuning_db_a.db")
+		<< "plan 100\thost a\tmap\n0 100 CPU 1 static 0 4 65535 256 0.2\nend\n"
+		<< "plan 100\thost b\tmap\n0 100 CPU 1 static 0 4 65535 256 0.2\nend\n";
+	std::ofstream("tuning_db_b.db")
+		<< "plan 200\thost b\tmap\n0 100 OpenMP 8 guided 16 4 65535 256 0.2\nend\n"
+		<< "plan 50\thost a\tmap\n0 100 OpenMP 2 static 0 4 65535 256 0.2\nend\n"
+		<< "plan 50\thost c\treduce\n0 100 CUDA 1 static 0 2 128 64 0.2\nend\n";
+
+	TuningDatabase db("tuning_db_a.db");
+	REQUIRE(db.merge("tuning_db_b.db"));
+	CHECK(db.size() == 3);
+
+	// The newest plan of each host wins
+	skepu::ExecPlan *a = db.lookup("map", "host a");
+	skepu::ExecPlan *b = db.lookup("map", "host b");
+	CHECK(a->find(10).backend() == skepu::Backend::Type::CPU);
+	CHECK(b->find(10).backend() == skepu::Backend::Type::OpenMP);
+	CHECK(b->find(10).CPUThreads() == 8);
+	delete a;
+	delete b;
+
+	// Plans for other hosts are kept when saving, even for backends this build lacks
+	db.save();
+	TuningDatabase saved("tuning_db_a.db");
+	CHECK(saved.size() == 3);
+	skepu::ExecPlan *c = saved.lookup("reduce", "host c");
+	REQUIRE(c != nullptr);
+	CHECK(c->find(10).GPUBlocks() == 128);
+	delete c;
+
+	std::remove("tuning_db_a.db");
+	std::remove("tuning_db_b.db");
+}
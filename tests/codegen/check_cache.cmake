@@ -0,0 +1,102 @@
+# Runs skepu-tool on copies of the inputs in WORK_DIR, as
+#   cmake -DSKEPU_TOOL=<skepu-tool> -DWORK_DIR=<dir> -DINPUTS=<files> -DINCLUDES=<dirs> -P check_cache.cmake
+# where INPUTS and INCLUDES are comma-separated, and checks that
+# - an input is not parsed again while it and the options are unchanged,
+# - editing the input or passing -no-cache generates it again,
+# - -j with several inputs writes the same outputs as precompiling them one at a time.
+
+string(REPLACE "," ";" _inputs "${INPUTS}")
+string(REPLACE "," ";" _includes "${INCLUDES}")
+set(_compiler_args -std=c++11)
+foreach(_dir IN LISTS _includes)
+	list(APPEND _compiler_args -I${_dir})
+endforeach()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/cache ${WORK_DIR}/serial ${WORK_DIR}/parallel)
+foreach(_input IN LISTS _inputs)
+	get_filename_component(_name ${_input} NAME)
+	configure_file(${_input} ${WORK_DIR}/${_name} COPYONLY)
+	list(APPEND _copies ${_name})
+endforeach()
+
+# Runs skepu-tool in WORK_DIR and stores what it printed in the variable named _log
+function(run_tool _log)
+	execute_process(COMMAND ${SKEPU_TOOL} ${ARGN} -- ${_compiler_args}
+		WORKING_DIRECTORY ${WORK_DIR}
+		RESULT_VARIABLE _result
+		OUTPUT_VARIABLE _output
+		ERROR_VARIABLE _output)
+	if(NOT _result EQUAL 0)
+		message(FATAL_ERROR "skepu-tool ${ARGN} failed:\n${_output}")
+	endif()
+	set(${_log} "${_output}" PARENT_SCOPE)
+endfunction()
+
+# Fails unless the run logged in _log did (_expected TRUE) or did not (FALSE) reuse the cached output
+function(expect_cached _log _expected _what)
+	string(FIND "${_log}" "Up to date, nothing to do" _pos)
+	if(_pos EQUAL -1)
+		set(_cached FALSE)
+	else()
+		set(_cached TRUE)
+	endif()
+	if(NOT _cached STREQUAL _expected)
+		message(FATAL_ERROR "${_what}: expected cached = ${_expected}\n${_log}")
+	endif()
+endfunction()
+
+# Cache hits and misses
+list(GET _copies 0 _first)
+set(_args -openmp -dir=cache -name cached ${_first})
+
+run_tool(_log ${_args})
+expect_cached("${_log}" FALSE "First run")
+if(NOT EXISTS ${WORK_DIR}/cache/cached.cpp OR NOT EXISTS ${WORK_DIR}/cache/cached.cpp.skepu-cache)
+	message(FATAL_ERROR "First run wrote no output or cache file")
+endif()
+
+run_tool(_log ${_args})
+expect_cached("${_log}" TRUE "Unchanged input")
+
+run_tool(_log -no-cache ${_args})
+expect_cached("${_log}" FALSE "Run with -no-cache")
+
+run_tool(_log -taskpool ${_args})
+expect_cached("${_log}" FALSE "Changed options")
+run_tool(_log ${_args})
+expect_cached("${_log}" FALSE "Options changed back")
+run_tool(_log ${_args})
+expect_cached("${_log}" TRUE "Unchanged input, second time")
+
+file(APPEND ${WORK_DIR}/${_first} "\n// Edited input\n")
+run_tool(_log ${_args})
+expect_cached("${_log}" FALSE "Edited input")
+file(READ ${WORK_DIR}/cache/cached.cpp _generated)
+string(FIND "${_generated}" "// Edited input" _pos)
+if(_pos EQUAL -1)
+	message(FATAL_ERROR "The output was not generated from the edited input")
+endif()
+run_tool(_log ${_args})
+expect_cached("${_log}" TRUE "Edited input, second run")
+
+# Concurrent precompilation
+foreach(_copy IN LISTS _copies)
+	run_tool(_log -openmp -no-cache -dir=serial ${_copy})
+endforeach()
+run_tool(_log -openmp -no-cache -dir=parallel -j=2 ${_copies})
+
+file(GLOB _serial RELATIVE ${WORK_DIR}/serial ${WORK_DIR}/serial/*)
+file(GLOB _parallel RELATIVE ${WORK_DIR}/parallel ${WORK_DIR}/parallel/*)
+list(LENGTH _copies _num_inputs)
+list(LENGTH _serial _num_serial)
+if(_num_serial LESS _num_inputs OR NOT _serial STREQUAL _parallel)
+	message(FATAL_ERROR "Serial outputs (${_serial}) differ from those of -j (${_parallel})")
+endif()
+foreach(_file IN LISTS _serial)
+	file(READ ${WORK_DIR}/serial/${_file} _serial_source)
+	file(READ ${WORK_DIR}/parallel/${_file} _parallel_source)
+	if(NOT _serial_source STREQUAL _parallel_source)
+		message(FATAL_ERROR "${_file} differs between serial and -j precompilation")
+	endif()
+endforeach()
@@ -0,0 +1,21 @@
+# Checks the source generated by skepu-tool for a test, run as
+#   cmake -DFILE=<generated source> [-DEXPECT=<text>] [-DREJECT=<text>] -P check_generated.cmake
+# EXPECT and REJECT are comma-separated. Each text in EXPECT must occur in the source and none in REJECT may.
+
+file(READ ${FILE} _source)
+string(REPLACE "," ";" _expect "${EXPECT}")
+string(REPLACE "," ";" _reject "${REJECT}")
+
+foreach(_text IN LISTS _expect)
+	string(FIND "${_source}" "${_text}" _pos)
+	if(_pos EQUAL -1)
+		message(FATAL_ERROR "${FILE} does not contain ${_text}")
+	endif()
+endforeach()
+
+foreach(_text IN LISTS _reject)
+	string(FIND "${_source}" "${_text}" _pos)
+	if(NOT _pos EQUAL -1)
+		message(FATAL_ERROR "${FILE} contains ${_text}")
+	endif()
+endforeach()
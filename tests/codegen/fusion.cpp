@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float square(float a)
+{
+	return a * a;
+}
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+float mult(float a, float b)
+{
+	return a * b;
+}
+
+TEST_CASE("Map fused into a consuming Map")
+{
+	for (size_t N : {1, 7, 2048})
+	{
+		auto skepu_square = skepu::Map<1>(square);
+		auto skepu_add = skepu::Map<2>(add);
+		
+		skepu::Vector<float> a(N), b(N), tmp(N), res(N);
+		for (size_t i = 0; i < N; ++i)
+		{
+			a(i) = i % 13;
+			b(i) = 1.f;
+		}
+		
+		skepu_square(tmp, a);
+		skepu_add(res, b, tmp);
+		
+		for (size_t i = 0; i < N; ++i)
+			REQUIRE(res(i) == a(i) * a(i) + 1.f);
+	}
+}
+
+TEST_CASE("Map fused into a MapReduce consuming it as second argument")
+{
+	for (size_t N : {1, 7, 2048})
+	{
+		auto skepu_square = skepu::Map<1>(square);
+		auto skepu_dot = skepu::MapReduce<2>(mult, add);
+		
+		// The intermediate is longer than the first argument, only as many elements as that holds are reduced
+		skepu::Vector<float> a(N + 5), tmp(N + 5), w(N);
+		for (size_t i = 0; i < N + 5; ++i)
+			a(i) = i % 5;
+		for (size_t i = 0; i < N; ++i)
+			w(i) = 2.f;
+		
+		skepu_square(tmp, a);
+		float res = skepu_dot(w, tmp);
+		
+		float expected = 0;
+		for (size_t i = 0; i < N; ++i)
+			expected += 2.f * a(i) * a(i);
+		REQUIRE(res == expected);
+	}
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float square(float a)
+{
+	return a * a;
+}
+
+// Clears the last element of a container the consumer can write
+float clear_last(float a, skepu::Vec<float> v)
+{
+	v[v.size - 1] = 0.f;
+	return a;
+}
+
+float add_offset(float a, float offset)
+{
+	return a + offset;
+}
+
+TEST_CASE("No fusion when the consumer writes a container the producer reads")
+{
+	const size_t N = 100;
+	auto skepu_square = skepu::Map<1>(square);
+	auto skepu_clear_last = skepu::Map<1>(clear_last);
+	
+	skepu::Vector<float> a(N, 3.f), tmp(N), res(N);
+	
+	// The producer must have read all of a before the consumer clears its last element
+	skepu_square(tmp, a);
+	skepu_clear_last(res, tmp, a);
+	
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(res(i) == 9.f);
+	REQUIRE(a(N - 1) == 0.f);
+}
+
+TEST_CASE("No fusion when a consumer argument has side effects")
+{
+	const size_t N = 100;
+	auto skepu_square = skepu::Map<1>(square);
+	auto skepu_add_offset = skepu::Map<1>(add_offset);
+	
+	skepu::Vector<float> a(N, 2.f), tmp(N), res(N);
+	float offset = 1.f;
+	
+	skepu_square(tmp, a);
+	skepu_add_offset(res, tmp, offset++);
+	
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(res(i) == 5.f);
+	REQUIRE(offset == 2.f);
+}
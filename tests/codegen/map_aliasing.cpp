@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+float scale(double x)
+{
+	return x * 0.5;
+}
+
+float shift_row(skepu::Index2D idx, float x)
+{
+	return x + idx.row;
+}
+
+auto skepu_add = skepu::Map<2>(add);
+auto skepu_scale = skepu::Map<1>(scale);
+auto skepu_shift_row = skepu::Map<1>(shift_row);
+
+TEST_CASE("Map with the output aliasing its inputs")
+{
+	for (size_t N : {1, 7, 2048, 100003})
+	{
+		skepu::Vector<float> v(N);
+		for (size_t i = 0; i < N; ++i)
+			v(i) = i;
+		
+		skepu_add(v, v, v);
+		for (size_t i = 0; i < N; ++i)
+			REQUIRE(v(i) == 2.f * i);
+	}
+}
+
+TEST_CASE("Indexed Map on a matrix in place")
+{
+	skepu::Matrix<float> m(37, 53, 1.f);
+	skepu_shift_row(m, m);
+	
+	for (size_t i = 0; i < m.total_rows(); ++i)
+		for (size_t j = 0; j < m.total_cols(); ++j)
+			REQUIRE(m(i, j) == 1.f + i);
+}
+
+TEST_CASE("Map with a parameter type differing from the container element type")
+{
+	const size_t N = 1000;
+	skepu::Vector<float> in(N), res(N);
+	for (size_t i = 0; i < N; ++i)
+		in(i) = i;
+	
+	skepu_scale(res, in);
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(res(i) == 0.5f * i);
+}
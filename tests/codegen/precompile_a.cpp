@@ -0,0 +1,17 @@
+#include <skepu>
+
+// Input of the precompilation cache test, which only runs skepu-tool on it
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+int main()
+{
+	auto skepu_add = skepu::Map<2>(add);
+	
+	skepu::Vector<float> a(10, 1.f), b(10, 2.f), res(10);
+	skepu_add(res, a, b);
+	return res(0) == 3.f ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+#include <skepu>
+
+// Input of the precompilation cache test, which only runs skepu-tool on it
+
+int max_int(int a, int b)
+{
+	return a > b ? a : b;
+}
+
+int main()
+{
+	auto skepu_max = skepu::Reduce(max_int);
+	
+	skepu::Vector<int> v(10);
+	for (size_t i = 0; i < v.size(); ++i)
+		v(i) = (int)i;
+	return skepu_max(v) == 9 ? 0 : 1;
+}
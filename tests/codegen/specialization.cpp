@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float square(float x)
+{
+	return x * x;
+}
+
+float scaled_square(float x, float scale)
+{
+	return scale * square(x);
+}
+
+// Evaluates sum(scale * x^2k) for k < terms, the loop is unrolled once terms is a constant
+float series(float x, int terms, float scale)
+{
+	float res = 0.f;
+	float power = 1.f;
+	for (int k = 0; k < terms; ++k)
+	{
+		res += scaled_square(power, scale);
+		power *= x;
+	}
+	return res;
+}
+
+// Keeps the arguments of the generic calls from being known at compile time
+static int runtime_terms = 5;
+static float runtime_scale = 0.5f;
+
+TEST_CASE("Calls with constant uniform arguments match the generic instance")
+{
+	auto skepu_series = skepu::Map<1>(series);
+	auto skepu_series_generic = skepu::Map<1>(series);
+	
+	for (size_t N : {1, 7, 1000})
+	{
+		skepu::Vector<float> x(N), specialized(N), generic(N);
+		// All terms are exact in float, so the results do not depend on how the variants are optimized
+		for (size_t i = 0; i < N; ++i)
+			x(i) = (i % 5) / 4.f;
+		
+		skepu_series(specialized, x, 5, 0.5f);
+		skepu_series_generic(generic, x, runtime_terms, runtime_scale);
+		for (size_t i = 0; i < N; ++i)
+			REQUIRE(specialized(i) == generic(i));
+		
+		// A second set of constants gets a variant of its own
+		skepu_series(specialized, x, 3, 2.f);
+		runtime_terms = 3;
+		runtime_scale = 2.f;
+		skepu_series_generic(generic, x, runtime_terms, runtime_scale);
+		for (size_t i = 0; i < N; ++i)
+			REQUIRE(specialized(i) == generic(i));
+		
+		runtime_terms = 5;
+		runtime_scale = 0.5f;
+	}
+}
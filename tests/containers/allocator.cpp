@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+TEST_CASE("Container storage is aligned")
+{
+	skepu::SystemAllocator allocator(128);
+	skepu::HostAllocatorScope scope(allocator);
+
+	for (size_t N : {1, 100, 1000000})
+	{
+		skepu::Vector<float> v(N, 1.f);
+		skepu::Matrix<float> m(2, N, 2.f);
+		CHECK((size_t)v.getAddress() % 128 == 0);
+		CHECK((size_t)m.getAddress() % 128 == 0);
+		CHECK(m(1, N - 1) == 2.f);
+	}
+}
+
+TEST_CASE("Huge page storage")
+{
+	skepu::SystemAllocator allocator(64, skepu::SystemAllocator::HugePages::Transparent);
+	skepu::HostAllocatorScope scope(allocator);
+
+	size_t constexpr N{3000000};
+	skepu::Vector<float> v(N, 1.f);
+	skepu::Matrix<double> m(3, N / 3, 2.0);
+	CHECK(v(N - 1) == 1.f);
+	CHECK(m(2, N / 3 - 1) == 2.0);
+}
+
+TEST_CASE("Pool recycles released buffers")
+{
+	skepu::PoolAllocator pool(skepu::getHostAllocator());
+	skepu::HostAllocatorScope scope(pool);
+
+	size_t constexpr N{1000000};
+	float *first;
+	{
+		skepu::Vector<float> tmp(N, 1.f);
+		first = tmp.getAddress();
+	}
+	CHECK(pool.cachedBytes() >= N * sizeof(float));
+
+	skepu::Vector<float> reused(N, 2.f);
+	CHECK(reused.getAddress() == first);
+	CHECK(reused(N - 1) == 2.f);
+	CHECK(pool.cachedBytes() == 0);
+
+	pool.release();
+}
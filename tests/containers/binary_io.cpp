@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <skepu>
+
+TEST_CASE("Binary round trip")
+{
+	skepu::Vector<float> v(1000);
+	for (size_t i = 0; i < v.size(); ++i)
+		v(i) = i * 0.5f;
+	v.saveBinary("binary_io_vector.bin");
+
+	skepu::Vector<float> v2;
+	v2.loadBinary("binary_io_vector.bin");
+	REQUIRE(v2.size() == v.size());
+	for (size_t i = 0; i < v.size(); ++i)
+		REQUIRE(v2(i) == v(i));
+
+	skepu::Matrix<double> m(37, 53);
+	for (size_t i = 0; i < m.size(); ++i)
+		m[i] = i * 0.25;
+	m.saveBinary("binary_io_matrix.bin");
+
+	skepu::Matrix<double> m2(2, 2);
+	m2.loadBinary("binary_io_matrix.bin");
+	REQUIRE(m2.total_rows() == 37);
+	REQUIRE(m2.total_cols() == 53);
+	for (size_t i = 0; i < m.size(); ++i)
+		REQUIRE(m2[i] == m[i]);
+
+	skepu::Tensor3<int> t3(4, 5, 6);
+	for (size_t i = 0; i < t3.size(); ++i)
+		t3[i] = i;
+	t3.saveBinary("binary_io_tensor3.bin");
+
+	skepu::Tensor3<int> t3b;
+	t3b.loadBinary("binary_io_tensor3.bin");
+	REQUIRE(t3b.size_k() == 6);
+	CHECK(t3b(3, 4, 5) == t3(3, 4, 5));
+
+	skepu::Tensor4<int> t4(2, 3, 4, 5);
+	for (size_t i = 0; i < t4.size(); ++i)
+		t4[i] = 3 * i;
+	t4.saveBinary("binary_io_tensor4.bin");
+
+	skepu::Tensor4<int> t4b;
+	t4b.loadBinary("binary_io_tensor4.bin");
+	REQUIRE(t4b.size_l() == 5);
+	CHECK(t4b(1, 2, 3, 4) == t4(1, 2, 3, 4));
+
+	// Any binary file can be read flat into a vector
+	skepu::Vector<int> flat;
+	flat.loadBinary("binary_io_tensor4.bin");
+	CHECK(flat.size() == t4.size());
+	CHECK(flat(119) == 3 * 119);
+
+	for (auto name : {"binary_io_vector.bin", "binary_io_matrix.bin", "binary_io_tensor3.bin", "binary_io_tensor4.bin"})
+		std::remove(name);
+}
+
+TEST_CASE("Large binary files are read in chunks")
+{
+	size_t constexpr N{5000000};
+	skepu::Vector<float> v(N);
+	for (size_t i = 0; i < N; ++i)
+		v(i) = (i * 7919 % 1000) / 8.f;
+	v.saveBinary("binary_io_large.bin");
+
+	skepu::Vector<float> v2(N, 0.f);
+	v2.loadBinary("binary_io_large.bin");
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(v2(i) == v(i));
+
+	std::remove("binary_io_large.bin");
+}
+
+TEST_CASE("Memory-mapped containers")
+{
+	skepu::Tensor3<float> t(10, 20, 30);
+	for (size_t i = 0; i < t.size(); ++i)
+		t[i] = i;
+	t.saveBinary("binary_io_mapped.bin");
+
+	{
+		skepu::Tensor3<float> mapped("binary_io_mapped.bin", skepu::memory_mapped);
+		REQUIRE(mapped.size_i() == 10);
+		REQUIRE(mapped.size_j() == 20);
+		REQUIRE(mapped.size_k() == 30);
+		CHECK(mapped(9, 19, 29) == t(9, 19, 29));
+
+		// Modifications stay private to the process
+		mapped(0, 0, 0) = -1.f;
+		CHECK(mapped(0, 0, 0) == -1.f);
+	}
+
+	skepu::Vector<float> v("binary_io_mapped.bin", skepu::memory_mapped);
+	REQUIRE(v.size() == t.size());
+	CHECK(v(0) == 0.f);
+	for (size_t i = 0; i < v.size(); ++i)
+		REQUIRE(v(i) == t[i]);
+
+	std::remove("binary_io_mapped.bin");
+}
+
+TEST_CASE("Binary files from the other byte order")
+{
+	skepu::Vector<float> v(100);
+	for (size_t i = 0; i < v.size(); ++i)
+		v(i) = i + 0.5f;
+	v.saveBinary("binary_io_native.bin");
+
+	// Convert the file to what a machine of the other byte order writes: the elements, the checksum of the
+	// resulting bytes, then the header fields
+	std::ifstream in("binary_io_native.bin", std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	for (size_t offset = 64; offset < bytes.size(); offset += sizeof(float))
+		std::reverse(&bytes[offset], &bytes[offset + sizeof(float)]);
+	uint64_t checksum = skepu::backend::binaryChecksum(&bytes[64], bytes.size() - 64);
+	std::memcpy(&bytes[56], &checksum, sizeof(checksum));
+	std::reverse(&bytes[8], &bytes[12]);
+	std::reverse(&bytes[12], &bytes[16]);
+	for (size_t offset = 16; offset < 64; offset += 8)
+		std::reverse(&bytes[offset], &bytes[offset + 8]);
+
+	std::ofstream out("binary_io_swapped.bin", std::ios::binary);
+	out.write(bytes.data(), bytes.size());
+	out.close();
+
+	skepu::Vector<float> v2;
+	v2.loadBinary("binary_io_swapped.bin");
+	REQUIRE(v2.size() == v.size());
+	for (size_t i = 0; i < v.size(); ++i)
+		REQUIRE(v2(i) == v(i));
+
+	std::remove("binary_io_native.bin");
+	std::remove("binary_io_swapped.bin");
+}
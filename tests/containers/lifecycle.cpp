@@ -163,4 +163,70 @@ TEST_CASE("Tensor4 lifecycle")
 	t5(0, 0, 0, 0) = 2.71f;
 	CHECK(t5(0, 0, 0, 0) == 2.71f);
 	CHECK(t4(0, 0, 0, 0) == 3.142f);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Vector ownership")
+{
+	// Uninitialized construction and resize
+	skepu::Vector<float> v1(100, skepu::uninitialized);
+	CHECK(v1.size() == 100);
+	v1.resize(200, 3.142f);
+	CHECK(v1.size() == 200);
+	CHECK(v1(199) == 3.142f);
+	v1(0) = 2.71f;
+	v1.resize(50);
+	CHECK(v1.size() == 50);
+	CHECK(v1(0) == 2.71f);
+	
+	// Move constructor and assignment do not copy
+	float *data = v1.getAddress();
+	skepu::Vector<float> v2(std::move(v1));
+	CHECK(v2.getAddress() == data);
+	CHECK(v1.size() == 0);
+	skepu::Vector<float> v3(10, 1.f);
+	v3 = std::move(v2);
+	CHECK(v3.getAddress() == data);
+	CHECK(v3.size() == 50);
+	
+	// Adopt with a custom deleter
+	bool deleted = false;
+	{
+		float *buffer = new float[10]();
+		skepu::Vector<float> v4(buffer, 10, [&deleted](float *p) { deleted = true; delete[] p; });
+		CHECK(v4.getAddress() == buffer);
+		CHECK(v4(9) == 0.f);
+	}
+	CHECK(deleted);
+	
+	// Release
+	auto released = v3.release();
+	CHECK(released.get() == data);
+	CHECK(v3.size() == 0);
+	CHECK(released[0] == 2.71f);
+}
+
+TEST_CASE("Matrix ownership")
+{
+	skepu::Matrix<float> m1(10, 10, skepu::uninitialized);
+	CHECK(m1.size() == 10 * 10);
+	m1.resize(20, 10, 3.142f);
+	CHECK(m1.total_rows() == 20);
+	CHECK(m1(19, 9) == 3.142f);
+	
+	float *data = m1.getAddress();
+	skepu::Matrix<float> m2(std::move(m1));
+	CHECK(m2.getAddress() == data);
+	CHECK(m1.size() == 0);
+	skepu::Matrix<float> m3(5, 5, 1.f);
+	m3 = std::move(m2);
+	CHECK(m3.getAddress() == data);
+	CHECK(m3.total_cols() == 10);
+	
+	auto storage = m3.release();
+	CHECK(storage.data() == data);
+	CHECK(m3.size() == 0);
+	skepu::Matrix<float> m4;
+	m4.adopt(20, 10, std::move(storage));
+	CHECK(m4.getAddress() == data);
+	CHECK(m4(19, 9) == 3.142f);
+}
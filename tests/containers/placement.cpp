@@ -0,0 +1,36 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+TEST_CASE("Containers keep their values under every placement")
+{
+	for (auto placement : {skepu::Placement::firstTouch(), skepu::Placement::interleave(), skepu::Placement::onNode(0)})
+	{
+		skepu::PlacementScope scope(placement);
+		for (size_t N : {1, 1000, 1000000})
+		{
+			skepu::Vector<float> v(N, 3.f), copy(v);
+			skepu::Matrix<double> m(2, N, 1.5), zero(2, N);
+			CHECK(v(N - 1) == 3.f);
+			CHECK(copy(N / 2) == 3.f);
+			CHECK(m(1, N - 1) == 1.5);
+			CHECK(zero(1, N / 2) == 0.0);
+		}
+	}
+}
+
+TEST_CASE("Containers can be placed after creation")
+{
+	size_t constexpr N{1000000};
+	skepu::Vector<float> v(N, 2.f);
+	skepu::Matrix<float> m(4, N / 4, 5.f);
+
+	v.place(skepu::Placement::interleave());
+	m.place(skepu::Placement::firstTouch());
+	CHECK(v(0) == 2.f);
+	CHECK(v(N - 1) == 2.f);
+	CHECK(m(3, N / 4 - 1) == 5.f);
+
+	v.place(skepu::Placement::firstTouch(2));
+	CHECK(v(N / 2) == 2.f);
+}
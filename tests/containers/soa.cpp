@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+struct Particle
+{
+	float x, y, z;
+	float vx, vy, vz;
+	float mass;
+};
+
+namespace skepu
+{
+	template<>
+	struct soa_layout<Particle>: soa_fields<
+		SKEPU_SOA_FIELD(Particle, x), SKEPU_SOA_FIELD(Particle, y), SKEPU_SOA_FIELD(Particle, z),
+		SKEPU_SOA_FIELD(Particle, vx), SKEPU_SOA_FIELD(Particle, vy), SKEPU_SOA_FIELD(Particle, vz),
+		SKEPU_SOA_FIELD(Particle, mass)> {};
+}
+
+Particle move(Particle p, float dt)
+{
+	p.x += p.vx * dt;
+	p.y += p.vy * dt;
+	p.z += p.vz * dt;
+	return p;
+}
+
+float kinetic(Particle p)
+{
+	return 0.5f * p.mass * (p.vx * p.vx + p.vy * p.vy + p.vz * p.vz);
+}
+
+skepu::multiple<Particle, float> split(skepu::Index1D idx, Particle p)
+{
+	p.mass = idx.i;
+	return skepu::ret(p, p.x);
+}
+
+Particle place(skepu::Index2D idx)
+{
+	Particle p{};
+	p.x = idx.row;
+	p.y = idx.col;
+	return p;
+}
+
+auto skepu_move = skepu::Map<1>(move);
+auto skepu_kinetic = skepu::Map<1>(kinetic);
+auto skepu_split = skepu::Map<1>(split);
+auto skepu_place = skepu::Map<0>(place);
+
+TEST_CASE("Elements are stored one array per member")
+{
+	skepu::VectorSoA<Particle> v(10, Particle{1, 2, 3, 4, 5, 6, 7});
+	v(3) = Particle{10, 20, 30, 40, 50, 60, 70};
+
+	Particle p = v(3);
+	CHECK(p.y == 20.f);
+	CHECK(p.mass == 70.f);
+
+	float *x = v.field<0>();
+	float *mass = v.field<6>();
+	CHECK(x[2] == 1.f);
+	CHECK(x[3] == 10.f);
+	CHECK(mass[3] == 70.f);
+
+	v(4) = v(3);
+	CHECK(x[4] == 10.f);
+}
+
+TEST_CASE("Map over structure-of-arrays vectors")
+{
+	size_t constexpr N{1000};
+	skepu::VectorSoA<Particle> particles(N), moved(N);
+	for (size_t i = 0; i < N; ++i)
+		particles(i) = Particle{float(i), 0, 0, 1, 2, 3, 2};
+
+	skepu_move(moved, particles, 0.5f);
+	for (size_t i = 0; i < N; ++i)
+	{
+		Particle p = moved(i);
+		REQUIRE(p.x == i + 0.5f);
+		REQUIRE(p.y == 1.f);
+		REQUIRE(p.z == 1.5f);
+		REQUIRE(p.mass == 2.f);
+	}
+
+	// In place
+	skepu_move(particles, particles, 1.f);
+	CHECK(particles.field<2>()[N - 1] == 3.f);
+
+	skepu::Vector<float> energy(N);
+	skepu_kinetic(energy, particles);
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(energy(i) == 14.f);
+
+	skepu::Vector<float> x(N);
+	skepu_split(moved, x, particles);
+	for (size_t i = 0; i < N; ++i)
+	{
+		REQUIRE(moved.field<6>()[i] == i);
+		REQUIRE(x(i) == i + 1.f);
+	}
+}
+
+TEST_CASE("Map over structure-of-arrays matrices")
+{
+	skepu::MatrixSoA<Particle> m(7, 9);
+	skepu_place(m);
+
+	for (size_t i = 0; i < 7; ++i)
+		for (size_t j = 0; j < 9; ++j)
+		{
+			Particle p = m(i, j);
+			REQUIRE(p.x == i);
+			REQUIRE(p.y == j);
+		}
+
+	skepu::Matrix<float> energy(7, 9);
+	skepu_kinetic(energy, m);
+	CHECK(energy(6, 8) == 0.f);
+}
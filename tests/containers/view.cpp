@@ -0,0 +1,168 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float scale(float a, float b)
+{
+	return 2 * a + b;
+}
+
+skepu::Index2D coords(skepu::Index2D idx)
+{
+	return idx;
+}
+
+float row_sum(float x, const skepu::MatRow<float> row)
+{
+	float res = x;
+	for (size_t j = 0; j < row.cols; ++j)
+		res += row[j];
+	return res;
+}
+
+float sum_all(float x, skepu::Vec<float> v)
+{
+	float res = x;
+	for (size_t i = 0; i < v.size; ++i)
+		res += v[i];
+	return res;
+}
+
+float blur(skepu::Region2D<float> r)
+{
+	return r(-1, 0) + r(1, 0) + r(0, -1) + r(0, 1) - 4 * r(0, 0);
+}
+
+auto skepu_scale = skepu::Map<2>(scale);
+auto skepu_coords = skepu::Map<0>(coords);
+auto skepu_row_sum = skepu::Map<1>(row_sum);
+auto skepu_sum_all = skepu::Map<1>(sum_all);
+auto skepu_blur = skepu::MapOverlap(blur);
+
+TEST_CASE("Vector views")
+{
+	size_t constexpr N{1000};
+	skepu::Vector<float> v(N), w(N, 1.f);
+	for (size_t i = 0; i < N; ++i)
+		v(i) = i;
+
+	// Every third element of v, starting at 10
+	auto strided = v.view(10, 300, 3);
+	REQUIRE(strided.size() == 300);
+	CHECK(strided(5) == 25.f);
+
+	skepu::Vector<float> res(300);
+	skepu_scale(res, strided, w.view(0, 300));
+	for (size_t i = 0; i < 300; ++i)
+		REQUIRE(res(i) == 2 * (10 + 3 * i) + 1);
+
+	// Writing through a view only touches the viewed elements
+	skepu_scale(v.view(1, 250, 2), res.view(0, 250), res.view(0, 250));
+	for (size_t i = 0; i < N; ++i)
+		if (i % 2 == 1 && i < 500)
+			REQUIRE(v(i) == 3 * res(i / 2));
+		else
+			REQUIRE(v(i) == i);
+
+	// A contiguous view as random-access argument
+	skepu::Vector<float> sums(4);
+	skepu_sum_all(sums, w.view(0, 4), w.view(100, 50));
+	CHECK(sums(3) == 51.f);
+
+}
+
+TEST_CASE("Matrix views")
+{
+	size_t constexpr R{40}, C{70};
+	skepu::Matrix<float> m(R, C);
+	for (size_t i = 0; i < R; ++i)
+		for (size_t j = 0; j < C; ++j)
+			m(i, j) = i * C + j;
+
+	auto block = m.view(3, 5, 10, 20);
+	REQUIRE(block.total_rows() == 10);
+	REQUIRE(block.total_cols() == 20);
+	CHECK(block(2, 4) == m(5, 9));
+
+	// Indices passed to the user function are relative to the view
+	skepu::Matrix<skepu::Index2D> idx(R, C);
+	skepu_coords(idx.view(3, 5, 10, 20));
+	for (size_t i = 0; i < 10; ++i)
+		for (size_t j = 0; j < 20; ++j)
+			REQUIRE((idx(3 + i, 5 + j).row == i && idx(3 + i, 5 + j).col == j));
+
+	skepu::Matrix<float> res(10, 20);
+	skepu_scale(res, block, block);
+	for (size_t i = 0; i < 10; ++i)
+		for (size_t j = 0; j < 20; ++j)
+			REQUIRE(res(i, j) == 3 * m(3 + i, 5 + j));
+
+	// Every other row and column
+	auto sparse = m.view(0, 1, R / 2, C / 2, 2, 2);
+	skepu::Matrix<float> res2(R / 2, C / 2);
+	skepu_scale(res2, sparse, sparse);
+	for (size_t i = 0; i < R / 2; ++i)
+		for (size_t j = 0; j < C / 2; ++j)
+			REQUIRE(res2(i, j) == 3 * m(2 * i, 1 + 2 * j));
+
+	// Row-wise access to a column window
+	skepu::Vector<float> rows(10), ones(10, 1.f);
+	skepu_row_sum(rows, ones, block);
+	for (size_t i = 0; i < 10; ++i)
+	{
+		float expected = 1;
+		for (size_t j = 0; j < 20; ++j)
+			expected += m(3 + i, 5 + j);
+		REQUIRE(rows(i) == expected);
+	}
+
+}
+
+TEST_CASE("MapOverlap on a sub-block view")
+{
+	size_t constexpr R{50}, C{90};
+	skepu_blur.setOverlap(1);
+
+	skepu::Matrix<float> m(R, C);
+	for (size_t i = 0; i < R * C; ++i)
+		m[i] = (i * 7919 % 1000) / 1000.f;
+
+	// Interior block including its halo, compared against a copied block
+	size_t constexpr r0{7}, c0{11}, rows{30}, cols{60};
+	skepu::Matrix<float> copy(rows, cols);
+	for (size_t i = 0; i < rows; ++i)
+		for (size_t j = 0; j < cols; ++j)
+			copy(i, j) = m(r0 + i, c0 + j);
+
+	skepu::Matrix<float> expected(rows - 2, cols - 2), res(rows - 2, cols - 2);
+	skepu_blur(expected, copy);
+	skepu_blur(res, m.view(r0, c0, rows, cols));
+	for (size_t i = 0; i < res.size(); ++i)
+		REQUIRE(res[i] == expected[i]);
+}
+
+TEST_CASE("Tensor3 views")
+{
+	size_t constexpr I{6}, J{8}, K{10};
+	skepu::Tensor3<float> t(I, J, K);
+	for (size_t i = 0; i < t.size(); ++i)
+		t[i] = i;
+
+	auto plane = t.slice(2);
+	CHECK(plane.total_rows() == J);
+	CHECK(plane(3, 4) == t(2, 3, 4));
+
+	skepu::Matrix<float> res(J, K);
+	skepu_scale(res, plane, plane);
+	for (size_t j = 0; j < J; ++j)
+		for (size_t k = 0; k < K; ++k)
+			REQUIRE(res(j, k) == 3 * t(2, j, k));
+
+	auto sub = t.view(1, 2, 3, 4, 5, 6);
+	skepu::Tensor3<float> res3(4, 5, 6);
+	skepu_scale(res3, sub, sub);
+	for (size_t i = 0; i < 4; ++i)
+		for (size_t j = 0; j < 5; ++j)
+			for (size_t k = 0; k < 6; ++k)
+				REQUIRE(res3(i, j, k) == 3 * t(1 + i, 2 + j, 3 + k));
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+float axpy(float x, float y, float alpha)
+{
+	return alpha * x + y;
+}
+
+float mult(float a, float b)
+{
+	return a * b;
+}
+
+auto skepu_add = skepu::Map<2>(add);
+auto skepu_axpy = skepu::Map<2>(axpy);
+auto skepu_sum = skepu::Reduce(add);
+auto skepu_dot = skepu::MapReduce<2>(mult, add);
+
+TEST_CASE("Map chain consumed by Reduce")
+{
+	for (size_t N : {1, 7, 2048, 2049, 100003})
+	{
+		skepu::Vector<float> a(N, 1.f), b(N, 2.f), tmp(N), tmp2(N);
+
+		skepu_add(tmp, a, b);
+		skepu_axpy(tmp2, tmp, a, 2.f);
+		REQUIRE(skepu_sum(tmp2) == Approx(7.f * N));
+
+		// Intermediates are still produced
+		REQUIRE(tmp(0) == 3.f);
+		REQUIRE(tmp(N - 1) == 3.f);
+		REQUIRE(tmp2(N / 2) == 7.f);
+	}
+}
+
+TEST_CASE("Map chain consumed by MapReduce")
+{
+	size_t constexpr N{10000};
+	skepu::Vector<float> a(N, 1.f), b(N, 2.f), tmp(N);
+
+	skepu_add(tmp, a, b);
+	REQUIRE(skepu_dot(tmp, b) == Approx(6.f * N));
+}
+
+TEST_CASE("Host access executes pending calls")
+{
+	size_t constexpr N{5000};
+	skepu::Vector<float> a(N, 1.f), b(N, 2.f), res(N);
+
+	skepu_axpy(res, a, b, 3.f);
+	REQUIRE(res(N - 1) == 5.f);
+
+	skepu_add(res, res, a);
+	skepu_add(res, res, a);
+	skepu::flush();
+	for (size_t i = 0; i < N; ++i)
+		REQUIRE(res(i) == 7.f);
+}
+
+#ifdef SKEPU_OPENMP
+
+TEST_CASE("Threads record and flush their own calls")
+{
+	size_t constexpr N{5000};
+	int wrong = 0, flushedByOthers = 0;
+
+#pragma omp parallel num_threads(4) reduction(+:wrong, flushedByOthers)
+	{
+		auto thread_add = skepu::Map<2>(add);
+		const int id = omp_get_thread_num();
+		skepu::Vector<float> a(N, id), b(N, 1.f), res(N);
+
+		thread_add(res, a, b);
+		thread_add(res, res, b);
+
+		// Flushing on one thread leaves the calls of the others pending
+#pragma omp barrier
+		if (id == 0)
+			skepu::flush();
+#pragma omp barrier
+		flushedByOthers += (id != 0 && skepu::backend::LazyQueue::instance().empty());
+
+		for (size_t i = 0; i < N; ++i)
+			wrong += (res(i) != id + 2.f);
+	}
+
+	REQUIRE(flushedByOthers == 0);
+	REQUIRE(wrong == 0);
+}
+
+#endif
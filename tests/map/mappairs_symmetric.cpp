@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float distance(float a, float b)
+{
+	return (a > b) ? a - b : b - a;
+}
+
+float difference(float a, float b)
+{
+	return a - b;
+}
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+// Identifies both elements of a pair, to detect misplaced results
+float pair_code(float a, float b)
+{
+	return a * 1000 + b;
+}
+
+auto skepu_distance = skepu::MapPairs<1, 1>(distance);
+auto skepu_difference = skepu::MapPairs<1, 1>(difference);
+auto skepu_distance_sum = skepu::MapPairsReduce<1, 1>(distance, add);
+auto skepu_difference_sum = skepu::MapPairsReduce<1, 1>(difference, add);
+auto skepu_pair_code = skepu::MapPairs<1, 1>(pair_code);
+
+// Shapes spanning several of the default 16 x 1024 tiles, with partial tiles at both edges
+static const std::vector<std::pair<size_t, size_t>> rectangular_shapes {{1, 1500}, {17, 1025}, {37, 2100}, {2050, 3}};
+
+TEST_CASE("Symmetric MapPairs mirrors the upper triangle")
+{
+	for (size_t n : {1, 7, 100, 131})
+	{
+		skepu::Vector<float> v(n);
+		for (size_t i = 0; i < n; ++i)
+			v(i) = (i * 37) % 11;
+
+		skepu::Matrix<float> full(n, n), symmetric(n, n), antisymmetric(n, n);
+		skepu_distance.setSymmetry(skepu::Symmetry::None);
+		skepu_distance(full, v, v);
+
+		skepu_distance.setSymmetry(skepu::Symmetry::Symmetric);
+		skepu_distance(symmetric, v, v);
+
+		skepu_difference.setSymmetry(skepu::Symmetry::Antisymmetric);
+		skepu_difference(antisymmetric, v, v);
+
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < n; ++j)
+			{
+				REQUIRE(symmetric(i, j) == full(i, j));
+				REQUIRE(antisymmetric(i, j) == v(i) - v(j));
+			}
+	}
+}
+
+TEST_CASE("Symmetric MapPairsReduce reduces each pair into both rows")
+{
+	for (size_t n : {1, 7, 100, 131})
+	{
+		skepu::Vector<float> v(n);
+		for (size_t i = 0; i < n; ++i)
+			v(i) = (i * 37) % 11;
+
+		for (auto mode : {skepu::ReduceMode::RowWise, skepu::ReduceMode::ColWise})
+		{
+			skepu::Vector<float> full(n), symmetric(n), antisymmetric(n);
+			skepu_distance_sum.setReduceMode(mode);
+			skepu_distance_sum.setSymmetry(skepu::Symmetry::None);
+			skepu_distance_sum(full, v, v);
+
+			skepu_distance_sum.setSymmetry(skepu::Symmetry::Symmetric);
+			skepu_distance_sum(symmetric, v, v);
+
+			skepu_difference_sum.setReduceMode(mode);
+			skepu_difference_sum.setSymmetry(skepu::Symmetry::Antisymmetric);
+			skepu_difference_sum(antisymmetric, v, v);
+
+			for (size_t k = 0; k < n; ++k)
+			{
+				float expected = 0;
+				for (size_t l = 0; l < n; ++l)
+					expected += (mode == skepu::ReduceMode::RowWise) ? v(k) - v(l) : v(l) - v(k);
+
+				REQUIRE(symmetric(k) == full(k));
+				REQUIRE(antisymmetric(k) == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("MapPairs on non-square shapes spanning several tiles")
+{
+	skepu_pair_code.setSymmetry(skepu::Symmetry::None);
+	
+	for (auto shape : rectangular_shapes)
+	{
+		const size_t rows = shape.first, cols = shape.second;
+		skepu::Vector<float> v(rows), h(cols);
+		for (size_t i = 0; i < rows; ++i)
+			v(i) = i % 50;
+		for (size_t j = 0; j < cols; ++j)
+			h(j) = j % 1000;
+		
+		skepu::Matrix<float> res(rows, cols);
+		skepu_pair_code(res, v, h);
+		
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 0; j < cols; ++j)
+				REQUIRE(res(i, j) == v(i) * 1000 + h(j));
+	}
+}
+
+TEST_CASE("MapPairsReduce on non-square shapes spanning several tiles")
+{
+	skepu_difference_sum.setSymmetry(skepu::Symmetry::None);
+	
+	for (auto shape : rectangular_shapes)
+	{
+		const size_t rows = shape.first, cols = shape.second;
+		skepu::Vector<float> v(rows), h(cols);
+		for (size_t i = 0; i < rows; ++i)
+			v(i) = (i * 37) % 11;
+		for (size_t j = 0; j < cols; ++j)
+			h(j) = (j * 13) % 7;
+		
+		skepu::Vector<float> row_sums(rows), col_sums(cols);
+		skepu_difference_sum.setReduceMode(skepu::ReduceMode::RowWise);
+		skepu_difference_sum(row_sums, v, h);
+		skepu_difference_sum.setReduceMode(skepu::ReduceMode::ColWise);
+		skepu_difference_sum(col_sums, v, h);
+		
+		std::vector<float> expected_rows(rows, 0), expected_cols(cols, 0);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 0; j < cols; ++j)
+			{
+				expected_rows[i] += v(i) - h(j);
+				expected_cols[j] += v(i) - h(j);
+			}
+		
+		for (size_t i = 0; i < rows; ++i)
+			REQUIRE(row_sums(i) == expected_rows[i]);
+		for (size_t j = 0; j < cols; ++j)
+			REQUIRE(col_sums(j) == expected_cols[j]);
+	}
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+float heat2d(skepu::Region2D<float> r)
+{
+	return 0.2f * (r(0, 0) + r(-1, 0) + r(1, 0) + r(0, -1) + r(0, 1));
+}
+
+float heat3d(skepu::Region3D<float> r)
+{
+	return (r(0, 0, 0) + r(-1, 0, 0) + r(1, 0, 0) + r(0, -1, 0) + r(0, 1, 0) + r(0, 0, -1) + r(0, 0, 1)) / 7.f;
+}
+
+auto skepu_heat2d = skepu::MapOverlap(heat2d);
+auto skepu_heat3d = skepu::MapOverlap(heat3d);
+
+TEST_CASE("2D iterate matches repeated application")
+{
+	size_t constexpr R{67}, C{300}, steps{9};
+	skepu_heat2d.setOverlap(1);
+
+	skepu::Matrix<float> in(R, C), out(R, C), ref(R, C), tmp(R - 2, C - 2);
+	for (size_t i = 0; i < R * C; ++i)
+		in[i] = ref[i] = (i * 7919 % 1000) / 1000.f;
+
+	for (size_t t = 0; t < steps; ++t)
+	{
+		skepu_heat2d(tmp, ref);
+		for (size_t i = 1; i < R - 1; ++i)
+			for (size_t j = 1; j < C - 1; ++j)
+				ref(i, j) = tmp(i - 1, j - 1);
+	}
+
+	for (size_t block : {0, 1, 4})
+	{
+		skepu_heat2d.setTemporalBlocking(block);
+		skepu_heat2d.iterate(steps, out, in);
+		for (size_t i = 0; i < R * C; ++i)
+			REQUIRE(out[i] == Approx(ref[i]));
+	}
+}
+
+TEST_CASE("3D iterate matches repeated application")
+{
+	size_t constexpr I{12}, J{21}, K{40}, steps{5};
+	skepu_heat3d.setOverlap(1);
+
+	skepu::Tensor3<float> in(I, J, K), out(I, J, K), ref(I, J, K), tmp(I - 2, J - 2, K - 2);
+	for (size_t i = 0; i < in.size(); ++i)
+		in[i] = ref[i] = (i * 7919 % 1000) / 1000.f;
+
+	for (size_t t = 0; t < steps; ++t)
+	{
+		skepu_heat3d(tmp, ref);
+		for (size_t i = 1; i < I - 1; ++i)
+			for (size_t j = 1; j < J - 1; ++j)
+				for (size_t k = 1; k < K - 1; ++k)
+					ref(i, j, k) = tmp(i - 1, j - 1, k - 1);
+	}
+
+	skepu_heat3d.iterate(steps, out, in);
+	for (size_t i = 0; i < in.size(); ++i)
+		REQUIRE(out[i] == Approx(ref[i]));
+}
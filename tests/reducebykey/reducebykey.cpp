@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+int small_key(int x)
+{
+	return x % 20;
+}
+
+int large_key(int x)
+{
+	return x / 3;
+}
+
+int add(int a, int b)
+{
+	return a + b;
+}
+
+// Associative but not commutative, keeps the last element of every key
+int last(int a, int b)
+{
+	return b;
+}
+
+auto skepu_small_sum = skepu::ReduceByKey(small_key, add);
+auto skepu_small_last = skepu::ReduceByKey(small_key, last);
+auto skepu_large_sum = skepu::ReduceByKey(large_key, add);
+auto skepu_large_last = skepu::ReduceByKey(large_key, last);
+auto skepu_small_count = skepu::Histogram(small_key);
+auto skepu_large_count = skepu::Histogram(large_key);
+
+// A helper function to calculate the grouped reductions. Used to verify that the SkePU output is correct.
+template<typename Key>
+void directReduceByKey(skepu::Vector<int> &v, Key key, skepu::Vector<int> &sum, skepu::Vector<int> &last, skepu::Vector<float> &count)
+{
+	for (size_t k = 0; k < sum.size(); ++k)
+	{
+		sum(k) = 10;
+		last(k) = -1;
+		count(k) = 0;
+	}
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		size_t k = key(v(i));
+		if (k < sum.size())
+		{
+			sum(k) += v(i);
+			last(k) = v(i);
+			count(k) += 1;
+		}
+	}
+}
+
+TEST_CASE("ReduceByKey and Histogram with few keys")
+{
+	for (size_t n : {1, 15, 1000, 100000})
+	{
+		skepu::Vector<int> v(n);
+		for (size_t i = 0; i < n; ++i)
+			v(i) = (i * 7919) % 1013 - 13;
+
+		skepu::Vector<int> sum(16), last(16), expectedSum(16), expectedLast(16);
+		skepu::Vector<float> count(16), expectedCount(16);
+		directReduceByKey(v, small_key, expectedSum, expectedLast, expectedCount);
+
+		skepu_small_sum.setStartValue(10);
+		skepu_small_sum(sum, v);
+		skepu_small_last.setStartValue(-1);
+		skepu_small_last(last, v);
+		skepu_small_count(count, v);
+
+		for (size_t k = 0; k < 16; ++k)
+		{
+			REQUIRE(sum(k) == expectedSum(k));
+			REQUIRE(last(k) == expectedLast(k));
+			REQUIRE(count(k) == expectedCount(k));
+		}
+	}
+}
+
+TEST_CASE("ReduceByKey and Histogram with many keys")
+{
+	for (size_t n : {1, 1000, 300000})
+	{
+		skepu::Matrix<int> m(n / 100 + 1, 100);
+		skepu::Vector<int> v(m.size());
+		for (size_t i = 0; i < m.size(); ++i)
+			v(i) = m(i / 100, i % 100) = (i * 7919) % 300007;
+
+		const size_t bins = 90000;
+		skepu::Vector<int> sum(bins), last(bins), expectedSum(bins), expectedLast(bins);
+		skepu::Vector<float> count(bins), expectedCount(bins);
+		directReduceByKey(v, large_key, expectedSum, expectedLast, expectedCount);
+
+		skepu_large_sum.setStartValue(10);
+		skepu_large_sum(sum, m);
+		skepu_large_last.setStartValue(-1);
+		skepu_large_last(last, m);
+		skepu_large_count(count, m);
+
+		for (size_t k = 0; k < bins; ++k)
+		{
+			REQUIRE(sum(k) == expectedSum(k));
+			REQUIRE(last(k) == expectedLast(k));
+			REQUIRE(count(k) == expectedCount(k));
+		}
+	}
+}
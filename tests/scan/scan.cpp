@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+int add(int a, int b)
+{
+	return a + b;
+}
+
+auto skepu_scan = skepu::Scan(add);
+
+TEST_CASE("Inclusive and exclusive scan, also in place")
+{
+	for (size_t n : {1, 2, 9, 1000, 100000})
+	{
+		skepu::Vector<int> v(n), res(n);
+		for (size_t i = 0; i < n; ++i)
+			v(i) = (i * 7) % 13 - 6;
+
+		skepu_scan.setStartValue(5);
+		skepu_scan.setScanMode(skepu::ScanMode::Inclusive);
+		skepu_scan(res, v);
+
+		int sum = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			sum += v(i);
+			REQUIRE(res(i) == sum);
+		}
+
+		skepu_scan.setScanMode(skepu::ScanMode::Exclusive);
+		skepu_scan(res, v);
+		sum = 5;
+		for (size_t i = 0; i < n; ++i)
+		{
+			REQUIRE(res(i) == sum);
+			sum += v(i);
+		}
+
+		skepu_scan(v, v);
+		CHECK(v(0) == 5);
+		for (size_t i = 0; i < n; ++i)
+			REQUIRE(v(i) == res(i));
+	}
+}
+
+TEST_CASE("Segmented scan with flags and head indices")
+{
+	for (size_t n : {1, 9, 1000, 100000})
+	{
+		skepu::Vector<int> v(n), flagged(n), indexed(n);
+		skepu::Vector<char> flags(n, 0);
+		std::vector<size_t> starts;
+		for (size_t i = 0; i < n; ++i)
+		{
+			v(i) = (i * 7) % 13 - 6;
+			if (i % 17 == 3 || i % 1001 == 0)
+			{
+				flags(i) = 1;
+				starts.push_back(i);
+			}
+		}
+
+		// Row pointers with an empty segment and the end index
+		skepu::Vector<size_t> heads(starts.size() + 2);
+		heads(0) = 0;
+		for (size_t i = 0; i < starts.size(); ++i)
+			heads(i + 1) = starts[i];
+		heads(starts.size() + 1) = n;
+
+		for (auto mode : {skepu::ScanMode::Inclusive, skepu::ScanMode::Exclusive})
+		{
+			skepu_scan.setScanMode(mode);
+			skepu_scan.setStartValue(2);
+
+			skepu_scan.setSegmentMode(skepu::SegmentMode::Flags);
+			skepu_scan(flagged, v, flags);
+
+			skepu_scan.setSegmentMode(skepu::SegmentMode::Heads);
+			skepu_scan(indexed, v, heads);
+
+			int running = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (i == 0 || flags(i))
+					running = (mode == skepu::ScanMode::Inclusive) ? 0 : 2;
+
+				int expected = (mode == skepu::ScanMode::Inclusive) ? running + v(i) : running;
+				running += v(i);
+				REQUIRE(flagged(i) == expected);
+				REQUIRE(indexed(i) == expected);
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+
+#include <skepu>
+
+bool greater(int a, int b)
+{
+	return a > b;
+}
+
+float identity(float x)
+{
+	return x;
+}
+
+// Sorts by the last decimal digit only, which leaves many equal keys
+int last_digit(int x)
+{
+	return x % 10;
+}
+
+auto skepu_descending = skepu::Sort(greater);
+auto skepu_ascending = skepu::Sort(identity);
+auto skepu_by_digit = skepu::Sort(last_digit);
+
+TEST_CASE("Sort vectors with a comparator and by key")
+{
+	for (size_t n : {1, 2, 100, 200000})
+	{
+		skepu::Vector<int> v(n);
+		skepu::Vector<float> f(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			v(i) = (i * 7919) % 100003;
+			f(i) = (float)v(i) / 7 - 5000;
+		}
+
+		skepu_descending(v);
+		skepu_ascending(f);
+
+		for (size_t i = 1; i < n; ++i)
+		{
+			REQUIRE(v(i - 1) >= v(i));
+			REQUIRE(f(i - 1) <= f(i));
+		}
+	}
+}
+
+TEST_CASE("Sort is stable and permutes values along with the keys")
+{
+	for (size_t n : {1, 100, 200000})
+	{
+		skepu::Vector<int> keys(n), values(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			keys(i) = (i * 7919) % 100003;
+			values(i) = i;
+		}
+
+		skepu_by_digit(keys, values);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			REQUIRE(keys(i) == (values(i) * 7919) % 100003);
+			if (i > 0)
+			{
+				REQUIRE(keys(i - 1) % 10 <= keys(i) % 10);
+				if (keys(i - 1) % 10 == keys(i) % 10)
+					REQUIRE(values(i - 1) < values(i));
+			}
+		}
+
+		// With a comparator
+		skepu_descending(keys, values);
+		for (size_t i = 1; i < n; ++i)
+		{
+			REQUIRE(keys(i - 1) >= keys(i));
+			REQUIRE(keys(i) == (values(i) * 7919) % 100003);
+		}
+	}
+}
+
+TEST_CASE("Sort matrices row-wise")
+{
+	for (size_t rows : {1, 3, 64})
+	{
+		skepu::Matrix<int> m(rows, 1000), values(rows, 1000);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 0; j < 1000; ++j)
+			{
+				m(i, j) = (i * 1000 + j) * 7919 % 1009;
+				values(i, j) = j;
+			}
+
+		skepu_descending(m);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 1; j < 1000; ++j)
+				REQUIRE(m(i, j - 1) >= m(i, j));
+
+		skepu_by_digit(m, values);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 1; j < 1000; ++j)
+			{
+				REQUIRE(m(i, j - 1) % 10 <= m(i, j) % 10);
+				if (m(i, j - 1) % 10 == m(i, j) % 10)
+					REQUIRE(values(i, j - 1) < values(i, j));
+			}
+	}
+}
+
+TEST_CASE("Sort keeps positive and negative zero keys in their original order")
+{
+	for (size_t n : {100, 200000})
+	{
+		skepu::Vector<float> keys(n);
+		skepu::Vector<int> values(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			keys(i) = (i % 3 == 0) ? -0.f : (i % 3 == 1) ? 0.f : (float)(i % 7) - 3;
+			values(i) = i;
+		}
+
+		skepu_ascending(keys, values);
+
+		for (size_t i = 1; i < n; ++i)
+		{
+			REQUIRE(keys(i - 1) <= keys(i));
+			if (keys(i - 1) == keys(i))
+				REQUIRE(values(i - 1) < values(i));
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include <iostream>
+#include <skepu>
+
+float mult(float a, float b)
+{
+	return a * b;
+}
+
+float add(float a, float b)
+{
+	return a + b;
+}
+
+// A helper function to calculate the sparse matrix-vector product. Used to verify that the SkePU output is correct.
+void directSpMV(skepu::SparseMatrix<float> &A, skepu::Vector<float> &x, skepu::Vector<float> &res)
+{
+	for (size_t r = 0; r < A.total_rows(); ++r)
+	{
+		float sum = 0;
+		for (size_t c = 0; c < A.total_cols(); ++c)
+			sum += A.at(r, c) * x(c);
+		res(r) = sum;
+	}
+}
+
+auto spmv = skepu::SpMV(mult, add);
+
+TEST_CASE("Sparse matrix vector multiplication")
+{
+	size_t constexpr Rows{500};
+	size_t constexpr Cols{300};
+
+	skepu::SparseMatrix<float> A(Rows, Cols, 10000, 0.f, 1.f);
+	skepu::Vector<float> x(Cols), res(Rows), expected(Rows);
+	x.randomize(0, 10);
+
+	directSpMV(A, x, expected);
+
+	SECTION("CSR layout")
+	{
+		REQUIRE_NOTHROW(spmv(res, A, x));
+	}
+
+	SECTION("SELL-C-sigma layout")
+	{
+		A.setLayout(skepu::SELL_C_SIGMA_LAYOUT);
+		A.setSELLParameters(8, 64);
+		REQUIRE_NOTHROW(spmv(res, A, x));
+	}
+
+	SECTION("Blocked CSR layout")
+	{
+		A.setLayout(skepu::BLOCKED_CSR_LAYOUT);
+		A.setBlockSize(4, 4);
+		REQUIRE_NOTHROW(spmv(res, A, x));
+	}
+
+	skepu::external(skepu::read(res, expected), [&]{
+		for(size_t i = 0; i < Rows; ++i)
+			REQUIRE(res(i) == Approx(expected(i)).epsilon(1E-3));
+	});
+}
+
+TEST_CASE("Transposed sparse matrix vector multiplication")
+{
+	size_t constexpr Rows{300};
+	size_t constexpr Cols{200};
+
+	skepu::SparseMatrix<float> A(Rows, Cols, 5000, 0.f, 1.f);
+	skepu::Vector<float> x(Rows, 1.f), res(Cols);
+
+	spmv.setTransposed(true);
+	REQUIRE_NOTHROW(spmv(res, A, x));
+	spmv.setTransposed(false);
+
+	for (size_t c = 0; c < Cols; ++c)
+	{
+		float sum = 0;
+		for (size_t r = 0; r < Rows; ++r)
+			sum += A.at(r, c);
+		CHECK(res(c) == Approx(sum).epsilon(1E-3));
+	}
+}
+
+TEST_CASE("Sparse matrix dense matrix multiplication")
+{
+	size_t constexpr Rows{300};
+	size_t constexpr Cols{200};
+	size_t constexpr K{16};
+
+	skepu::SparseMatrix<float> A(Rows, Cols, 5000, 0.f, 1.f);
+	skepu::Matrix<float> X(Cols, K), res(Rows, K);
+	X.randomize(0, 10);
+
+	REQUIRE_NOTHROW(spmv(res, A, X));
+
+	for (size_t r = 0; r < Rows; ++r)
+		for (size_t k = 0; k < K; ++k)
+		{
+			float sum = 0;
+			for (size_t c = 0; c < Cols; ++c)
+				sum += A.at(r, c) * X(c, k);
+			CHECK(res(r, k) == Approx(sum).epsilon(1E-3));
+		}
+}